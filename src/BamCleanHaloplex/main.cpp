@@ -22,7 +22,9 @@ public:
 		//optional
 		addInt("min_match", "Minimum number of CIGAR matches (M).", true, 30);
 		addInfile("ref", "Reference genome for CRAM support (mandatory if CRAM is used).", true);
+		addInt("threads", "The number of threads used for BAM/CRAM (de)compression.", true, 1);
 
+		changeLog(2026, 10, 18, "Added 'threads' parameter for multi-threaded BAM/CRAM (de)compression.");
 		changeLog(2020,  11, 27, "Added CRAM support.");
 	}
 
@@ -34,6 +36,7 @@ public:
 		int c_reads_mapped = 0;
 		int c_reads_failed = 0;
 
+		HtsThreadPool::setThreadCount(getInt("threads"));
 		BamReader reader(getInfile("in"), getInfile("ref"));
 		BamWriter writer(getOutfile("out"), getInfile("ref"));
 		writer.writeHeader(reader);
@@ -47,7 +50,7 @@ public:
 			{
 				++c_reads_mapped;
 				int sum_m = 0;
-				for (CigarOp& op : al.cigarData())
+				for (const CigarOp& op : al.cigarView())
 				{
 					if (op.Type==BAM_CMATCH) sum_m += op.Length;
 				}
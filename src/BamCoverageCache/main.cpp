@@ -0,0 +1,67 @@
+#include "ToolBase.h"
+#include "CoverageCache.h"
+#include "Helper.h"
+#include <QTextStream>
+
+class ConcreteTool
+		: public ToolBase
+{
+	Q_OBJECT
+
+public:
+	ConcreteTool(int& argc, char *argv[])
+		: ToolBase(argc, argv)
+	{
+	}
+
+	virtual void setup()
+	{
+		setDescription("Creates a persistent depth cache for a BAM/CRAM file.");
+		setExtendedDescription(QStringList() << "The cache contains the run-length encoded depth of the given regions."
+											 << "BedLowCoverage, BedHighCoverage and BedCoverage use the cache instead of the BAM/CRAM file if it exists next to the BAM/CRAM file (default output file name), if it was created with the same mapping/base quality cutoffs and if it contains all regions of the input BED file."
+											 << "The cache is ignored if the BAM/CRAM file was modified after the cache was created.");
+		addInfile("bam", "Input BAM/CRAM file.", false);
+		//optional
+		addInfile("roi", "Regions to cache, e.g. the target region of a panel/exome. If unset, the whole genome is cached.", true);
+		addOutfile("out", "Output cache file. If unset, the BAM/CRAM file name with the suffix '.cov' is used.", true);
+		addInt("min_mapq", "Minimum mapping quality to consider a read.", true, 1);
+		addInt("min_baseq", "Minimum base quality to consider a base.", true, 0);
+		addInfile("ref", "Reference genome for CRAM support (mandatory if CRAM is used).", true);
+		addInt("threads", "Number of threads used.", true, 1);
+
+		changeLog(2026, 10, 18, "Initial version.");
+	}
+
+	virtual void main()
+	{
+		//init
+		QString bam = getInfile("bam");
+		QString roi = getInfile("roi");
+		QString out = getOutfile("out");
+		if (out.isEmpty()) out = CoverageCache::defaultFileName(bam);
+		QTime timer;
+		timer.start();
+
+		//load regions
+		BedFile regions;
+		if (!roi.isEmpty()) regions.load(roi);
+
+		//create cache
+		CoverageCache::create(bam, regions, out, getInt("min_mapq"), getInt("min_baseq"), getInfile("ref"), getInt("threads"));
+
+		//statistics
+		CoverageCache cache(out);
+		QTextStream stream(stdout);
+		stream << "Cached regions: " << cache.regions().count() << endl;
+		stream << "Cached bases: " << cache.regions().baseCount() << endl;
+		stream << "Time elapsed: " << Helper::elapsedTime(timer) << endl;
+	}
+};
+
+#include "main.moc"
+
+int main(int argc, char *argv[])
+{
+	ConcreteTool tool(argc, argv);
+	return tool.execute();
+}
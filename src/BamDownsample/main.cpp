@@ -3,6 +3,7 @@
 #include "Helper.h"
 #include "BasicStatistics.h"
 #include "BamWriter.h"
+#include "BamMateCache.h"
 #include <QTime>
 
 class ConcreteTool
@@ -25,7 +26,11 @@ public:
 		//optional
 		addFlag("test", "Test mode: fix random number generator seed and write kept read names to STDOUT.");
 		addInfile("ref", "Reference genome for CRAM support (mandatory if CRAM is used).", true);
+		addInt("threads", "The number of threads used for BAM/CRAM (de)compression.", true, 1);
+		addInt("max_cache", "Maximum memory used for caching alignments until the mate is seen (in MB). If exceeded, cached alignments are written to temporary files.", true, 4000);
 
+		changeLog(2026, 10, 18, "Added 'max_cache' parameter to limit the memory used for caching alignments until the mate is seen.");
+		changeLog(2026, 10, 18, "Added 'threads' parameter for multi-threaded BAM/CRAM (de)compression.");
 		changeLog(2020,  11, 27, "Added CRAM support.");
 	}
 
@@ -37,7 +42,10 @@ public:
 		srand(test ? 1 : QTime::currentTime().msec());
 		double percentage = getFloat("percentage");
 		if (percentage<=0 || percentage>=100) THROW(CommandLineParsingException, "Invalid percentage " + QString::number(percentage) +"!");
+		int max_cache = getInt("max_cache");
+		if (max_cache<1) THROW(CommandLineParsingException, "Invalid maximum cache size " + QString::number(max_cache) + " MB!");
 
+		HtsThreadPool::setThreadCount(getInt("threads"));
 		BamReader reader(getInfile("in"), getInfile("ref"));
 
 		BamWriter writer(getOutfile("out"), getInfile("ref"));
@@ -50,7 +58,8 @@ public:
 		int c_pe_pass = 0;
 
 		BamAlignment al;
-		QHash<QByteArray, BamAlignment> al_cache;
+		BamAlignment mate;
+		BamMateCache al_cache(1024ll * 1024ll * max_cache);
 		while (reader.getNextAlignment(al))
 		{
 			//skip secondary and supplementary alignments
@@ -66,28 +75,25 @@ public:
 					if (test) out << "KEPT SE: " << al.name() << endl;
 				}
 			}
-			else //paired-end reads
+			else if (al_cache.takeMate(al, mate)) //paired-end reads: mate seen => decide if pair is written (otherwise the alignment is cached)
 			{
-				QByteArray name = al.name();
-				if (!al_cache.contains(name)) //mate not seen yet => cache
-				{
-					al_cache.insert(name, al);
-				}
-				else //mate seen => decide if pair is written
-				{
-					++c_pe;
-					if (Helper::randomNumber(0, 100)<percentage)
-					{
-						++c_pe_pass;
-						writer.writeAlignment(al_cache.take(name));
-						writer.writeAlignment(al);
-						if (test) out << "KEPT PE: " << name << endl;
-					}
-					else
-					{
-						al_cache.remove(name);
-					}
-				}
+				processPair(writer, out, test, percentage, mate, al, c_pe, c_pe_pass);
+			}
+		}
+
+		//process pairs whose alignments were written to temporary files
+		al_cache.finish();
+		long long c_unmatched = 0;
+		int result;
+		while ((result = al_cache.takeRemaining(mate, al))!=0)
+		{
+			if (result==2)
+			{
+				processPair(writer, out, test, percentage, mate, al, c_pe, c_pe_pass);
+			}
+			else
+			{
+				++c_unmatched;
 			}
 		}
 
@@ -96,7 +102,21 @@ public:
 		out << "SE reads (written)          : " << c_se_pass << endl;
 		out << "PE reads                    : " << c_pe << endl;
 		out << "PE reads (written)          : " << c_pe_pass << endl;
-		out << "PE reads unmatched (skipped): " << al_cache.size() << endl;
+		out << "PE reads unmatched (skipped): " << c_unmatched << endl;
+		out << "PE reads cached (maximum)   : " << al_cache.peakCount() << endl;
+		out << "PE reads cached on disk     : " << al_cache.spilledCount() << endl;
+	}
+
+	void processPair(BamWriter& writer, QTextStream& out, bool test, double percentage, const BamAlignment& mate, const BamAlignment& al, int& c_pe, int& c_pe_pass)
+	{
+		++c_pe;
+		if (Helper::randomNumber(0, 100)<percentage)
+		{
+			++c_pe_pass;
+			writer.writeAlignment(mate);
+			writer.writeAlignment(al);
+			if (test) out << "KEPT PE: " << al.name() << endl;
+		}
 	}
 };
 
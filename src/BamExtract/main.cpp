@@ -20,7 +20,9 @@ public:
 		addOutfile("out", "Output BAM/CRAM file with matching reads.", false);
 		addOutfile("out2", "Output BAM/CRAM file with not matching reads.", true);
 		addInfile("ref", "Reference genome for CRAM support (mandatory if CRAM is used).", true);
+		addInt("threads", "The number of threads used for BAM/CRAM (de)compression.", true, 1);
 
+		changeLog(2026, 10, 18, "Added 'threads' parameter for multi-threaded BAM/CRAM (de)compression.");
 		changeLog(2023, 11, 30, "Initial implementation.");
 	}
 
@@ -45,6 +47,7 @@ public:
 		stdout_stream << "Read IDs: " << ids.count() << endl;
 
 		//open intput/output streams
+		HtsThreadPool::setThreadCount(getInt("threads"));
 		BamReader reader(getInfile("in"), ref);
 		BamWriter writer(getOutfile("out"), ref);
 		writer.writeHeader(reader);
@@ -1,5 +1,6 @@
 #include "ToolBase.h"
 #include "BamWriter.h"
+#include "BamMateCache.h"
 
 class ConcreteTool
 		: public ToolBase
@@ -24,18 +25,21 @@ public:
 		addInt("minDup", "Minimum number of duplicates.", true, 0);
 		addInt("maxIS", "Maximum insert size, -1 to disable.", true, -1);
 		addInfile("ref", "Reference genome for CRAM support (mandatory if CRAM is used).", true);
+		addInt("threads", "The number of threads used for BAM/CRAM (de)compression.", true, 1);
+		addInt("max_cache", "Maximum memory used for caching alignments until the mate is seen (in MB). If exceeded, cached alignments are written to temporary files.", true, 4000);
 		addFlag("write_cram", "Writes a CRAM file as output.");
 
 		changeLog(2020,  11, 27, "Added CRAM support.");
 		changeLog(2024,   2, 15, "Added option to remove large fragments.");
+		changeLog(2026,  10, 18, "Added 'threads' parameter for multi-threaded BAM/CRAM (de)compression.");
+		changeLog(2026,  10, 18, "Added 'max_cache' parameter to limit the memory used for caching alignments until the mate is seen.");
 	}
 
-	bool alignment_pass(BamAlignment& al) const
+	bool alignment_pass(const BamAlignment& al) const
 	{
 		int n_gaps = 0;
 		int indel_size = 0;
-		QList<CigarOp> cigar = al.cigarData();
-		foreach(CigarOp op, cigar)
+		for (const CigarOp& op : al.cigarView())
 		{
 			if (op.Type == 1 || op.Type == 2)
 			{
@@ -66,6 +70,8 @@ public:
 	{
 		//init
 		QTextStream out(stdout);
+		int max_cache = getInt("max_cache");
+		if (max_cache<1) THROW(CommandLineParsingException, "Invalid maximum cache size " + QString::number(max_cache) + " MB!");
 
 		int count_pass = 0;
 		int count_fail = 0;
@@ -76,55 +82,53 @@ public:
 		minDup = getInt("minDup");
 		maxIS = getInt("maxIS");
 
+		HtsThreadPool::setThreadCount(getInt("threads"));
 		BamReader reader(getInfile("in"), getInfile("ref"));
 		BamWriter writer(getOutfile("out"), getInfile("ref"));
 		writer.writeHeader(reader);
 
 		//process alignments
 		BamAlignment al;
-		QHash<QByteArray, BamAlignment> cache; //tracks alignments until mate is seen
-		QHash<QByteArray, bool> cache_pass; //tracks pass status of alignments until mate is seen
+		BamAlignment mate;
+		BamMateCache cache(1024ll * 1024ll * max_cache); //tracks alignments until mate is seen
 		while (reader.getNextAlignment(al))
 		{
 			if(al.isSecondaryAlignment() || al.isSupplementaryAlignment()) continue; //skip secondary/supplementary alignments
 
-			QByteArray name = al.name();
-
-			if (!cache.contains(name))
-			{
-				//mate note seen
-
-				//add alignment to cache
-				cache.insert(name, al);
-
-				//determine pass status
-				cache_pass.insert(name, alignment_pass(al));
-			}
-			else
+			if (cache.takeMate(al, mate))
 			{
 				//mate seen
-
-				if (cache_pass.value(name) && alignment_pass(al))
-				{
-					//mate passed, this alignment passes, keep alignments
-					writer.writeAlignment(cache.take(name));
-					writer.writeAlignment(al);
-					cache_pass.remove(name);
-					++count_pass;
-				}
-				else
-				{
-					//mate and/or this alignment does not pass
-					cache.remove(name);
-					cache_pass.remove(name);
-					++count_fail;
-				}
+				processPair(writer, mate, al, count_pass, count_fail);
 			}
+		}
 
+		//process pairs whose alignments were written to temporary files
+		cache.finish();
+		while (cache.takeRemaining(mate, al)==2)
+		{
+			processPair(writer, mate, al, count_pass, count_fail);
 		}
 
 		out << "pairs passed: " << count_pass << endl;
 		out << "pairs dropped: " << count_fail << endl;
+		out << "maximum cached alignments: " << cache.peakCount() << endl;
+		out << "alignments written to temporary files: " << cache.spilledCount() << endl;
+	}
+
+	void processPair(BamWriter& writer, const BamAlignment& mate, const BamAlignment& al, int& count_pass, int& count_fail) const
+	{
+		if (alignment_pass(mate) && alignment_pass(al))
+		{
+			//mate passed, this alignment passes, keep alignments
+			writer.writeAlignment(mate);
+			writer.writeAlignment(al);
+			++count_pass;
+		}
+		else
+		{
+			//mate and/or this alignment does not pass
+			++count_fail;
+		}
 	}
 
 private:
@@ -21,7 +21,9 @@ public:
 		addInfile("vcf", "Input indexed VCF.GZ file.", false);
 
 		addInfile("ref", "Reference genome for CRAM support (mandatory if CRAM is used).", true);
+		addInt("threads", "The number of threads used for BAM/CRAM (de)compression.", true, 1);
 
+		changeLog(2026, 10, 18, "Added 'threads' parameter for multi-threaded BAM/CRAM (de)compression.");
 		changeLog(2024, 7, 24, "Inital commit.");
 	}
 
@@ -74,6 +76,7 @@ public:
 		int count_fail = 0;
 
 
+		HtsThreadPool::setThreadCount(getInt("threads"));
 		BamReader reader(getInfile("in"), getInfile("ref"));
 		BamWriter writer(getOutfile("out"), getInfile("ref"));
 		writer.writeHeader(reader);
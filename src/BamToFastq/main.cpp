@@ -4,6 +4,7 @@
 #include "Helper.h"
 #include <QThreadPool>
 #include "OutputWorker.h"
+#include "BamMateCache.h"
 
 class ConcreteTool
 		: public ToolBase
@@ -30,33 +31,56 @@ public:
 		addInt("compression_level", "Output FASTQ compression level from 1 (fastest) to 9 (best compression).", true, 1);
 		addInt("write_buffer_size", "Output write buffer size (number of FASTQ entry pairs).", true, 100);
 		addInfile("ref", "Reference genome for CRAM support (mandatory if CRAM is used).", true);
+		addInt("threads", "The number of threads used for BAM/CRAM (de)compression.", true, 1);
+		addInt("max_cache", "Maximum memory used for caching reads until the mate is seen (in MB). If exceeded, cached reads are written to temporary files.", true, 4000);
 
+		changeLog(2026, 10, 18, "Added 'max_cache' parameter to limit the memory used for caching reads until the mate is seen.");
+		changeLog(2026, 10, 18, "Added 'threads' parameter for multi-threaded BAM/CRAM (de)compression.");
 		changeLog(2020, 11, 27, "Added CRAM support.");
 		changeLog(2020,  5, 29, "Massive speed-up by writing in background. Added 'compression_level' parameter.");
 		changeLog(2020,  3, 21, "Added 'reg' parameter.");
 		changeLog(2023,  3, 22, "Added mode for single-end samples (long reads).");
 	}
 
-	static void alignmentToFastq(const QSharedPointer<BamAlignment>& al, FastqEntry& e)
+	static void alignmentToFastq(const BamAlignment& al, FastqEntry& e)
 	{
-		e.header = "@" + al->name();
-		e.bases = al->bases();
+		e.header = "@" + al.name();
+		e.bases = al.bases();
 		e.header2 = "+";
-		e.qualities = al->qualities();
+		e.qualities = al.qualities();
 
-		if (al->isReverseStrand())
+		if (al.isReverseStrand())
 		{
 			e.bases.reverseComplement();
 			std::reverse(e.qualities.begin(), e.qualities.end());
 		}
 	}
 
+	static void writePair(ReadPairPool& pair_pool, const BamAlignment& mate, const BamAlignment& al)
+	{
+		ReadPair& pair = pair_pool.nextFreePair();
+		if (al.isRead1())
+		{
+			alignmentToFastq(al, pair.e1);
+			alignmentToFastq(mate, pair.e2);
+		}
+		else
+		{
+			alignmentToFastq(mate, pair.e1);
+			alignmentToFastq(al, pair.e2);
+		}
+		pair.status = ReadPair::TO_BE_WRITTEN;
+	}
+
 	virtual void main()
 	{
 		//init
 		QTime timer;
 		timer.start();
 		QTextStream out(stdout);
+		int max_cache = getInt("max_cache");
+		if (max_cache<1) THROW(CommandLineParsingException, "Invalid maximum cache size " + QString::number(max_cache) + " MB!");
+		HtsThreadPool::setThreadCount(getInt("threads"));
 		BamReader reader(getInfile("in"), getInfile("ref"));
 
 		QString out1 = getOutfile("out1");
@@ -109,22 +133,22 @@ public:
 		long long c_paired = 0;
 		long long c_duplicates = 0;
 		long long c_single_end = 0;
-		int max_cached = 0;
 
 		//iterate through reads
-		QHash<QByteArray, QSharedPointer<BamAlignment>> al_cache;
-		QSharedPointer<BamAlignment> al = QSharedPointer<BamAlignment>(new BamAlignment());
+		BamMateCache al_cache(1024ll * 1024ll * max_cache);
+		BamAlignment al;
+		BamAlignment mate;
 		while (true)
 		{
-			bool ok = reader.getNextAlignment(*al);
+			bool ok = reader.getNextAlignment(al);
 			if (!ok) break;
 			//out << al.name() << " PAIRED=" << al.isPaired() << " SEC=" << al.isSecondaryAlignment() << " PROP=" << al.isProperPair() << endl;
 			
 			//skip secondary alinments
-			if(al->isSecondaryAlignment() || al->isSupplementaryAlignment()) continue;
+			if(al.isSecondaryAlignment() || al.isSupplementaryAlignment()) continue;
 
 			//skip duplicates
-			if (remove_duplicates && al->isDuplicate())
+			if (remove_duplicates && al.isDuplicate())
 			{
 				++c_duplicates;
 				continue;
@@ -133,41 +157,18 @@ public:
 			if(mode == "paired-end")
 			{
 				//skip unpaired
-				if(!al->isPaired())
+				if(!al.isPaired())
 				{
 					++c_unpaired;
 					continue;
 				}
 
-				//store cached read when we encounter the mate
-				QByteArray name = al->name();
-				if (al_cache.contains(name))
+				//store cached read when we encounter the mate (otherwise the read is cached for later retrieval)
+				if (al_cache.takeMate(al, mate))
 				{
-					QSharedPointer<BamAlignment> mate = al_cache.take(name);
-					//out << name << " [AL] First: " << al.isRead1() << " Reverse: " << al.isReverseStrand() << " Seq: " << al.QueryBases.data() << endl;
-					//out << name << " [MA] First: " << mate.isRead1() << " Reverse: " << mate.isReverseStrand() << " Seq: " << mate.QueryBases.data() << endl;
-					ReadPair& pair = pair_pool.nextFreePair();
-					if (al->isRead1())
-					{
-						alignmentToFastq(al, pair.e1);
-						alignmentToFastq(mate, pair.e2);
-					}
-					else
-					{
-						alignmentToFastq(mate, pair.e1);
-						alignmentToFastq(al, pair.e2);
-					}
-					pair.status = ReadPair::TO_BE_WRITTEN;
+					writePair(pair_pool, mate, al);
 					++c_paired;
 				}
-				//cache read for later retrieval
-				else
-				{
-					al_cache.insert(name, al);
-					al = QSharedPointer<BamAlignment>(new BamAlignment());
-				}
-
-				max_cached = std::max(max_cached, al_cache.size());
 			}
 			else if (mode == "single-end")
 			{
@@ -182,12 +183,29 @@ public:
 			}
 		}
 
+		//store pairs whose reads were written to temporary files
+		al_cache.finish();
+		long long c_unmatched = 0;
+		int result;
+		while ((result = al_cache.takeRemaining(mate, al))!=0)
+		{
+			if (result==2)
+			{
+				writePair(pair_pool, mate, al);
+				++c_paired;
+			}
+			else
+			{
+				++c_unmatched;
+			}
+		}
+
 		//write debug output
 		if(mode == "paired-end")
 		{
 			out << "Pair reads (written)            : " << c_paired << endl;
 			out << "Unpaired reads (skipped)        : " << c_unpaired << endl;
-			out << "Unmatched paired reads (skipped): " << al_cache.size() << endl;
+			out << "Unmatched paired reads (skipped): " << c_unmatched << endl;
 		}
 		else //single-end
 		{
@@ -199,7 +217,8 @@ public:
 			out << "Duplicate reads (skipped)       : " << c_duplicates << endl;
 		}
 		out << endl;
-		out << "Maximum cached reads            : " << max_cached << endl;
+		out << "Maximum cached reads            : " << al_cache.peakCount() << endl;
+		out << "Cached reads written to disk    : " << al_cache.spilledCount() << endl;
 		out << "Time elapsed                    : " << Helper::elapsedTime(timer, true) << endl;
 
 		//terminate FASTQ writer after all reads are written
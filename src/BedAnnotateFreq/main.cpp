@@ -1,6 +1,7 @@
 #include "BedFile.h"
 #include "ToolBase.h"
 #include "Statistics.h"
+#include "MultiSitePileup.h"
 #include <QFileInfo>
 
 #include "NGSHelper.h"
@@ -29,7 +30,9 @@ public:
 		addInfile("ref", "Reference genome for CRAM support (mandatory if CRAM is used).", true);
 		addInt("min_mapq", "Minimum mapping quality.", true, 1);
 		addInt("min_baseq", "Minimum base quality.", true, 25);
+		addInt("threads", "The number of threads used to calculate base counts (chromosomes are distributed to the threads).", true, 1);
 
+		changeLog(2026,  10, 18, "Base counts of nearby regions are calculated in one go. Added 'threads' parameter.");
 		changeLog(2020,  11, 27, "Added CRAM support.");
 	}
 
@@ -39,6 +42,7 @@ public:
 		QStringList bams = getInfileList("bam");
 		int min_mapq = getInt("min_mapq");
 		int min_baseq = getInt("min_baseq");
+		int threads = getInt("threads");
 
 		//open output stream
 		QString out = getOutfile("out");
@@ -46,27 +50,33 @@ public:
 		QTextStream outstream(outfile.data());
 		outstream << "#chr\tstart\tend\tsample\tA\tC\tG\tT\ttotal\n";
 
-		//open BAM files
-		QList<QSharedPointer<BamReader>> bams_open;
-		const QString ref_string = getInfile("ref");
-		foreach(QString bam, bams)
-		{
-			bams_open.append(QSharedPointer<BamReader>(new BamReader(bam, ref_string)));
-		}
-
-		//extract base counts from BAMs
+		//load positions
 		BedFile file;
 		file.load(getInfile("in"));
+		MultiSitePileup engine;
 		for(int i=0; i<file.count(); ++i)
 		{
 			if(file[i].length()!=1)
 			{
 				THROW(ToolFailedException, "BED file contains region with length > 1, which is not supported: " + file[i].toString(true));
 			}
+			engine.addSite(file[i].chr(), file[i].end());
+		}
 
+		//extract base counts from BAMs
+		const QString ref_string = getInfile("ref");
+		QVector<QVector<Pileup>> pileups;
+		foreach(QString bam, bams)
+		{
+			pileups.append(engine.calculate(bam, ref_string, threads, -1, min_mapq, false, min_baseq));
+		}
+
+		//write output
+		for(int i=0; i<file.count(); ++i)
+		{
 			for(int j=0; j<bams.count(); ++j)
 			{
-				Pileup pileup = bams_open[j]->getPileup(file[i].chr(), file[i].end(), -1, min_mapq, false, min_baseq);
+				const Pileup& pileup = pileups[j][i];
 				outstream << file[i].toString(false)+"\t"+QFileInfo(bams[j]).baseName()+"\t"+QString::number(pileup.a())+"\t"+QString::number(pileup.c())+"\t"+QString::number(pileup.g())+"\t"+QString::number(pileup.t())+"\t"+QString::number(pileup.depth(false)) + "\n";
 			}
 		}
@@ -1,6 +1,6 @@
 #include "Exceptions.h"
 #include "ToolBase.h"
-#include "ChromosomalIndex.h"
+#include "ChromosomalIntervalTree.h"
 #include "VariantList.h"
 #include "BedFile.h"
 #include "BedpeFile.h"
@@ -29,6 +29,7 @@ public:
 		addFlag("add_simple_gene_names", "Adds an additional column containing only the list of gene names.");
 		addFlag("test", "Uses the test database instead of on the production database.");
 
+		changeLog(2026, 10, 18, "Faster lookup of genes overlapping SVs.");
 		changeLog(2023, 5, 10, "Added column with gene names at breakpoints.");
 		changeLog(2020, 1, 27, "Bugfix: 0-based BEDPE positions are now converted into 1-based BED positions.");
 		changeLog(2020, 1, 21, "Added ability to reannotate BEDPE files by overwriting old annotation.");
@@ -58,7 +59,7 @@ public:
 			gene_regions.add(regions);
 		}
 		gene_regions.sort();
-		ChromosomalIndex<BedFile> gene_regions_index(gene_regions);
+		ChromosomalIntervalTree<BedFile> gene_regions_index(gene_regions); //interval tree because gene regions are long
 		out << "caching gene start/end finished (runtime: " << Helper::elapsedTime(timer) << ")" << endl;
 		timer.restart();
 
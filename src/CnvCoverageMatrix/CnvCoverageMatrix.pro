@@ -0,0 +1,14 @@
+#-------------------------------------------------
+#
+# Project created by QtCreator 2026-10-18T12:00:00
+#
+#-------------------------------------------------
+
+TEMPLATE = app
+QT       -= gui
+CONFIG   += console
+CONFIG   -= app_bundle
+
+SOURCES += main.cpp
+
+include("../app_cli.pri")
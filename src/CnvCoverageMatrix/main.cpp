@@ -0,0 +1,127 @@
+#include "ToolBase.h"
+#include "CoverageMatrix.h"
+#include "Helper.h"
+#include <QTextStream>
+#include <QThreadPool>
+#include <QRunnable>
+
+//Loads one coverage profile
+class ProfileLoader
+	: public QRunnable
+{
+public:
+	ProfileLoader(SampleCoverageProfile& profile, const QString& filename, QString& error)
+		: QRunnable()
+		, profile_(profile)
+		, filename_(filename)
+		, error_(error)
+	{
+	}
+
+	void run() override
+	{
+		try
+		{
+			profile_.load(filename_);
+		}
+		catch(Exception& e)
+		{
+			error_ = e.message();
+		}
+		catch(std::exception& e)
+		{
+			error_ = e.what();
+		}
+		catch(...)
+		{
+			error_ = "Unknown exception!";
+		}
+	}
+
+private:
+	SampleCoverageProfile& profile_;
+	QString filename_;
+	QString& error_;
+};
+
+class ConcreteTool
+		: public ToolBase
+{
+	Q_OBJECT
+
+public:
+	ConcreteTool(int& argc, char *argv[])
+		: ToolBase(argc, argv)
+	{
+	}
+
+	virtual void setup()
+	{
+		setDescription("Creates a binary coverage matrix from coverage profiles for CnvReferenceCohort.");
+		setExtendedDescription(QStringList() << "The matrix contains the depth of each region (row) and sample (column) in a binary, memory-mappable format."
+											 << "All coverage profiles must contain the same regions in the same order."
+											 << "If the output file exists, the coverage profiles are appended to it. Samples that are already contained cause an error.");
+		addInfileList("in", "Coverage profiles in BED format (GZ files supported). The sample name is taken from the header line or the file name.", false);
+		addOutfile("out", "Output coverage matrix file.", false);
+		//optional
+		addInt("threads", "Number of threads used to load the coverage profiles.", true, 1);
+
+		changeLog(2026, 10, 18, "Initial version.");
+	}
+
+	virtual void main()
+	{
+		//init
+		QStringList in = getInfileList("in");
+		QString out = getOutfile("out");
+		int threads = getInt("threads");
+		if (threads<1) THROW(CommandLineParsingException, "Number of threads has to be at least 1!");
+		QTime timer;
+		timer.start();
+
+		//load profiles in batches (only one batch is kept in memory) and append their columns to the output file
+		CoverageMatrixWriter writer(out);
+		const int batch_size = 10 * threads;
+		QThreadPool thread_pool;
+		thread_pool.setMaxThreadCount(threads);
+		for (int batch_start=0; batch_start<in.count(); batch_start+=batch_size)
+		{
+			QStringList files = in.mid(batch_start, batch_size);
+			QList<SampleCoverageProfile> profiles;
+			QStringList errors;
+			for (int i=0; i<files.count(); ++i)
+			{
+				profiles << SampleCoverageProfile();
+				errors << QString();
+			}
+			for (int i=0; i<files.count(); ++i)
+			{
+				thread_pool.start(new ProfileLoader(profiles[i], files[i], errors[i]));
+			}
+			thread_pool.waitForDone();
+			for (int i=0; i<files.count(); ++i)
+			{
+				if (!errors[i].isEmpty()) THROW(Exception, "Could not load coverage profile " + files[i] + ": " + errors[i]);
+			}
+
+			writer.append(profiles);
+		}
+		writer.commit();
+
+		//statistics
+		CoverageMatrix matrix(out);
+		QTextStream stream(stdout);
+		stream << "Regions: " << matrix.rowCount() << endl;
+		stream << "Samples added: " << in.count() << endl;
+		stream << "Samples: " << matrix.sampleCount() << endl;
+		stream << "Time elapsed: " << Helper::elapsedTime(timer) << endl;
+	}
+};
+
+#include "main.moc"
+
+int main(int argc, char *argv[])
+{
+	ConcreteTool tool(argc, argv);
+	return tool.execute();
+}
@@ -1,10 +1,14 @@
 #include "ToolBase.h"
 #include "Statistics.h"
 #include "BasicStatistics.h"
+#include "CoverageMatrix.h"
 #include <zlib.h>
 #include <QFileInfo>
 #include <QVector>
 #include <QElapsedTimer>
+#include <QThreadPool>
+#include <QRunnable>
+#include <cmath>
 
 class ConcreteTool
 		: public ToolBase
@@ -26,6 +30,7 @@ public:
 		int end;
 		double depth;
 		QByteArray chr_start_end;
+		QByteArray depth_str;
 	};
 
 	struct TabIndices
@@ -44,6 +49,113 @@ public:
 
 	typedef QVector<double> CoverageProfile;
 
+	//Main sample coverage profile, centered per chromosome
+	struct CenteredProfile
+	{
+		CoverageProfile values; //depth minus chromosome mean
+		QVector<MinMaxIndex> chr_ranges; //row index ranges of the chromosomes
+		QVector<double> chr_sum_sq; //sum of squares of the centered values of each chromosome
+	};
+
+	//Pearson correlation of the centered main sample and a reference sample (several accumulators to allow vectorization)
+	static double correlation(const CenteredProfile& main, int chr, const double* y)
+	{
+		const double* x = main.values.constData();
+		const int min = main.chr_ranges[chr].min;
+		const int max = main.chr_ranges[chr].max;
+
+		//mean of reference sample
+		double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+		int i = min;
+		for (; i+3<=max; i+=4)
+		{
+			s0 += y[i];
+			s1 += y[i+1];
+			s2 += y[i+2];
+			s3 += y[i+3];
+		}
+		for (; i<=max; ++i) s0 += y[i];
+		const double y_mean = (s0 + s1 + s2 + s3) / (max - min + 1);
+
+		//covariance and variance of reference sample
+		double xy0 = 0.0, xy1 = 0.0, xy2 = 0.0, xy3 = 0.0;
+		double yy0 = 0.0, yy1 = 0.0, yy2 = 0.0, yy3 = 0.0;
+		i = min;
+		for (; i+3<=max; i+=4)
+		{
+			const double d0 = y[i] - y_mean;
+			const double d1 = y[i+1] - y_mean;
+			const double d2 = y[i+2] - y_mean;
+			const double d3 = y[i+3] - y_mean;
+			xy0 += x[i] * d0;
+			xy1 += x[i+1] * d1;
+			xy2 += x[i+2] * d2;
+			xy3 += x[i+3] * d3;
+			yy0 += d0 * d0;
+			yy1 += d1 * d1;
+			yy2 += d2 * d2;
+			yy3 += d3 * d3;
+		}
+		for (; i<=max; ++i)
+		{
+			const double d = y[i] - y_mean;
+			xy0 += x[i] * d;
+			yy0 += d * d;
+		}
+
+		return (xy0 + xy1 + xy2 + xy3) / std::sqrt(main.chr_sum_sq[chr] * (yy0 + yy1 + yy2 + yy3));
+	}
+
+	//Computes the median per-chromosome correlation of matrix columns with the main sample
+	class CorrelationWorker
+		: public QRunnable
+	{
+	public:
+		CorrelationWorker(const CoverageMatrix& matrix, const QVector<int>& rows, const CenteredProfile& main, const QVector<int>& columns, QVector<double>& correlations, int first, int last)
+			: QRunnable()
+			, matrix_(matrix)
+			, rows_(rows)
+			, main_(main)
+			, columns_(columns)
+			, correlations_(correlations)
+			, first_(first)
+			, last_(last)
+		{
+		}
+
+		void run() override
+		{
+			CoverageProfile y(rows_.count());
+			QVector<double> corr(main_.chr_ranges.count());
+			for (int c=first_; c<=last_; ++c)
+			{
+				//gather used rows
+				const double* column = matrix_.column(columns_[c]);
+				for (int i=0; i<rows_.count(); ++i)
+				{
+					y[i] = column[rows_[i]];
+				}
+
+				//median correlation of chromosomes
+				for (int chr=0; chr<main_.chr_ranges.count(); ++chr)
+				{
+					corr[chr] = correlation(main_, chr, y.constData());
+				}
+				std::sort(corr.begin(), corr.end());
+				correlations_[c] = BasicStatistics::median(corr);
+			}
+		}
+
+	private:
+		const CoverageMatrix& matrix_;
+		const QVector<int>& rows_;
+		const CenteredProfile& main_;
+		const QVector<int>& columns_;
+		QVector<double>& correlations_;
+		int first_;
+		int last_;
+	};
+
 	QByteArray sampleName(QString filename)
 	{
 		QString output = QFileInfo(filename).fileName();
@@ -80,7 +192,7 @@ public:
 	}
 
 	//Function to load a BED file with coverage data (.cov, .bed and gzipped possible)
-	QList<BedLineRepresentation> parseGzFileBedFile(const QString& filename)
+	QList<BedLineRepresentation> parseGzFileBedFile(const QString& filename, QByteArray& sample_name)
 	{
 		const int buffer_size = 1048576;
 		std::vector<char> buffer(buffer_size);
@@ -119,6 +231,11 @@ public:
 			//skip headers
 			if (line.startsWith("#") || line.startsWith("track ") || line.startsWith("browser "))
 			{
+				if (line.startsWith("#chr\t"))
+				{
+					QByteArrayList fields = line.split('\t');
+					if (fields.count()>3) sample_name = fields[3];
+				}
 				continue;
 			}
 
@@ -140,7 +257,7 @@ public:
 			if (!ok) THROW(FileParseException, "COV file line with invalid coverage score found: '" + line + "'");
 
 			//append line
-			lines << BedLineRepresentation{fields[0], start, end, depth, fields[0] + "\t" + fields[1] + "\t" + fields[2]};
+			lines << BedLineRepresentation{fields[0], start, end, depth, fields[0] + "\t" + fields[1] + "\t" + fields[2], fields[3]};
 		}
 		gzclose(file);
 		return lines;
@@ -230,20 +347,123 @@ public:
 	}
 
 
+	//Calculates the median per-chromosome correlation of the main sample with all samples of the coverage matrix (except the main sample)
+	QList<QPair<QString, double>> correlationsFromMatrix(const CoverageMatrix& matrix, const QList<BedLineRepresentation>& main_file, const QBitArray& rows_to_use, const QMap<QByteArray, MinMaxIndex>& chr_indices, const CoverageProfile& cov1, const QByteArray& main_name, int threads, QHash<QString, int>& file2column)
+	{
+		//check that the regions are the same
+		if (matrix.rowCount()!=main_file.size())
+		{
+			THROW(FileParseException, "Coverage matrix contains a different number of regions (" + QString::number(matrix.rowCount()) +") than main sample (" + QString::number(main_file.size()) +")");
+		}
+		for (int i=0; i<main_file.size(); ++i)
+		{
+			const BedLineRepresentation& line = main_file[i];
+			const BedLine& region = matrix.regions()[i];
+			if (region.chr()!=line.chr || region.start()!=line.start+1 || region.end()!=line.end)
+			{
+				THROW(FileParseException, "Region '" + region.toString(true) + "' of coverage matrix does not match the main file: '" + line.chr_start_end + "'");
+			}
+		}
+
+		//determine used rows
+		QVector<int> rows;
+		for (int i=0; i<rows_to_use.size(); ++i)
+		{
+			if (rows_to_use[i]) rows << i;
+		}
+
+		//center main sample per chromosome
+		CenteredProfile main;
+		main.values = cov1;
+		for (auto it = chr_indices.cbegin(); it != chr_indices.cend(); ++it)
+		{
+			const MinMaxIndex& range = it.value();
+			double sum = 0.0;
+			for (int i=range.min; i<=range.max; ++i) sum += cov1[i];
+			const double mean = sum / (range.max - range.min + 1);
+
+			double sum_sq = 0.0;
+			for (int i=range.min; i<=range.max; ++i)
+			{
+				main.values[i] = cov1[i] - mean;
+				sum_sq += main.values[i] * main.values[i];
+			}
+			main.chr_ranges << range;
+			main.chr_sum_sq << sum_sq;
+		}
+
+		//determine samples to compare
+		QVector<int> columns;
+		for (int c=0; c<matrix.sampleCount(); ++c)
+		{
+			if (matrix.sampleName(c)==main_name) continue;
+			columns << c;
+		}
+
+		//calculate correlations
+		const int chunk_size = 50;
+		QVector<double> correlations(columns.count());
+		QThreadPool thread_pool;
+		thread_pool.setMaxThreadCount(threads);
+		for (int first=0; first<columns.count(); first+=chunk_size)
+		{
+			thread_pool.start(new CorrelationWorker(matrix, rows, main, columns, correlations, first, std::min(columns.count(), first + chunk_size) - 1));
+		}
+		thread_pool.waitForDone();
+
+		QList<QPair<QString, double>> output;
+		for (int c=0; c<columns.count(); ++c)
+		{
+			const QString& file = matrix.sampleFile(columns[c]);
+			output << qMakePair(file, correlations[c]);
+			file2column[file] = columns[c];
+		}
+		return output;
+	}
+
+	//Writes the output TSV file based on the main file and the coverage matrix
+	void writeFromMatrix(QFile& outstream, const CoverageMatrix& matrix, const QList<BedLineRepresentation>& main_file, const QByteArray& main_name, const QStringList& best_ref_files, const QHash<QString, int>& file2column)
+	{
+		QVector<const double*> columns;
+		QByteArray line = "#chr\tstart\tend\t" + main_name;
+		foreach(const QString& ref_file, best_ref_files)
+		{
+			const int c = file2column[ref_file];
+			columns << matrix.column(c);
+			line += '\t' + matrix.sampleName(c);
+		}
+		outstream.write(line + '\n');
+
+		for (int i=0; i<main_file.size(); ++i)
+		{
+			const BedLineRepresentation& main_line = main_file[i];
+			line = main_line.chr_start_end + '\t' + main_line.depth_str;
+			foreach(const double* column, columns)
+			{
+				line += '\t' + QByteArray::number(column[i], 'f', 4);
+			}
+			outstream.write(line + '\n');
+		}
+	}
+
 	virtual void setup()
 	{
 		setDescription("Create a reference cohort for CNV calling from a list of coverage profiles.");
 		setExtendedDescription(QStringList() << "This tool creates a reference cohort for CNV calling by analyzing the correlation between the main sample coverage profile and a list of reference coverage profiles."
 											 << "The coverage profiles of the samples that correlate best with the main sample are saved in the output TSV file."
-											 << "The TSV file contains the chromosome, start, and end positions in the first three columns, with subsequent columns showing the coverage for each selected reference file.");
+											 << "The TSV file contains the chromosome, start, and end positions in the first three columns, with subsequent columns showing the coverage for each selected reference file."
+											 << "For large reference cohorts, the reference coverage profiles should be provided as coverage matrix created with CnvCoverageMatrix. Then, no reference files are parsed and correlations are calculated in parallel.");
 		addInfile("in", "Coverage profile of main sample in BED format.", false);
-		addInfileList("in_ref", "Reference coverage profiles of other sample in BED format (GZ files supported).", false);
 		addOutfile("out", "Output TSV file with coverage profiles of selected reference samples.", false);
 		//optional
+		addInfileList("in_ref", "Reference coverage profiles of other sample in BED format (GZ files supported). Either this parameter or 'in_matrix' must be given.", true);
+		addInfile("in_matrix", "Reference coverage profiles as binary coverage matrix created with CnvCoverageMatrix. Either this parameter or 'in_ref' must be given. If the matrix contains the main sample, it is ignored.", true);
 		addInfileList("exclude", "Regions in the given BED file(s) are excluded from the coverage calcualtion, e.g. copy-number polymorphic regions.", true);
 		addInt("cov_max", "Best n reference coverage files to include in 'out' based on correlation.", true, 150);
+		addInt("threads", "Number of threads used for correlation calculation (only used with 'in_matrix').", true, 1);
 		addFlag("debug", "Enable debug output.");
 
+		changeLog(2026, 10, 18, "Added 'in_matrix' and 'threads' parameters.");
 		changeLog(2024,  8, 16, "Initial version.");
 	}
 
@@ -255,8 +475,12 @@ public:
 		QString in = getInfile("in");
 		QStringList exclude_files = getInfileList("exclude");
 		QStringList in_refs = getInfileList("in_ref");
+		QString in_matrix = getInfile("in_matrix");
 		int cov_max = getInt("cov_max");
+		int threads = getInt("threads");
 		bool debug = getFlag("debug");
+		if (in_refs.isEmpty()==in_matrix.isEmpty()) THROW(CommandLineParsingException, "Exactly one of the parameters 'in_ref' and 'in_matrix' has to be given!");
+		if (threads<1) THROW(CommandLineParsingException, "Number of threads has to be at least 1!");
 
 		//Merge exclude files
 		timer.start();
@@ -273,7 +497,8 @@ public:
 
 		//Determine indices to use
 		//load main sample and determine row indices for correlation computation
-		QList<BedLineRepresentation> main_file = parseGzFileBedFile(in);
+		QByteArray main_name;
+		QList<BedLineRepresentation> main_file = parseGzFileBedFile(in, main_name);
 		if (debug) out << "loading main sample: " << Helper::elapsedTime(timer.restart()) << endl;
 
 		//compute ChromosomalIndex from merged excludes
@@ -320,7 +545,7 @@ public:
 				}
 				else
 				{
-					chr_indices[line.chr.str()].min = row_count;
+					chr_indices[line.chr.str()] = MinMaxIndex{row_count, row_count};
 				}
 				++row_count;
 			}
@@ -344,9 +569,22 @@ public:
 		QTime corr_timer;
 		QList<QPair<QString, double>> file2corr;
 		CoverageProfile cov2(cov1.size());
+		QScopedPointer<CoverageMatrix> matrix;
+		QHash<QString, int> file2column;
 
-		//iterate over each reference file
+		//use coverage matrix
 		corr_timer.start();
+		if (!in_matrix.isEmpty())
+		{
+			if (main_name.isEmpty()) main_name = sampleName(in);
+			matrix.reset(new CoverageMatrix(in_matrix));
+			if (debug) out << "opening coverage matrix: " << Helper::elapsedTime(timer.restart()) << endl;
+
+			file2corr = correlationsFromMatrix(*matrix, main_file, correct_indices, chr_indices, cov1, main_name, threads, file2column);
+			if (debug) out << "calculating correlation for " << file2corr.count() << " samples of the coverage matrix: " << Helper::elapsedTime(timer.restart()) << endl;
+		}
+
+		//iterate over each reference file
 		foreach (const QString& ref_file, in_refs)
 		{
 			timer.restart();
@@ -398,6 +636,13 @@ public:
 
 		//Merge coverage profiles and store them in a tsv file
 		QSharedPointer<QFile> outstream = Helper::openFileForWriting(getOutfile("out"), true);
+		if (!matrix.isNull())
+		{
+			writeFromMatrix(*outstream, *matrix, main_file, main_name, best_ref_files, file2column);
+			outstream->close();
+			if (debug) out << "writing output: " << Helper::elapsedTime(timer.restart()) << endl;
+			return;
+		}
 		QVector<gzFile> files;
 		files << gzopen(in.toUtf8().constData(), "rb");
 		foreach(QString ref_file, best_ref_files)
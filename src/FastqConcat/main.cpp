@@ -24,8 +24,10 @@ public:
 		//optional
 		addInt("compression_level", "Output FASTQ compression level from 1 (fastest) to 9 (best compression).", true, 1);
 		addFlag("long_read", "Support long reads (> 1kb).");
+		addInt("threads", "Number of threads used for BGZF compression/decompression (plain gzip input is always decompressed with one thread).", true, 1);
 
 		//changelog
+		changeLog(2026, 10, 18, "Added 'threads' parameter for multi-threaded (de)compression of BGZF-compressed FASTQ files. Output files are BGZF-compressed now.");
 		changeLog(2023, 6, 15, "Added support for long reads.");
 		changeLog(2020, 7, 15, "Added 'compression_level' parameter.");
 		changeLog(2019, 4, 8, "Initial version of this tool");
@@ -37,13 +39,14 @@ public:
 		QStringList in_files = getInfileList("in");
 
 		int compression_level = getInt("compression_level");
-		FastqOutfileStream output_stream(getOutfile("out"), compression_level);
+		int threads = getInt("threads");
+		FastqOutfileStream output_stream(getOutfile("out"), compression_level, threads);
 
 		FastqEntry entry;
 		foreach(QString in_file, in_files)
 		{
 			// get next input file:
-			FastqFileStream input_stream(in_file, false, getFlag("long_read"));
+			FastqFileStream input_stream(in_file, false, getFlag("long_read"), threads);
 
 			// write input file in output
 			while (!input_stream.atEnd())
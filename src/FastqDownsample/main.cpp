@@ -24,7 +24,9 @@ public:
 		//optional
 		addFlag("test", "Test mode: fix random number generator seed and write kept read names to STDOUT.");
 		addInt("compression_level", "Output FASTQ compression level from 1 (fastest) to 9 (best compression).", true, 1);
+		addInt("threads", "Number of threads used per FASTQ file for BGZF compression/decompression (plain gzip input is always decompressed with one thread).", true, 1);
 
+		changeLog(2026, 10, 18, "Added 'threads' parameter for multi-threaded (de)compression of BGZF-compressed FASTQ files. Output files are BGZF-compressed now.");
 		changeLog(2020, 7, 15, "Initial version of this tool.");
 	}
 
@@ -39,13 +41,14 @@ public:
 		if (percentage<=0 || percentage>=100) THROW(CommandLineParsingException, "Invalid percentage " + QString::number(percentage) +"!");
 		bool test = getFlag("test");
 		int compression_level = getInt("compression_level");
+		int threads = getInt("threads");
 
 		//open streams
 		QTextStream out(stdout);
-		FastqFileStream is1(in1, false);
-		FastqFileStream is2(in2, false);
-		FastqOutfileStream os1(out1, compression_level);
-		FastqOutfileStream os2(out2, compression_level);
+		FastqFileStream is1(in1, false, false, threads);
+		FastqFileStream is2(in2, false, false, threads);
+		FastqOutfileStream os1(out1, compression_level, threads);
+		FastqOutfileStream os2(out2, compression_level, threads);
 
 		//init random number generator
 		srand(test ? 1 : QTime::currentTime().msec());
@@ -25,7 +25,9 @@ public:
 		addFlag("v", "Invert match: keep non-matching reads.");
 		addInt("compression_level", "Output FASTQ compression level from 1 (fastest) to 9 (best compression).", true, Z_BEST_SPEED);
 		addFlag("long_read", "Support long reads (> 1kb).");
+		addInt("threads", "Number of threads used for BGZF compression/decompression (plain gzip input is always decompressed with one thread).", true, 1);
 
+		changeLog(2026, 10, 18, "Added 'threads' parameter for multi-threaded (de)compression of BGZF-compressed FASTQ files. Output files are BGZF-compressed now.");
 		changeLog(2023,  4,  18, "Added support for long reads.");
 		changeLog(2020, 7, 15, "Added 'compression_level' parameter.");
 	}
@@ -35,6 +37,7 @@ public:
 		//init
 		bool v = getFlag("v");
 		bool long_read = getFlag("long_read");
+		int threads = getInt("threads");
 
 		//load ids and lengths
 		QHash<QByteArray, int> ids;
@@ -54,10 +57,10 @@ public:
 
 		//open output stream
 		int compression_level = getInt("compression_level");
-		FastqOutfileStream outfile(getOutfile("out"), compression_level);
+		FastqOutfileStream outfile(getOutfile("out"), compression_level, threads);
 
 		//parse input and write output
-		FastqFileStream stream(getInfile("in"), true, long_read);
+		FastqFileStream stream(getInfile("in"), true, long_read, threads);
 		FastqEntry entry;
 		while (!stream.atEnd())
 		{
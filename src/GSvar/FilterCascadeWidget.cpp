@@ -50,6 +50,8 @@ void FilterCascadeWidget::markFailedFilters()
 		QStringList errors = filters_.errors(i);
 		if (errors.isEmpty())
 		{
+			FilterStepStatistics stats = filters_.statistics(i);
+			item->setToolTip(filters_[i]->description().join("\n") + "\n\nLast run: " + QString::number(stats.rows_in) + " > " + QString::number(stats.rows_out) + " variants (" + QString::number(stats.time_ms) + " ms)");
 			item->setBackground(QBrush());
 		}
 		else
@@ -797,17 +797,18 @@ void MainWindow::on_actionSV_triggered()
 		for (int i=0; i<variants_.count(); ++i)
 		{
 			if (!filter_result_.passing(i)) continue;
+			const Variant& variant = qAsConst(variants_)[i];
 
 			bool all_genos_het = true;
 			foreach(int i_genotype, i_genotypes)
 			{
-				if (variants_[i].annotations()[i_genotype]!="het")
+				if (variant.annotations()[i_genotype]!="het")
 				{
 					all_genos_het = false;
 				}
 			}
 			if (!all_genos_het) continue;
-			het_hit_genes.insert(GeneSet::createFromText(variants_[i].annotations()[i_genes], ','));
+			het_hit_genes.insert(GeneSet::createFromText(variant.annotations()[i_genes], ','));
 		}
 	}
 	else if (variants_.type()!=SOMATIC_PAIR && variants_.type() != SOMATIC_SINGLESAMPLE)
@@ -887,17 +888,18 @@ void MainWindow::on_actionCNV_triggered()
 		for (int i=0; i<variants_.count(); ++i)
 		{
 			if (!filter_result_.passing(i)) continue;
+			const Variant& variant = qAsConst(variants_)[i];
 
 			bool all_genos_het = true;
 			foreach(int i_genotype, i_genotypes)
 			{
-				if (variants_[i].annotations()[i_genotype]!="het")
+				if (variant.annotations()[i_genotype]!="het")
 				{
 					all_genos_het = false;
 				}
 			}
 			if (!all_genos_het) continue;
-			het_hit_genes.insert(GeneSet::createFromText(variants_[i].annotations()[i_genes], ','));
+			het_hit_genes.insert(GeneSet::createFromText(variant.annotations()[i_genes], ','));
 		}
 	}
 	else if (type!=SOMATIC_PAIR && type!=SOMATIC_SINGLESAMPLE)
@@ -1701,7 +1703,7 @@ void MainWindow::delayedInitialization()
 
 void MainWindow::variantCellDoubleClicked(int row, int /*col*/)
 {
-    const Variant& v = variants_[ui_.vars->rowToVariantIndex(row)];
+    const Variant& v = qAsConst(variants_)[ui_.vars->rowToVariantIndex(row)];
     IgvSessionManager::get(0).gotoInIGV(v.chr().str() + ":" + QString::number(v.start()) + "-" + QString::number(v.end()), true);
 }
 
@@ -1775,7 +1777,7 @@ void MainWindow::editVariantValidation(int index)
 			if (status=="true positive") status = "TP";
 			if (status=="false positive") status = "FP";
 			int i_validation = variants_.annotationIndexByName("validation", true, true);
-			variant.annotations()[i_validation] = status;
+			variants_.setAnnotation(index, i_validation, status);
 
 			//update details widget and filtering
 			ui_.variant_details->updateVariant(variants_, index);
@@ -1822,7 +1824,7 @@ void MainWindow::editVariantComment(int index)
 			int col_index = variants_.annotationIndexByName("comment", true, false);
 			if (col_index!=-1)
 			{
-				variant.annotations()[col_index] = text;
+				variants_.setAnnotation(index, col_index, text);
 				refreshVariantTable();
 
 				//mark variant list as changed
@@ -2299,7 +2301,7 @@ void MainWindow::checkMendelianErrorRate(double cutoff_perc)
 
 			for (int i=0; i<variants_.count(); ++i)
 			{
-				const Variant& v = variants_[i];
+				const Variant& v = qAsConst(variants_)[i];
 				if (!v.chr().isAutosome()) continue;
 				++autosomal;
 
@@ -5785,13 +5787,13 @@ void MainWindow::editVariantClassification(VariantList& variants, int index, boo
 			//update variant list classification
 			int i_som_class = variants.annotationIndexByName("somatic_classification");
 			QString new_class = class_info.classification.replace("n/a", "");
-			variant.annotations()[i_som_class] = new_class.toUtf8();
+			variants.setAnnotation(index, i_som_class, new_class.toUtf8());
 
 			markVariantListChanged(variant, "somatic_classification", new_class);
 
 			//update variant list classification comment
 			int i_som_class_comment = variants.annotationIndexByName("somatic_classification_comment");
-			variant.annotations()[i_som_class_comment] = class_info.comments.toUtf8();
+			variants.setAnnotation(index, i_som_class_comment, class_info.comments.toUtf8());
 
 			markVariantListChanged(variant, "somatic_classification_comment", class_info.comments);
 
@@ -5803,13 +5805,13 @@ void MainWindow::editVariantClassification(VariantList& variants, int index, boo
 			//update variant list classification
 			int i_class = variants.annotationIndexByName("classification");
 			QString new_class = class_info.classification.replace("n/a", "");
-			variant.annotations()[i_class] = new_class.toUtf8();
+			variants.setAnnotation(index, i_class, new_class.toUtf8());
 
 			markVariantListChanged(variant, "classification", new_class);
 
 			//update variant list classification comment
 			int i_class_comment = variants.annotationIndexByName("classification_comment");
-			variant.annotations()[i_class_comment] = class_info.comments.toUtf8();
+			variants.setAnnotation(index, i_class_comment, class_info.comments.toUtf8());
 
 			markVariantListChanged(variant, "classification_comment", class_info.comments);
 
@@ -5850,12 +5852,12 @@ void MainWindow::editSomaticVariantInterpretation(const VariantList &vl, int ind
 void MainWindow::updateSomaticVariantInterpretationAnno(int index, QString vicc_interpretation, QString vicc_comment)
 {
 	int i_vicc = variants_.annotationIndexByName("NGSD_som_vicc_interpretation");
-	variants_[index].annotations()[i_vicc] = vicc_interpretation.toUtf8();
+	variants_.setAnnotation(index, i_vicc, vicc_interpretation.toUtf8());
 
 	markVariantListChanged(variants_[index], "NGSD_som_vicc_interpretation", vicc_interpretation);
 
 	int i_vicc_comment = variants_.annotationIndexByName("NGSD_som_vicc_comment");
-	variants_[index].annotations()[i_vicc_comment] = vicc_comment.toUtf8();
+	variants_.setAnnotation(index, i_vicc_comment, vicc_comment.toUtf8());
 
 	markVariantListChanged(variants_[index], "NGSD_som_vicc_comment", vicc_comment);
 
@@ -5885,7 +5887,7 @@ void MainWindow::on_actionAnnotateSomaticVariantInterpretation_triggered()
 		QByteArray vicc_score = SomaticVariantInterpreter::viccScoreAsString(vicc_data).toUtf8();
 		if (vicc_score!=variants_[i].annotations()[i_vicc])
 		{
-			variants_[i].annotations()[i_vicc] = vicc_score;
+			variants_.setAnnotation(i, i_vicc, vicc_score);
 			markVariantListChanged(variants_[i], "NGSD_som_vicc_interpretation", vicc_score);
 		}
 
@@ -5893,7 +5895,7 @@ void MainWindow::on_actionAnnotateSomaticVariantInterpretation_triggered()
 		QByteArray vicc_comment = vicc_data.comment.toUtf8();
 		if (variants_[i].annotations()[i_vicc_comment]!=vicc_comment)
 		{
-			variants_[i].annotations()[i_vicc_comment]= vicc_comment;
+			variants_.setAnnotation(i, i_vicc_comment, vicc_comment);
 			markVariantListChanged(variants_[i], "NGSD_som_vicc_comment", vicc_comment);
 		}
 	}
@@ -6025,7 +6027,7 @@ void MainWindow::editVariantReportConfiguration(int index)
 		}
 
 		//get inheritance mode by gene
-		const Variant& variant = variants_[index];
+		const Variant& variant = qAsConst(variants_)[index];
 		QList<KeyValuePair> inheritance_by_gene;
 		int i_genes = variants_.annotationIndexByName("gene", true, false);
 
@@ -6052,7 +6054,7 @@ void MainWindow::editVariantReportConfiguration(int index)
 		//force classification of causal variants
 		if(var_config.causal)
 		{
-			const Variant& variant = variants_[index];
+			const Variant& variant = qAsConst(variants_)[index];
 			ClassificationInfo classification_info = db.getClassification(variant);
 			if (classification_info.classification=="" || classification_info.classification=="n/a")
 			{
@@ -0,0 +1,60 @@
+#include "ToolBase.h"
+#include "NGSHelper.h"
+#include "Helper.h"
+
+class ConcreteTool
+		: public ToolBase
+{
+	Q_OBJECT
+
+public:
+	ConcreteTool(int& argc, char *argv[])
+		: ToolBase(argc, argv)
+	{
+	}
+
+	virtual void setup()
+	{
+		setDescription("Converts a GFF file to a binary transcript database.");
+		setExtendedDescription(QStringList() << "The transcript database can be used instead of the GFF file in VcfAnnotateConsequence and VcfAnnotateMaxEntScan. Loading it is much faster than parsing the GFF file."
+											 << "Transcripts are filtered when the database is created. Thus, the filter parameters used when loading the database have to match the parameters used for creating it.");
+		addInfile("in", "Ensembl-style GFF file with transcripts, e.g. from https://ftp.ensembl.org/pub/release-112/gff3/homo_sapiens/Homo_sapiens.GRCh38.112.gff3.gz.", false);
+		addOutfile("out", "Output transcript database file.", false);
+		//optional
+		addEnum("source", "GFF source.", true, QStringList() << "ensembl" << "refseq", "ensembl");
+		addFlag("all", "If set, all transcripts are imported. The default is to skip transcripts not labeled as 'GENCODE basic' for Ensembl and not with RefSeq/BestRefSeq origin for Refseq.");
+		addFlag("skip_not_hgnc", "Skip genes that do not have a HGNC identifier.");
+
+		changeLog(2026, 10, 18, "Initial version.");
+	}
+
+	virtual void main()
+	{
+		//init
+		QTextStream out(stdout);
+		QTime timer;
+		timer.start();
+
+		//parse GFF file
+		GffSettings gff_settings;
+		gff_settings.source = getEnum("source");
+		gff_settings.print_to_stdout = true;
+		gff_settings.include_all = getFlag("all");
+		gff_settings.skip_not_hgnc = getFlag("skip_not_hgnc");
+		GffData data = NGSHelper::loadGffFile(getInfile("in"), gff_settings);
+		out << "Parsing transcripts took: " << Helper::elapsedTime(timer) << endl;
+
+		//store database
+		timer.restart();
+		NGSHelper::storeGffDatabase(getOutfile("out"), data, gff_settings);
+		out << "Writing transcript database took: " << Helper::elapsedTime(timer) << endl;
+	}
+};
+
+#include "main.moc"
+
+int main(int argc, char *argv[])
+{
+	ConcreteTool tool(argc, argv);
+	return tool.execute();
+}
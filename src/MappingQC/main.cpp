@@ -5,6 +5,7 @@
 #include "Exceptions.h"
 #include "Settings.h"
 #include "StatisticsReads.h"
+#include "HtsThreadPool.h"
 #include <QFileInfo>
 
 class ConcreteTool
@@ -37,8 +38,10 @@ public:
 		addInfile("somatic_custom_bed", "Somatic custom region of interest (subpanel of actual roi). If specified, additional depth metrics will be calculated.", true, true);
 		addOutfile("read_qc", "If set, a read QC file in qcML format is created (just like ReadQC/SeqPurge).", true);
 		addFlag("long_read", "Support long reads (> 1kb).");
+		addInt("threads", "The number of threads used for the main QC and for BAM/CRAM decompression. If more than one thread is used, the input file has to be indexed.", true, 1);
 
 		//changelog
+		changeLog(2026, 10, 18, "Added 'threads' parameter (used for the main QC and for BAM/CRAM decompression).");
 		changeLog(2023, 11,  8, "Added long_read support.");
 		changeLog(2023,  5, 12, "Added 'read_qc' parameter.");
 		changeLog(2022,  5, 25, "Added new QC metrics to WGS mode.");
@@ -63,6 +66,8 @@ public:
 		int min_mapq = getInt("min_mapq");
 		bool debug = getFlag("debug");
 		bool long_read = getFlag("long_read");
+		int threads = getInt("threads");
+		HtsThreadPool::setThreadCount(threads);
 		QTextStream debug_stream(stdout);
 
 		// check that just one of roi_file, wgs, rna is set
@@ -105,12 +110,12 @@ public:
 			QString build = getEnum("build");
 			if (build=="non_human")
 			{
-				metrics = Statistics::mapping(in, min_mapq, ref_file);
+				metrics = Statistics::mapping(in, min_mapq, ref_file, threads);
 			}
 			else
 			{
 				QString qc_region = QString("://resources/") + (build=="hg19" ? "hg19_439_omim_genes.bed" : "hg38_440_omim_genes.bed");
-				metrics = Statistics::mapping_wgs(in, qc_region, min_mapq, ref_file);
+				metrics = Statistics::mapping_wgs(in, qc_region, min_mapq, ref_file, threads);
 			}
 
 			//parameters
@@ -118,7 +123,7 @@ public:
 		}
 		else if(rna)
 		{
-			metrics = Statistics::mapping(in, min_mapq, ref_file);
+			metrics = Statistics::mapping(in, min_mapq, ref_file, threads);
 
 			//parameters
 			parameters << "-rna";
@@ -131,7 +136,7 @@ public:
 			roi.merge();
 
 			//calculate metrics
-			metrics = Statistics::mapping(roi, in, ref_file, min_mapq, cfdna);
+			metrics = Statistics::mapping(roi, in, ref_file, min_mapq, cfdna, threads);
 
 			//parameters
 			parameters << "-roi" << QFileInfo(roi_file).fileName();
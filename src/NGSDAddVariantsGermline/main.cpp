@@ -36,6 +36,7 @@ public:
 		addFlag("debug", "Enable verbose debug output.");
 		addFlag("no_time", "Disable timing output.");
 
+		changeLog(2026, 10, 18, "Batched import of small variants (much faster for WGS samples). Added import throughput to timing output.");
 		changeLog(2024,  8, 28, "Merged all force parameters into one. Implmented skipping of small variants import if the same callset was already imported.");
 		changeLog(2021,  7, 19, "Added support for 'CADD' and 'SpliceAI' columns in 'variant' table.");
 	}
@@ -88,7 +89,8 @@ public:
 		double max_af = getFloat("max_af");
 		QList<int> variant_ids = db.addVariants(variants, max_af, c_add, c_update);
 		out << "Imported variants (added:" << c_add << " updated:" << c_update << ")" << endl;
-		sub_times << ("adding variants took: " + Helper::elapsedTime(sub_timer));
+		double variants_per_sec = variants.count() / std::max(0.001, sub_timer.elapsed()/1000.0);
+		sub_times << ("adding variants took: " + Helper::elapsedTime(sub_timer) + " (" + QString::number(variants_per_sec, 'f', 0) + " variants/s)");
 
 		//skip import of detected variants if same callset was already imported
 		VariantCaller caller = variants.getCaller();
@@ -104,7 +104,8 @@ public:
 		int c_add, c_update;
 		QList<int> variant_ids = db.addVariants(variants, 1.0, c_add, c_update);
 		out << "Imported variants (added:" << c_add << " updated:" << c_update << ")" << endl;
-		sub_times << ("adding variants took: " + Helper::elapsedTime(sub_timer));
+		double variants_per_sec = variants.count() / std::max(0.001, sub_timer.elapsed()/1000.0);
+		sub_times << ("adding variants took: " + Helper::elapsedTime(sub_timer) + " (" + QString::number(variants_per_sec, 'f', 0) + " variants/s)");
 
 		//add detected somatic variants
 		sub_timer.start();
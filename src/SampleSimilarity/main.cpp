@@ -5,6 +5,174 @@
 #include <QTextStream>
 #include <QFileInfo>
 #include "Helper.h"
+#include "NGSHelper.h"
+#include <QThreadPool>
+#include <QRunnable>
+#include <QDir>
+#include <QCryptographicHash>
+
+//Settings for loading the genotype data of the input files
+struct LoadSettings
+{
+	QString mode;
+	BedFile roi;
+	bool include_gonosomes;
+	int min_cov;
+	int max_snps;
+	QString ref;
+	bool include_single_end_reads;
+	VcfFile snps; //SNP list (bam and fingerprint mode)
+	quint64 panel_id; //SNP panel identifier (fingerprint mode)
+	QString fingerprint_dir; //folder for storing fingerprints (fingerprint mode)
+};
+
+//Genotype data of one input file
+struct SampleData
+{
+	QString filename;
+	SampleSimilarity::VariantGenotypes genotypes; //vcf, gsvar and bam mode
+	GenotypeFingerprint fingerprint; //fingerprint mode
+	QString error;
+};
+
+//Loads the genotype data of one input file
+class SampleLoader
+	: public QRunnable
+{
+public:
+	SampleLoader(SampleData& sample, const LoadSettings& settings)
+		: QRunnable()
+		, sample_(sample)
+		, settings_(settings)
+	{
+	}
+
+	void run() override
+	{
+		try
+		{
+			const QString& filename = sample_.filename;
+			if (settings_.mode=="vcf")
+			{
+				sample_.genotypes = settings_.roi.count()>0 ? SampleSimilarity::genotypesFromVcf(filename, settings_.include_gonosomes, true, settings_.roi) : SampleSimilarity::genotypesFromVcf(filename, settings_.include_gonosomes, true);
+			}
+			else if (settings_.mode=="gsvar")
+			{
+				sample_.genotypes = settings_.roi.count()>0 ? SampleSimilarity::genotypesFromGSvar(filename, settings_.include_gonosomes, settings_.roi) : SampleSimilarity::genotypesFromGSvar(filename, settings_.include_gonosomes);
+			}
+			else if (settings_.mode=="bam")
+			{
+				sample_.genotypes = SampleSimilarity::genotypesFromBam(settings_.snps, filename, settings_.min_cov, settings_.max_snps, settings_.include_gonosomes, settings_.ref, settings_.include_single_end_reads);
+			}
+			else if (filename.endsWith(".fingerprint"))
+			{
+				sample_.fingerprint.load(filename);
+				if (sample_.fingerprint.panelId()!=settings_.panel_id)
+				{
+					THROW(ArgumentException, "Fingerprint file " + filename + " was created for a different SNP panel (build, roi or include_gonosomes differs)!");
+				}
+			}
+			else
+			{
+				//re-use stored fingerprint if it was created from the same file (path, size and modification time) with the same settings
+				QString fp_file = settings_.fingerprint_dir.isEmpty() ? "" : settings_.fingerprint_dir + "/" + fingerprintFileName(filename);
+				if (!fp_file.isEmpty() && QFile::exists(fp_file))
+				{
+					GenotypeFingerprint& fp = sample_.fingerprint;
+					fp.load(fp_file);
+					if (fp.isFromSource(filename) && fp.panelId()==settings_.panel_id && fp.minCov()==settings_.min_cov && fp.maxSnps()==settings_.max_snps && fp.includeSingleEndReads()==settings_.include_single_end_reads) return;
+				}
+
+				sample_.fingerprint = GenotypeFingerprint::fromBam(settings_.snps, settings_.panel_id, filename, settings_.min_cov, settings_.max_snps, settings_.ref, settings_.include_single_end_reads);
+				if (!fp_file.isEmpty()) sample_.fingerprint.store(fp_file);
+			}
+		}
+		catch(Exception& e)
+		{
+			sample_.error = e.message();
+		}
+		catch(std::exception& e)
+		{
+			sample_.error = e.what();
+		}
+		catch(...)
+		{
+			sample_.error = "Unknown exception!";
+		}
+	}
+
+	//Returns the name of the stored fingerprint of a BAM/CRAM file. It contains a hash of the absolute path, so that files with the same name in different folders do not collide.
+	static QString fingerprintFileName(const QString& filename)
+	{
+		QFileInfo info(filename);
+		QByteArray path_hash = QCryptographicHash::hash(info.absoluteFilePath().toUtf8(), QCryptographicHash::Md5).toHex().left(8);
+		return info.fileName() + "_" + path_hash + ".fingerprint";
+	}
+
+private:
+	SampleData& sample_;
+	const LoadSettings& settings_;
+};
+
+//Compares one sample to a list of samples and creates the output lines
+class SampleComparer
+	: public QRunnable
+{
+public:
+	SampleComparer(const QString& mode, const SampleData& sample, const QList<const SampleData*>& others, QStringList& lines)
+		: QRunnable()
+		, mode_(mode)
+		, sample_(sample)
+		, others_(others)
+		, lines_(lines)
+	{
+	}
+
+	void run() override
+	{
+		foreach(const SampleData* other, others_)
+		{
+			SampleSimilarity sc;
+			QStringList cols;
+			cols << QFileInfo(sample_.filename).fileName();
+			cols << QFileInfo(other->filename).fileName();
+			if (mode_=="vcf" || mode_=="gsvar")
+			{
+				sc.calculateSimilarity(sample_.genotypes, other->genotypes);
+
+				cols << QString::number(sc.olPerc(), 'f', 2);
+				cols << QString::number(sc.sampleCorrelation(), 'f', 4);
+				cols << QString::number(sc.ibs2Perc(), 'f', 2);
+				cols << QString::number(sc.noVariants1());
+				cols << QString::number(sc.noVariants2());
+			}
+			else
+			{
+				if (mode_=="bam")
+				{
+					sc.calculateSimilarity(sample_.genotypes, other->genotypes);
+				}
+				else
+				{
+					sc.calculateSimilarity(sample_.fingerprint, other->fingerprint);
+				}
+
+				cols << QString::number(sc.olCount());
+				cols << QString::number(sc.sampleCorrelation(), 'f', 4);
+				cols << QString::number(sc.ibs0Perc(), 'f', 2);
+				cols << QString::number(sc.ibs2Perc(), 'f', 2);
+			}
+			cols << sc.messages().join(", ");
+			lines_ << cols.join("\t");
+		}
+	}
+
+private:
+	QString mode_;
+	const SampleData& sample_;
+	QList<const SampleData*> others_;
+	QStringList& lines_;
+};
 
 class ConcreteTool
 		: public ToolBase
@@ -24,12 +192,14 @@ public:
 											 << "Multi-sample VCFs are not supported. Use VcfExtractSamples to split them to one VCF per sample."
 											 << "In VCF mode, it is assumed that variant lists are left-normalized, e.g. with VcfLeftNormalize."
 											 << "BAM mode supports BAM as well as CRAM files."
+											 << "Fingerprint mode genotypes the same SNPs as BAM mode, but stores them as bit-packed genotype fingerprints, which are compared very fast. Input files are BAM/CRAM files or fingerprint files (extension '.fingerprint'). The correlation is calculated from the genotypes instead of the allele frequencies."
 											 << "Note: When working on hg38 WES or WGS samples, it is recommended to use the 'roi_hg38_wes_wgs' flag!");
 
         addInfileList("in", "Input variant lists in VCF format (two or more). If only one file is given, each line in this file is interpreted as an input file path.", false, true);
 		//optional
 		addOutfile("out", "Output file. If unset, writes to STDOUT.", true);
-		addEnum("mode", "Mode (input format).", true, QStringList() << "vcf" << "gsvar" << "bam", "vcf");
+		addInfileList("in2", "Second list of input files. If given, each file of 'in' is compared to each file of 'in2' instead of comparing all pairs of files in 'in'. If only one file is given, each line in this file is interpreted as an input file path.", true, true);
+		addEnum("mode", "Mode (input format).", true, QStringList() << "vcf" << "gsvar" << "bam" << "fingerprint", "vcf");
 		addInfile("roi", "Restrict similarity calculation to variants in target region.", true);
 		addFlag("roi_hg38_wes_wgs", "Used pre-defined high-confidence coding region of hg38. Speeds up calculations, especially for WGS. Also makes scores comparable when mixing WES and WGS or different WES kits.");
 		addFlag("include_gonosomes", "Includes gonosomes into calculation (by default only variants on autosomes are considered).");
@@ -38,9 +208,12 @@ public:
 		addEnum("build", "Genome build used to generate the input (BAM mode).", true, QStringList() << "hg19" << "hg38", "hg38");
 		addInfile("ref", "Reference genome for CRAM support (mandatory if CRAM is used).", true);
 		addFlag("include_single_end_reads", "In bam mode: include reads which are not (properly) paired. Required e.g. for long-read input data.");
+		addString("fingerprint_dir", "Folder in which the fingerprints of BAM/CRAM input files are stored as '<filename>_<path hash>.fingerprint' (fingerprint mode). Stored fingerprints are re-used if they were created from the same file (path, size and modification time) with the same settings.", true);
+		addInt("threads", "Number of threads used for loading and comparing samples.", true, 1);
 		addFlag("debug", "Print debug output.");
 
 		//changelog
+		changeLog(2026, 10, 18, "Added fingerprint mode and 'in2', 'fingerprint_dir' and 'threads' parameters.");
 		changeLog(2023, 12, 22, "Added 'roi_hg38_wes_wgs' flag.");
 		changeLog(2022,  7,  7, "Changed BAM mode: max_snps is now 5000 by default because this results in a better separation of related and unrelated samples.");
 		changeLog(2022,  6, 30, "Changed GSvar mode: MODIFIER impact variants are now ingnored to make scores more similar between exomes and genomes.");
@@ -60,25 +233,43 @@ public:
 		{
 			in = Helper::loadTextFile(in[0], true, '#', true);
 		}
+		QStringList in2 = getInfileList("in2");
+		if (in2.count()==1)
+		{
+			in2 = Helper::loadTextFile(in2[0], true, '#', true);
+		}
 		QSharedPointer<QFile> outfile = Helper::openFileForWriting(getOutfile("out"), true);
 		QTextStream out(outfile.data());
 		QString mode = getEnum("mode");
-		int min_cov = getInt("min_cov");
-		int max_snps = getInt("max_snps");
 		QString roi = getInfile("roi");
 		bool roi_hg38_wes_wgs = getFlag("roi_hg38_wes_wgs");
-		bool include_gonosomes = getFlag("include_gonosomes");
 		GenomeBuild build = stringToBuild(getEnum("build"));
+		int threads = getInt("threads");
+		if (threads<1) THROW(CommandLineParsingException, "Number of threads has to be at least 1!");
 		bool debug = getFlag("debug");
 		QTime timer;
 		timer.start();
 
+		LoadSettings settings;
+		settings.mode = mode;
+		settings.include_gonosomes = getFlag("include_gonosomes");
+		settings.min_cov = getInt("min_cov");
+		settings.max_snps = getInt("max_snps");
+		settings.ref = getInfile("ref");
+		settings.include_single_end_reads = getFlag("include_single_end_reads");
+		settings.panel_id = 0;
+		settings.fingerprint_dir = getString("fingerprint_dir");
+		if (!settings.fingerprint_dir.isEmpty() && !QDir().mkpath(settings.fingerprint_dir))
+		{
+			THROW(FileAccessException, "Could not create fingerprint folder " + settings.fingerprint_dir);
+		}
+
 		//write header
 		if (mode=="vcf" || mode=="gsvar")
 		{
 			out << "#file1\tfile2\toverlap_percent\tcorrelation\tibs2_percent\tcount1\tcount2\tcomments" << endl;
 		}
-		else if (mode=="bam")
+		else if (mode=="bam" || mode=="fingerprint")
 		{
 			out << "#file1\tfile2\tvariant_count\tcorrelation\tibs0_percent\tibs2_percent\tcomments" << endl;
 		}
@@ -90,75 +281,94 @@ public:
 		//load ROI
 		if (!roi.isEmpty() && roi_hg38_wes_wgs) THROW(ArgumentException, "Parameters 'roi' and 'roi_hg38_wes_wgs' are mutually exclusive!");
 		if (roi_hg38_wes_wgs && build==GenomeBuild::HG19) THROW(ArgumentException, "Parameters 'build hg19' and 'roi_hg38_wes_wgs' are mutually exclusive!");
-		BedFile roi_reg;
-		if (!roi.isEmpty()) roi_reg.load(roi);
-		if (roi_hg38_wes_wgs) roi_reg.load(":/Resources/hg38_coding_highconf_all_kits.bed");
+		if (!roi.isEmpty()) settings.roi.load(roi);
+		if (roi_hg38_wes_wgs) settings.roi.load(":/Resources/hg38_coding_highconf_all_kits.bed");
 		if (debug)
 		{
 			out << "##loaded target region (took: " << Helper::elapsedTime(timer, true) << ")" << endl;
 			timer.restart();
 		}
 
-		//load genotype data
-		QList<SampleSimilarity::VariantGenotypes> genotype_data;
+		//load SNP list (once for all samples)
+		if (mode=="bam")
+		{
+			settings.snps = settings.roi.count()>0 ? NGSHelper::getKnownVariants(build, true, settings.roi, 0.2, 0.8) : NGSHelper::getKnownVariants(build, true, 0.2, 0.8);
+		}
+		else if (mode=="fingerprint")
+		{
+			settings.snps = GenotypeFingerprint::panel(build, settings.include_gonosomes, settings.roi);
+			settings.panel_id = GenotypeFingerprint::panelId(settings.snps);
+		}
 
-		foreach(QString filename, in)
+		//load genotype data (missing files are skipped)
+		QList<SampleData> samples;
+		QList<SampleData> samples2;
+		for (int l=0; l<2; ++l)
 		{
-			if (!QFile::exists(filename))
-			{
-				out << "##skipped missing file " << filename << endl;
-				continue;
-			}
-			if (mode=="vcf")
+			foreach(QString filename, l==0 ? in : in2)
 			{
-				genotype_data << (roi_reg.count()>0 ? SampleSimilarity::genotypesFromVcf(filename, include_gonosomes, true, roi_reg) : SampleSimilarity::genotypesFromVcf(filename, include_gonosomes, true));
-			}
-			else if(mode=="gsvar")
-			{
-				genotype_data << (roi_reg.count()>0 ? SampleSimilarity::genotypesFromGSvar(filename, include_gonosomes, roi_reg) : SampleSimilarity::genotypesFromGSvar(filename, include_gonosomes));
-			}
-			else
-			{
-				genotype_data << (roi_reg.count()>0 ? SampleSimilarity::genotypesFromBam(build, filename, min_cov, max_snps, include_gonosomes, roi_reg, getInfile("ref"), getFlag("include_single_end_reads"))
-													: SampleSimilarity::genotypesFromBam(build, filename, min_cov, max_snps, include_gonosomes, getInfile("ref"), getFlag("include_single_end_reads")));
+				if (!QFile::exists(filename))
+				{
+					out << "##skipped missing file " << filename << endl;
+					continue;
+				}
+				SampleData sample;
+				sample.filename = filename;
+				(l==0 ? samples : samples2) << sample;
 			}
-			if (debug)
+		}
+		QThreadPool thread_pool;
+		thread_pool.setMaxThreadCount(threads);
+		for (int l=0; l<2; ++l)
+		{
+			QList<SampleData>& list = (l==0 ? samples : samples2);
+			for (int i=0; i<list.count(); ++i)
 			{
-				out << "##loaded input file " << filename << " (took: " << Helper::elapsedTime(timer, true) << ")" << endl;
-				timer.restart();
+				thread_pool.start(new SampleLoader(list[i], settings));
 			}
 		}
+		thread_pool.waitForDone();
+		foreach(const SampleData& sample, samples + samples2)
+		{
+			if (!sample.error.isEmpty()) THROW(Exception, "Could not load genotypes from " + sample.filename + ": " + sample.error);
+		}
+		if (debug)
+		{
+			out << "##loaded " << (samples.count() + samples2.count()) << " input files (took: " << Helper::elapsedTime(timer, true) << ")" << endl;
+			timer.restart();
+		}
 
-		//process
-		for (int i=0; i<in.count(); ++i)
+		//process (in batches of samples to write the output in input order with bounded memory)
+		const int batch_size = 10 * threads;
+		for (int batch_start=0; batch_start<samples.count(); batch_start+=batch_size)
 		{
-			for (int j=i+1; j<in.count(); ++j)
+			const int batch_end = std::min(samples.count(), batch_start + batch_size);
+			QList<QStringList> lines;
+			for (int i=batch_start; i<batch_end; ++i)
+			{
+				lines << QStringList();
+			}
+			for (int i=batch_start; i<batch_end; ++i)
 			{
-				SampleSimilarity sc;
-				QStringList cols;
-				cols << QFileInfo(in[i]).fileName();
-				cols << QFileInfo(in[j]).fileName();
-				if (mode=="vcf" || mode=="gsvar")
+				QList<const SampleData*> others;
+				if (in2.isEmpty())
 				{
-					sc.calculateSimilarity(genotype_data[i], genotype_data[j]);
-
-					cols << QString::number(sc.olPerc(), 'f', 2);
-					cols << QString::number(sc.sampleCorrelation(), 'f', 4);
-					cols << QString::number(sc.ibs2Perc(), 'f', 2);
-					cols << QString::number(sc.noVariants1());
-					cols << QString::number(sc.noVariants2());
+					for (int j=i+1; j<samples.count(); ++j) others << &samples.at(j);
 				}
 				else
 				{
-					sc.calculateSimilarity(genotype_data[i], genotype_data[j]);
+					for (int j=0; j<samples2.count(); ++j) others << &samples2.at(j);
+				}
+				thread_pool.start(new SampleComparer(mode, samples.at(i), others, lines[i-batch_start]));
+			}
+			thread_pool.waitForDone();
 
-					cols << QString::number(sc.olCount());
-					cols << QString::number(sc.sampleCorrelation(), 'f', 4);
-					cols << QString::number(sc.ibs0Perc(), 'f', 2);
-					cols << QString::number(sc.ibs2Perc(), 'f', 2);
+			foreach(const QStringList& sample_lines, lines)
+			{
+				foreach(const QString& line, sample_lines)
+				{
+					out << line << endl;
 				}
-				cols << sc.messages().join(", ");
-				out << cols.join("\t") << endl;
 			}
 		}
 		if (debug)
@@ -1,15 +1,16 @@
 #include "AnalysisWorker.h"
 #include "cmath"
+#include <cstring>
 #include "NGSHelper.h"
 #include "BasicStatistics.h"
+#include "MatchKernels.h"
 
-AnalysisWorker::AnalysisWorker(AnalysisJob& job, TrimmingParameters& params, TrimmingStatistics& stats, ErrorCorrectionStatistics& ecstats)
+AnalysisWorker::AnalysisWorker(AnalysisJob& job, TrimmingParameters& params, AnalysisStatistics& stats)
 	: QObject()
 	, QRunnable()
 	, job_(job)
 	, params_(params)
 	, stats_(stats)
-	, ecstats_(ecstats)
 {
 	//QTextStream(stdout) << "AnalysisWorker" << endl;
 }
@@ -23,12 +24,17 @@ void AnalysisWorker::correctErrors(int r, QTextStream& debug_out)
 {
 	int mm_count = 0;
 	const int count = std::min(job_.r1[r].bases.count(), job_.r2[r].bases.count());
+
+	//reverse complement of read 2, i.e. position i of read 1 corresponds to position i of this sequence
+	QByteArray r2_rc = MatchKernels::reverseComplement(job_.r2[r].bases.left(count));
+	if (memcmp(job_.r1[r].bases.constData(), r2_rc.constData(), count)==0) return;
+
 	for (int i=0; i<count; ++i)
 	{
 		const int i2 = count-i-1;
 
 		//error detected
-		if (job_.r1[r].bases[i]!=Sequence::complement(job_.r2[r].bases[i2]))
+		if (job_.r1[r].bases[i]!=r2_rc[i])
 		{
 			++mm_count;
 			int q1 = job_.r1[r].quality(i, params_.qoff);
@@ -57,7 +63,7 @@ void AnalysisWorker::correctErrors(int r, QTextStream& debug_out)
 				}
 				job_.r2[r].bases[i2] = replacement;
 				job_.r2[r].qualities[i2] = job_.r1[r].qualities[i];
-				++ecstats_.mismatch_r2[i2];
+				++stats_.ec.mismatch_r2[i2];
 			}
 			else if(q1<q2)
 			{
@@ -68,14 +74,14 @@ void AnalysisWorker::correctErrors(int r, QTextStream& debug_out)
 				}
 				job_.r1[r].bases[i] = replacement;
 				job_.r1[r].qualities[i] = job_.r2[r].qualities[i2];
-				++ecstats_.mismatch_r1[i];
+				++stats_.ec.mismatch_r1[i];
 			}
 		}
 	}
 
 	if (mm_count>0)
 	{
-		++ecstats_.errors_per_read[mm_count];
+		++stats_.ec.errors_per_read[mm_count];
 	}
 }
 
@@ -89,13 +95,11 @@ void AnalysisWorker::run()
 		//update raw data statistics (before trimming)
 		if (!params_.qc.isEmpty())
 		{
-			stats_.qc_mutex.lock();
 			for (int r=0; r<job_.read_count; ++r)
 			{
 				stats_.qc.update(job_.r1[r], StatisticsReads::FORWARD);
 				stats_.qc.update(job_.r2[r], StatisticsReads::REVERSE);
 			}
-			stats_.qc_mutex.unlock();
 		}
 
 		for (int r=0; r<job_.read_count; ++r)
@@ -125,7 +129,7 @@ void AnalysisWorker::run()
 
 			//make sure the sequences have the same length
 			Sequence seq1 = job_.r1[r].bases;
-			Sequence seq2 = job_.r2[r].bases.toReverseComplement();
+			Sequence seq2 = MatchKernels::reverseComplement(job_.r2[r].bases);
 			job_.length_r1_orig[r] = seq1.count();
 			job_.length_r2_orig[r] = seq2.count();
 			int min_length = std::min(job_.length_r1_orig[r], job_.length_r2_orig[r]);
@@ -149,27 +153,9 @@ void AnalysisWorker::run()
 				//              the base comparisons we would actually have to make.
 				int max_mismatches = (int)(std::ceil((1.0-params_.match_perc/100.0) * (min_length-offset)));
 
-				int matches = 0;
-				int mismatches = 0;
-				int invalid = 0;
-				for (int j=offset; j<min_length; ++j)
-				{
-					char b1 = seq1_data[j-offset];
-					char b2 = seq2_data[j];
-					if (b1=='N' || b2=='N')
-					{
-						++invalid;
-					}
-					else if (b1==b2)
-					{
-						++matches;
-					}
-					else
-					{
-						++mismatches;
-						if (mismatches>max_mismatches) break;
-					}
-				}
+				MatchKernels::Counts counts = MatchKernels::compare(seq1_data, seq2_data+offset, min_length-offset, max_mismatches);
+				int matches = counts.matches;
+				int mismatches = counts.mismatches;
 				//debug_out << offset << matches << mismatches << (100.0*matches/(matches + mismatches)) << endl;
 
 				if ((matches + mismatches)==0 || 100.0*matches/(matches + mismatches) < params_.match_perc) continue;
@@ -186,52 +172,14 @@ void AnalysisWorker::run()
 
 				//check that at least on one side the adapter is present - if not continue
 				QByteArray adapter1 = seq1.mid(job_.length_r2_orig[r]-offset, params_.adapter_overlap);
-				int a1_matches = 0;
-				int a1_mismatches = 0;
-				int a1_invalid = 0;
-				for (int i=0; i<adapter1.count(); ++i)
-				{
-					//forward
-					char b1 = adapter1.constData()[i];
-					char b2 = params_.a1.constData()[i];
+				MatchKernels::Counts a1_counts = MatchKernels::compare(adapter1.constData(), params_.a1.constData(), adapter1.count());
+				int a1_matches = a1_counts.matches;
+				int a1_mismatches = a1_counts.mismatches;
 
-					if (b1=='N' || b2=='N')
-					{
-						++a1_invalid;
-					}
-					else if (b1==b2)
-					{
-						++a1_matches;
-					}
-					else
-					{
-						++a1_mismatches;
-					}
-				}
-
-				QByteArray adapter2 = seq2.left(offset).toReverseComplement().left(params_.adapter_overlap);
-				int a2_matches = 0;
-				int a2_mismatches = 0;
-				int a2_invalid = 0;
-				for (int i=0; i<adapter2.count(); ++i)
-				{
-					//forward
-					char b1 = adapter2.constData()[i];
-					char b2 = params_.a2.constData()[i];
-
-					if (b1=='N' || b2=='N')
-					{
-						++a2_invalid;
-					}
-					else if (b1==b2)
-					{
-						++a2_matches;
-					}
-					else
-					{
-						++a2_mismatches;
-					}
-				}
+				QByteArray adapter2 = MatchKernels::reverseComplement(seq2.left(offset)).left(params_.adapter_overlap);
+				MatchKernels::Counts a2_counts = MatchKernels::compare(adapter2.constData(), params_.a2.constData(), adapter2.count());
+				int a2_matches = a2_counts.matches;
+				int a2_mismatches = a2_counts.mismatches;
 
 				if (offset<10) //when the adapter fragment is short => check only number of mismatches
 				{
@@ -287,7 +235,7 @@ void AnalysisWorker::run()
 				{
 					stats_.acons1[i].inc(adapter1.at(i));
 				}
-				QByteArray adapter2 = seq2.left(best_offset).toReverseComplement();
+				QByteArray adapter2 = MatchKernels::reverseComplement(seq2.left(best_offset));
 				if (adapter2.count()>40) adapter2.resize(40);
 				for (int i=0; i<adapter2.count(); ++i)
 				{
@@ -313,30 +261,10 @@ void AnalysisWorker::run()
 				const char* a1_data = params_.a1.constData();
 				for (int offset=0; offset<job_.length_r1_orig[r]; ++offset)
 				{
-					int matches = 0;
-					int mismatches = 0;
-					int invalid = 0;
-					for (int i=0; i<params_.a_size; ++i)
-					{
-						if (offset+i>=job_.length_r1_orig[r]) break;
-
-						//forward
-						char b1 = seq1_data[offset+i];
-						char b2 = a1_data[i];
-
-						if (b1=='N' || b2=='N')
-						{
-							++invalid;
-						}
-						else if (b1==b2)
-						{
-							++matches;
-						}
-						else
-						{
-							++mismatches;
-						}
-					}
+					MatchKernels::Counts counts = MatchKernels::compare(seq1_data+offset, a1_data, std::min(params_.a_size, job_.length_r1_orig[r]-offset));
+					int matches = counts.matches;
+					int mismatches = counts.mismatches;
+					int invalid = counts.invalid;
 					if (100.0*matches/(matches+mismatches) < params_.match_perc) continue;
 					double p = BasicStatistics::matchProbability(0.25, matches, matches+mismatches);
 					if (p>params_.mep) continue;
@@ -364,30 +292,10 @@ void AnalysisWorker::run()
 				const char* a2_data = params_.a2.constData();
 				for (int offset=0; offset<job_.length_r2_orig[r]; ++offset)
 				{
-					int matches = 0;
-					int mismatches = 0;
-					int invalid = 0;
-					for (int i=0; i<params_.a_size; ++i)
-					{
-						if (offset+i>=job_.length_r2_orig[r]) break;
-
-						//forward
-						char b1 = seq2_data[offset+i];
-						char b2 = a2_data[i];
-
-						if (b1=='N' || b2=='N')
-						{
-							++invalid;
-						}
-						else if (b1==b2)
-						{
-							++matches;
-						}
-						else
-						{
-							++mismatches;
-						}
-					}
+					MatchKernels::Counts counts = MatchKernels::compare(seq2_data+offset, a2_data, std::min(params_.a_size, job_.length_r2_orig[r]-offset));
+					int matches = counts.matches;
+					int mismatches = counts.mismatches;
+					int invalid = counts.invalid;
 
 					if (100.0*matches/(matches+mismatches) < params_.match_perc) continue;
 					double p = BasicStatistics::matchProbability(0.25, matches, matches+mismatches);
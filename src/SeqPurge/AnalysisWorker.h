@@ -13,7 +13,7 @@ class AnalysisWorker
 	Q_OBJECT
 
 public:
-	AnalysisWorker(AnalysisJob& job, TrimmingParameters& params, TrimmingStatistics& stats, ErrorCorrectionStatistics& ecstats);
+	AnalysisWorker(AnalysisJob& job, TrimmingParameters& params, AnalysisStatistics& stats);
 	virtual ~AnalysisWorker();
 	virtual void run() override;
 
@@ -24,8 +24,7 @@ signals:
 private:
 	AnalysisJob& job_;
 	const TrimmingParameters& params_;
-	TrimmingStatistics& stats_;
-	ErrorCorrectionStatistics& ecstats_;
+	AnalysisStatistics& stats_;
 
 	///Error correction
 	void correctErrors(int r, QTextStream& debug_out);
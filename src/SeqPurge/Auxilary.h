@@ -129,6 +129,7 @@ struct TrimmingParameters
 	bool ec;
 	bool debug;
 	int compression_level;
+	int compression_threads;
 	QString qc;
 };
 
@@ -161,7 +162,6 @@ struct TrimmingStatistics
 	double reads_removed;
 	double bases_perc_trim_sum;
 	StatisticsReads qc;
-	QMutex qc_mutex;
 
 	void writeStatistics(QTextStream& out, const TrimmingParameters& params_)
 	{
@@ -235,6 +235,16 @@ struct ErrorCorrectionStatistics
 	QVector<long> mismatch_r2;
 	QVector<long> errors_per_read;
 
+	void merge(const ErrorCorrectionStatistics& rhs)
+	{
+		for (int i=0; i<MAXLEN; ++i)
+		{
+			mismatch_r1[i] += rhs.mismatch_r1[i];
+			mismatch_r2[i] += rhs.mismatch_r2[i];
+			errors_per_read[i] += rhs.errors_per_read[i];
+		}
+	}
+
 	void writeStatistics(QTextStream& out)
 	{
 		//print read error per cycle (read 1)
@@ -270,5 +280,33 @@ struct ErrorCorrectionStatistics
 
 };
 
+///Statistics datastructure of one analysis job slot. A job slot is analyzed by one thread at a time, so no locking is needed. The data of all slots is merged at the end.
+struct AnalysisStatistics
+{
+	AnalysisStatistics()
+		: acons1(40)
+		, acons2(40)
+		, qc()
+		, ec()
+	{
+	}
+
+	QVector<Pileup> acons1;
+	QVector<Pileup> acons2;
+	StatisticsReads qc;
+	ErrorCorrectionStatistics ec;
+
+	void mergeInto(TrimmingStatistics& stats, ErrorCorrectionStatistics& ec_stats) const
+	{
+		for (int i=0; i<acons1.count(); ++i)
+		{
+			stats.acons1[i].add(acons1[i]);
+			stats.acons2[i].add(acons2[i]);
+		}
+		stats.qc.merge(qc);
+		ec_stats.merge(ec);
+	}
+};
+
 #endif // AUXILARY_H
 
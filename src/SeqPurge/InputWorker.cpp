@@ -38,8 +38,8 @@ void InputWorker::run()
 				else
 				{
 					//QTextStream(stdout) << "InputWorker::run new file pair with index " << streams_.current_index << endl;
-					streams_.istream1.reset(new FastqFileStream(params_.files_in1[streams_.current_index], false));
-					streams_.istream2.reset(new FastqFileStream(params_.files_in2[streams_.current_index], false));
+					streams_.istream1.reset(new FastqFileStream(params_.files_in1[streams_.current_index], false, false, params_.compression_threads));
+					streams_.istream2.reset(new FastqFileStream(params_.files_in2[streams_.current_index], false, false, params_.compression_threads));
 				}
 			}
 			else if (streams_.istream1->atEnd()) //read number different > error
@@ -3,6 +3,7 @@
 #include "OutputWorker.h"
 #include "AnalysisWorker.h"
 #include "Helper.h"
+#include "MatchKernels.h"
 
 ThreadCoordinator::ThreadCoordinator(QObject* parent, TrimmingParameters params)
 	: QObject(parent)
@@ -14,23 +15,25 @@ ThreadCoordinator::ThreadCoordinator(QObject* parent, TrimmingParameters params)
 	, thread_pool_write_()
 	, params_(params)
 	, stats_()
+	, ec_stats_()
+	, analysis_stats_(params.block_prefetch)
 {
 	timer_overall_.start();
 
 	//open input streams
-	streams_in_.istream1.reset(new FastqFileStream(params.files_in1[0], false));
-	streams_in_.istream2.reset(new FastqFileStream(params.files_in2[0], false));
+	streams_in_.istream1.reset(new FastqFileStream(params.files_in1[0], false, false, params.compression_threads));
+	streams_in_.istream2.reset(new FastqFileStream(params.files_in2[0], false, false, params.compression_threads));
 
 	//open output streams
 	streams_out_.summary_file = Helper::openFileForWriting(params.summary, true);
 	streams_out_.summary_stream.reset(new QTextStream(streams_out_.summary_file.data()));
-	streams_out_.ostream1.reset(new FastqOutfileStream(params.out1, params.compression_level));
-	streams_out_.ostream2.reset(new FastqOutfileStream(params.out2, params.compression_level));
+	streams_out_.ostream1.reset(new FastqOutfileStream(params.out1, params.compression_level, params.compression_threads));
+	streams_out_.ostream2.reset(new FastqOutfileStream(params.out2, params.compression_level, params.compression_threads));
 	QString out3_base = params.out3;
 	if (!out3_base.isEmpty())
 	{
-		streams_out_.ostream3.reset(new FastqOutfileStream(out3_base + "_R1.fastq.gz", params.compression_level));
-		streams_out_.ostream4.reset(new FastqOutfileStream(out3_base + "_R2.fastq.gz", params.compression_level));
+		streams_out_.ostream3.reset(new FastqOutfileStream(out3_base + "_R1.fastq.gz", params.compression_level, params.compression_threads));
+		streams_out_.ostream4.reset(new FastqOutfileStream(out3_base + "_R2.fastq.gz", params.compression_level, params.compression_threads));
 	}
 
 	streams_out_.ostream1_thread.setMaxThreadCount(1);
@@ -93,7 +96,7 @@ void ThreadCoordinator::load(int i)
 
 void ThreadCoordinator::analyze(int i)
 {
-	AnalysisWorker* worker = new AnalysisWorker(job_pool_[i], params_, stats_, ec_stats_);
+	AnalysisWorker* worker = new AnalysisWorker(job_pool_[i], params_, analysis_stats_[i]);
 	connect(worker, SIGNAL(done(int)), this, SLOT(write(int)));
 	connect(worker, SIGNAL(error(int,QString)), this, SLOT(error(int,QString)));
 	thread_pool_analyze_.start(worker);
@@ -137,6 +140,12 @@ void ThreadCoordinator::checkDone()
 	//done > stop timer to prevent it from fireing again
 	timer_done_.stop();
 
+	//merge statistics of analysis job slots
+	foreach(const AnalysisStatistics& job_stats, analysis_stats_)
+	{
+		job_stats.mergeInto(stats_, ec_stats_);
+	}
+
 	//print trimming statistics
 	(*streams_out_.summary_stream) << Helper::dateTime() << " writing statistics summary" << endl;
 	stats_.writeStatistics((*streams_out_.summary_stream), params_);
@@ -155,6 +164,8 @@ void ThreadCoordinator::checkDone()
 	}
 
 	(*streams_out_.summary_stream) << Helper::dateTime() << " overall runtime: " << Helper::elapsedTime(timer_overall_) << endl;
+	double seconds = std::max(1, timer_overall_.elapsed()) / 1000.0;
+	(*streams_out_.summary_stream) << Helper::dateTime() << " read pairs per second: " << QString::number(stats_.read_num / 2 / seconds, 'f', 0) << " (matching kernels: " << MatchKernels::implementation() << ")" << endl;
 
 	emit finished();
 }
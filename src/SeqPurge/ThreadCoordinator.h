@@ -48,6 +48,7 @@ private:
 	TrimmingParameters params_;
 	TrimmingStatistics stats_;
 	ErrorCorrectionStatistics ec_stats_;
+	QVector<AnalysisStatistics> analysis_stats_; //one per analysis job slot
 
 	QTime timer_overall_;
 	QTimer timer_progress_;
@@ -45,8 +45,12 @@ public:
 		addFlag("debug", "Enables debug output (use only with one thread).");
 		addInt("progress", "Enables progress output at the given interval in milliseconds (disabled by default).", true, -1);
 		addInt("compression_level", "Output FASTQ compression level from 1 (fastest) to 9 (best compression).", true, Z_BEST_SPEED);
+		addInt("compression_threads", "Number of threads used per FASTQ file for BGZF compression/decompression (plain gzip input is always decompressed with one thread).", true, 1);
 
 		//changelog
+		changeLog(2026, 10, 18, "Added 'compression_threads' parameter for multi-threaded (de)compression of BGZF-compressed FASTQ files. Output files are BGZF-compressed now.");
+		changeLog(2026, 10, 18, "Improved scaling with many threads when 'qc' is set.");
+		changeLog(2026, 10, 18, "Added vectorized adapter and insert matching (SSE4.2/AVX2).");
 		changeLog(2022, 7, 15, "Improved scaling with more than 4 threads and CPU usage.");
 		changeLog(2019, 3, 26, "Added 'compression_level' parameter.");
 		changeLog(2019, 2, 11, "Added writer thread to make SeqPurge scale better when using many threads.");
@@ -91,6 +95,7 @@ public:
 		params.ec = getFlag("ec");
 		params.debug = getFlag("debug");
 		params.compression_level = getInt("compression_level");
+		params.compression_threads = getInt("compression_threads");
 
 		//init pre-calculation of factorials
 		BasicStatistics::precalculateFactorials();
@@ -64,6 +64,7 @@ public:
 		if(mode=="vcf")
 		{
 			VcfFile variants;
+			variants.setLazyDecoding(true); //sample columns are not needed for filtering
 			if (mark!="")
 			{
                 variants.load(getInfile("in"), true);
@@ -3,6 +3,7 @@
 
 #include "Transcript.h"
 #include "VariantHgvsAnnotator.h"
+#include <QSharedPointer>
 
 
 //Tool parameters
@@ -37,11 +38,13 @@ struct MetaData
 	const QString reference;
 	const TranscriptList transcripts;
 	VariantHgvsAnnotator::Parameters annotation_parameters;
+	QSharedPointer<TranscriptSequenceCache> sequence_cache; //shared by all worker threads
 
 	MetaData(const QByteArray tag, const QString reference, TranscriptList transcripts)
 		: tag(tag)
 		, reference(reference)
 		, transcripts(transcripts)
+		, sequence_cache(new TranscriptSequenceCache())
 	{
 	}
 };
@@ -16,7 +16,7 @@ ChunkProcessor::ChunkProcessor(AnalysisJob &job, const MetaData& settings, const
 	, settings_(settings)
 	, params_(params)
 	, reference_(settings.reference)
-	, hgvs_anno_(reference_, settings_.annotation_parameters)
+	, hgvs_anno_(reference_, settings_.annotation_parameters, settings_.sequence_cache.data())
 {
 	if (params_.debug) QTextStream(stdout) << "ChunkProcessor(): " << job_.index << endl;
 }
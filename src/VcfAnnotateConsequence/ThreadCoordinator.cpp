@@ -124,6 +124,8 @@ void ThreadCoordinator::checkDone()
 	stream << "Annotation done" << endl;
 	stream << "Annotated " << QString::number(c_annotated_) << " variants." << endl;
 	stream << "Skipped " << QString::number(c_skipped_) << " invalid variants." << endl;
+	const TranscriptSequenceCache& cache = *meta_.sequence_cache;
+	stream << "Transcript sequence cache: " << QString::number(cache.hits()) << " hits, " << QString::number(cache.misses()) << " misses (" << QString::number(cache.hitPercentage(), 'f', 2) << "% hit rate)" << endl;
 	stream << "Annotation took: " << Helper::elapsedTime(timer_annotation_) << endl;
 
 	emit finished();
@@ -28,7 +28,7 @@ public:
 		setDescription("Adds transcript-specific consequence predictions to a VCF file.");
 		setExtendedDescription(extendedDescription());
 		addInfile("in", "Input VCF file to annotate.", false);
-		addInfile("gff", "Ensembl-style GFF file with transcripts, e.g. from https://ftp.ensembl.org/pub/release-112/gff3/homo_sapiens/Homo_sapiens.GRCh38.112.gff3.gz.", false);
+		addInfile("gff", "Ensembl-style GFF file with transcripts, e.g. from https://ftp.ensembl.org/pub/release-112/gff3/homo_sapiens/Homo_sapiens.GRCh38.112.gff3.gz. A binary transcript database created with GffToTranscriptDb can be used instead.", false);
 
 		//optional
 		addInfile("ref", "Reference genome FASTA file. If unset 'reference_genome' from the 'settings.ini' file is used.", true, false);
@@ -46,6 +46,7 @@ public:
 		addEnum("source", "GFF source.", true, QStringList() << "ensembl" << "refseq", "ensembl");
 		addFlag("debug", "Enable debug output");
 
+		changeLog(2026, 10, 18, "Added support for binary transcript databases created with GffToTranscriptDb (gff parameter).");
 		changeLog(2024, 7, 26, "Added support for RefSeq GFF format (source parameter).");
 		changeLog(2022, 7,  7, "Change to event-driven multithreaded implementation.");
 	}
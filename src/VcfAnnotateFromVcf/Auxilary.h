@@ -5,6 +5,8 @@
 #include <QString>
 #include <QVector>
 #include <QSet>
+#include "Tokenizer.h"
+#include "TabixIndexedFile.h"
 
 //Tool parameters
 struct Parameters
@@ -14,6 +16,7 @@ struct Parameters
 	int prefetch;
 	int threads;
 	int block_size;
+	bool sorted;
 	bool debug;
 };
 
@@ -36,6 +39,7 @@ struct MetaData
 {
 	QVector<QByteArrayList> info_id_list;
 	QVector<QByteArrayList> out_info_id_list;
+	QVector<InfoKeyLookup> info_id_lookup; //lookup table for INFO keys (created from 'info_id_list')
 	QByteArrayList out_id_column_name_list;
 	QByteArrayList annotation_file_list;
 	QByteArrayList id_column_name_list;
@@ -44,6 +48,7 @@ struct MetaData
 	QVector<bool> allow_missing_header_list;
 	QSet<QByteArray> unique_output_ids;
 	QByteArrayList prefix_list;
+	QVector<TabixIndexedFile> annotation_files; //loaded once - each chunk uses copies that share the index, but have their own file handle
 };
 
 #endif // AUXILARY_H
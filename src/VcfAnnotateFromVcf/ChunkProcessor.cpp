@@ -1,8 +1,11 @@
 #include "ChunkProcessor.h"
 #include "VcfFile.h"
 #include "TabixIndexedFile.h"
+#include "Tokenizer.h"
 #include <zlib.h>
 #include <QFileInfo>
+#include <QSharedPointer>
+#include <algorithm>
 
 ChunkProcessor::ChunkProcessor(AnalysisJob& job, const MetaData& meta, Parameters& params)
 	: QObject()
@@ -199,141 +202,179 @@ QByteArrayList getVcfHeaderLines(const QByteArray &vcf_file_path, QByteArrayList
 	return info_header_lines;
 }
 
+//reusable buffers for the annotation of lines (to avoid allocations per line)
+struct LineBuffers
+{
+	VcfColumnTokenizer input;
+	VcfColumnTokenizer match;
+	QByteArray chr_str;
+	Chromosome chr;
+	QVector<ByteView> values; //INFO value per requested key of the current match
+	QVector<char> states; //state per requested key of the current match: 0=not found, 1=flag, 2=value
+	QVector<QByteArray> joined_values; //'&'-joined INFO values per requested key of all matches
+	QVector<int> key_order; //order in which requested keys were found in the matches
+};
+
 //extends a given vcf line by a key-value-pair of the given annotation vcf
-QByteArray extendVcfDataLine(const QByteArray& vcf_line, const MetaData& meta, const QVector<int>& id_column_indices, const QVector<TabixIndexedFile>& annotation_files)
+//if cursors are given (sorted mode), they are used instead of index queries
+QByteArray extendVcfDataLine(const QByteArray& vcf_line, const MetaData& meta, const QVector<int>& id_column_indices, const QVector<TabixIndexedFile>& annotation_files, const QVector<QSharedPointer<TabixIndexedFileCursor>>& cursors, LineBuffers& buffers)
 {
-	int extended_lines_ = 0;
-
-    //split line and extract variant infos
-    QList<QByteArray> vcf_column = vcf_line.trimmed().split('\t');
-	if (vcf_column.count()<VcfFile::MIN_COLS) THROW(FileParseException, "VCF line with too few columns in input file: " + vcf_line);
-
-    // parse position
-    Chromosome chr = vcf_column[VcfFile::CHROM];
-    bool ok = false;
-    int start = vcf_column[VcfFile::POS].toInt(&ok);
-	if (!ok) THROW(FileParseException, "Could not convert VCF variant position '" + vcf_column[VcfFile::POS] + "' to integer in line: " + vcf_line);
-    int end = start + vcf_column[VcfFile::REF].length() - 1; //length of ref
-
-    // parse sequences
-    QByteArray ref = vcf_column[VcfFile::REF];
-    QByteArray obs = vcf_column[VcfFile::ALT];
-
-    QByteArrayList additional_annotation;
-    // iterate over all annotation files
-    for (int ann_file_idx = 0; ann_file_idx < annotation_files.size(); ann_file_idx++)
-    {
-        // get all matching variants for this annotaion file
-		QByteArrayList matches = annotation_files[ann_file_idx].getMatchingLines(chr, start, end, true);
-
-        // collect the key-value pairs for all matches to prevent key duplications
-        QByteArrayList additional_keys;
-        QByteArrayList additional_values;
-        QByteArrayList additional_ids;
-        foreach(const QByteArray& match, matches)
-        {
-
-            // parse vcf line
-            QByteArrayList parts = match.trimmed().split('\t');
-			if (parts.count()<VcfFile::MIN_COLS) THROW(FileParseException, "VCF line with too few columns in annotation file: " + match);
-
-            // check if same variant
-            if (parts[VcfFile::REF] != ref || parts[VcfFile::ALT] != obs) continue;
-            bool ok;
-            int pos = parts[VcfFile::POS].toInt(&ok);
-			if (!ok) THROW(FileParseException, "Could not convert VCF variant position '" + parts[VcfFile::POS] + "' to integer in annotation file line: " + match);
-            if (pos != start) continue;
-
-			// add info key if existence only
+	//tokenize line and extract variant infos
+	const VcfColumnTokenizer& input = buffers.input;
+	if (buffers.input.tokenize(vcf_line)<VcfFile::MIN_COLS) THROW(FileParseException, "VCF line with too few columns in input file: " + vcf_line);
+
+	//parse position (chromosome is cached because consecutive lines are mostly on the same chromosome)
+	const ByteView& chr_view = input[VcfFile::CHROM];
+	if (buffers.chr_str.size()!=chr_view.size || memcmp(buffers.chr_str.constData(), chr_view.data, chr_view.size)!=0)
+	{
+		buffers.chr_str = chr_view.toByteArray();
+		buffers.chr = Chromosome(buffers.chr_str);
+	}
+	bool ok = false;
+	int start = input[VcfFile::POS].toInt(&ok);
+	if (!ok) THROW(FileParseException, "Could not convert VCF variant position '" + input[VcfFile::POS].toByteArray() + "' to integer in line: " + vcf_line);
+	int end = start + input[VcfFile::REF].size - 1; //length of ref
+
+	//sequences
+	const ByteView& ref = input[VcfFile::REF];
+	const ByteView& obs = input[VcfFile::ALT];
+
+	QByteArrayList additional_annotation;
+	//iterate over all annotation files
+	for (int ann_file_idx = 0; ann_file_idx < annotation_files.size(); ann_file_idx++)
+	{
+		//get all matching variants for this annotaion file
+		QByteArrayList matches = cursors.isEmpty() ? annotation_files[ann_file_idx].getMatchingLines(buffers.chr, start, end, true) : cursors[ann_file_idx]->getLinesAt(buffers.chr, start, true);
+		if (matches.isEmpty()) continue;
+
+		//init buffers for the requested keys of this annotation file
+		const InfoKeyLookup& lookup = meta.info_id_lookup[ann_file_idx];
+		const int key_count = lookup.count();
+		if (buffers.values.count()<key_count)
+		{
+			buffers.values.resize(key_count);
+			buffers.states.resize(key_count);
+			buffers.joined_values.resize(key_count);
+		}
+		buffers.key_order.clear();
+
+		//collect the key-value pairs for all matches to prevent key duplications
+		QByteArrayList additional_ids;
+		foreach(const QByteArray& match, matches)
+		{
+			//tokenize vcf line
+			const VcfColumnTokenizer& parts = buffers.match;
+			if (buffers.match.tokenize(match)<VcfFile::MIN_COLS) THROW(FileParseException, "VCF line with too few columns in annotation file: " + match);
+
+			//check if same variant
+			if (parts[VcfFile::REF] != ref || parts[VcfFile::ALT] != obs) continue;
+			int pos = parts[VcfFile::POS].toInt(&ok);
+			if (!ok) THROW(FileParseException, "Could not convert VCF variant position '" + parts[VcfFile::POS].toByteArray() + "' to integer in annotation file line: " + match);
+			if (pos != start) continue;
+
+			//add info key if existence only
 			if (meta.annotate_only_existence[ann_file_idx])
 			{
 				additional_annotation.append(meta.existence_name_list[ann_file_idx]);
+				continue;
 			}
-			else
+
+			//add ID column from annotation file
+			if (id_column_indices[ann_file_idx] > -1)
 			{
-				// add ID column from annotation file
-				if (id_column_indices[ann_file_idx] > -1)
+				additional_ids.append(parts[id_column_indices[ann_file_idx]].trimmed().toByteArray());
+			}
+
+			//parse INFO column in one pass: the first entry with a non-empty value (or flag) is used for each requested key
+			std::fill(buffers.states.begin(), buffers.states.begin() + key_count, 0);
+			const ByteView& info = parts[VcfFile::INFO];
+			int entry_start = 0;
+			while (entry_start<=info.size)
+			{
+				int entry_end = info.indexOf(';', entry_start);
+				if (entry_end==-1) entry_end = info.size;
+				ByteView entry = info.mid(entry_start, entry_end-entry_start);
+				entry_start = entry_end + 1;
+
+				int sep = entry.indexOf('=');
+				ByteView key = (sep==-1 ? entry : entry.mid(0, sep)).trimmed();
+				lookup.forEachMatch(key, [&](int j)
 				{
-					additional_ids.append(parts[id_column_indices[ann_file_idx]].trimmed());
-				}
+					if (buffers.states[j]!=0) return;
 
+					//handle boolean INFO entries (contain only key)
+					if (sep==-1)
+					{
+						buffers.states[j] = 1;
+						return;
+					}
 
-				// parse INFO column
-				QByteArrayList info_column = parts[VcfFile::INFO].split(';');
+					//skip empty values
+					int sep2 = entry.indexOf('=', sep+1);
+					ByteView value = entry.mid(sep+1, sep2==-1 ? -1 : sep2-sep-1).trimmed();
+					if (value.isEmpty()) return;
 
-				//get annotation
-				for (int j = 0; j < meta.info_id_list[ann_file_idx].size(); j++)
+					buffers.states[j] = 2;
+					buffers.values[j] = value;
+				});
+			}
+
+			//get annotation
+			for (int j = 0; j < key_count; j++)
+			{
+				if (buffers.states[j]==1)
+				{
+					additional_annotation.append(meta.out_info_id_list[ann_file_idx][j]);
+				}
+				else if (buffers.states[j]==2)
 				{
-					foreach (QByteArray key_value_pair, info_column)
+					if (!buffers.key_order.contains(j))
 					{
-						QByteArrayList key_value_pair_split = key_value_pair.split('=');
-						if (key_value_pair_split[0].trimmed() == meta.info_id_list[ann_file_idx][j])
-						{
-							// handle boolean INFO entries (contain only key):
-							if (key_value_pair_split.size() == 1)
-							{
-								additional_annotation.append(meta.out_info_id_list[ann_file_idx][j]);
-							}
-							else
-							{
-								QByteArray annotation_value = key_value_pair.split('=')[1].trimmed();
-
-								// skip empty values
-								if (annotation_value == "") continue;
-
-								int key_idx = additional_keys.indexOf(meta.out_info_id_list[ann_file_idx][j]);
-								if (key_idx == -1)
-								{
-									additional_keys.append(meta.out_info_id_list[ann_file_idx][j]);
-									additional_values.append(annotation_value);
-								}
-								else
-								{
-									additional_values[key_idx] += "&" + annotation_value;
-								}
-							}
-							break;
-						}
+						buffers.key_order.append(j);
+						buffers.joined_values[j] = buffers.values[j].toByteArray();
+					}
+					else
+					{
+						buffers.joined_values[j].append('&');
+						buffers.joined_values[j].append(buffers.values[j].data, buffers.values[j].size);
 					}
 				}
 			}
-
 		}
 
-        // transfer the collected values into the INFO column
-        if (additional_ids.size() > 0)
-        {
-			additional_annotation.append(meta.out_id_column_name_list[ann_file_idx] + "=" + additional_ids.join("&"));
-        }
-
-        for (int kv_idx=0; kv_idx<additional_keys.size(); kv_idx++)
-        {
-			additional_annotation.append(additional_keys[kv_idx] + "=" + additional_values[kv_idx]);
-        }
-    }
-
-    if (additional_annotation.size() > 0)
-    {
-
-        // extend info column
-		if (vcf_column[VcfFile::INFO]==".")
+		//transfer the collected values into the INFO column
+		if (additional_ids.size() > 0)
 		{
-			vcf_column[VcfFile::INFO] = additional_annotation.join(';');
+			additional_annotation.append(meta.out_id_column_name_list[ann_file_idx] + "=" + additional_ids.join("&"));
 		}
-		else
+
+		foreach(int j, buffers.key_order)
 		{
-			vcf_column[VcfFile::INFO] += ";" + additional_annotation.join(';');
+			additional_annotation.append(meta.out_info_id_list[ann_file_idx][j] + "=" + buffers.joined_values[j]);
 		}
-        extended_lines_++;
-
-		// concat vcf line:
-        return vcf_column.join('\t') + "\n";
-    }
-    else
-    {
-        // if no annotation found write line without changes
-        return vcf_line;
-    }
+	}
+
+	//if no annotation found write line without changes
+	if (additional_annotation.isEmpty()) return vcf_line;
+
+	//extend info column
+	const ByteView& line = input.line();
+	const ByteView& info = input[VcfFile::INFO];
+	int info_start = info.data - line.data;
+	int info_end = info_start + info.size;
+	QByteArray output;
+	output.reserve(vcf_line.size() + 256);
+	output.append(line.data, info_start);
+	if (info.size!=1 || info.data[0]!='.')
+	{
+		output.append(info.data, info.size);
+		output.append(';');
+	}
+	output.append(additional_annotation.join(';'));
+	output.append(line.data + info_end, line.size - info_end);
+	output.append('\n');
+
+	return output;
 }
 
 
@@ -342,8 +383,13 @@ void ChunkProcessor::run()
 {
 	try
 	{
-		//load annotation indices - they are not thread-safe, so we need to load them in each thread :(
-		QVector<TabixIndexedFile> annotation_files(meta_.annotation_file_list.size());
+		//copy annotation files - the copies share the index, but file handles are not thread-safe, so we need one per thread
+		QVector<TabixIndexedFile> annotation_files;
+		annotation_files.reserve(meta_.annotation_files.size());
+		foreach(const TabixIndexedFile& file, meta_.annotation_files)
+		{
+			annotation_files.append(file);
+		}
 		QVector<int> id_column_indices(meta_.annotation_file_list.size(), -1);
 		QByteArrayList annotation_header_lines;
 		for (int i = 0; i < meta_.annotation_file_list.size(); i++)
@@ -382,11 +428,20 @@ void ChunkProcessor::run()
 
 			// append header lines to global list
 			annotation_header_lines.append(header_lines);
-			// load tab-indexed vcf file
-			annotation_files[i].load(meta_.annotation_file_list[i]);
+		}
+
+		//sorted mode: create forward-only cursors for merge-join
+		QVector<QSharedPointer<TabixIndexedFileCursor>> cursors;
+		if (params_.sorted)
+		{
+			for (int i = 0; i < annotation_files.size(); i++)
+			{
+				cursors << QSharedPointer<TabixIndexedFileCursor>(new TabixIndexedFileCursor(annotation_files[i]));
+			}
 		}
 
 		//process data
+		LineBuffers buffers;
 		QList<QByteArray> lines_new;
 		lines_new.reserve(job_.lines.size());
 		foreach(const QByteArray& line, job_.lines)
@@ -412,11 +467,19 @@ void ChunkProcessor::run()
 			}
 			else //content line
 			{
-				lines_new << extendVcfDataLine(line, meta_, id_column_indices, annotation_files);
+				lines_new << extendVcfDataLine(line, meta_, id_column_indices, annotation_files, cursors, buffers);
 			}
 		}
 		job_.lines = lines_new;
 
+		if (params_.debug)
+		{
+			for (int i = 0; i < cursors.size(); i++)
+			{
+				QTextStream(stdout) << "ChunkProcessor(): " << job_.index << " seeks in " << meta_.annotation_file_list[i] << ": " << cursors[i]->seekCount() << endl;
+			}
+		}
+
 		emit done(job_.index);
 	}
 	catch(Exception& e)
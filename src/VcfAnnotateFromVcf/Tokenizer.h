@@ -0,0 +1,190 @@
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <QByteArray>
+#include <QByteArrayList>
+#include <QVector>
+#include <cstring>
+
+//Non-owning view of a part of a line buffer. The buffer must outlive the view.
+struct ByteView
+{
+	const char* data = nullptr;
+	int size = 0;
+
+	ByteView()
+	{
+	}
+
+	ByteView(const char* d, int s)
+		: data(d)
+		, size(s)
+	{
+	}
+
+	bool isEmpty() const
+	{
+		return size==0;
+	}
+
+	bool operator==(const ByteView& rhs) const
+	{
+		return size==rhs.size && memcmp(data, rhs.data, size)==0;
+	}
+
+	bool operator!=(const ByteView& rhs) const
+	{
+		return !operator==(rhs);
+	}
+
+	//returns the view without leading/trailing whitespaces
+	ByteView trimmed() const
+	{
+		int start = 0;
+		int end = size;
+		while (start<end && isWhitespace(data[start])) ++start;
+		while (end>start && isWhitespace(data[end-1])) --end;
+		return ByteView(data+start, end-start);
+	}
+
+	//returns the index of the first occurance of the given character, or -1 if not found
+	int indexOf(char c, int from = 0) const
+	{
+		if (from>=size) return -1;
+		const char* hit = static_cast<const char*>(memchr(data+from, c, size-from));
+		return hit==nullptr ? -1 : hit-data;
+	}
+
+	ByteView mid(int start, int length = -1) const
+	{
+		if (length<0 || start+length>size) length = size-start;
+		return ByteView(data+start, length);
+	}
+
+	//converts the view to a positive integer
+	int toInt(bool* ok) const
+	{
+		*ok = size>0;
+		int output = 0;
+		for (int i=0; i<size; ++i)
+		{
+			char c = data[i];
+			if (c<'0' || c>'9')
+			{
+				*ok = false;
+				return 0;
+			}
+			output = 10*output + (c-'0');
+		}
+		return output;
+	}
+
+	//deep copy (allocates)
+	QByteArray toByteArray() const
+	{
+		return QByteArray(data, size);
+	}
+
+	static bool isWhitespace(char c)
+	{
+		return c==' ' || c=='\t' || c=='\n' || c=='\r' || c=='\v' || c=='\f';
+	}
+};
+
+//Splits the first columns of a VCF data line into views (no allocation)
+class VcfColumnTokenizer
+{
+public:
+	//Maximum number of columns extracted: CHROM, POS, ID, REF, ALT, QUAL, FILTER, INFO
+	static const int MAX_COLS = 8;
+
+	//Tokenizes the line (leading/trailing whitespaces are ignored). Returns the number of columns, i.e. at most MAX_COLS.
+	int tokenize(const QByteArray& line)
+	{
+		line_ = ByteView(line.constData(), line.size()).trimmed();
+		count_ = 0;
+		int start = 0;
+		while (count_<MAX_COLS)
+		{
+			int end = line_.indexOf('\t', start);
+			if (end==-1)
+			{
+				cols_[count_++] = line_.mid(start);
+				break;
+			}
+			cols_[count_++] = line_.mid(start, end-start);
+			start = end + 1;
+		}
+		return count_;
+	}
+
+	//Returns the trimmed line.
+	const ByteView& line() const
+	{
+		return line_;
+	}
+
+	//Returns the column view.
+	const ByteView& operator[](int i) const
+	{
+		return cols_[i];
+	}
+
+	//Returns the number of columns.
+	int count() const
+	{
+		return count_;
+	}
+
+private:
+	ByteView line_;
+	ByteView cols_[MAX_COLS];
+	int count_ = 0;
+};
+
+//Lookup table for the INFO keys requested from one annotation source.
+//Keys are bucketed by their first character, so most INFO entries of the source are rejected without comparing bytes.
+class InfoKeyLookup
+{
+public:
+	InfoKeyLookup()
+		: buckets_(256)
+	{
+	}
+
+	InfoKeyLookup(const QByteArrayList& keys)
+		: keys_(keys)
+		, buckets_(256)
+	{
+		for (int i=0; i<keys_.count(); ++i)
+		{
+			if (keys_[i].isEmpty()) continue;
+			buckets_[static_cast<unsigned char>(keys_[i][0])] << i;
+		}
+	}
+
+	//Returns the number of keys.
+	int count() const
+	{
+		return keys_.count();
+	}
+
+	//Calls 'func(index)' for the index of each requested key that matches the given key (the same key can be requested several times).
+	template<typename T>
+	void forEachMatch(const ByteView& key, T func) const
+	{
+		if (key.isEmpty()) return;
+		const QVector<int>& bucket = buckets_[static_cast<unsigned char>(key.data[0])];
+		for (int i : bucket)
+		{
+			const QByteArray& candidate = keys_[i];
+			if (candidate.size()==key.size && memcmp(candidate.constData(), key.data, key.size)==0) func(i);
+		}
+	}
+
+private:
+	QByteArrayList keys_;
+	QVector<QVector<int>> buckets_;
+};
+
+#endif // TOKENIZER_H
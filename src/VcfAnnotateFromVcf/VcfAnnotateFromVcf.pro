@@ -22,4 +22,5 @@ HEADERS += \
     ChunkProcessor.h \
     OutputWorker.h \
     ThreadCoordinator.h \
-    InputWorker.h
+    InputWorker.h \
+    Tokenizer.h
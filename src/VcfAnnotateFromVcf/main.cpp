@@ -41,8 +41,11 @@ public:
 		addInt("threads", "The number of threads used to process VCF lines.", true, 1);
 		addInt("block_size", "Number of lines processed in one chunk.", true, 10000);
 		addInt("prefetch", "Maximum number of chunks that may be pre-fetched into memory.", true, 64);
+		addFlag("sorted", "Enables streaming merge-join of input and source files. Source files are read sequentially instead of one index query per variant. Requires a coordinate-sorted input file (unsorted input is handled correctly, but slower).");
 		addFlag("debug", "Enables debug output (use only with one thread).");
 
+		changeLog(2026,10, 18, "Source file indices are loaded only once and shared between threads.");
+		changeLog(2026,10, 18, "Added 'sorted' mode for streaming merge-join of input and source files.");
 		changeLog(2024, 5,  6, "Added option to annotate the existence of variants in the source file");
 		changeLog(2022, 7,  8, "Usability: changed parameter names and updated documentation.");
 		changeLog(2022, 2, 24, "Refactoring and change to event-driven implementation (improved scaling with many threads)");
@@ -73,6 +76,7 @@ public:
 		params.threads = getInt("threads");
 		params.prefetch = getInt("prefetch");
 		params.block_size = getInt("block_size");
+		params.sorted = getFlag("sorted");
 		params.debug = getFlag("debug");
 
 		//check parameters
@@ -183,6 +187,19 @@ public:
 			meta.existence_name_list.append(existence_key_name);
         }
 
+		//create INFO key lookup tables
+		foreach (const QByteArrayList& ids, meta.info_id_list)
+		{
+			meta.info_id_lookup.append(InfoKeyLookup(ids));
+		}
+
+		//load tabix indices of annotation files
+		meta.annotation_files.resize(meta.annotation_file_list.size());
+		for (int i = 0; i < meta.annotation_file_list.size(); i++)
+		{
+			meta.annotation_files[i].load(meta.annotation_file_list[i]);
+		}
+
 		//check meta data
 		QByteArrayList tmp;
 		foreach (QByteArrayList ids, meta.out_info_id_list)
@@ -200,6 +217,7 @@ public:
 		out << "Output file: \t" << params.out << "\n";
 		out << "Threads: \t" << params.threads << "\n";
 		out << "Block (Chunk) size: \t" << params.block_size << "\n";
+		out << "Sorted mode: \t" << (params.sorted ? "yes" : "no") << "\n";
 
 		for(int i = 0; i < meta.annotation_file_list.size(); i++)
         {
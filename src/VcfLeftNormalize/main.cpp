@@ -128,6 +128,7 @@ public:
 		else
 		{
 			VcfFile vcf_file;
+			vcf_file.setLazyDecoding(true); //sample columns are not needed for normalization
 			vcf_file.load(in);
 			if (right)
 			{
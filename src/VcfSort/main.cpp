@@ -36,6 +36,7 @@ public:
 
 		//load
 		VcfFile vl;
+		vl.setLazyDecoding(true); //sample columns are not needed for sorting
 		vl.load(getInfile("in"), true);
 
 		//sort
@@ -35,6 +35,7 @@ public:
 	{
 		//load
 		VcfFile vl;
+		vl.setLazyDecoding(true); //INFO and sample columns are decoded line by line when writing
 		vl.load(getInfile("in"));
 
 		//store
@@ -0,0 +1,140 @@
+#include "TestFramework.h"
+#include "BamMateCache.h"
+
+TEST_CLASS(BamMateCache_Test)
+{
+Q_OBJECT
+private:
+
+	static QByteArray pairString(const BamAlignment& al1, const BamAlignment& al2)
+	{
+		return al1.name() + " " + QByteArray::number(al1.start()) + " " + al1.cigarDataAsString() + " " + al1.bases() + " / " + QByteArray::number(al2.start()) + " " + al2.cigarDataAsString() + " " + al2.bases();
+	}
+
+	//Pairs all alignments of a BAM file and returns the pairs and the alignments without mate
+	static void pairAlignments(const QString& bam_file, BamMateCache& cache, QSet<QByteArray>& pairs, QSet<QByteArray>& unpaired)
+	{
+		BamReader reader(bam_file);
+		BamAlignment al;
+		BamAlignment mate;
+		while (reader.getNextAlignment(al))
+		{
+			if (cache.takeMate(al, mate))
+			{
+				pairs << pairString(mate, al);
+			}
+		}
+		cache.finish();
+
+		int result = cache.takeRemaining(mate, al);
+		while (result!=0)
+		{
+			if (result==2) pairs << pairString(mate, al);
+			if (result==1) unpaired << mate.name() + " " + QByteArray::number(mate.start());
+			result = cache.takeRemaining(mate, al);
+		}
+	}
+
+	//Sets an unmapped alignment with the given name and 100 bases
+	static void setAlignment(BamAlignment& al, const QByteArray& name)
+	{
+		QByteArray bases(100, 'A');
+		if (bam_set1(al.aln_, name.size(), name.constData(), BAM_FUNMAP, -1, -1, 0, 0, nullptr, -1, -1, 0, bases.size(), bases.constData(), nullptr, 0)<0)
+		{
+			THROW(Exception, "Could not create alignment " + name);
+		}
+	}
+
+private slots:
+
+	void in_memory()
+	{
+		BamMateCache cache;
+		QSet<QByteArray> pairs;
+		QSet<QByteArray> unpaired;
+		pairAlignments(TESTDATA("data_in/BamReader_sr.bam"), cache, pairs, unpaired);
+
+		I_EQUAL(pairs.count(), 574);
+		I_EQUAL(unpaired.count(), 73);
+		I_EQUAL(cache.count(), 0);
+		I_EQUAL(cache.peakCount(), 89);
+		IS_TRUE(cache.peakMemory()>0);
+		I_EQUAL(cache.spilledCount(), 0);
+		I_EQUAL(cache.spillFileCount(), 0);
+	}
+
+	void temporary_files()
+	{
+		BamMateCache cache_mem;
+		QSet<QByteArray> pairs_mem;
+		QSet<QByteArray> unpaired_mem;
+		pairAlignments(TESTDATA("data_in/BamReader_sr.bam"), cache_mem, pairs_mem, unpaired_mem);
+
+		//small memory limit > alignments are written to several temporary files
+		BamMateCache cache(20000);
+		QSet<QByteArray> pairs;
+		QSet<QByteArray> unpaired;
+		pairAlignments(TESTDATA("data_in/BamReader_sr.bam"), cache, pairs, unpaired);
+
+		IS_TRUE(pairs==pairs_mem);
+		IS_TRUE(unpaired==unpaired_mem);
+		I_EQUAL(cache.count(), 0);
+		IS_TRUE(cache.peakCount()<89);
+		IS_TRUE(cache.spilledCount()>0);
+		IS_TRUE(cache.spillFileCount()>1);
+	}
+
+	void compaction()
+	{
+		//each block contains one long-lived alignment, all other alignments are paired shortly after (block size is 64KB)
+		BamMateCache cache(1024 * 1024);
+		BamAlignment al;
+		BamAlignment mate;
+		const int rounds = 100;
+		for (int r=0; r<rounds; ++r)
+		{
+			setAlignment(al, "long_" + QByteArray::number(r));
+			IS_FALSE(cache.takeMate(al, mate));
+			for (int i=0; i<300; ++i)
+			{
+				setAlignment(al, "pair_" + QByteArray::number(r) + "_" + QByteArray::number(i));
+				IS_FALSE(cache.takeMate(al, mate));
+			}
+			for (int i=0; i<300; ++i)
+			{
+				setAlignment(al, "pair_" + QByteArray::number(r) + "_" + QByteArray::number(i));
+				IS_TRUE(cache.takeMate(al, mate));
+				S_EQUAL(mate.name(), al.name());
+			}
+		}
+
+		//memory does not grow with the input (about 6MB of alignments in total)
+		I_EQUAL(cache.count(), rounds);
+		I_EQUAL(cache.spilledCount(), 0);
+		IS_TRUE(cache.peakMemory()<=4 * 64 * 1024);
+
+		//moved alignments are found
+		for (int r=0; r<rounds; ++r)
+		{
+			setAlignment(al, "long_" + QByteArray::number(r));
+			IS_TRUE(cache.takeMate(al, mate));
+			S_EQUAL(mate.name(), al.name());
+		}
+		I_EQUAL(cache.count(), 0);
+	}
+
+	void add_after_finish()
+	{
+		BamReader reader(TESTDATA("data_in/BamReader_sr.bam"));
+		BamAlignment al;
+		BamAlignment mate;
+		IS_TRUE(reader.getNextAlignment(al));
+
+		BamMateCache cache;
+		IS_FALSE(cache.takeMate(al, mate));
+		cache.finish();
+		IS_THROWN(ProgrammingException, cache.takeMate(al, mate));
+		I_EQUAL(cache.takeRemaining(mate, al), 1);
+		I_EQUAL(cache.takeRemaining(mate, al), 0);
+	}
+};
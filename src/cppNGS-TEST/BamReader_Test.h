@@ -69,6 +69,58 @@ private slots:
 		S_EQUAL(al.tag("XX"), "");
 	}
 
+	void BamAlignment_views()
+	{
+		BamReader reader(TESTDATA("data_in/BamReader_sr.bam"));
+		BamAlignment al;
+		int al_checked = 0;
+		int al_with_indel = 0;
+		while (reader.getNextAlignment(al))
+		{
+			//CIGAR
+			QList<CigarOp> cigar_data = al.cigarData();
+			CigarView cigar_view = al.cigarView();
+			I_EQUAL(cigar_view.count(), cigar_data.count());
+			int op_index = 0;
+			for (const CigarOp& op : cigar_view)
+			{
+				I_EQUAL(op.Type, cigar_data[op_index].Type);
+				I_EQUAL(op.Length, cigar_data[op_index].Length);
+				I_EQUAL(cigar_view[op_index].Type, cigar_data[op_index].Type);
+				I_EQUAL(cigar_view[op_index].Length, cigar_data[op_index].Length);
+				if (op.Type==BAM_CINS || op.Type==BAM_CDEL) ++al_with_indel;
+				++op_index;
+			}
+			I_EQUAL(op_index, cigar_data.count());
+
+			//bases
+			Sequence bases = al.bases();
+			QVector<int> base_ints = al.baseIntegers();
+			BaseView bases_view = al.basesView();
+			I_EQUAL(bases_view.length(), bases.count());
+			for (int i=0; i<bases.count(); ++i)
+			{
+				S_EQUAL(bases_view[i], bases[i]);
+				I_EQUAL(bases_view.code(i), base_ints[i]);
+			}
+			if (bases.count()>=10) S_EQUAL(bases_view.mid(3, 7), bases.mid(3, 7));
+
+			//qualities
+			QByteArray qualities = al.qualities();
+			QualityView qualities_view = al.qualitiesView();
+			I_EQUAL(qualities_view.length(), qualities.count());
+			for (int i=0; i<qualities.count(); ++i)
+			{
+				I_EQUAL(qualities_view[i]+33, (int)qualities[i]);
+				I_EQUAL((int)qualities_view.data()[i], al.quality(i));
+			}
+
+			++al_checked;
+		}
+		I_EQUAL(al_checked, 1221);
+		IS_TRUE(al_with_indel>0);
+	}
+
 	void BamAlignment_setCigarData()
 	{
 		BamReader reader(TESTDATA("data_in/panel.bam"));
@@ -538,4 +590,58 @@ private slots:
 		IS_TRUE(reader2.is_single_end());
 	}
 
+	//benchmarks (only executed if the environment variable NGSBITS_BENCHMARK is set, see tools/benchmark) - copying CIGAR data, bases and qualities allocates three buffers per alignment, the views allocate nothing
+
+	void benchmark_BamAlignment_copies()
+	{
+		if (!qEnvironmentVariableIsSet("NGSBITS_BENCHMARK")) SKIP("Benchmark - set NGSBITS_BENCHMARK to execute it");
+
+		long long sum = 0;
+		for (int r=0; r<50; ++r)
+		{
+			BamReader reader(TESTDATA("data_in/BamReader_sr.bam"));
+			BamAlignment al;
+			while (reader.getNextAlignment(al))
+			{
+				foreach(const CigarOp& op, al.cigarData())
+				{
+					if (op.Type==BAM_CMATCH) sum += op.Length;
+				}
+				Sequence bases = al.bases();
+				QByteArray qualities = al.qualities();
+				for (int i=0; i<bases.count(); ++i)
+				{
+					if (bases[i]=='G' || bases[i]=='C') sum += qualities[i] - 33;
+				}
+			}
+		}
+		IS_TRUE(sum>0);
+	}
+
+	void benchmark_BamAlignment_views()
+	{
+		if (!qEnvironmentVariableIsSet("NGSBITS_BENCHMARK")) SKIP("Benchmark - set NGSBITS_BENCHMARK to execute it");
+
+		long long sum = 0;
+		for (int r=0; r<50; ++r)
+		{
+			BamReader reader(TESTDATA("data_in/BamReader_sr.bam"));
+			BamAlignment al;
+			while (reader.getNextAlignment(al))
+			{
+				for (const CigarOp& op : al.cigarView())
+				{
+					if (op.Type==BAM_CMATCH) sum += op.Length;
+				}
+				const BaseView bases = al.basesView();
+				const QualityView qualities = al.qualitiesView();
+				for (int i=0; i<bases.length(); ++i)
+				{
+					if (bases[i]=='G' || bases[i]=='C') sum += qualities[i];
+				}
+			}
+		}
+		IS_TRUE(sum>0);
+	}
+
 };
@@ -73,4 +73,45 @@ private slots:
 		S_EQUAL(al_string, new_al.cigarDataAsString());
 
 	}
+
+	void write_bam_thread_pool_test()
+	{
+		HtsThreadPool::setThreadCount(4);
+		I_EQUAL(HtsThreadPool::threadCount(), 4);
+
+		//copy all alignments using the thread pool
+		QStringList names;
+		{
+			BamReader reader(TESTDATA("data_in/bamWriterTest.bam"));
+			BamWriter writer("out/bamWriterTest_threads.bam");
+			IS_THROWN(ProgrammingException, HtsThreadPool::setThreadCount(2));
+			writer.writeHeader(reader);
+			BamAlignment al;
+			while (reader.getNextAlignment(al))
+			{
+				names << al.name();
+				writer.writeAlignment(al);
+			}
+		}
+
+		//read copy using the thread pool
+		QStringList names_copy;
+		{
+			BamReader reader("out/bamWriterTest_threads.bam");
+			BamAlignment al;
+			while (reader.getNextAlignment(al))
+			{
+				names_copy << al.name();
+			}
+		}
+		IS_TRUE(names.count()>0);
+		IS_TRUE(names==names_copy);
+
+		//failed initialization of a reader does not keep the thread pool attached
+		IS_THROWN(Exception, BamReader(TESTDATA("data_in/cramTest.cram"), "out/bamWriterTest_missing_reference.fa"));
+
+		//disable thread pool
+		HtsThreadPool::setThreadCount(1);
+		I_EQUAL(HtsThreadPool::threadCount(), 0);
+	}
 };
@@ -0,0 +1,109 @@
+#include "TestFramework.h"
+#include "BedFileSweepCursor.h"
+#include "ChromosomalIndex.h"
+
+TEST_CLASS(BedFileSweepCursor_Test)
+{
+Q_OBJECT
+private slots:
+
+	void matchingIndices()
+	{
+		BedFile bed_file;
+		bed_file.append(BedLine("chr1", 100, 200));
+		bed_file.append(BedLine("chr1", 150, 1000));
+		bed_file.append(BedLine("chr1", 300, 400));
+		bed_file.append(BedLine("chr1", 1200, 1300));
+		bed_file.append(BedLine("chr2", 100, 200));
+		BedFileSweepCursor cursor(bed_file);
+
+		QVector<int> indices;
+		I_EQUAL(cursor.matchingIndices("chr1", 1, 99, indices), 0);
+		I_EQUAL(cursor.matchingIndices("chr1", 90, 160, indices), 2);
+		I_EQUAL(indices[0], 0);
+		I_EQUAL(indices[1], 1);
+		I_EQUAL(cursor.matchingIndices("chr1", 350, 360, indices), 2);
+		I_EQUAL(indices[0], 1);
+		I_EQUAL(indices[1], 2);
+		I_EQUAL(cursor.matchingIndices("chr1", 1001, 1199, indices), 0);
+		I_EQUAL(cursor.matchingIndices("chr1", 1300, 1400, indices), 1);
+		I_EQUAL(indices[0], 3);
+
+		//query start before the last query start
+		I_EQUAL(cursor.matchingIndices("chr1", 190, 190, indices), 2);
+		I_EQUAL(indices[0], 0);
+		I_EQUAL(indices[1], 1);
+
+		//chromosome change
+		I_EQUAL(cursor.matchingIndices("chr2", 150, 150, indices), 1);
+		I_EQUAL(indices[0], 4);
+		I_EQUAL(cursor.matchingIndices("chrX", 150, 150, indices), 0);
+		I_EQUAL(cursor.matchingIndices("chr1", 150, 150, indices), 2);
+	}
+
+	void overlaps()
+	{
+		BedFile bed_file;
+		bed_file.append(BedLine("chr1", 100, 200));
+		bed_file.append(BedLine("chr1", 300, 400));
+		BedFileSweepCursor cursor(bed_file);
+
+		IS_FALSE(cursor.overlaps("chr1", 1, 99));
+		IS_TRUE(cursor.overlaps("chr1", 50, 100));
+		IS_FALSE(cursor.overlaps("chr1", 201, 299));
+		IS_TRUE(cursor.overlaps("chr1", 250, 350));
+		IS_FALSE(cursor.overlaps("chr1", 401, 500));
+		IS_TRUE(cursor.overlaps("chr1", 1, 1000));
+		IS_FALSE(cursor.overlaps("chr2", 1, 1000));
+	}
+
+	void unsorted_input()
+	{
+		BedFile bed_file;
+		bed_file.append(BedLine("chr1", 300, 400));
+		bed_file.append(BedLine("chr1", 100, 200));
+		IS_THROWN(ArgumentException, BedFileSweepCursor cursor(bed_file));
+	}
+
+	void default_constructor()
+	{
+		BedFileSweepCursor cursor;
+		QVector<int> indices;
+		I_EQUAL(cursor.matchingIndices("chr1", 1, 1000, indices), 0);
+		IS_FALSE(cursor.overlaps("chr1", 1, 1000));
+	}
+
+	void compare_with_ChromosomalIndex()
+	{
+		BedFile bed_file;
+		bed_file.load(TESTDATA("data_in/panel.bed"));
+		bed_file.merge();
+		BedFile dropout = bed_file;
+		dropout.chunk(100);
+		ChromosomalIndex<BedFile> index(dropout);
+		BedFileSweepCursor cursor(dropout);
+		BedFileSweepCursor cursor_near(dropout);
+
+		//sorted queries (like alignments of a BAM file)
+		QVector<int> indices;
+		for (int i=0; i<bed_file.count(); ++i)
+		{
+			const BedLine& line = bed_file[i];
+			for (int start=line.start()-300; start<=line.end()+300; start+=37)
+			{
+				int end = start + 100 + (start % 50);
+				cursor.matchingIndices(line.chr(), start, end, indices);
+				IS_TRUE(indices==index.matchingIndices(line.chr(), start, end));
+				IS_TRUE(cursor_near.overlaps(line.chr(), start-250, end+250)==(index.matchingIndex(line.chr(), start-250, end+250)!=-1));
+			}
+		}
+
+		//reverse order
+		for (int i=bed_file.count()-1; i>=0; --i)
+		{
+			const BedLine& line = bed_file[i];
+			cursor.matchingIndices(line.chr(), line.start()-10, line.start()+10, indices);
+			IS_TRUE(indices==index.matchingIndices(line.chr(), line.start()-10, line.start()+10));
+		}
+	}
+};
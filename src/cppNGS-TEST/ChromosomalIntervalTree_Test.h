@@ -0,0 +1,338 @@
+#include "TestFramework.h"
+#include "ChromosomalIntervalTree.h"
+#include "ChromosomalIndex.h"
+#include "BedFile.h"
+#include "CnvList.h"
+#include "VcfFile.h"
+
+TEST_CLASS(ChromosomalIntervalTree_Test)
+{
+Q_OBJECT
+private:
+
+	//exome-like target region (short elements)
+	BedFile exomeBed()
+	{
+		BedFile output;
+		output.load(TESTDATA("data_in/Statistics_somatic_tmb_target.bed"));
+		output.sort();
+		return output;
+	}
+
+	//gene regions (long elements)
+	BedFile geneBed()
+	{
+		BedFile exons;
+		exons.load(TESTDATA("data_in/Statistics_somatic_tmb_tsg.bed"));
+
+		QHash<QByteArray, BedLine> gene2region;
+		for (int i=0; i<exons.count(); ++i)
+		{
+			const BedLine& exon = exons[i];
+			QByteArray gene = exon.chr().str() + "_" + exon.annotations()[0];
+			if (gene2region.contains(gene))
+			{
+				BedLine& region = gene2region[gene];
+				region.setStart(std::min(region.start(), exon.start()));
+				region.setEnd(std::max(region.end(), exon.end()));
+			}
+			else
+			{
+				gene2region[gene] = BedLine(exon.chr(), exon.start(), exon.end());
+			}
+		}
+
+		BedFile output;
+		foreach(const BedLine& line, gene2region)
+		{
+			output.append(line);
+		}
+		output.sort();
+		return output;
+	}
+
+	//CNV regions (mixed lengths)
+	BedFile cnvBed()
+	{
+		CnvList cnvs;
+		cnvs.load(TESTDATA("data_in/CnvList_ClinCNV_germline.tsv"));
+
+		BedFile output;
+		for (int i=0; i<cnvs.count(); ++i)
+		{
+			output.append(BedLine(cnvs[i].chr(), cnvs[i].start(), cnvs[i].end()));
+		}
+		output.sort();
+		return output;
+	}
+
+	//exome-like target region with one 5Mb element
+	BedFile exomeWithLongElementBed()
+	{
+		BedFile output = exomeBed();
+		output.append(BedLine("chr1", 1, 5000000));
+		output.sort();
+		return output;
+	}
+
+	//queries: exome target regions extended by 100 bases
+	BedFile queries()
+	{
+		BedFile output = exomeBed();
+		output.extend(100);
+		return output;
+	}
+
+	//checks that the interval tree returns the same matches as ChromosomalIndex
+	void compareWithChromosomalIndex(const BedFile& bed_file)
+	{
+		ChromosomalIndex<BedFile> index(bed_file);
+		ChromosomalIntervalTree<BedFile> tree(bed_file);
+
+		BedFile query_regions = queries();
+		for (int i=0; i<query_regions.count(); ++i)
+		{
+			const BedLine& line = query_regions[i];
+			QVector<int> expected = index.matchingIndices(line.chr(), line.start(), line.end());
+			QVector<int> actual = tree.matchingIndices(line.chr(), line.start(), line.end());
+			IS_TRUE(actual==expected);
+			I_EQUAL(tree.matchingIndex(line.chr(), line.start(), line.end()), index.matchingIndex(line.chr(), line.start(), line.end()));
+		}
+	}
+
+	//runs all queries several times and returns the number of matches
+	template <typename IndexType>
+	long long runQueries(const IndexType& index, const BedFile& query_regions)
+	{
+		long long matches = 0;
+		for (int r=0; r<20; ++r)
+		{
+			for (int i=0; i<query_regions.count(); ++i)
+			{
+				const BedLine& line = query_regions[i];
+				matches += index.matchingIndices(line.chr(), line.start(), line.end()).count();
+			}
+		}
+		return matches;
+	}
+
+private slots:
+
+	void matchingIndices_BedFile()
+	{
+		BedFile bed_file;
+		for (int c=1; c<=22; ++c)
+		{
+			for (int p=1; p<=100*c; ++p)
+			{
+				BedLine line ("chr" + QString::number(c), p, p);
+				if (p%10==0) line.setEnd(p + 10);
+				bed_file.append(line);
+			}
+		}
+		ChromosomalIntervalTree<BedFile> bed_index(bed_file);
+
+		//chromosome not found
+		QVector<int> elements = bed_index.matchingIndices("chrX", 5, 15);
+		I_EQUAL(elements.count(), 0);
+
+		//whole chr1
+		elements = bed_index.matchingIndices("chr1", 0, 100000);
+		I_EQUAL(elements.count(), 100);
+
+		//3 elements
+		elements = bed_index.matchingIndices("chr1", 5, 7);
+		I_EQUAL(elements.count(), 3);
+		I_EQUAL(elements[0], 4);
+		I_EQUAL(elements[1], 5);
+		I_EQUAL(elements[2], 6);
+
+		//1 element
+		elements = bed_index.matchingIndices("chr1", 5, 5);
+		I_EQUAL(elements.count(), 1);
+
+		//whole chr2
+		elements = bed_index.matchingIndices("chr2", 0, 100000);
+		I_EQUAL(elements.count(), 200);
+
+		//5 elements
+		elements = bed_index.matchingIndices("chr2", 1, 5);
+		I_EQUAL(elements.count(), 5);
+
+		//overlap with beginning
+		elements = bed_index.matchingIndices("chr2", -10, 5);
+		I_EQUAL(elements.count(), 5);
+
+		//overlap with end
+		elements = bed_index.matchingIndices("chr2", 200, 205);
+		I_EQUAL(elements.count(), 2);
+
+		//no overlap
+		elements = bed_index.matchingIndices("chr2", 500, 505);
+		I_EQUAL(elements.count(), 0);
+	}
+
+	void matchingIndex_BedFile()
+	{
+		BedFile bed_file;
+		bed_file.append(BedLine("chr1", 1, 5000000));
+		bed_file.append(BedLine("chr1", 100, 200));
+		bed_file.append(BedLine("chr1", 150, 250));
+		bed_file.append(BedLine("chr2", 100, 200));
+		ChromosomalIntervalTree<BedFile> bed_index(bed_file);
+
+		I_EQUAL(bed_index.matchingIndex("chr1", 160, 170), 0);
+		I_EQUAL(bed_index.matchingIndex("chr1", 5000000, 5000001), 0);
+		I_EQUAL(bed_index.matchingIndex("chr1", 5000001, 5000002), -1);
+		I_EQUAL(bed_index.matchingIndex("chr2", 150, 150), 3);
+		I_EQUAL(bed_index.matchingIndex("chr2", 201, 300), -1);
+		I_EQUAL(bed_index.matchingIndex("chrX", 1, 300), -1);
+	}
+
+	void forEachMatch_BedFile()
+	{
+		BedFile bed_file;
+		bed_file.append(BedLine("chr1", 1, 5000000));
+		bed_file.append(BedLine("chr1", 100, 200));
+		bed_file.append(BedLine("chr1", 150, 250));
+		bed_file.append(BedLine("chr1", 300, 400));
+		ChromosomalIntervalTree<BedFile> bed_index(bed_file);
+
+		QVector<int> elements;
+		bed_index.forEachMatch("chr1", 180, 310, [&elements](int index) { elements << index; });
+		I_EQUAL(elements.count(), 4);
+		I_EQUAL(elements[0], 0);
+		I_EQUAL(elements[1], 1);
+		I_EQUAL(elements[2], 2);
+		I_EQUAL(elements[3], 3);
+
+		elements.clear();
+		bed_index.forEachMatch("chr1", 210, 290, [&elements](int index) { elements << index; });
+		I_EQUAL(elements.count(), 2);
+		I_EQUAL(elements[0], 0);
+		I_EQUAL(elements[1], 2);
+	}
+
+	void unsorted_BedFile()
+	{
+		BedFile bed_file;
+		bed_file.append(BedLine("chr2", 100, 200));
+		bed_file.append(BedLine("chr1", 300, 400));
+		bed_file.append(BedLine("chr1", 100, 200));
+		ChromosomalIntervalTree<BedFile> bed_index(bed_file);
+
+		QVector<int> elements = bed_index.matchingIndices("chr1", 1, 1000);
+		I_EQUAL(elements.count(), 2);
+		I_EQUAL(elements[0], 2);
+		I_EQUAL(elements[1], 1);
+	}
+
+	void matchingIndices_VcfFile()
+	{
+		VcfFile var_list;
+		var_list.load(TESTDATA("data_in/panel_vep.vcf"));
+		var_list.sort();
+		ChromosomalIndex<VcfFile> index(var_list);
+		ChromosomalIntervalTree<VcfFile> tree(var_list);
+
+		for (int i=0; i<var_list.count(); ++i)
+		{
+			const VcfLine& line = var_list[i];
+			IS_TRUE(tree.matchingIndices(line.chr(), line.start()-50, line.end()+50)==index.matchingIndices(line.chr(), line.start()-50, line.end()+50));
+		}
+	}
+
+	void compare_exome()
+	{
+		compareWithChromosomalIndex(exomeBed());
+	}
+
+	void compare_genes()
+	{
+		compareWithChromosomalIndex(geneBed());
+	}
+
+	void compare_cnvs()
+	{
+		compareWithChromosomalIndex(cnvBed());
+	}
+
+	void compare_exome_with_long_element()
+	{
+		compareWithChromosomalIndex(exomeWithLongElementBed());
+	}
+
+	//benchmarks (only executed if the environment variable NGSBITS_BENCHMARK is set, see tools/benchmark)
+
+	void benchmark_exome_ChromosomalIndex()
+	{
+		if (!qEnvironmentVariableIsSet("NGSBITS_BENCHMARK")) SKIP("Benchmark - set NGSBITS_BENCHMARK to execute it");
+
+		BedFile bed_file = exomeBed();
+		ChromosomalIndex<BedFile> index(bed_file);
+		IS_TRUE(runQueries(index, queries())>0);
+	}
+
+	void benchmark_exome_ChromosomalIntervalTree()
+	{
+		if (!qEnvironmentVariableIsSet("NGSBITS_BENCHMARK")) SKIP("Benchmark - set NGSBITS_BENCHMARK to execute it");
+
+		BedFile bed_file = exomeBed();
+		ChromosomalIntervalTree<BedFile> index(bed_file);
+		IS_TRUE(runQueries(index, queries())>0);
+	}
+
+	void benchmark_genes_ChromosomalIndex()
+	{
+		if (!qEnvironmentVariableIsSet("NGSBITS_BENCHMARK")) SKIP("Benchmark - set NGSBITS_BENCHMARK to execute it");
+
+		BedFile bed_file = geneBed();
+		ChromosomalIndex<BedFile> index(bed_file);
+		IS_TRUE(runQueries(index, queries())>0);
+	}
+
+	void benchmark_genes_ChromosomalIntervalTree()
+	{
+		if (!qEnvironmentVariableIsSet("NGSBITS_BENCHMARK")) SKIP("Benchmark - set NGSBITS_BENCHMARK to execute it");
+
+		BedFile bed_file = geneBed();
+		ChromosomalIntervalTree<BedFile> index(bed_file);
+		IS_TRUE(runQueries(index, queries())>0);
+	}
+
+	void benchmark_cnvs_ChromosomalIndex()
+	{
+		if (!qEnvironmentVariableIsSet("NGSBITS_BENCHMARK")) SKIP("Benchmark - set NGSBITS_BENCHMARK to execute it");
+
+		BedFile bed_file = cnvBed();
+		ChromosomalIndex<BedFile> index(bed_file);
+		IS_TRUE(runQueries(index, queries())>0);
+	}
+
+	void benchmark_cnvs_ChromosomalIntervalTree()
+	{
+		if (!qEnvironmentVariableIsSet("NGSBITS_BENCHMARK")) SKIP("Benchmark - set NGSBITS_BENCHMARK to execute it");
+
+		BedFile bed_file = cnvBed();
+		ChromosomalIntervalTree<BedFile> index(bed_file);
+		IS_TRUE(runQueries(index, queries())>0);
+	}
+
+	void benchmark_exome_with_long_element_ChromosomalIndex()
+	{
+		if (!qEnvironmentVariableIsSet("NGSBITS_BENCHMARK")) SKIP("Benchmark - set NGSBITS_BENCHMARK to execute it");
+
+		BedFile bed_file = exomeWithLongElementBed();
+		ChromosomalIndex<BedFile> index(bed_file);
+		IS_TRUE(runQueries(index, queries())>0);
+	}
+
+	void benchmark_exome_with_long_element_ChromosomalIntervalTree()
+	{
+		if (!qEnvironmentVariableIsSet("NGSBITS_BENCHMARK")) SKIP("Benchmark - set NGSBITS_BENCHMARK to execute it");
+
+		BedFile bed_file = exomeWithLongElementBed();
+		ChromosomalIntervalTree<BedFile> index(bed_file);
+		IS_TRUE(runQueries(index, queries())>0);
+	}
+};
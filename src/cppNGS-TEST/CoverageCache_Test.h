@@ -0,0 +1,84 @@
+#include "TestFramework.h"
+#include "CoverageCache.h"
+#include <QDateTime>
+
+TEST_CLASS(CoverageCache_Test)
+{
+Q_OBJECT
+private:
+
+	//Creates a copy of the test BAM file and its coverage cache in the output folder
+	static QString createCache()
+	{
+		QString bam = "out/CoverageCache_in1.bam";
+		QFile::remove(bam);
+		QFile::remove(bam + ".bai");
+		QFile::copy(TESTDATA("data_in/BamReader_sr.bam"), bam);
+		QFile::copy(TESTDATA("data_in/BamReader_sr.bam.bai"), bam + ".bai");
+
+		BedFile regions;
+		regions.append(BedLine("chr17", 43090000, 43100000));
+		CoverageCache::create(bam, regions, CoverageCache::defaultFileName(bam), 1, 0);
+
+		return bam;
+	}
+
+	//Overwrites one byte of a file without changing its size and modification time
+	static void modifyContent(const QString& filename, qint64 pos)
+	{
+		QFile file(filename);
+		file.open(QFile::ReadWrite);
+		QDateTime modified = file.fileTime(QFileDevice::FileModificationTime);
+		file.seek(pos);
+		char c = file.read(1)[0];
+		file.seek(pos);
+		file.write(QByteArray(1, (char)(c ^ 0xFF)));
+		file.flush();
+		file.setFileTime(modified, QFileDevice::FileModificationTime);
+		file.close();
+	}
+
+private slots:
+
+	void isUpToDate()
+	{
+		//same size and modification time, but different content at the start of the file
+		QString bam = createCache();
+		{
+			CoverageCache cache(CoverageCache::defaultFileName(bam));
+			IS_TRUE(cache.isUpToDate(bam));
+			modifyContent(bam, 100);
+			IS_FALSE(cache.isUpToDate(bam));
+		}
+
+		//same size and modification time, but different content at the end of the file
+		bam = createCache();
+		{
+			CoverageCache cache(CoverageCache::defaultFileName(bam));
+			IS_TRUE(cache.isUpToDate(bam));
+			modifyContent(bam, QFileInfo(bam).size() - 100);
+			IS_FALSE(cache.isUpToDate(bam));
+		}
+	}
+
+	void openIfValid()
+	{
+		QString bam = createCache();
+
+		//cache is opened only once
+		QSharedPointer<CoverageCache> cache = CoverageCache::openIfValid(bam, 1, 0);
+		IS_FALSE(cache.isNull());
+		IS_TRUE(cache==CoverageCache::openIfValid(bam, 1, 0));
+
+		//different cutoffs
+		IS_TRUE(CoverageCache::openIfValid(bam, 20, 0).isNull());
+		IS_TRUE(CoverageCache::openIfValid(bam, 1, 30).isNull());
+
+		//BAM file modified
+		QFile file(bam);
+		file.open(QFile::ReadWrite);
+		file.setFileTime(file.fileTime(QFileDevice::FileModificationTime).addSecs(60), QFileDevice::FileModificationTime);
+		file.close();
+		IS_TRUE(CoverageCache::openIfValid(bam, 1, 0).isNull());
+	}
+};
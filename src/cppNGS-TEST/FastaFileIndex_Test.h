@@ -49,6 +49,51 @@ private slots:
 		S_EQUAL(seq, Sequence("ACGT"));
 	}
 
+	void seqs()
+	{
+		FastaFileIndex index(TESTDATA("data_in/example.fa"));
+
+		BedFile regions;
+		regions.append(BedLine("chr14", 60, 65));
+		regions.append(BedLine("chr14", 100, 130));
+		regions.append(BedLine("chr14", 1001, 1010));
+		regions.append(BedLine("chr15", 1, 4));
+		regions.append(BedLine("chr16", 2, 3));
+		regions.append(BedLine("chr14", 1, 10)); //unsorted
+		QList<Sequence> seqs = index.seqs(regions, false);
+		I_EQUAL(seqs.count(), 6);
+		S_EQUAL(seqs[0], Sequence("tttttg"));
+		S_EQUAL(seqs[1], Sequence("cgcccaggctggagtgcagtggcgcgatctt"));
+		S_EQUAL(seqs[2], Sequence("gcagttacca"));
+		S_EQUAL(seqs[3], Sequence("cgat"));
+		S_EQUAL(seqs[4], Sequence("at"));
+		S_EQUAL(seqs[5], Sequence("ataaaccaac"));
+
+		seqs = index.seqs(regions);
+		S_EQUAL(seqs[3], Sequence("CGAT"));
+
+		//empty input
+		I_EQUAL(index.seqs(BedFile()).count(), 0);
+	}
+
+	void seqs_compare_with_seq()
+	{
+		FastaFileIndex index(TESTDATA("data_in/example.fa"));
+
+		BedFile regions;
+		for (int start=1; start<=1500; start+=7)
+		{
+			regions.append(BedLine("chr14", start, start + (start % 9)));
+		}
+		QList<Sequence> seqs = index.seqs(regions);
+		I_EQUAL(seqs.count(), regions.count());
+		for (int i=0; i<regions.count(); ++i)
+		{
+			const BedLine& line = regions[i];
+			S_EQUAL(seqs[i], index.seq(line.chr(), line.start(), line.length()));
+		}
+	}
+
 	void seq_substr_large()
 	{
 		QString ref_file = Settings::string("reference_genome", true);
@@ -1989,6 +1989,49 @@ private slots:
 		}
 	}
 
+	void FilterResult_selection()
+	{
+		FilterResult result(5);
+		I_EQUAL(result.selection().count(), 5);
+
+		result.flags()[1] = false;
+		result.flags()[3] = false;
+		I_EQUAL(result.selection().count(), 3);
+		I_EQUAL(result.selection()[0], 0);
+		I_EQUAL(result.selection()[1], 2);
+		I_EQUAL(result.selection()[2], 4);
+
+		result.invert();
+		I_EQUAL(result.selection().count(), 2);
+		I_EQUAL(result.selection()[0], 1);
+		I_EQUAL(result.selection()[1], 3);
+
+		result.reset(false);
+		I_EQUAL(result.selection().count(), 0);
+	}
+
+	void FilterCascade_statistics()
+	{
+		VariantList vl;
+		vl.load(TESTDATA("data_in/VariantFilter_in.GSvar"));
+
+		FilterCascade cascade;
+		cascade.add(FilterFactory::create("Gene inheritance", QStringList() << "modes=AD,AR"));
+		cascade.add(FilterFactory::create("Gene constraint", QStringList() << "max_oe_lof=0.0" << "min_pli=0.5"));
+		I_EQUAL(cascade.statistics(0).rows_in, 0);
+
+		FilterResult result = cascade.apply(vl);
+		I_EQUAL(cascade.statistics(0).rows_in, vl.count());
+		I_EQUAL(cascade.statistics(0).rows_out, 44);
+		I_EQUAL(cascade.statistics(1).rows_in, 44);
+		I_EQUAL(cascade.statistics(1).rows_out, result.countPassing());
+		IS_TRUE(cascade.statistics(1).time_ms>=0);
+
+		//adding a filter resets the statistics
+		cascade.add(FilterFactory::create("SNVs only"));
+		I_EQUAL(cascade.statistics(0).rows_in, 0);
+	}
+
 	void load_bug_empty_enum()
 	{
 		VariantList vl;
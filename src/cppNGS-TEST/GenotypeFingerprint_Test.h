@@ -0,0 +1,75 @@
+#include "TestFramework.h"
+#include "SampleSimilarity.h"
+#include "Helper.h"
+
+TEST_CLASS(GenotypeFingerprint_Test)
+{
+Q_OBJECT
+private:
+
+	static GenotypeFingerprint createFingerprint(quint64 panel_id, const QList<GenotypeFingerprint::Genotype>& genotypes)
+	{
+		GenotypeFingerprint output(panel_id, genotypes.count());
+		for (int i=0; i<genotypes.count(); ++i)
+		{
+			output.setGenotype(i, genotypes[i]);
+		}
+		return output;
+	}
+
+private slots:
+
+	void calculateSimilarity()
+	{
+		GenotypeFingerprint fp1 = createFingerprint(42, QList<GenotypeFingerprint::Genotype>() << GenotypeFingerprint::HOM_REF << GenotypeFingerprint::HET << GenotypeFingerprint::HOM_ALT << GenotypeFingerprint::HET << GenotypeFingerprint::NO_CALL << GenotypeFingerprint::HOM_REF << GenotypeFingerprint::HOM_ALT << GenotypeFingerprint::HET);
+		GenotypeFingerprint fp2 = createFingerprint(42, QList<GenotypeFingerprint::Genotype>() << GenotypeFingerprint::HOM_REF << GenotypeFingerprint::HET << GenotypeFingerprint::HET << GenotypeFingerprint::HOM_ALT << GenotypeFingerprint::HET << GenotypeFingerprint::HOM_ALT << GenotypeFingerprint::HOM_ALT << GenotypeFingerprint::NO_CALL);
+		I_EQUAL(fp1.calledCount(), 7);
+		I_EQUAL(fp2.calledCount(), 7);
+
+		//expected values calculated by hand: overlap of 6 SNPs, dosages 0,1,2,1,0,2 and 0,1,1,2,2,2
+		SampleSimilarity sc;
+		sc.calculateSimilarity(fp1, fp2);
+		F_EQUAL(sc.olCount(), 6.0);
+		S_EQUAL(QString::number(sc.olPerc(), 'f', 2), QString("85.71"));
+		S_EQUAL(QString::number(sc.sampleCorrelation(), 'f', 4), QString("0.2739"));
+		S_EQUAL(QString::number(sc.ibs0Perc(), 'f', 2), QString("14.29"));
+		S_EQUAL(QString::number(sc.ibs2Perc(), 'f', 2), QString("28.57"));
+		I_EQUAL(sc.messages().count(), 0);
+
+		//different SNP panel
+		GenotypeFingerprint fp3 = createFingerprint(43, QList<GenotypeFingerprint::Genotype>() << GenotypeFingerprint::HOM_REF);
+		IS_THROWN(ArgumentException, sc.calculateSimilarity(fp1, fp3));
+	}
+
+	void storeLoad()
+	{
+		//create source file
+		QString source = Helper::tempFileName(".bam");
+		Helper::storeTextFile(source, QStringList() << "content");
+
+		GenotypeFingerprint fp = createFingerprint(42, QList<GenotypeFingerprint::Genotype>() << GenotypeFingerprint::HOM_REF << GenotypeFingerprint::HET << GenotypeFingerprint::NO_CALL << GenotypeFingerprint::HOM_ALT);
+		fp.setSource(source);
+		IS_TRUE(fp.isFromSource(source));
+
+		QString fp_file = Helper::tempFileName(".fingerprint");
+		fp.store(fp_file);
+		GenotypeFingerprint fp2;
+		fp2.load(fp_file);
+		IS_TRUE(fp2.panelId()==42);
+		I_EQUAL(fp2.snpCount(), 4);
+		I_EQUAL(fp2.calledCount(), 3);
+		I_EQUAL(fp2.genotype(0), GenotypeFingerprint::HOM_REF);
+		I_EQUAL(fp2.genotype(1), GenotypeFingerprint::HET);
+		I_EQUAL(fp2.genotype(2), GenotypeFingerprint::NO_CALL);
+		I_EQUAL(fp2.genotype(3), GenotypeFingerprint::HOM_ALT);
+		S_EQUAL(fp2.sourceFile(), QFileInfo(source).absoluteFilePath());
+		IS_TRUE(fp2.isFromSource(source));
+
+		//source file modified
+		Helper::storeTextFile(source, QStringList() << "modified content");
+		IS_FALSE(fp2.isFromSource(source));
+
+		//other file
+		IS_FALSE(fp2.isFromSource(fp_file));
+	}
+};
@@ -0,0 +1,133 @@
+#include "TestFramework.h"
+#include "MatchKernels.h"
+#include "Sequence.h"
+#include <random>
+
+TEST_CLASS(MatchKernels_Test)
+{
+Q_OBJECT
+private:
+
+	//Returns a random sequence of ACGTN (N with 5% probability)
+	static QByteArray randomSequence(std::mt19937& gen, int length)
+	{
+		std::uniform_int_distribution<int> dist(0, 79);
+		QByteArray output;
+		for (int i=0; i<length; ++i)
+		{
+			int r = dist(gen);
+			output.append(r<4 ? 'N' : "ACGT"[r%4]);
+		}
+		return output;
+	}
+
+	//Returns a copy of the sequence with random mismatches (with the given probability)
+	static QByteArray addMismatches(std::mt19937& gen, QByteArray seq, double probability)
+	{
+		std::uniform_real_distribution<double> dist(0, 1);
+		for (int i=0; i<seq.count(); ++i)
+		{
+			if (dist(gen)<probability) seq[i] = seq[i]=='A' ? 'C' : 'A';
+		}
+		return seq;
+	}
+
+private slots:
+
+	void supportedImplementations()
+	{
+		QByteArrayList impls = MatchKernels::supportedImplementations();
+		IS_TRUE(impls.count()>=1);
+		S_EQUAL(impls.first(), MatchKernels::implementation());
+		S_EQUAL(impls.last(), QByteArray("scalar"));
+
+		IS_THROWN(ArgumentException, MatchKernels::compare("invalid", "ACGT", "ACGT", 4));
+	}
+
+	void compare_scalar()
+	{
+		MatchKernels::Counts counts = MatchKernels::compare("scalar", "ACGTNACGTA", "ACGTACGNTT", 10);
+		I_EQUAL(counts.matches, 5);
+		I_EQUAL(counts.mismatches, 3);
+		I_EQUAL(counts.invalid, 2);
+
+		//empty
+		counts = MatchKernels::compare("scalar", "", "", 0);
+		I_EQUAL(counts.matches, 0);
+		I_EQUAL(counts.mismatches, 0);
+		I_EQUAL(counts.invalid, 0);
+
+		//abort after too many mismatches
+		counts = MatchKernels::compare("scalar", "AAAAAAAAAA", "CCCCCCCCCC", 10, 2);
+		I_EQUAL(counts.mismatches, 3);
+	}
+
+	void compare_implementations()
+	{
+		std::mt19937 gen(42);
+		foreach(const QByteArray& impl, MatchKernels::supportedImplementations())
+		{
+			//lengths below, equal to and above the vector widths (16/32), with tails of all sizes
+			for (int length=0; length<=100; ++length)
+			{
+				foreach(double mismatch_prob, QList<double>() << 0.0 << 0.05 << 0.5)
+				{
+					//use offsets for unaligned data
+					QByteArray s1 = randomSequence(gen, length + 1);
+					QByteArray s2 = "NN" + addMismatches(gen, s1, mismatch_prob);
+					const char* p1 = s1.constData() + 1;
+					const char* p2 = s2.constData() + 3;
+
+					//without abort: identical counts
+					MatchKernels::Counts expected = MatchKernels::compare("scalar", p1, p2, length);
+					MatchKernels::Counts counts = MatchKernels::compare(impl, p1, p2, length);
+					I_EQUAL(counts.matches, expected.matches);
+					I_EQUAL(counts.mismatches, expected.mismatches);
+					I_EQUAL(counts.invalid, expected.invalid);
+
+					//with abort: identical counts if not aborted, otherwise more than the maximum mismatches
+					foreach(int max_mismatches, QList<int>() << 0 << 1 << 5)
+					{
+						expected = MatchKernels::compare("scalar", p1, p2, length, max_mismatches);
+						counts = MatchKernels::compare(impl, p1, p2, length, max_mismatches);
+						if (expected.mismatches>max_mismatches)
+						{
+							IS_TRUE(counts.mismatches>max_mismatches);
+						}
+						else
+						{
+							I_EQUAL(counts.matches, expected.matches);
+							I_EQUAL(counts.mismatches, expected.mismatches);
+							I_EQUAL(counts.invalid, expected.invalid);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	void reverseComplement_implementations()
+	{
+		std::mt19937 gen(42);
+		foreach(const QByteArray& impl, MatchKernels::supportedImplementations())
+		{
+			for (int length=0; length<=100; ++length)
+			{
+				QByteArray seq = randomSequence(gen, length + 1);
+				QByteArray expected = Sequence(seq.mid(1)).toReverseComplement();
+				QByteArray output(length, '-');
+				MatchKernels::reverseComplement(impl, seq.constData() + 1, output.data(), length);
+				S_EQUAL(output, expected);
+			}
+
+			//invalid bases in the vectorized part and in the tail
+			foreach(int pos, QList<int>() << 0 << 5 << 20 << 40 << 69)
+			{
+				QByteArray seq = randomSequence(gen, 70);
+				seq[pos] = 'X';
+				QByteArray output(seq.count(), '-');
+				IS_THROWN(ProgrammingException, MatchKernels::reverseComplement(impl, seq.constData(), output.data(), seq.count()));
+			}
+		}
+	}
+};
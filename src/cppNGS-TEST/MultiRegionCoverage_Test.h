@@ -0,0 +1,103 @@
+#include "TestFramework.h"
+#include "MultiRegionCoverage.h"
+#include "Statistics.h"
+
+TEST_CLASS(MultiRegionCoverage_Test)
+{
+Q_OBJECT
+private slots:
+
+	void superRegions()
+	{
+		BedFile bed_file;
+		bed_file.append(BedLine("chr1", 5000, 5100));
+		bed_file.append(BedLine("chr1", 1000, 1100));
+		bed_file.append(BedLine("chr1", 1500, 1600));
+		bed_file.append(BedLine("chr1", 2601, 2700));
+		bed_file.append(BedLine("chr2", 1000, 1100));
+
+		I_EQUAL(MultiRegionCoverage(bed_file).superRegionCount(), 3);
+		I_EQUAL(MultiRegionCoverage(bed_file, 999).superRegionCount(), 4);
+		I_EQUAL(MultiRegionCoverage(bed_file, 1000, 500).superRegionCount(), 5);
+		I_EQUAL(MultiRegionCoverage(bed_file, 5000).superRegionCount(), 2);
+		I_EQUAL(MultiRegionCoverage(BedFile()).superRegionCount(), 0);
+	}
+
+	void calculate()
+	{
+		BedFile bed_file;
+		bed_file.load(TESTDATA("data_in/panel.bed"));
+		bed_file.merge();
+
+		MultiRegionCoverage engine(bed_file);
+		IS_TRUE(engine.superRegionCount()<bed_file.count());
+		for (int threads=1; threads<=4; ++threads)
+		{
+			MultiRegionCoverageResult result = engine.calculate(TESTDATA("data_in/panel.bam"), 20, 20, 20, 0, threads);
+			result.low.merge(true, true, true);
+			I_EQUAL(result.low.count(), 450);
+			I_EQUAL(result.low.baseCount(), 16129);
+			result.high.merge(true, true, true);
+			I_EQUAL(result.high.count(), 1707);
+			I_EQUAL(result.high.baseCount(), 255407);
+			I_EQUAL(result.avg.count(), bed_file.count());
+			S_EQUAL(QString::number(result.avg[0], 'f', 2), QString("106.40"));
+		}
+	}
+
+	void calculate_cutoff_disabled()
+	{
+		BedFile bed_file;
+		bed_file.append(BedLine("chr1", 11013718, 11013975));
+		bed_file.append(BedLine("chr1", 11013718, 11013818));
+		bed_file.append(BedLine("chr1", 11013818, 11013975));
+
+		MultiRegionCoverageResult result = MultiRegionCoverage(bed_file).calculate(TESTDATA("data_in/panel.bam"), -1, -1, 20);
+		I_EQUAL(result.low.count(), 0);
+		I_EQUAL(result.high.count(), 0);
+		I_EQUAL(result.avg.count(), 3);
+		S_EQUAL(QString::number(result.avg[0], 'f', 2), QString("106.40"));
+		S_EQUAL(QString::number(result.avg[1], 'f', 2), QString("75.07"));
+		S_EQUAL(QString::number(result.avg[2], 'f', 2), QString("126.03"));
+	}
+
+	void calculate_long_regions()
+	{
+		BedFile bed_file;
+		bed_file.load(TESTDATA("data_in/panel.bed"));
+		bed_file.merge();
+
+		//target regions longer than the maximum span are processed in windows - the result is the same
+		MultiRegionCoverageResult expected = MultiRegionCoverage(bed_file).calculate(TESTDATA("data_in/panel.bam"), 20, 100, 1, 30, 2);
+		MultiRegionCoverageResult result = MultiRegionCoverage(bed_file, 1000, 50).calculate(TESTDATA("data_in/panel.bam"), 20, 100, 1, 30, 2);
+		I_EQUAL(result.low.count(), expected.low.count());
+		I_EQUAL(result.low.baseCount(), expected.low.baseCount());
+		I_EQUAL(result.high.count(), expected.high.count());
+		I_EQUAL(result.high.baseCount(), expected.high.baseCount());
+		I_EQUAL(result.avg.count(), expected.avg.count());
+		for (int i=0; i<expected.avg.count(); ++i)
+		{
+			F_EQUAL2(result.avg[i], expected.avg[i], 0.0001);
+		}
+	}
+
+	//compare with chromosome-wise sweep
+	void compare_with_sweep_min_baseq()
+	{
+		BedFile bed_file;
+		bed_file.load(TESTDATA("data_in/panel.bed"));
+		bed_file.merge();
+
+		MultiRegionCoverageResult result = MultiRegionCoverage(bed_file).calculate(TESTDATA("data_in/panel.bam"), 20, 100, 1, 30, 2);
+
+		BedFile expected = Statistics::lowCoverage(bed_file, TESTDATA("data_in/panel.bam"), 20, 1, 30, 1, QString(), false);
+		result.low.merge(true, true, true);
+		I_EQUAL(result.low.count(), expected.count());
+		I_EQUAL(result.low.baseCount(), expected.baseCount());
+
+		expected = Statistics::highCoverage(bed_file, TESTDATA("data_in/panel.bam"), 100, 1, 30, 1, QString(), false);
+		result.high.merge(true, true, true);
+		I_EQUAL(result.high.count(), expected.count());
+		I_EQUAL(result.high.baseCount(), expected.baseCount());
+	}
+};
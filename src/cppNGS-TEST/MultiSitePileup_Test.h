@@ -0,0 +1,144 @@
+#include "TestFramework.h"
+#include "MultiSitePileup.h"
+#include "BamReader.h"
+#include "BasicStatistics.h"
+
+TEST_CLASS(MultiSitePileup_Test)
+{
+Q_OBJECT
+private:
+
+	static bool pileupsEqual(const Pileup& p1, const Pileup& p2)
+	{
+		if (p1.a()!=p2.a() || p1.c()!=p2.c() || p1.g()!=p2.g() || p1.t()!=p2.t() || p1.n()!=p2.n()) return false;
+		if (p1.depth(true)!=p2.depth(true)) return false;
+		if (p1.indels()!=p2.indels()) return false;
+		if (BasicStatistics::isValidFloat(p1.mapq0Frac())!=BasicStatistics::isValidFloat(p2.mapq0Frac())) return false;
+		if (BasicStatistics::isValidFloat(p1.mapq0Frac()) && p1.mapq0Frac()!=p2.mapq0Frac()) return false;
+		return true;
+	}
+
+	//Compares the pileups of the engine with BamReader::getPileup for each site
+	static void compareWithGetPileup(const QString& bam_file, const QList<QPair<Chromosome, int>>& sites, int indel_window, bool anom)
+	{
+		MultiSitePileup engine;
+		for (int i=0; i<sites.count(); ++i)
+		{
+			I_EQUAL(engine.addSite(sites[i].first, sites[i].second), i);
+		}
+		I_EQUAL(engine.siteCount(), sites.count());
+
+		BamReader reader(bam_file);
+		QVector<Pileup> pileups = engine.calculate(reader, indel_window, 1, anom);
+		I_EQUAL(pileups.count(), sites.count());
+		for (int i=0; i<sites.count(); ++i)
+		{
+			IS_TRUE(pileupsEqual(pileups[i], reader.getPileup(sites[i].first, sites[i].second, indel_window, 1, anom)));
+		}
+
+		for (int threads=1; threads<=3; ++threads)
+		{
+			QVector<Pileup> pileups_mt = engine.calculate(bam_file, QString(), threads, indel_window, 1, anom);
+			I_EQUAL(pileups_mt.count(), sites.count());
+			for (int i=0; i<sites.count(); ++i)
+			{
+				IS_TRUE(pileupsEqual(pileups_mt[i], pileups[i]));
+			}
+		}
+	}
+
+private slots:
+
+	void calculate()
+	{
+		//unsorted sites, with duplicates and different chromosome notations
+		MultiSitePileup engine;
+		engine.addSite("chr14", 53046761);
+		engine.addSite("chr1", 12002148);
+		engine.addSite("1", 12002124);
+		engine.addSite("chr6", 109732622);
+		engine.addSite("chr1", 12002123);
+		engine.addSite("chr1", 12002148);
+
+		BamReader reader(TESTDATA("data_in/panel.bam"));
+		QVector<Pileup> pileups = engine.calculate(reader, 1);
+		I_EQUAL(pileups.count(), 6);
+		//DELETION
+		I_EQUAL(pileups[0].depth(false), 52);
+		I_EQUAL(pileups[0].a(), 52);
+		I_EQUAL(pileups[0].indels().count(), 14);
+		//SNP
+		I_EQUAL(pileups[1].depth(false), 117);
+		F_EQUAL2(pileups[1].frequency('A', 'G'), 0.410, 0.001);
+		I_EQUAL(pileups[1].indels().count(), 0);
+		//SNP
+		I_EQUAL(pileups[2].depth(false), 167);
+		F_EQUAL2(pileups[2].frequency('G', 'A'), 1.0, 0.001);
+		//INSERTATION
+		I_EQUAL(pileups[3].depth(false), 40);
+		I_EQUAL(pileups[3].t(), 40);
+		I_EQUAL(pileups[3].indels().count(), 27);
+		//SNP
+		I_EQUAL(pileups[4].depth(false), 167);
+		IS_TRUE(!BasicStatistics::isValidFloat(pileups[4].frequency('A', 'T')));
+		//duplicate site
+		IS_TRUE(pileupsEqual(pileups[5], pileups[1]));
+	}
+
+	void calculate_no_sites()
+	{
+		MultiSitePileup engine;
+		BamReader reader(TESTDATA("data_in/panel.bam"));
+		I_EQUAL(engine.calculate(reader).count(), 0);
+		I_EQUAL(engine.calculate(TESTDATA("data_in/panel.bam"), QString(), 4).count(), 0);
+	}
+
+	void compare_with_getPileup()
+	{
+		//dense and sparse sites in the target region (including sites without coverage)
+		BedFile bed_file;
+		bed_file.load(TESTDATA("data_in/panel.bed"));
+		bed_file.merge();
+		QList<QPair<Chromosome, int>> sites;
+		for (int i=0; i<bed_file.count(); i+=5)
+		{
+			const BedLine& line = bed_file[i];
+			for (int pos=line.start()-200; pos<=line.end()+200; pos+=(i%2==0 ? 3 : 97))
+			{
+				sites << qMakePair(line.chr(), pos);
+			}
+		}
+
+		compareWithGetPileup(TESTDATA("data_in/panel.bam"), sites, -1, false);
+		compareWithGetPileup(TESTDATA("data_in/panel.bam"), sites, 10, true);
+	}
+
+	//RNA contains the CIGAR operations S and N
+	void compare_with_getPileup_RNA()
+	{
+		QList<QPair<Chromosome, int>> sites;
+		for (int pos=90974627; pos<=90974827; ++pos)
+		{
+			sites << qMakePair(Chromosome("chr10"), pos);
+		}
+		for (int pos=92675187; pos<=92675387; ++pos)
+		{
+			sites << qMakePair(Chromosome("chr10"), pos);
+		}
+		sites << qMakePair(Chromosome("chr11"), 92675295);
+
+		compareWithGetPileup(TESTDATA("data_in/BamReader_rna.bam"), sites, 10, false);
+	}
+
+	//reads consisting of insertions only
+	void compare_with_getPileup_insert_only()
+	{
+		QList<QPair<Chromosome, int>> sites;
+		for (int pos=5787114; pos<=5787314; ++pos)
+		{
+			sites << qMakePair(Chromosome("chr19"), pos);
+		}
+
+		compareWithGetPileup(TESTDATA("data_in/BamReader_insert_only.bam"), sites, -1, false);
+	}
+};
@@ -359,6 +359,64 @@ private slots:
 		IS_TRUE(gff.transcripts.contains("XR_007057951")); //predicted by Gnomon
 	}
 
+	void storeGffDatabase()
+	{
+		GffSettings settings;
+		settings.print_to_stdout = false;
+		settings.include_all = true;
+		GffData gff = NGSHelper::loadGffFile(TESTDATA("data_in/NGSHelper_loadGffFile_in1.gff3"), settings);
+		gff.transcripts.sortByPosition();
+
+		QString db_file = Helper::tempFileName(".transcripts");
+		NGSHelper::storeGffDatabase(db_file, gff, settings);
+		IS_TRUE(NGSHelper::isGffDatabase(db_file));
+		IS_FALSE(NGSHelper::isGffDatabase(TESTDATA("data_in/NGSHelper_loadGffFile_in1.gff3")));
+		IS_FALSE(NGSHelper::isGffDatabase(TESTDATA("data_in/NGSHelper_loadGffFile_in2.gff3.gz")));
+
+		//compare with GFF data
+		GffData db = NGSHelper::loadGffFile(db_file, settings);
+		I_EQUAL(db.transcripts.count(), gff.transcripts.count());
+		for (int i=0; i<gff.transcripts.count(); ++i)
+		{
+			const Transcript& t1 = gff.transcripts[i];
+			const Transcript& t2 = db.transcripts[i];
+			S_EQUAL(t2.name(), t1.name());
+			I_EQUAL(t2.version(), t1.version());
+			S_EQUAL(t2.nameCcds(), t1.nameCcds());
+			S_EQUAL(t2.gene(), t1.gene());
+			S_EQUAL(t2.geneId(), t1.geneId());
+			S_EQUAL(t2.hgncId(), t1.hgncId());
+			I_EQUAL(t2.source(), t1.source());
+			I_EQUAL(t2.strand(), t1.strand());
+			I_EQUAL(t2.biotype(), t1.biotype());
+			S_EQUAL(t2.chr().str(), t1.chr().str());
+			I_EQUAL(t2.start(), t1.start());
+			I_EQUAL(t2.end(), t1.end());
+			IS_TRUE(t2.isPreferredTranscript()==t1.isPreferredTranscript());
+			IS_TRUE(t2.isGencodeBasicTranscript()==t1.isGencodeBasicTranscript());
+			IS_TRUE(t2.isEnsemblCanonicalTranscript()==t1.isEnsemblCanonicalTranscript());
+			IS_TRUE(t2.isManeSelectTranscript()==t1.isManeSelectTranscript());
+			IS_TRUE(t2.isManePlusClinicalTranscript()==t1.isManePlusClinicalTranscript());
+			I_EQUAL(t2.codingStart(), t1.codingStart());
+			I_EQUAL(t2.codingEnd(), t1.codingEnd());
+			I_EQUAL(t2.regions().count(), t1.regions().count());
+			I_EQUAL(t2.regions().baseCount(), t1.regions().baseCount());
+			I_EQUAL(t2.codingRegions().count(), t1.codingRegions().count());
+			I_EQUAL(t2.codingRegions().baseCount(), t1.codingRegions().baseCount());
+			I_EQUAL(t2.utr5prime().baseCount(), t1.utr5prime().baseCount());
+			I_EQUAL(t2.utr3prime().baseCount(), t1.utr3prime().baseCount());
+		}
+		IS_TRUE(db.enst2ensg==gff.enst2ensg);
+		IS_TRUE(db.ensg2symbol==gff.ensg2symbol);
+
+		//different settings
+		settings.include_all = false;
+		IS_THROWN(ArgumentException, NGSHelper::loadGffFile(db_file, settings));
+		settings.include_all = true;
+		settings.source = "refseq";
+		IS_THROWN(ArgumentException, NGSHelper::loadGffFile(db_file, settings));
+	}
+
 	void maxEntScanImpact()
 	{
 		QByteArrayList score_pairs;
@@ -57,4 +57,51 @@ private slots:
 			IS_TRUE(result[i].description()!="");
 		}
 	}
+
+	void merge()
+	{
+		//split reads between two instances
+		StatisticsReads stats1;
+		StatisticsReads stats2;
+		FastqEntry e;
+		int i = 0;
+		FastqFileStream stream(TESTDATA("data_in/example6.fastq.gz"), false);
+		while(!stream.atEnd())
+		{
+			stream.readEntry(e);
+			if (i%3==0) stats1.update(e, StatisticsReads::FORWARD);
+			else stats2.update(e, StatisticsReads::FORWARD);
+			++i;
+		}
+		FastqFileStream stream2(TESTDATA("data_in/example7.fastq.gz"), false);
+		while(!stream2.atEnd())
+		{
+			stream2.readEntry(e);
+			if (i%3==0) stats1.update(e, StatisticsReads::REVERSE);
+			else stats2.update(e, StatisticsReads::REVERSE);
+			++i;
+		}
+		stats1.merge(stats2);
+
+		QCCollection result = stats1.getResult();
+		S_EQUAL(result[0].name(), QString("read count"));
+		S_EQUAL(result[0].toString(), QString("5000"));
+		S_EQUAL(result[1].name(), QString("read length"));
+		S_EQUAL(result[1].toString(), QString("151"));
+		S_EQUAL(result[2].name(), QString("bases sequenced (MB)"));
+		S_EQUAL(result[2].toString(), QString("0.76"));
+		S_EQUAL(result[3].name(), QString("Q20 read percentage"));
+		S_EQUAL(result[3].toString(), QString("99.40"));
+		S_EQUAL(result[4].name(), QString("Q30 base percentage"));
+		S_EQUAL(result[4].toString(), QString("96.30"));
+		S_EQUAL(result[5].name(), QString("no base call percentage"));
+		S_EQUAL(result[5].toString(), QString("0.00"));
+		S_EQUAL(result[6].name(), QString("gc content percentage"));
+		S_EQUAL(result[6].toString(), QString("46.26"));
+		S_EQUAL(result[10].name(), QString("median base Q score"));
+		I_EQUAL(result[10].asInt(), 39);
+		S_EQUAL(result[11].name(), QString("mode base Q score"));
+		I_EQUAL(result[11].asInt(), 39);
+		I_EQUAL(result.count(), 12);
+	}
 };
@@ -456,6 +456,45 @@ TEST_CLASS(Statistics_Test)
 		I_EQUAL(stats.count(), 23);
 	}
 
+	void mapping_threads()
+	{
+		QString ref_file = Settings::string("reference_genome", true);
+		if (ref_file=="") SKIP("Test needs the reference genome!");
+
+		//target region
+		BedFile bed_file;
+		bed_file.load(TESTDATA("data_in/cfDNA.bed"));
+		bed_file.merge();
+		QCCollection stats = Statistics::mapping(bed_file, TESTDATA("data_in/cfDNA.bam"), ref_file, 1, true);
+		QCCollection stats_threads = Statistics::mapping(bed_file, TESTDATA("data_in/cfDNA.bam"), ref_file, 1, true, 4);
+		I_EQUAL(stats_threads.count(), stats.count());
+		for (int i=0; i<stats.count(); ++i)
+		{
+			S_EQUAL(stats_threads[i].name(), stats[i].name());
+			if (stats[i].type()!=QCValueType::IMAGE) S_EQUAL(stats_threads[i].toString(8), stats[i].toString(8));
+		}
+
+		//genome
+		stats = Statistics::mapping(TESTDATA("data_in/close_exons.bam"), 1, ref_file);
+		stats_threads = Statistics::mapping(TESTDATA("data_in/close_exons.bam"), 1, ref_file, 4);
+		I_EQUAL(stats_threads.count(), stats.count());
+		for (int i=0; i<stats.count(); ++i)
+		{
+			S_EQUAL(stats_threads[i].name(), stats[i].name());
+			if (stats[i].type()!=QCValueType::IMAGE) S_EQUAL(stats_threads[i].toString(8), stats[i].toString(8));
+		}
+
+		//WGS with roi
+		stats = Statistics::mapping_wgs(TESTDATA("data_in/Statistics_mapqc_wgs.bam"), TESTDATA("data_in/Statistics_mapqc_wgs.bed"), 1, ref_file);
+		stats_threads = Statistics::mapping_wgs(TESTDATA("data_in/Statistics_mapqc_wgs.bam"), TESTDATA("data_in/Statistics_mapqc_wgs.bed"), 1, ref_file, 4);
+		I_EQUAL(stats_threads.count(), stats.count());
+		for (int i=0; i<stats.count(); ++i)
+		{
+			S_EQUAL(stats_threads[i].name(), stats[i].name());
+			if (stats[i].type()!=QCValueType::IMAGE) S_EQUAL(stats_threads[i].toString(8), stats[i].toString(8));
+		}
+	}
+
 	void mapping_cfdna()
 	{
 		QString ref_file = Settings::string("reference_genome", true);
@@ -44,6 +44,87 @@ private slots:
 		I_EQUAL(lines.count(), 42);
 	}
 
+	void cursor()
+	{
+		TabixIndexedFile file;
+		file.load(TESTDATA("data_in/TabixIndexedFile_in1.vcf.gz"));
+		TabixIndexedFileCursor cursor(file);
+
+		Chromosome chr("chr1");
+		QByteArrayList lines = cursor.getLinesAt(chr, 17385);
+		I_EQUAL(lines.count(), 1);
+		S_EQUAL(lines[0], "chr1	17385	.	G	A	111	.	MQM=26;SAP=42;ABP=24	GT:DP:AO:GQ	0/1:60:18:110");
+
+		//multi-allelic
+		lines = cursor.getLinesAt(chr, 1312198);
+		I_EQUAL(lines.count(), 2);
+		S_EQUAL(lines[0], "chr1	1312198	.	T	TGG	153	off-target	MQM=60;SAP=20;ABP=4	GT:DP:AO:GQ	0/1:14:8:7");
+		S_EQUAL(lines[1], "chr1	1312198	.	T	TGGGGG	153	off-target	MQM=60;SAP=10;ABP=13	GT:DP:AO:GQ	0/1:14:3:7");
+
+		//same position again
+		lines = cursor.getLinesAt(chr, 1312198);
+		I_EQUAL(lines.count(), 2);
+
+		//position without variant
+		lines = cursor.getLinesAt(chr, 3831038);
+		I_EQUAL(lines.count(), 0);
+
+		lines = cursor.getLinesAt(chr, 3831039);
+		I_EQUAL(lines.count(), 1);
+		S_EQUAL(lines[0], "chr1	3831039	.	T	C	1286	.	MQM=60;SAP=88;ABP=0	GT:DP:AO:GQ	1/1:43:43:148");
+
+		lines = cursor.getLinesAt(chr, 3836572);
+		I_EQUAL(lines.count(), 1);
+		S_EQUAL(lines[0], "chr1	3836572	.	A	T	7952	.	MQM=60;SAP=19;ABP=0	GT:DP:AO:GQ	1/1:247:247:160");
+
+		//last variant
+		lines = cursor.getLinesAt(chr, 6554355);
+		I_EQUAL(lines.count(), 1);
+		S_EQUAL(lines[0], "chr1	6554355	.	A	G	3086	.	MQM=60;SAP=10;ABP=0	GT:DP:AO:GQ	1/1:95:95:160");
+
+		//after last variant
+		lines = cursor.getLinesAt(chr, 6554356);
+		I_EQUAL(lines.count(), 0);
+
+		//unsorted query
+		lines = cursor.getLinesAt(chr, 17385);
+		I_EQUAL(lines.count(), 1);
+		S_EQUAL(lines[0], "chr1	17385	.	G	A	111	.	MQM=26;SAP=42;ABP=24	GT:DP:AO:GQ	0/1:60:18:110");
+
+		//missing chromosome
+		lines = cursor.getLinesAt(Chromosome("chr2"), 17385, true);
+		I_EQUAL(lines.count(), 0);
+		IS_THROWN(ProgrammingException, cursor.getLinesAt(Chromosome("chr2"), 17385));
+	}
+
+	void copy()
+	{
+		TabixIndexedFile file;
+		file.load(TESTDATA("data_in/TabixIndexedFile_in1.vcf.gz"));
+
+		//copies share the index, but have their own file handle
+		TabixIndexedFile copy(file);
+		TabixIndexedFile copy2;
+		copy2 = file;
+		TabixIndexedFileCursor cursor(file);
+		file.clear();
+
+		Chromosome chr("chr1");
+		QByteArrayList lines = copy.getMatchingLines(chr, 3831039, 3836572);
+		I_EQUAL(lines.count(), 3);
+		S_EQUAL(lines[2], "chr1	3836572	.	A	T	7952	.	MQM=60;SAP=19;ABP=0	GT:DP:AO:GQ	1/1:247:247:160");
+		lines = copy2.getMatchingLines(chr, 3752608, 5888617);
+		I_EQUAL(lines.count(), 42);
+		lines = copy.getMatchingLines(chr, 17384, 17386);
+		I_EQUAL(lines.count(), 1);
+		lines = cursor.getLinesAt(chr, 17385);
+		I_EQUAL(lines.count(), 1);
+
+		//copy of a file that is not loaded
+		TabixIndexedFile copy3(file);
+		IS_THROWN(ProgrammingException, copy3.getMatchingLines(chr, 17384, 17386));
+	}
+
 	void broken_index()
 	{
 		TabixIndexedFile file;
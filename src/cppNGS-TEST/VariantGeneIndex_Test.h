@@ -0,0 +1,58 @@
+#include "TestFramework.h"
+#include "VariantGeneIndex.h"
+#include "VariantList.h"
+
+TEST_CLASS(VariantGeneIndex_Test)
+{
+Q_OBJECT
+private slots:
+
+	void genes()
+	{
+		VariantList vl;
+		vl.load(TESTDATA("data_in/VariantFilter_in.GSvar"));
+
+		const VariantGeneIndex& index = vl.geneIndex();
+		I_EQUAL(index.count(), 143);
+		I_EQUAL(index.genes().count(), 66);
+		I_EQUAL(index.rowsWithGene("KANK4").count(true), 12);
+		I_EQUAL(index.rowsWithGene("MAP3K6").count(true), 1);
+		IS_TRUE(index.rowsWithGene("MAP3K6").testBit(0));
+		I_EQUAL(index.rowsWithGene("NOT_A_GENE").count(true), 0);
+		I_EQUAL(index.rowsWithGene("NOT_A_GENE").count(), 143);
+		I_EQUAL(index.rowsWithGenes(GeneSet() << "KANK4" << "MAP3K6").count(true), 13);
+	}
+
+	void gene_info()
+	{
+		VariantList vl;
+		vl.load(TESTDATA("data_in/VariantFilter_in.GSvar"));
+
+		const VariantGeneIndex& index = vl.geneIndex();
+		I_EQUAL(index.rowsWithInheritance("AD").count(true), 19);
+		I_EQUAL(index.rowsWithInheritance("AR").count(true), 28);
+		I_EQUAL((index.rowsWithInheritance("AD") | index.rowsWithInheritance("AR")).count(true), 44);
+
+		//DDX11L1 (inh=n/a pLI=n/a oe_lof=0.1)
+		F_EQUAL(index.maxPli(0), 0.0);
+		F_EQUAL(index.minOeLof(0), 0.1);
+	}
+
+	void omim()
+	{
+		VariantList vl;
+		vl.load(TESTDATA("data_in/VariantFilter_in.GSvar"));
+		I_EQUAL(vl.geneIndex().rowsWithOmim().count(true), 108);
+
+		//index is updated when an OMIM annotation is changed
+		int i_omim = vl.annotationIndexByName("OMIM");
+		int row = 0;
+		while (!vl.geneIndex().rowsWithOmim().testBit(row)) ++row;
+		vl.setAnnotation(row, i_omim, "");
+		I_EQUAL(vl.geneIndex().rowsWithOmim().count(true), 107);
+
+		//index is invalidated when the variant list is modified
+		vl.removeAnnotationByName("OMIM");
+		I_EQUAL(vl.geneIndex().rowsWithOmim().count(true), 0);
+	}
+};
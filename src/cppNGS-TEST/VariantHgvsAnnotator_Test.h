@@ -1358,6 +1358,42 @@ private slots:
 		I_EQUAL(hgvs.intron_number, -1);
 	}
 
+	void sequence_cache()
+	{
+		QString ref_file = Settings::string("reference_genome", true);
+		if (ref_file=="") SKIP("Test needs the reference genome!");
+		FastaFileIndex reference(ref_file);
+
+		TranscriptSequenceCache cache;
+		VariantHgvsAnnotator var_hgvs_anno(reference, VariantHgvsAnnotator::Parameters(5000, 3, 8, 8));
+		VariantHgvsAnnotator var_hgvs_anno_cached(reference, VariantHgvsAnnotator::Parameters(5000, 3, 8, 8), &cache);
+
+		//SNVs in all coding exons of a plus-strand and a minus-strand transcript
+		QList<Transcript> transcripts = QList<Transcript>() << trans_SLC51A() << trans_APOD();
+		foreach(const Transcript& t, transcripts)
+		{
+			const BedFile& coding_regions = t.codingRegions();
+			for (int i=0; i<coding_regions.count(); ++i)
+			{
+				for (int pos=coding_regions[i].start(); pos<=coding_regions[i].end(); pos+=7)
+				{
+					Sequence ref = reference.seq(t.chr(), pos, 1);
+					VcfLine variant(t.chr(), pos, ref, QList<Sequence>() << (ref=="A" ? "C" : "A"));
+					VariantConsequence hgvs = var_hgvs_anno.annotate(t, variant);
+					VariantConsequence hgvs_cached = var_hgvs_anno_cached.annotate(t, variant);
+					S_EQUAL(hgvs_cached.hgvs_c, hgvs.hgvs_c);
+					S_EQUAL(hgvs_cached.hgvs_p, hgvs.hgvs_p);
+					S_EQUAL(hgvs_cached.typesToString(), hgvs.typesToString());
+				}
+			}
+		}
+
+		//each transcript sequence is assembled once
+		I_EQUAL(cache.misses(), 2);
+		IS_TRUE(cache.hits()>100);
+		IS_TRUE(cache.hitPercentage()>95.0);
+	}
+
 	//TODO Marc: Error processing variant chr7:157009949 A>CGCGGCGGCG and transcript ENST00000252971.11: Coding sequence length must be multiple of three. (1 times, e.g. in DNA2206556A1_02)
 	//TODO Marc: Error processing variant chr17:31229232 CGTA>TGTC: Coding sequence length must be multiple of three
 };
@@ -433,4 +433,71 @@ private slots:
 		vl.load(TESTDATA("data_in/VariantFilter_in_multi.GSvar"));
 		IS_FALSE(vl.getCallingDate().isValid());
 	}
+
+	void column()
+	{
+		VariantList vl;
+		vl.append(Variant(Chromosome("chr1"), 1, 2, "A", "C"));
+		vl.append(Variant(Chromosome("chr2"), 1, 2, "A", "C"));
+		vl.append(Variant(Chromosome("chr3"), 1, 2, "A", "C"));
+		vl.addAnnotation("name", "desc", "");
+		vl[0].annotations()[0] = "0.25";
+		vl[1].annotations()[0] = "n/a";
+		vl[2].annotations()[0] = "7";
+
+		const VariantList& vl_const = vl;
+		const VariantAnnotationColumn& column = vl_const.column(0);
+		I_EQUAL(column.count(), 3);
+		I_EQUAL(column.length(0), 4);
+		S_EQUAL(column.value(0), "0.25");
+		S_EQUAL(column.value(1), "n/a");
+		S_EQUAL(column.value(2), "7");
+		IS_TRUE(column.equals(1, "n/a"));
+		IS_FALSE(column.equals(1, "n/a2"));
+
+		//numeric values
+		bool ok;
+		F_EQUAL(column.toDouble(0, &ok), 0.25);
+		IS_TRUE(ok);
+		F_EQUAL(column.toDouble(1, &ok), 0.0);
+		IS_FALSE(ok);
+		I_EQUAL(column.toInt(0, &ok), 0);
+		IS_FALSE(ok);
+		I_EQUAL(column.toInt(2, &ok), 7);
+		IS_TRUE(ok);
+
+		//cache is kept by non-const variant access
+		IS_TRUE(&vl_const.column(0)==&column);
+		IS_TRUE(vl[2].annotations()[0]=="7");
+		IS_TRUE(&vl_const.column(0)==&column);
+
+		//cache is updated by setAnnotation
+		vl.setAnnotation(2, 0, "8");
+		S_EQUAL(vl[2].annotations()[0], "8");
+		S_EQUAL(vl_const.column(0).value(2), "8");
+
+		//invalid index
+		IS_THROWN(ProgrammingException, vl_const.column(1));
+	}
+
+	void column_compare_with_rows()
+	{
+		VariantList vl;
+		vl.load(TESTDATA("data_in/panel_vep.GSvar"));
+		const VariantList& vl_const = vl;
+
+		for (int c=0; c<vl_const.annotations().count(); ++c)
+		{
+			const VariantAnnotationColumn& column = vl_const.column(c);
+			I_EQUAL(column.count(), vl.count());
+			for (int i=0; i<vl.count(); ++i)
+			{
+				const QByteArray& value = vl_const[i].annotations()[c];
+				S_EQUAL(column.value(i), value);
+				IS_TRUE(column.equals(i, value));
+				F_EQUAL(column.toDouble(i), value.toDouble());
+				I_EQUAL(column.toInt(i), value.toInt());
+			}
+		}
+	}
 };
@@ -709,4 +709,101 @@ private slots:
 		COMPARE_FILES("out/panel_vep_loadStore.vcf", TESTDATA("data_in/panel_vep.vcf"));
     }
 
+	void loadFromVCF_lazyDecoding()
+	{
+		foreach(bool allow_multi_sample, QList<bool>() << true << false)
+		{
+			VcfFile vl;
+			vl.load(TESTDATA("data_in/VcfFileHandler_in.vcf"), allow_multi_sample);
+
+			VcfFile vl_lazy;
+			vl_lazy.setLazyDecoding(true);
+			IS_TRUE(vl_lazy.lazyDecoding());
+			vl_lazy.load(TESTDATA("data_in/VcfFileHandler_in.vcf"), allow_multi_sample);
+
+			//header (undeclared INFO entries are added during loading)
+			I_EQUAL(vl_lazy.count(), vl.count());
+			I_EQUAL(vl_lazy.vcfHeader().infoLines().count(), vl.vcfHeader().infoLines().count());
+			I_EQUAL(vl_lazy.vcfHeader().formatLines().count(), vl.vcfHeader().formatLines().count());
+			I_EQUAL(vl_lazy.vcfHeader().filterLines().count(), vl.vcfHeader().filterLines().count());
+			S_EQUAL(vl_lazy.sampleIDs().join(","), vl.sampleIDs().join(","));
+
+			//variants
+			for (int i=0; i<vl.count(); ++i)
+			{
+				IS_FALSE(vl_lazy[i].rawSamples().isEmpty());
+				IS_TRUE(vl_lazy[i]==vl[i]);
+				S_EQUAL(vl_lazy[i].filters().join(","), vl[i].filters().join(","));
+				S_EQUAL(vl_lazy[i].infoKeys().join(","), vl[i].infoKeys().join(","));
+				foreach(const QByteArray& key, vl[i].infoKeys())
+				{
+					S_EQUAL(vl_lazy[i].info(key), vl[i].info(key));
+				}
+				S_EQUAL(vl_lazy[i].formatKeys().join(":"), vl[i].formatKeys().join(":"));
+				I_EQUAL(vl_lazy[i].samples().count(), vl[i].samples().count());
+				for (int s=0; s<vl[i].samples().count(); ++s)
+				{
+					S_EQUAL(vl_lazy[i].sample(s).join(":"), vl[i].sample(s).join(":"));
+				}
+				IS_TRUE(vl_lazy[i].rawSamples().isEmpty());
+			}
+		}
+	}
+
+	void loadStoreComparison_lazyDecoding()
+	{
+		//untouched lines
+		VcfFile vcf_file;
+		vcf_file.setLazyDecoding(true);
+		vcf_file.load(TESTDATA("data_in/panel_vep.vcf"));
+		vcf_file.store("out/panel_vep_loadStore_lazy.vcf");
+		COMPARE_FILES("out/panel_vep_loadStore_lazy.vcf", TESTDATA("data_in/panel_vep.vcf"));
+
+		vcf_file.load(TESTDATA("data_in/VariantList_loadFromVCF_emptyInfoAndFormat.vcf"));
+		vcf_file.store("out/VariantList_loadFromVCF_emptyInfoAndFormat_lazy.vcf", false, BGZF_NO_COMPRESSION);
+		COMPARE_FILES("out/VariantList_loadFromVCF_emptyInfoAndFormat_lazy.vcf", TESTDATA("data_in/VariantList_loadFromVCF_emptyInfoAndFormat.vcf"));
+
+		//output is the same as without lazy decoding (also with undeclared annotations, single-sample mode and decoded lines)
+		foreach(bool allow_multi_sample, QList<bool>() << true << false)
+		{
+			VcfFile vl;
+			vl.load(TESTDATA("data_in/VcfFileHandler_in.vcf"), allow_multi_sample);
+			vl.store("out/VcfFileHandler_loadStore.vcf");
+
+			VcfFile vl_lazy;
+			vl_lazy.setLazyDecoding(true);
+			vl_lazy.load(TESTDATA("data_in/VcfFileHandler_in.vcf"), allow_multi_sample);
+			vl_lazy.store("out/VcfFileHandler_loadStore_lazy.vcf");
+			COMPARE_FILES("out/VcfFileHandler_loadStore_lazy.vcf", "out/VcfFileHandler_loadStore.vcf");
+
+			vl_lazy[0].samples();
+			vl_lazy[1].info("SGT");
+			vl_lazy.store("out/VcfFileHandler_loadStore_lazy.vcf");
+			COMPARE_FILES("out/VcfFileHandler_loadStore_lazy.vcf", "out/VcfFileHandler_loadStore.vcf");
+		}
+	}
+
+	void loadFromVCF_lazyDecoding_invalidSample()
+	{
+		QByteArray text = "##fileformat=VCFv4.2\n"
+						  "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\tFORMAT\tS1\n"
+						  "chr1\t100\t.\tA\tG\t30\tPASS\tDP=5\tGT:DP\t0/1:5:7\n";
+
+		//error during loading
+		VcfFile vl;
+		IS_THROWN(FileParseException, vl.fromText(text));
+
+		//error during loading, although sample columns are not decoded
+		VcfFile vl_lazy;
+		vl_lazy.setLazyDecoding(true);
+		IS_THROWN(FileParseException, vl_lazy.fromText(text));
+
+		//also with several samples
+		text = "##fileformat=VCFv4.2\n"
+			   "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\tFORMAT\tS1\tS2\n"
+			   "chr1\t100\t.\tA\tG\t30\tPASS\tDP=5\tGT:DP\t0/1:5\t0/1\n";
+		IS_THROWN(FileParseException, vl.fromText(text));
+		IS_THROWN(FileParseException, vl_lazy.fromText(text));
+	}
+
 };
@@ -44,10 +44,19 @@ HEADERS += \
     Chromosome_Test.h \
     BedLine_Test.h \
     BedFile_Test.h \
+    BedFileSweepCursor_Test.h \
     VariantList_Test.h \
+    VariantGeneIndex_Test.h \
     FilterCascade_Test.h \
     ChromosomalIndex_Test.h \
+    ChromosomalIntervalTree_Test.h \
     Statistics_Test.h \
+    MultiRegionCoverage_Test.h \
+    MultiSitePileup_Test.h \
+    GenotypeFingerprint_Test.h \
+    CoverageCache_Test.h \
+    BamMateCache_Test.h \
+    MatchKernels_Test.h \
     Variant_Test.h \
     NGSHelper_Test.h \
     FastqFileStream_Test.h \
@@ -0,0 +1,399 @@
+#include "BamMateCache.h"
+#include "Exceptions.h"
+#include "Helper.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+//Maximum size of the memory blocks alignments are stored in
+static const int BLOCK_SIZE = 16 * 1024 * 1024;
+//Size of the record header (id and data size)
+static const int RECORD_HEADER_SIZE = sizeof(quint64) + sizeof(qint32);
+//Id of records that were removed from the cache
+static const quint64 RELEASED_ID = std::numeric_limits<quint64>::max();
+
+BamMateCache::BamMateCache(qint64 max_memory)
+	: max_memory_(max_memory)
+	, block_size_((int)std::min((qint64)BLOCK_SIZE, max_memory / 16))
+	, memory_(0)
+	, live_memory_(0)
+	, next_id_(0)
+	, count_(0)
+	, peak_count_(0)
+	, peak_memory_(0)
+	, spilled_count_(0)
+	, finished_(false)
+	, group_pos_(0)
+{
+	if (max_memory<=0) THROW(ArgumentException, "Invalid maximum memory for BamMateCache: " + QString::number(max_memory));
+}
+
+BamMateCache::~BamMateCache()
+{
+	for (int i=0; i<runs_.count(); ++i)
+	{
+		runs_[i].file.clear();
+		QFile::remove(runs_[i].filename);
+	}
+}
+
+bool BamMateCache::takeMate(const BamAlignment& al, BamAlignment& mate)
+{
+	if (finished_) THROW(ProgrammingException, "Cannot add alignments to BamMateCache after finish() was called!");
+
+	//look up mate
+	const char* name = bam_get_qname(al.aln_);
+	const quint64 hash = nameHash(name);
+	QMultiHash<quint64, Entry>::iterator it = index_.find(hash);
+	while (it!=index_.end() && it.key()==hash)
+	{
+		const char* record = recordData(it.value());
+		if (strcmp(recordName(record), name)==0)
+		{
+			recordToAlignment(record, mate);
+			Entry entry = it.value();
+			index_.erase(it);
+			release(entry);
+			--count_;
+			return true;
+		}
+		++it;
+	}
+
+	//add alignment
+	index_.insert(hash, store(al));
+	++count_;
+	peak_count_ = std::max(peak_count_, (long long)index_.count());
+
+	//write alignments to temporary file if the memory limit is exceeded
+	if (live_memory_>max_memory_)
+	{
+		spilled_count_ += index_.count();
+		spill();
+	}
+
+	return false;
+}
+
+void BamMateCache::finish()
+{
+	if (finished_) return;
+	finished_ = true;
+
+	//no temporary files > return alignments in memory in insertion order
+	if (runs_.isEmpty())
+	{
+		remaining_ = index_.values().toVector();
+		std::sort(remaining_.begin(), remaining_.end(), [this](const Entry& a, const Entry& b)
+		{
+			return recordId(recordData(a)) < recordId(recordData(b));
+		});
+		index_.clear();
+		return;
+	}
+
+	//write remaining alignments to a temporary file as well and merge all temporary files
+	if (!index_.isEmpty()) spill();
+	for (int i=0; i<runs_.count(); ++i)
+	{
+		Run& run = runs_[i];
+		run.file = QSharedPointer<QFile>(new QFile(run.filename));
+		if (!run.file->open(QFile::ReadOnly))
+		{
+			THROW(FileAccessException, "Could not open temporary file " + run.filename + " for reading: " + run.file->errorString());
+		}
+		readRecord(run);
+	}
+}
+
+int BamMateCache::takeRemaining(BamAlignment& al1, BamAlignment& al2)
+{
+	if (!finished_) THROW(ProgrammingException, "BamMateCache::finish() has to be called before BamMateCache::takeRemaining()!");
+
+	//alignments in memory
+	if (runs_.isEmpty())
+	{
+		if (group_pos_>=remaining_.count()) return 0;
+
+		recordToAlignment(recordData(remaining_[group_pos_]), al1);
+		++group_pos_;
+		--count_;
+		return 1;
+	}
+
+	//alignments in temporary files
+	if (group_pos_>=group_.count())
+	{
+		group_.clear();
+		group_pos_ = 0;
+		if (!readGroup()) return 0;
+	}
+	recordToAlignment(group_[group_pos_].constData(), al1);
+	if (group_.count()-group_pos_>=2)
+	{
+		recordToAlignment(group_[group_pos_+1].constData(), al2);
+		group_pos_ += 2;
+		count_ -= 2;
+		return 2;
+	}
+	++group_pos_;
+	--count_;
+	return 1;
+}
+
+quint64 BamMateCache::nameHash(const char* name)
+{
+	//FNV-1a hash
+	quint64 hash = 14695981039346656037ull;
+	for (const char* c=name; *c!='\0'; ++c)
+	{
+		hash ^= (uchar)*c;
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+BamMateCache::Entry BamMateCache::allocate(int size)
+{
+	//create new block if the current block is full
+	if (blocks_.isEmpty() || blocks_.last().size() + size > blocks_.last().capacity())
+	{
+		QByteArray block;
+		block.reserve(std::max(block_size_, size));
+		memory_ += block.capacity();
+		peak_memory_ = std::max(peak_memory_, memory_);
+		blocks_ << block;
+		block_counts_ << 0;
+		block_live_ << 0;
+	}
+
+	Entry entry{blocks_.count()-1, blocks_.last().size()};
+	++block_counts_[entry.block];
+	block_live_[entry.block] += size;
+	live_memory_ += size;
+
+	return entry;
+}
+
+BamMateCache::Entry BamMateCache::store(const BamAlignment& al)
+{
+	const bam1_t* b = al.aln_;
+	const int size = RECORD_HEADER_SIZE + sizeof(bam1_core_t) + b->l_data;
+
+	//append record
+	Entry entry = allocate(size);
+	QByteArray& block = blocks_[entry.block];
+	const quint64 id = next_id_++;
+	const qint32 data_size = b->l_data;
+	block.append(reinterpret_cast<const char*>(&id), sizeof(quint64));
+	block.append(reinterpret_cast<const char*>(&data_size), sizeof(qint32));
+	block.append(reinterpret_cast<const char*>(&b->core), sizeof(bam1_core_t));
+	block.append(reinterpret_cast<const char*>(b->data), data_size);
+
+	return entry;
+}
+
+void BamMateCache::release(const Entry& entry)
+{
+	//mark record as released
+	QByteArray& block = blocks_[entry.block];
+	const int size = recordSize(block.constData() + entry.offset);
+	memcpy(block.data() + entry.offset, &RELEASED_ID, sizeof(quint64));
+	--block_counts_[entry.block];
+	block_live_[entry.block] -= size;
+	live_memory_ -= size;
+
+	if (entry.block==blocks_.count()-1)
+	{
+		//current block is re-used (capacity is kept)
+		if (block_counts_[entry.block]==0) block.resize(0);
+	}
+	else if (block_counts_[entry.block]==0)
+	{
+		memory_ -= block.capacity();
+		block = QByteArray();
+	}
+	else if (block_live_[entry.block] < block.capacity() / 2)
+	{
+		//move the remaining alignments, so that blocks with a few long-lived alignments do not accumulate
+		compact(entry.block);
+	}
+}
+
+void BamMateCache::compact(int block)
+{
+	const QByteArray source = blocks_[block];
+	int offset = 0;
+	while (offset<source.size())
+	{
+		const char* record = source.constData() + offset;
+		const int size = recordSize(record);
+		if (recordId(record)!=RELEASED_ID)
+		{
+			//copy record
+			Entry entry = allocate(size);
+			blocks_[entry.block].append(record, size);
+
+			//update index
+			const quint64 hash = nameHash(recordName(record));
+			QMultiHash<quint64, Entry>::iterator it = index_.find(hash);
+			while (it!=index_.end() && it.key()==hash)
+			{
+				if (it.value().block==block && it.value().offset==offset)
+				{
+					it.value() = entry;
+					break;
+				}
+				++it;
+			}
+		}
+		offset += size;
+	}
+
+	//free block
+	memory_ -= source.capacity();
+	live_memory_ -= block_live_[block];
+	block_counts_[block] = 0;
+	block_live_[block] = 0;
+	blocks_[block] = QByteArray();
+}
+
+void BamMateCache::spill()
+{
+	//sort alignments by name hash, name and insertion order
+	QVector<QPair<quint64, Entry>> entries;
+	entries.reserve(index_.count());
+	for (QMultiHash<quint64, Entry>::const_iterator it=index_.cbegin(); it!=index_.cend(); ++it)
+	{
+		entries << qMakePair(it.key(), it.value());
+	}
+	std::sort(entries.begin(), entries.end(), [this](const QPair<quint64, Entry>& a, const QPair<quint64, Entry>& b)
+	{
+		if (a.first!=b.first) return a.first < b.first;
+		const char* record_a = recordData(a.second);
+		const char* record_b = recordData(b.second);
+		int cmp = strcmp(recordName(record_a), recordName(record_b));
+		if (cmp!=0) return cmp < 0;
+		return recordId(record_a) < recordId(record_b);
+	});
+
+	//write temporary file
+	Run run;
+	run.filename = Helper::tempFileName(".mates");
+	run.hash = 0;
+	QFile file(run.filename);
+	if (!file.open(QFile::WriteOnly))
+	{
+		THROW(FileAccessException, "Could not open temporary file " + run.filename + " for writing: " + file.errorString());
+	}
+	for (int i=0; i<entries.count(); ++i)
+	{
+		const char* record = recordData(entries[i].second);
+		file.write(reinterpret_cast<const char*>(&entries[i].first), sizeof(quint64));
+		file.write(record, recordSize(record));
+	}
+	file.close();
+	if (file.error()!=QFile::NoError)
+	{
+		THROW(FileAccessException, "Could not write temporary file " + run.filename + ": " + file.errorString());
+	}
+	runs_ << run;
+
+	//clear memory
+	index_.clear();
+	blocks_.clear();
+	block_counts_.clear();
+	block_live_.clear();
+	memory_ = 0;
+	live_memory_ = 0;
+}
+
+void BamMateCache::readRecord(Run& run)
+{
+	run.record.clear();
+	if (run.file->atEnd()) return;
+
+	QByteArray header = run.file->read(sizeof(quint64) + RECORD_HEADER_SIZE);
+	if (header.size()!=(int)sizeof(quint64) + RECORD_HEADER_SIZE)
+	{
+		THROW(FileParseException, "Temporary file " + run.filename + " is truncated!");
+	}
+	memcpy(&run.hash, header.constData(), sizeof(quint64));
+	run.record = header.mid(sizeof(quint64));
+	const int rest = recordSize(run.record.constData()) - RECORD_HEADER_SIZE;
+	QByteArray data = run.file->read(rest);
+	if (data.size()!=rest)
+	{
+		THROW(FileParseException, "Temporary file " + run.filename + " is truncated!");
+	}
+	run.record.append(data);
+}
+
+bool BamMateCache::readGroup()
+{
+	//determine smallest name
+	int min = -1;
+	for (int i=0; i<runs_.count(); ++i)
+	{
+		const Run& run = runs_[i];
+		if (run.record.isEmpty()) continue;
+		if (min==-1 || run.hash<runs_[min].hash || (run.hash==runs_[min].hash && strcmp(recordName(run.record.constData()), recordName(runs_[min].record.constData()))<0))
+		{
+			min = i;
+		}
+	}
+	if (min==-1) return false;
+
+	//collect records with that name from all files
+	const quint64 hash = runs_[min].hash;
+	const QByteArray name = recordName(runs_[min].record.constData());
+	for (int i=0; i<runs_.count(); ++i)
+	{
+		Run& run = runs_[i];
+		while (!run.record.isEmpty() && run.hash==hash && name==recordName(run.record.constData()))
+		{
+			group_ << run.record;
+			readRecord(run);
+		}
+	}
+	std::sort(group_.begin(), group_.end(), [](const QByteArray& a, const QByteArray& b)
+	{
+		return recordId(a.constData()) < recordId(b.constData());
+	});
+
+	return true;
+}
+
+int BamMateCache::recordSize(const char* record)
+{
+	qint32 data_size;
+	memcpy(&data_size, record + sizeof(quint64), sizeof(qint32));
+	return RECORD_HEADER_SIZE + sizeof(bam1_core_t) + data_size;
+}
+
+const char* BamMateCache::recordName(const char* record)
+{
+	return record + RECORD_HEADER_SIZE + sizeof(bam1_core_t);
+}
+
+quint64 BamMateCache::recordId(const char* record)
+{
+	quint64 id;
+	memcpy(&id, record, sizeof(quint64));
+	return id;
+}
+
+void BamMateCache::recordToAlignment(const char* record, BamAlignment& al)
+{
+	//wrap record data in an alignment struct and copy it (the data is not modified)
+	bam1_t tmp;
+	memset(&tmp, 0, sizeof(bam1_t));
+	memcpy(&tmp.core, record + RECORD_HEADER_SIZE, sizeof(bam1_core_t));
+	tmp.data = reinterpret_cast<uint8_t*>(const_cast<char*>(recordName(record)));
+	tmp.l_data = recordSize(record) - RECORD_HEADER_SIZE - sizeof(bam1_core_t);
+	tmp.m_data = tmp.l_data;
+	if (bam_copy1(al.aln_, &tmp)==nullptr)
+	{
+		THROW(Exception, "Could not copy cached alignment " + QByteArray(recordName(record)));
+	}
+}
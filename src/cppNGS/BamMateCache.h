@@ -0,0 +1,133 @@
+#ifndef BAMMATECACHE_H
+#define BAMMATECACHE_H
+
+#include "cppNGS_global.h"
+#include "BamReader.h"
+#include <QFile>
+#include <QMultiHash>
+#include <QSharedPointer>
+#include <QVector>
+
+/**
+  @brief Cache for alignments whose mate was not seen yet, e.g. for tools that process read pairs of BAM/CRAM files not sorted by name.
+
+  Alignments are stored in binary form in large memory blocks and are looked up by a 64-bit hash of the read name (the name is only compared for hash matches).
+  If less than half of a block is used by cached alignments, the alignments are moved to the current block and the block is freed.
+  If the cached alignments exceed a memory limit, they are written to a temporary file sorted by name.
+  Alignments written to temporary files are paired when all alignments have been added, i.e. pairs are returned in a different order in this case.
+*/
+class CPPNGSSHARED_EXPORT BamMateCache
+{
+public:
+	///Constructor. If the cached alignments exceed @p max_memory bytes, they are written to a temporary file. Because of partially used blocks, the allocated memory can be up to about twice as much.
+	BamMateCache(qint64 max_memory = 4000ll * 1024ll * 1024ll);
+	///Destructor. Removes temporary files.
+	~BamMateCache();
+
+	///Looks up the mate of an alignment, i.e. an alignment with the same name. If the mate is cached, it is removed from the cache, stored in @p mate and true is returned. Otherwise the alignment is added to the cache and false is returned.
+	bool takeMate(const BamAlignment& al, BamAlignment& mate);
+
+	///Has to be called after the last alignment was added. Pairs the alignments written to temporary files.
+	void finish();
+	/**
+	  @brief Returns the remaining alignments one by one after finish() was called.
+	  @return 2 for a pair of alignments that was written to temporary files (@p al1 is the alignment added first), 1 for an alignment without mate (stored in @p al1) and 0 if no alignment is left.
+	*/
+	int takeRemaining(BamAlignment& al1, BamAlignment& al2);
+
+	///Returns the number of cached alignments (in memory and in temporary files).
+	long long count() const
+	{
+		return count_;
+	}
+	///Returns the maximum number of alignments that were cached in memory at the same time.
+	long long peakCount() const
+	{
+		return peak_count_;
+	}
+	///Returns the maximum memory allocated for cached alignments (in bytes).
+	qint64 peakMemory() const
+	{
+		return peak_memory_;
+	}
+	///Returns the number of alignments that were written to temporary files.
+	long long spilledCount() const
+	{
+		return spilled_count_;
+	}
+	///Returns the number of temporary files.
+	int spillFileCount() const
+	{
+		return runs_.count();
+	}
+
+protected:
+	//Position of an alignment in the memory blocks
+	struct Entry
+	{
+		int block;
+		int offset;
+	};
+
+	//Sorted alignments of a temporary file
+	struct Run
+	{
+		QString filename;
+		QSharedPointer<QFile> file;
+		QByteArray record; //current record (empty if the file is at the end)
+		quint64 hash;
+	};
+
+	qint64 max_memory_;
+	int block_size_; //small memory limits use smaller blocks, so that not every alignment is written to a separate temporary file
+	QVector<QByteArray> blocks_;
+	QVector<int> block_counts_; //number of cached alignments per block
+	QVector<int> block_live_; //size of the cached alignments per block
+	qint64 memory_; //allocated memory
+	qint64 live_memory_; //size of the cached alignments
+	QMultiHash<quint64, Entry> index_;
+	quint64 next_id_;
+	long long count_;
+	long long peak_count_;
+	qint64 peak_memory_;
+	long long spilled_count_;
+	QVector<Run> runs_;
+	bool finished_;
+	QVector<Entry> remaining_; //alignments in memory after finish() (no temporary files)
+	QVector<QByteArray> group_; //records with the same name when merging temporary files
+	int group_pos_;
+
+	//Returns the hash of a read name.
+	static quint64 nameHash(const char* name);
+	//Returns the record data of an entry.
+	const char* recordData(const Entry& entry) const
+	{
+		return blocks_[entry.block].constData() + entry.offset;
+	}
+	//Reserves space for a record in the current memory block (a new block is created if the current block is full).
+	Entry allocate(int size);
+	//Stores an alignment in the memory blocks.
+	Entry store(const BamAlignment& al);
+	//Removes an alignment from the memory blocks.
+	void release(const Entry& entry);
+	//Moves the alignments of a block to the current block and frees the block.
+	void compact(int block);
+	//Writes all cached alignments to a temporary file (sorted by hash, name and insertion order).
+	void spill();
+	//Reads the next record of a temporary file.
+	void readRecord(Run& run);
+	//Reads the records with the next name from the temporary files into group_.
+	bool readGroup();
+
+	//Record layout: id (quint64), data size (qint32), alignment core data, alignment variable-length data (starts with the read name)
+	static int recordSize(const char* record);
+	static const char* recordName(const char* record);
+	static quint64 recordId(const char* record);
+	static void recordToAlignment(const char* record, BamAlignment& al);
+
+	//"declared away" methods
+	BamMateCache(const BamMateCache&) = delete;
+	BamMateCache& operator=(const BamMateCache&) = delete;
+};
+
+#endif // BAMMATECACHE_H
@@ -231,8 +231,7 @@ void BamAlignment::qualities(QBitArray& qualities, int min_baseq, int len) const
 	//position in the genome (e.g. contains deletions)
 	int genome_position_index = 0;
 
-	const QList<CigarOp> cigar_data = cigarData();
-	foreach(const CigarOp& op, cigar_data)
+	for (const CigarOp& op : cigarView())
 	{
 		if (op.Type==BAM_CMATCH)
 		{
@@ -320,8 +319,8 @@ QPair<char, int> BamAlignment::extractBaseByCIGAR(int pos)
 	//sometimes reads consist of insertions only > skip them
 	if (cigarIsOnlyInsertion()) return qMakePair('~', -1);
 
-	const QList<CigarOp> cigar_data = cigarData();
-	foreach(const CigarOp& op, cigar_data)
+	const CigarView cigar_data = cigarView();
+	for (const CigarOp& op : cigar_data)
 	{
 		//update positions
 		if (op.Type==BAM_CMATCH || op.Type==BAM_CEQUAL || op.Type==BAM_CDIFF)
@@ -371,13 +370,87 @@ QPair<char, int> BamAlignment::extractBaseByCIGAR(int pos)
 		}
 	}
 
-	foreach(const CigarOp& op, cigar_data)
+	for (const CigarOp& op : cigar_data)
 	{
 		qDebug() <<  op.Type << op.Length;
 	}
 	THROW(Exception, "Could not find position " + QString::number(pos) + " in read " + name() + " with start position " + QString::number(start()) + "!");
 }
 
+void BamAlignment::extractBasesByCIGAR(const int* positions, int count, QPair<char, int>* output) const
+{
+	int i = 0;
+
+	//sometimes reads consist of insertions only > skip them
+	if (cigarIsOnlyInsertion())
+	{
+		for (; i<count; ++i) output[i] = qMakePair('~', -1);
+		return;
+	}
+
+	int read_pos = 0;
+	int genome_pos = start()-1;
+	const uint32_t* cigar = bam_get_cigar(aln_);
+	for (uint32_t c=0; c<aln_->core.n_cigar && i<count; ++c)
+	{
+		const int type = bam_cigar_op(cigar[c]);
+		const int length = bam_cigar_oplen(cigar[c]);
+
+		//update positions and extract bases of all positions up to the current genome position
+		if (type==BAM_CMATCH || type==BAM_CEQUAL || type==BAM_CDIFF)
+		{
+			genome_pos += length;
+			read_pos += length;
+			for (; i<count && positions[i]<=genome_pos; ++i)
+			{
+				int actual_pos = read_pos - (genome_pos + 1 - positions[i]);
+				output[i] = qMakePair(base(actual_pos), quality(actual_pos));
+			}
+		}
+		else if(type==BAM_CINS)
+		{
+			read_pos += length;
+		}
+		else if(type==BAM_CDEL)
+		{
+			genome_pos += length;
+
+			//bases are deleted
+			for (; i<count && positions[i]<=genome_pos; ++i) output[i] = qMakePair('-', 255);
+		}
+		else if(type==BAM_CREF_SKIP) //skipped reference bases (for RNA)
+		{
+			genome_pos += length;
+
+			//bases are skipped
+			for (; i<count && positions[i]<=genome_pos; ++i) output[i] = qMakePair('~', -1);
+		}
+		else if(type==BAM_CSOFT_CLIP) //soft-clipped (only at the beginning/end)
+		{
+			read_pos += length;
+
+			//remaining bases are soft-clipped
+			if(read_pos>=this->length())
+			{
+				for (; i<count; ++i) output[i] = qMakePair('~', -1);
+			}
+		}
+		else if(type==BAM_CHARD_CLIP) //hard-clipped (only at the beginning/end)
+		{
+			//can be ignored as hard-clipped bases are not considered in the position or sequence
+		}
+		else
+		{
+			THROW(Exception, "Unknown CIGAR operation " + QString::number(type) + "!");
+		}
+	}
+
+	if (i<count)
+	{
+		THROW(Exception, "Could not find position " + QString::number(positions[i]) + " in read " + name() + " with start position " + QString::number(start()) + "!");
+	}
+}
+
 QList<Sequence> BamAlignment::extractIndelsByCIGAR(int pos, int indel_window)
 {
 	//init
@@ -389,9 +462,8 @@ QList<Sequence> BamAlignment::extractIndelsByCIGAR(int pos, int indel_window)
 	//look up indels
 	int read_pos = 0;
 	int genome_pos = start();
-	const QList<CigarOp> cigar_data = cigarData();
-	const QByteArray sequence = bases();
-	foreach(const CigarOp& op, cigar_data)
+	const BaseView sequence = basesView();
+	for (const CigarOp& op : cigarView())
 	{
 		//update positions
 		if (op.Type==BAM_CMATCH) //match or mismatch
@@ -466,32 +538,43 @@ void BamReader::init(const QString& bam_file, QString ref_genome)
 		THROW(FileAccessException, "Could not open BAM/CRAM file " + bam_file_);
 	}
 
-	//read header
-	header_ = sam_hdr_read(fp_);
-	if (header_==nullptr)
+	//use process-wide thread pool for decompression (if enabled) - detached again if the initialization fails
+	thread_pool_ = HtsThreadPool::attach(fp_, bam_file_);
+	try
 	{
-		THROW(FileAccessException, "Could not read header from BAM/CRAM file " + bam_file);
-	}
+		//read header
+		header_ = sam_hdr_read(fp_);
+		if (header_==nullptr)
+		{
+			THROW(FileAccessException, "Could not read header from BAM/CRAM file " + bam_file);
+		}
 
-	//set reference for CRAM files
-	if(fp_->is_cram)
-	{
-		if (ref_genome.isEmpty()) ref_genome = RefGenomeService::getReferenceGenome();
-		int fai = hts_set_fai_filename(fp_, ref_genome.toUtf8().constData());
-		if(fai < 0)
+		//set reference for CRAM files
+		if(fp_->is_cram)
 		{
-			THROW(FileAccessException, "Error while setting reference genome '" + ref_genome + "'for cram file " + bam_file);
+			if (ref_genome.isEmpty()) ref_genome = RefGenomeService::getReferenceGenome();
+			int fai = hts_set_fai_filename(fp_, ref_genome.toUtf8().constData());
+			if(fai < 0)
+			{
+				THROW(FileAccessException, "Error while setting reference genome '" + ref_genome + "'for cram file " + bam_file);
+			}
+
+			checkChromosomeLengths(ref_genome);
 		}
 
-		checkChromosomeLengths(ref_genome);
+		//parse chromosome names and sizes
+		for(int i=0; i<header_->n_targets; ++i)
+		{
+			Chromosome chr(header_->target_name[i]);
+			chrs_ << chr;
+			chrs_sizes_[chr] = header_->target_len[i];
+		}
 	}
-
-	//parse chromosome names and sizes
-	for(int i=0; i<header_->n_targets; ++i)
+	catch(...)
 	{
-		Chromosome chr(header_->target_name[i]);
-		chrs_ << chr;
-		chrs_sizes_[chr] = header_->target_len[i];
+		if (thread_pool_) HtsThreadPool::detach();
+		thread_pool_ = false;
+		throw;
 	}
 }
 
@@ -515,6 +598,7 @@ BamReader::~BamReader()
 	hts_idx_destroy(index_);
 	sam_hdr_destroy(header_);
 	hts_close(fp_);
+	if (thread_pool_) HtsThreadPool::detach();
 }
 
 QByteArrayList BamReader::headerLines() const
@@ -576,14 +660,7 @@ void BamReader::setRegion(const Chromosome& chr, int start, int end)
 	clearIterator();
 
 	//load index if not done already
-	if (index_==nullptr)
-	{
-		index_ = sam_index_load(fp_, bam_file_.toUtf8().data());
-		if (index_==nullptr)
-		{
-			THROW(FileAccessException, "Could not load index of BAM/CRAM file " + bam_file_);
-		}
-	}
+	loadIndex();
 
 	//find chromosome string used in BAM header ('chr1' does not equal '1' for htslib)
 	int chr_index = chrs_.indexOf(chr);
@@ -606,6 +683,22 @@ void BamReader::setRegion(const Chromosome& chr, int start, int end)
 	}
 }
 
+void BamReader::setRegionUnmapped()
+{
+	//clear data from previous calls
+	clearIterator();
+
+	//load index if not done already
+	loadIndex();
+
+	//create iterator for reads without coordinate
+	iter_ = sam_itr_queryi(index_, HTS_IDX_NOCOOR, 0, 0);
+	if (iter_==nullptr)
+	{
+		THROW(FileAccessException, "Could not create iterator for unmapped reads in BAM/CRAM file " + bam_file_);
+	}
+}
+
 const QList<Chromosome>& BamReader::chromosomes() const
 {
 	return chrs_;
@@ -645,6 +738,17 @@ void BamReader::clearIterator()
 	iter_ = nullptr;
 }
 
+void BamReader::loadIndex()
+{
+	if (index_!=nullptr) return;
+
+	index_ = sam_index_load(fp_, bam_file_.toUtf8().data());
+	if (index_==nullptr)
+	{
+		THROW(FileAccessException, "Could not load index of BAM/CRAM file " + bam_file_);
+	}
+}
+
 Pileup BamReader::getPileup(const Chromosome& chr, int pos, int indel_window, int min_mapq, bool anom, int min_baseq)
 {
 	//init
@@ -783,8 +887,8 @@ void BamReader::getIndels(const FastaFileIndex& reference, const Chromosome& chr
 
 		//run time optimization: skip reads that do not contain Indels
 		bool contains_indels_refskip = false;
-		const QList<CigarOp> cigar_data = al.cigarData();
-		foreach(const CigarOp& op, cigar_data)
+		const CigarView cigar_data = al.cigarView();
+		for (const CigarOp& op : cigar_data)
 		{
 			if (op.Type==BAM_CINS || op.Type==BAM_CDEL || op.Type==BAM_CREF_SKIP)
 			{
@@ -797,8 +901,8 @@ void BamReader::getIndels(const FastaFileIndex& reference, const Chromosome& chr
 		//look up indels
 		int read_pos = 0;
 		int genome_pos = al.start();
-		const QList<CigarOp> cigar_data2 = al.cigarData();
-		foreach(const CigarOp& op, cigar_data2)
+		const BaseView sequence = al.basesView();
+		for (const CigarOp& op : cigar_data)
 		{
 			//update positions
 			if (op.Type==BAM_CMATCH)
@@ -810,7 +914,7 @@ void BamReader::getIndels(const FastaFileIndex& reference, const Chromosome& chr
 			{
 				if (genome_pos>=start && genome_pos<=end)
 				{
-					indels.append(QByteArray("+") + al.bases().mid(read_pos, op.Length));
+					indels.append(QByteArray("+") + sequence.mid(read_pos, op.Length));
 				}
 				read_pos += op.Length;
 			}
@@ -11,6 +11,7 @@
 #include "QHash"
 
 #include "RefGenomeService.h"
+#include "HtsThreadPool.h"
 #include "htslib/sam.h"
 #include "htslib/cram.h"
 
@@ -26,6 +27,141 @@ struct CPPNGSSHARED_EXPORT CigarOp
 		return BAM_CIGAR_STR[Type];
 	}
 };
+Q_DECLARE_TYPEINFO(CigarOp, Q_PRIMITIVE_TYPE); //stored in-place in QList (no allocation per CIGAR operation)
+
+//Non-owning view of the CIGAR data of an alignment. No data is copied, i.e. the view is only valid as long as the alignment is not modified or deleted.
+class CPPNGSSHARED_EXPORT CigarView
+{
+	public:
+		//Iterator over the CIGAR operations (for range-based for loops)
+		class ConstIterator
+		{
+			public:
+				ConstIterator(const uint32_t* cigar)
+					: cigar_(cigar)
+				{
+				}
+				CigarOp operator*() const
+				{
+					return CigarOp { (int)bam_cigar_op(*cigar_), (int)bam_cigar_oplen(*cigar_) };
+				}
+				ConstIterator& operator++()
+				{
+					++cigar_;
+					return *this;
+				}
+				bool operator!=(const ConstIterator& rhs) const
+				{
+					return cigar_!=rhs.cigar_;
+				}
+
+			protected:
+				const uint32_t* cigar_;
+		};
+
+		CigarView(const uint32_t* cigar, int count)
+			: cigar_(cigar)
+			, count_(count)
+		{
+		}
+
+		//Returns the number of CIGAR operations.
+		int count() const
+		{
+			return count_;
+		}
+		//Returns the n-th CIGAR operation.
+		CigarOp operator[](int n) const
+		{
+			return CigarOp { (int)bam_cigar_op(cigar_[n]), (int)bam_cigar_oplen(cigar_[n]) };
+		}
+
+		ConstIterator begin() const
+		{
+			return ConstIterator(cigar_);
+		}
+		ConstIterator end() const
+		{
+			return ConstIterator(cigar_ + count_);
+		}
+
+	protected:
+		const uint32_t* cigar_;
+		int count_;
+};
+
+//Non-owning view of the 4-bit encoded sequence bases of an alignment. No data is copied, i.e. the view is only valid as long as the alignment is not modified or deleted.
+class CPPNGSSHARED_EXPORT BaseView
+{
+	public:
+		BaseView(const uint8_t* seq, int length)
+			: seq_(seq)
+			, length_(length)
+		{
+		}
+
+		//Returns the number of bases.
+		int length() const
+		{
+			return length_;
+		}
+		//Returns the n-th base.
+		char operator[](int n) const
+		{
+			return seq_nt16_str[bam_seqi(seq_, n)];
+		}
+		//Returns the 4-bit code of the n-th base (1=A, 2=C, 4=G, 8=T, 15=N).
+		int code(int n) const
+		{
+			return bam_seqi(seq_, n);
+		}
+		//Returns @p length bases starting at @p pos as a sequence.
+		Sequence mid(int pos, int length) const
+		{
+			Sequence output;
+			output.resize(length);
+			for (int i=0; i<length; ++i)
+			{
+				output[i] = seq_nt16_str[bam_seqi(seq_, pos + i)];
+			}
+			return output;
+		}
+
+	protected:
+		const uint8_t* seq_;
+		int length_;
+};
+
+//Non-owning view of the base qualities of an alignment (integer values, not ASCII-encoded). No data is copied, i.e. the view is only valid as long as the alignment is not modified or deleted.
+class CPPNGSSHARED_EXPORT QualityView
+{
+	public:
+		QualityView(const uint8_t* qual, int length)
+			: qual_(qual)
+			, length_(length)
+		{
+		}
+
+		//Returns the number of qualities.
+		int length() const
+		{
+			return length_;
+		}
+		//Returns the quality of the n-th base.
+		int operator[](int n) const
+		{
+			return qual_[n];
+		}
+		//Returns the raw quality data.
+		const uint8_t* data() const
+		{
+			return qual_;
+		}
+
+	protected:
+		const uint8_t* qual_;
+		int length_;
+};
 
 //Representation of a BAM alignment
 class CPPNGSSHARED_EXPORT BamAlignment
@@ -171,6 +307,11 @@ class CPPNGSSHARED_EXPORT BamAlignment
 
 		//Returns the CIGAR data.
 		QList<CigarOp> cigarData() const;
+		//Returns a view of the CIGAR data (no copy is made - use this in loops over all alignments of a file).
+		CigarView cigarView() const
+		{
+			return CigarView(bam_get_cigar(aln_), aln_->core.n_cigar);
+		}
 		//Sets the CIGAR data.
 		void setCigarData(const QList<CigarOp>& cigar);
 		//Returns the CIGAR data as a string.
@@ -187,6 +328,11 @@ class CPPNGSSHARED_EXPORT BamAlignment
 		{
 			return seq_nt16_str[bam_seqi(bam_get_seq(aln_), n)];
 		}
+		//Returns a view of the sequence bases (no copy is made - use this in loops over all alignments of a file).
+		BaseView basesView() const
+		{
+			return BaseView(bam_get_seq(aln_), aln_->core.l_qseq);
+		}
 		//Fills the given vector with integer representations of bases ()
 		QVector<int> baseIntegers() const;
 
@@ -199,6 +345,11 @@ class CPPNGSSHARED_EXPORT BamAlignment
 		{
 			return bam_get_qual(aln_)[n];
 		}
+		//Returns a view of the base qualities (no copy is made - use this in loops over all alignments of a file).
+		QualityView qualitiesView() const
+		{
+			return QualityView(bam_get_qual(aln_), aln_->core.l_qseq);
+		}
 		//Fills a bit array representing base qualities - a bit is set if the base quality is >= min_baseq
 		//the array is of size al.end() - al.start() +1 and by that includes deletions
 		void qualities(QBitArray& qualities, int min_baseq, int len) const;
@@ -242,6 +393,11 @@ class CPPNGSSHARED_EXPORT BamAlignment
 		  @note If the base is deleted, '-' with quality 255 is returned. If the base is skipped/soft-clipped, '~' with quality -1 is returned.
 		*/
 		QPair<char, int> extractBaseByCIGAR(int pos);
+		/**
+		  @brief Returns the bases and qualities at several chromosomal positions (1-based) in @p output. The CIGAR is processed only once for all positions.
+		  @note The positions must be sorted and inside the alignment, i.e. between start() and end(). The result for each position is the same as for extractBaseByCIGAR.
+		*/
+		void extractBasesByCIGAR(const int* positions, int count, QPair<char, int>* output) const;
 
 		/**
 		  @brief Returns the indels at a chromosomal position (1-based) or a range when using the @p indel_window parameter.
@@ -256,6 +412,8 @@ class CPPNGSSHARED_EXPORT BamAlignment
 		//friends
 		friend class BamReader;
 		friend class BamWriter;
+		friend class BamMateCache;
+		friend class BamMateCache_Test;
 };
 
 //Variant details struct.
@@ -302,6 +460,8 @@ class CPPNGSSHARED_EXPORT BamReader
 
 		//Set region for alignment retrieval (1-based coordinates).
 		void setRegion(const Chromosome& chr, int start, int end);
+		//Set region to alignments without coordinate, i.e. the unmapped reads at the end of the file.
+		void setRegionUnmapped();
 
 		//Get next alignment and stores it in @p al.
 		bool getNextAlignment(BamAlignment& al)
@@ -352,9 +512,12 @@ class CPPNGSSHARED_EXPORT BamReader
 		sam_hdr_t* header_ = nullptr;
 		hts_idx_t* index_ = nullptr;
 		hts_itr_t* iter_  = nullptr;
+		bool thread_pool_ = false;
 
 		//Releases resources held by the iterator (index is not cleared)
 		void clearIterator();
+		//Loads the index if not done already
+		void loadIndex();
 		void checkChromosomeLengths(const QString& ref_genome);
         void init(const QString& bam_file, QString ref_genome = QString());
 
@@ -35,9 +35,13 @@ BamWriter::BamWriter(const QString& bam_file, const QString& ref_file)
 	{
 		THROW(FileAccessException, "Could not open file for writing: " + bam_file_);
 	}
+
+	//use process-wide thread pool for compression (if enabled)
+	thread_pool_ = HtsThreadPool::attach(fp_, bam_file_);
 }
 
 BamWriter::~BamWriter()
 {
 	sam_close(fp_);
+	if (thread_pool_) HtsThreadPool::detach();
 }
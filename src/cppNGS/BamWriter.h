@@ -39,6 +39,7 @@ class CPPNGSSHARED_EXPORT BamWriter
 		QString bam_file_;
 		samFile* fp_ = nullptr;
 		sam_hdr_t* header_ = nullptr;
+		bool thread_pool_ = false;
 
 		//"declared away" methods
 		BamWriter(const BamWriter&) = delete;
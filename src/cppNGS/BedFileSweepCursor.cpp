@@ -0,0 +1,94 @@
+#include "BedFileSweepCursor.h"
+#include "Exceptions.h"
+#include <limits>
+
+BedFileSweepCursor::BedFileSweepCursor()
+	: file_(nullptr)
+	, chr_num_(-1)
+	, first_(0)
+	, last_(-1)
+	, pos_(0)
+	, last_start_(std::numeric_limits<int>::min())
+{
+}
+
+BedFileSweepCursor::BedFileSweepCursor(const BedFile& file)
+	: file_(&file)
+	, max_end_(file.count())
+	, chr_num_(-1)
+	, first_(0)
+	, last_(-1)
+	, pos_(0)
+	, last_start_(std::numeric_limits<int>::min())
+{
+	if (!file.isSorted()) THROW(ArgumentException, "Sorted BED file required for sweep cursor!");
+
+	int first = 0;
+	for (int i=0; i<file.count(); ++i)
+	{
+		const BedLine& line = file[i];
+		if (i==0 || line.chr()!=file[i-1].chr())
+		{
+			first = i;
+			max_end_[i] = line.end();
+		}
+		else
+		{
+			max_end_[i] = std::max(max_end_[i-1], line.end());
+		}
+		chr_ranges_[line.chr().num()] = qMakePair(first, i);
+	}
+}
+
+void BedFileSweepCursor::seek(const Chromosome& chr, int start)
+{
+	//chromosome changed
+	if (chr.num()!=chr_num_)
+	{
+		chr_num_ = chr.num();
+		QPair<int, int> range = chr_ranges_.value(chr_num_, qMakePair(0, -1));
+		first_ = range.first;
+		last_ = range.second;
+		pos_ = first_;
+		last_start_ = std::numeric_limits<int>::min();
+	}
+
+	if (start>=last_start_) //sweep forward
+	{
+		while (pos_<=last_ && max_end_.at(pos_)<start) ++pos_;
+	}
+	else //binary search (maximum end positions are sorted)
+	{
+		pos_ = std::lower_bound(max_end_.constBegin() + first_, max_end_.constBegin() + last_ + 1, start) - max_end_.constBegin();
+	}
+	last_start_ = start;
+}
+
+int BedFileSweepCursor::matchingIndices(const Chromosome& chr, int start, int end, QVector<int>& indices)
+{
+	indices.clear();
+	seek(chr, start);
+
+	for (int i=pos_; i<=last_; ++i)
+	{
+		const BedLine& line = (*file_)[i];
+		if (line.start()>end) break;
+		if (line.end()>=start) indices.append(i);
+	}
+
+	return indices.count();
+}
+
+bool BedFileSweepCursor::overlaps(const Chromosome& chr, int start, int end)
+{
+	seek(chr, start);
+
+	for (int i=pos_; i<=last_; ++i)
+	{
+		const BedLine& line = (*file_)[i];
+		if (line.start()>end) break;
+		if (line.end()>=start) return true;
+	}
+
+	return false;
+}
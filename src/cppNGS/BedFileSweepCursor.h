@@ -0,0 +1,42 @@
+#ifndef BEDFILESWEEPCURSOR_H
+#define BEDFILESWEEPCURSOR_H
+
+#include "cppNGS_global.h"
+#include "BedFile.h"
+#include <QHash>
+#include <QPair>
+#include <QVector>
+
+///Overlap cursor for a sorted BED file and query ranges sorted by start position, e.g. the alignments of a coordinate-sorted BAM file.
+///Queries with non-decreasing start position on the same chromosome are answered in amortized constant time. Other queries are supported, but need a binary search.
+///Copies share the precomputed data, so each thread can use its own copy of a cursor.
+class CPPNGSSHARED_EXPORT BedFileSweepCursor
+{
+public:
+	///Default constructor (no BED lines).
+	BedFileSweepCursor();
+	///Constructor. Throws an ArgumentException if the BED file is not sorted. The BED file must outlive the cursor.
+	BedFileSweepCursor(const BedFile& file);
+
+	///Fills @p indices with the indices of the BED lines overlapping the given range (ascending order, i.e. like ChromosomalIndex::matchingIndices). Returns the number of overlapping BED lines.
+	int matchingIndices(const Chromosome& chr, int start, int end, QVector<int>& indices);
+	///Returns if at least one BED line overlaps the given range.
+	bool overlaps(const Chromosome& chr, int start, int end);
+
+protected:
+	const BedFile* file_;
+	QVector<int> max_end_; //maximum end position of the BED lines of the same chromosome up to the index
+	QHash<int, QPair<int, int>> chr_ranges_; //first/last index of each chromosome
+
+	//current position
+	int chr_num_;
+	int first_; //first index of the current chromosome
+	int last_; //last index of the current chromosome
+	int pos_; //first index of the current chromosome with a maximum end position not before the last query start
+	int last_start_; //last query start
+
+	//Moves the cursor to the given query start.
+	void seek(const Chromosome& chr, int start);
+};
+
+#endif // BEDFILESWEEPCURSOR_H
@@ -0,0 +1,197 @@
+#ifndef CHROMOSOMALINTERVALTREE_H
+#define CHROMOSOMALINTERVALTREE_H
+#include "cppNGS_global.h"
+#include "Chromosome.h"
+#include <QHash>
+#include <QVector>
+#include <algorithm>
+
+/**
+  @brief Chromosomal index based on an implicit interval tree (drop-in replacement of ChromosomalIndex).
+
+  The elements of each chromosome are stored in a flat array sorted by start position. The array is interpreted as a balanced binary tree, where each node stores the maximum end position of its subtree.
+  In contrast to ChromosomalIndex, query time does not depend on the length of the longest element, i.e. long elements (whole genes, large CNVs) do not slow down queries.
+  Matches are reported by ascending start position, which is the container order for sorted containers. Unsorted containers are supported as well.
+*/
+template <class T>
+class CPPNGSSHARED_EXPORT ChromosomalIntervalTree
+{
+public:
+	///Constructor.
+	ChromosomalIntervalTree(const T& container);
+
+	///Re-creates the index (only needed if the container content changed after calling the index constructor).
+	void createIndex();
+
+	///Returns the underlying container
+	const T& container() const { return container_; }
+
+	///Returns a vector of element indices overlapping the given chromosomal range.
+	QVector<int> matchingIndices(const Chromosome& chr, int start, int end) const;
+	///Returns the index of the first element (by start position) that overlaps the given chromosomal range, or -1 if no element overlaps.
+	int matchingIndex(const Chromosome& chr, int start, int end) const;
+	///Calls @p func with the index of each element overlapping the given chromosomal range. No memory is allocated.
+	template <typename Func>
+	void forEachMatch(const Chromosome& chr, int start, int end, Func func) const
+	{
+		visit(chr, start, end, [&func](int index) { func(index); return true; });
+	}
+
+protected:
+	//Tree node
+	struct Node
+	{
+		int start;
+		int end;
+		int max_end; //maximum end position of the subtree
+		int index; //index in the container
+	};
+
+	//Tree of one chromosome
+	struct Tree
+	{
+		QVector<Node> nodes;
+		int root_level = -1; //level of the root node (leaves are level 0)
+	};
+
+	const T& container_;
+	QHash<int, Tree> trees_;
+
+	//Calls 'func(index)' for each overlapping element in order of start position, until 'func' returns false.
+	template <typename Func>
+	void visit(const Chromosome& chr, int start, int end, Func func) const;
+
+	//Computes the maximum end positions of the subtrees and returns the level of the root.
+	static int buildTree(QVector<Node>& nodes);
+};
+
+template <class T>
+ChromosomalIntervalTree<T>::ChromosomalIntervalTree(const T& container)
+	: container_(container)
+	, trees_()
+{
+	createIndex();
+}
+
+template <class T>
+void ChromosomalIntervalTree<T>::createIndex()
+{
+	trees_.clear();
+
+	//collect elements per chromosome
+	for (int i=0; i<container_.count(); ++i)
+	{
+		const auto& element = container_[i];
+		trees_[element.chr().num()].nodes.append(Node{element.start(), element.end(), element.end(), i});
+	}
+
+	//sort by start position and build trees
+	for (auto it=trees_.begin(); it!=trees_.end(); ++it)
+	{
+		QVector<Node>& nodes = it.value().nodes;
+		std::sort(nodes.begin(), nodes.end(), [](const Node& a, const Node& b){ return a.start<b.start || (a.start==b.start && a.index<b.index); });
+		it.value().root_level = buildTree(nodes);
+	}
+}
+
+template <class T>
+int ChromosomalIntervalTree<T>::buildTree(QVector<Node>& nodes)
+{
+	const long long n = nodes.count();
+	if (n==0) return -1;
+
+	//leaves (even indices)
+	long long last_i = 0;
+	int last = 0; //maximum end of the last node of the current level
+	for (long long i=0; i<n; i+=2)
+	{
+		last_i = i;
+		last = nodes[i].max_end = nodes[i].end;
+	}
+
+	//inner nodes: nodes of level k are at indices (2^k - 1) + j * 2^(k+1)
+	int k = 1;
+	for (; (1LL<<k)<=n; ++k)
+	{
+		const long long x = 1LL<<(k-1);
+		const long long i0 = (x<<1) - 1;
+		const long long step = x<<2;
+		for (long long i=i0; i<n; i+=step)
+		{
+			int end_left = nodes[i-x].max_end;
+			int end_right = (i+x<n) ? nodes[i+x].max_end : last;
+			nodes[i].max_end = std::max(nodes[i].end, std::max(end_left, end_right));
+		}
+		last_i = ((last_i>>k) & 1) ? last_i - x : last_i + x;
+		if (last_i<n && nodes[last_i].max_end>last) last = nodes[last_i].max_end;
+	}
+
+	return k - 1;
+}
+
+template <class T>
+template <typename Func>
+void ChromosomalIntervalTree<T>::visit(const Chromosome& chr, int start, int end, Func func) const
+{
+	auto tree_it = trees_.constFind(chr.num());
+	if (tree_it==trees_.cend()) return;
+	const Tree& tree = tree_it.value();
+	const Node* nodes = tree.nodes.constData();
+	const long long n = tree.nodes.count();
+
+	//in-order traversal with explicit stack (depth is limited by the 32-bit index)
+	struct StackEntry
+	{
+		int level;
+		long long x; //node index
+		bool left_done; //if the left subtree was already processed
+	};
+	StackEntry stack[64];
+	int t = 0;
+	stack[t++] = StackEntry{tree.root_level, (1LL<<tree.root_level) - 1, false};
+	while (t>0)
+	{
+		StackEntry z = stack[--t];
+		if (z.level<=3) //small subtree: linear scan
+		{
+			const long long i0 = z.x >> z.level << z.level;
+			const long long i1 = std::min(n, i0 + (1LL<<(z.level+1)) - 1);
+			for (long long i=i0; i<i1 && nodes[i].start<=end; ++i)
+			{
+				if (start<=nodes[i].end && !func(nodes[i].index)) return;
+			}
+		}
+		else if (!z.left_done) //process left subtree first
+		{
+			const long long y = z.x - (1LL<<(z.level-1));
+			stack[t++] = StackEntry{z.level, z.x, true};
+			if (y>=n || nodes[y].max_end>=start)
+			{
+				stack[t++] = StackEntry{z.level-1, y, false};
+			}
+		}
+		else if (z.x<n && nodes[z.x].start<=end) //process node and right subtree
+		{
+			if (start<=nodes[z.x].end && !func(nodes[z.x].index)) return;
+			stack[t++] = StackEntry{z.level-1, z.x + (1LL<<(z.level-1)), false};
+		}
+	}
+}
+
+template <class T>
+QVector<int> ChromosomalIntervalTree<T>::matchingIndices(const Chromosome& chr, int start, int end) const
+{
+	QVector<int> matches;
+	visit(chr, start, end, [&matches](int index) { matches.append(index); return true; });
+	return matches;
+}
+
+template <class T>
+int ChromosomalIntervalTree<T>::matchingIndex(const Chromosome& chr, int start, int end) const
+{
+	int match = -1;
+	visit(chr, start, end, [&match](int index) { match = index; return false; });
+	return match;
+}
+
+#endif // CHROMOSOMALINTERVALTREE_H
@@ -0,0 +1,518 @@
+#include "CoverageCache.h"
+#include "BamReader.h"
+#include "Exceptions.h"
+#include "Helper.h"
+#include <QFileInfo>
+#include <QDateTime>
+#include <QCryptographicHash>
+#include <QMutex>
+#include <QHash>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QtEndian>
+
+//File layout (little-endian):
+//  header: magic (8 bytes), version, min_mapq, min_baseq (qint32), BAM size, BAM modification time in ms, region table offset (qint64), BAM checksum (16 bytes)
+//  runs: start position and depth (qint32) of each run, grouped by region
+//  region table: region count (qint32), then for each region: chromosome name length (qint32), chromosome name, start, end (qint32), offset of the first run (qint64), run count (qint32)
+static const QByteArray CACHE_MAGIC = "NGSCOVDP";
+static const int CACHE_VERSION = 2;
+static const int CHECKSUM_SIZE = 16;
+static const int HEADER_SIZE = 8 + 3*4 + 3*8 + CHECKSUM_SIZE;
+static const qint64 CHECKSUM_BYTES = 65536;
+static const int RUN_SIZE = 2*4;
+static const int WINDOW_SIZE = 1000000;
+static const int WINDOWS_PER_TASK = 10;
+
+//Window of a cached region and the depth runs determined for it
+struct CoverageCacheWindow
+{
+	int region;
+	Chromosome chr;
+	int start;
+	int end;
+	QVector<DepthRun> runs;
+};
+
+//Determines the depth runs of consecutive windows
+class CoverageCacheWorker
+	: public QRunnable
+{
+public:
+	CoverageCacheWorker(QList<CoverageCacheWindow>& windows, int first, int last, QString& error, const QString& bam_file, const QString& ref_file, int min_mapq, int min_baseq)
+		: QRunnable()
+		, windows_(windows)
+		, first_(first)
+		, last_(last)
+		, error_(error)
+		, bam_file_(bam_file)
+		, ref_file_(ref_file)
+		, min_mapq_(min_mapq)
+		, min_baseq_(min_baseq)
+	{
+	}
+
+	void run() override
+	{
+		try
+		{
+			BamReader reader(bam_file_, ref_file_);
+			for (int w=first_; w<=last_; ++w)
+			{
+				processWindow(reader, windows_[w]);
+			}
+		}
+		catch(Exception& e)
+		{
+			error_ = e.message();
+		}
+		catch(std::exception& e)
+		{
+			error_ = e.what();
+		}
+		catch(...)
+		{
+			error_ = "Unknown exception!";
+		}
+	}
+
+private:
+	QList<CoverageCacheWindow>& windows_;
+	int first_;
+	int last_;
+	QString& error_;
+	QString bam_file_;
+	QString ref_file_;
+	int min_mapq_;
+	int min_baseq_;
+
+	void processWindow(BamReader& reader, CoverageCacheWindow& window)
+	{
+		const int start = window.start;
+		QVector<int> cov(window.end - start + 1, 0);
+
+		//same depth definition as in Statistics::lowCoverage/avgCoverage
+		reader.setRegion(window.chr, start, window.end);
+		BamAlignment al;
+		QBitArray base_qualities;
+		while (reader.getNextAlignment(al))
+		{
+			if (al.isDuplicate()) continue;
+			if (al.isSecondaryAlignment() || al.isSupplementaryAlignment()) continue;
+			if (al.isUnmapped() || al.mappingQuality()<min_mapq_) continue;
+
+			const int ol_start = std::max(start, al.start()) - start;
+			const int ol_end = std::min(window.end, al.end()) - start;
+			if (min_baseq_>0)
+			{
+				int quality_pos = std::max(start, al.start()) - al.start();
+				al.qualities(base_qualities, min_baseq_, al.end() - al.start() + 1);
+				for (int p=ol_start; p<=ol_end; ++p)
+				{
+					if (base_qualities.testBit(quality_pos)) ++cov[p];
+					++quality_pos;
+				}
+			}
+			else
+			{
+				for (int p=ol_start; p<=ol_end; ++p)
+				{
+					++cov[p];
+				}
+			}
+		}
+
+		//run-length encoding
+		for (int p=0; p<cov.count(); ++p)
+		{
+			if (p==0 || cov[p]!=cov[p-1])
+			{
+				if (!window.runs.isEmpty()) window.runs.last().end = start + p - 1;
+				window.runs.append(DepthRun{start + p, window.end, cov[p]});
+			}
+		}
+	}
+};
+
+//Appends a little-endian integer to a buffer
+template<typename T>
+static void appendValue(QByteArray& buffer, T value)
+{
+	char bytes[sizeof(T)];
+	qToLittleEndian<T>(value, bytes);
+	buffer.append(bytes, sizeof(T));
+}
+
+//Reads a little-endian integer from a memory-mapped file
+template<typename T>
+static T readValue(const uchar* data, qint64 offset)
+{
+	return qFromLittleEndian<T>(data + offset);
+}
+
+CoverageCache::CoverageCache(const QString& cache_file)
+	: file_(cache_file)
+{
+	if (!file_.open(QFile::ReadOnly))
+	{
+		THROW(FileAccessException, "Could not open coverage cache file " + cache_file + " for reading: " + file_.errorString());
+	}
+	qint64 file_size = file_.size();
+	if (file_size<HEADER_SIZE + 4)
+	{
+		THROW(FileParseException, "Coverage cache file " + cache_file + " is truncated!");
+	}
+	data_ = file_.map(0, file_size);
+	if (data_==nullptr)
+	{
+		THROW(FileAccessException, "Could not memory-map coverage cache file " + cache_file + ": " + file_.errorString());
+	}
+
+	//header
+	if (QByteArray(reinterpret_cast<const char*>(data_), CACHE_MAGIC.size())!=CACHE_MAGIC)
+	{
+		THROW(FileParseException, "File " + cache_file + " is not a coverage cache file!");
+	}
+	int version = readValue<qint32>(data_, 8);
+	if (version!=CACHE_VERSION)
+	{
+		THROW(FileParseException, "Coverage cache file " + cache_file + " has unsupported version " + QString::number(version) + "!");
+	}
+	min_mapq_ = readValue<qint32>(data_, 12);
+	min_baseq_ = readValue<qint32>(data_, 16);
+	bam_size_ = readValue<qint64>(data_, 20);
+	bam_modified_ = readValue<qint64>(data_, 28);
+	qint64 offset = readValue<qint64>(data_, 36);
+	bam_checksum_ = QByteArray(reinterpret_cast<const char*>(data_ + 44), CHECKSUM_SIZE);
+
+	//region table
+	if (offset<HEADER_SIZE || offset+4>file_size)
+	{
+		THROW(FileParseException, "Coverage cache file " + cache_file + " is truncated!");
+	}
+	int region_count = readValue<qint32>(data_, offset);
+	offset += 4;
+	for (int i=0; i<region_count; ++i)
+	{
+		int chr_length = readValue<qint32>(data_, offset);
+		if (offset + 4 + chr_length + 3*4 + 8 > file_size)
+		{
+			THROW(FileParseException, "Coverage cache file " + cache_file + " is truncated!");
+		}
+		Chromosome chr(QByteArray(reinterpret_cast<const char*>(data_ + offset + 4), chr_length));
+		offset += 4 + chr_length;
+		int start = readValue<qint32>(data_, offset);
+		int end = readValue<qint32>(data_, offset + 4);
+		qint64 run_offset = readValue<qint64>(data_, offset + 8);
+		int run_count = readValue<qint32>(data_, offset + 16);
+		offset += 20;
+
+		if (run_count<1 || run_offset<HEADER_SIZE || run_offset + (qint64)run_count * RUN_SIZE > file_size)
+		{
+			THROW(FileParseException, "Coverage cache file " + cache_file + " contains invalid runs for region " + chr.str() + ":" + QString::number(start) + "-" + QString::number(end) + "!");
+		}
+
+		regions_.append(BedLine(chr, start, end));
+		region_offsets_ << run_offset;
+		region_run_counts_ << run_count;
+	}
+
+	index_ = new ChromosomalIndex<BedFile>(regions_);
+}
+
+CoverageCache::~CoverageCache()
+{
+	delete index_;
+	if (data_!=nullptr) file_.unmap(const_cast<uchar*>(data_));
+}
+
+void CoverageCache::create(const QString& bam_file, const BedFile& regions, const QString& cache_file, int min_mapq, int min_baseq, const QString& ref_file, int threads)
+{
+	//determine regions (sorted and merged, without annotations)
+	BedFile cache_regions;
+	if (regions.count()==0)
+	{
+		BamReader reader(bam_file, ref_file);
+		foreach(const Chromosome& chr, reader.chromosomes())
+		{
+			cache_regions.append(BedLine(chr, 1, reader.chromosomeSize(chr)));
+		}
+	}
+	else
+	{
+		for (int i=0; i<regions.count(); ++i)
+		{
+			const BedLine& line = regions[i];
+			cache_regions.append(BedLine(line.chr(), line.start(), line.end()));
+		}
+	}
+	cache_regions.sort();
+	cache_regions.merge(true, false, false);
+
+	//split regions into windows
+	QList<CoverageCacheWindow> windows;
+	for (int r=0; r<cache_regions.count(); ++r)
+	{
+		const BedLine& line = cache_regions[r];
+		for (int start=line.start(); start<=line.end(); start+=WINDOW_SIZE)
+		{
+			windows << CoverageCacheWindow{r, line.chr(), start, std::min(line.end(), start + WINDOW_SIZE - 1), QVector<DepthRun>()};
+		}
+	}
+
+	//open output file (header is written when finished)
+	QFileInfo bam_info(bam_file);
+	QByteArray bam_checksum = checksum(bam_file);
+	QSharedPointer<QFile> out = Helper::openFileForWriting(cache_file);
+	out->write(QByteArray(HEADER_SIZE, 0));
+
+	//process windows in batches (only one batch is kept in memory) and write runs
+	QVector<qint64> region_offsets(cache_regions.count(), -1);
+	QVector<int> region_run_counts(cache_regions.count(), 0);
+	qint64 offset = HEADER_SIZE;
+	DepthRun last_run{0, 0, -1};
+	const int batch_size = std::max(1, threads) * WINDOWS_PER_TASK;
+	for (int batch_start=0; batch_start<windows.count(); batch_start+=batch_size)
+	{
+		const int batch_end = std::min(windows.count(), batch_start + batch_size) - 1;
+
+		QThreadPool thread_pool;
+		thread_pool.setMaxThreadCount(threads);
+		QStringList errors;
+		for (int first=batch_start; first<=batch_end; first+=WINDOWS_PER_TASK)
+		{
+			errors << QString();
+		}
+		int task = 0;
+		for (int first=batch_start; first<=batch_end; first+=WINDOWS_PER_TASK)
+		{
+			int last = std::min(batch_end, first + WINDOWS_PER_TASK - 1);
+			thread_pool.start(new CoverageCacheWorker(windows, first, last, errors[task], bam_file, ref_file, min_mapq, min_baseq));
+			++task;
+		}
+		thread_pool.waitForDone();
+		foreach(const QString& error, errors)
+		{
+			if (!error.isEmpty()) THROW(Exception, error);
+		}
+
+		//write runs (runs with the same depth are merged across window borders)
+		QByteArray buffer;
+		for (int w=batch_start; w<=batch_end; ++w)
+		{
+			CoverageCacheWindow& window = windows[w];
+			const int r = window.region;
+			for (int i=0; i<window.runs.count(); ++i)
+			{
+				const DepthRun& run = window.runs[i];
+				if (region_run_counts[r]>0 && i==0 && run.depth==last_run.depth) continue;
+
+				if (region_run_counts[r]==0) region_offsets[r] = offset;
+				appendValue<qint32>(buffer, run.start);
+				appendValue<qint32>(buffer, run.depth);
+				offset += RUN_SIZE;
+				++region_run_counts[r];
+				last_run = run;
+			}
+			window.runs.clear();
+			window.runs.squeeze();
+		}
+		out->write(buffer);
+	}
+
+	//write region table
+	QByteArray table;
+	appendValue<qint32>(table, cache_regions.count());
+	for (int r=0; r<cache_regions.count(); ++r)
+	{
+		const BedLine& line = cache_regions[r];
+		appendValue<qint32>(table, line.chr().str().size());
+		table.append(line.chr().str());
+		appendValue<qint32>(table, line.start());
+		appendValue<qint32>(table, line.end());
+		appendValue<qint64>(table, region_offsets[r]);
+		appendValue<qint32>(table, region_run_counts[r]);
+	}
+	out->write(table);
+
+	//write header
+	QByteArray header = CACHE_MAGIC;
+	appendValue<qint32>(header, CACHE_VERSION);
+	appendValue<qint32>(header, min_mapq);
+	appendValue<qint32>(header, min_baseq);
+	appendValue<qint64>(header, bam_info.size());
+	appendValue<qint64>(header, bam_info.lastModified().toMSecsSinceEpoch());
+	appendValue<qint64>(header, offset);
+	header.append(bam_checksum);
+	out->seek(0);
+	out->write(header);
+	out->close();
+}
+
+QString CoverageCache::defaultFileName(const QString& bam_file)
+{
+	return bam_file + ".cov";
+}
+
+//Cache opened by CoverageCache::openIfValid and the file properties it was opened for
+struct OpenedCoverageCache
+{
+	QSharedPointer<CoverageCache> cache; //null if the cache file is invalid or outdated
+	qint64 cache_size;
+	qint64 cache_modified;
+	qint64 bam_size;
+	qint64 bam_modified;
+};
+static QMutex opened_caches_mutex;
+static QHash<QString, OpenedCoverageCache> opened_caches;
+
+QSharedPointer<CoverageCache> CoverageCache::openIfValid(const QString& bam_file, int min_mapq, int min_baseq)
+{
+	QFileInfo cache_info(defaultFileName(bam_file));
+	if (!cache_info.exists()) return QSharedPointer<CoverageCache>();
+	QFileInfo bam_info(bam_file);
+
+	//open cache file only if it was not opened before or if the cache/BAM/CRAM file changed since then
+	QMutexLocker locker(&opened_caches_mutex);
+	const QString key = cache_info.absoluteFilePath();
+	auto it = opened_caches.find(key);
+	if (it==opened_caches.end() || it->cache_size!=cache_info.size() || it->cache_modified!=cache_info.lastModified().toMSecsSinceEpoch() || it->bam_size!=bam_info.size() || it->bam_modified!=bam_info.lastModified().toMSecsSinceEpoch())
+	{
+		OpenedCoverageCache opened{QSharedPointer<CoverageCache>(), cache_info.size(), cache_info.lastModified().toMSecsSinceEpoch(), bam_info.size(), bam_info.lastModified().toMSecsSinceEpoch()};
+		try
+		{
+			QSharedPointer<CoverageCache> cache(new CoverageCache(key));
+			if (cache->isUpToDate(bam_file)) opened.cache = cache;
+		}
+		catch(Exception&)
+		{
+			//invalid cache files are ignored - the BAM/CRAM file is used instead
+		}
+		it = opened_caches.insert(key, opened);
+	}
+
+	const QSharedPointer<CoverageCache>& cache = it->cache;
+	if (!cache.isNull() && cache->minMapq()==min_mapq && cache->minBaseq()==min_baseq)
+	{
+		return cache;
+	}
+
+	return QSharedPointer<CoverageCache>();
+}
+
+bool CoverageCache::isUpToDate(const QString& bam_file) const
+{
+	QFileInfo bam_info(bam_file);
+	if (bam_info.size()!=bam_size_ || bam_info.lastModified().toMSecsSinceEpoch()!=bam_modified_) return false;
+
+	try
+	{
+		return checksum(bam_file)==bam_checksum_;
+	}
+	catch(Exception&)
+	{
+		return false;
+	}
+}
+
+QByteArray CoverageCache::checksum(const QString& bam_file)
+{
+	QFile file(bam_file);
+	if (!file.open(QFile::ReadOnly))
+	{
+		THROW(FileAccessException, "Could not open file " + bam_file + " for reading: " + file.errorString());
+	}
+
+	QCryptographicHash hash(QCryptographicHash::Md5);
+	hash.addData(file.read(CHECKSUM_BYTES));
+	if (file.size()>CHECKSUM_BYTES)
+	{
+		file.seek(std::max(CHECKSUM_BYTES, file.size() - CHECKSUM_BYTES));
+		hash.addData(file.read(CHECKSUM_BYTES));
+	}
+	return hash.result();
+}
+
+bool CoverageCache::contains(const Chromosome& chr, int start, int end) const
+{
+	return regionIndex(chr, start, end)!=-1;
+}
+
+bool CoverageCache::contains(const BedFile& regions) const
+{
+	for (int i=0; i<regions.count(); ++i)
+	{
+		const BedLine& line = regions[i];
+		if (!contains(line.chr(), line.start(), line.end())) return false;
+	}
+	return true;
+}
+
+QVector<DepthRun> CoverageCache::runs(const Chromosome& chr, int start, int end) const
+{
+	int r = regionIndex(chr, start, end);
+	if (r==-1)
+	{
+		THROW(ArgumentException, "Region " + chr.str() + ":" + QString::number(start) + "-" + QString::number(end) + " is not contained in the coverage cache " + file_.fileName() + "!");
+	}
+
+	//binary search for the last run starting at or before the start position
+	const int run_count = region_run_counts_[r];
+	int run = 0;
+	int high = run_count - 1;
+	while (run<high)
+	{
+		int mid = (run + high + 1) / 2;
+		if (runStart(r, mid)<=start)
+		{
+			run = mid;
+		}
+		else
+		{
+			high = mid - 1;
+		}
+	}
+
+	//collect runs
+	QVector<DepthRun> output;
+	const int region_end = regions_[r].end();
+	for (; run<run_count; ++run)
+	{
+		int run_start = runStart(r, run);
+		if (run_start>end) break;
+		int run_end = (run+1<run_count) ? runStart(r, run+1) - 1 : region_end;
+		output.append(DepthRun{std::max(run_start, start), std::min(run_end, end), runDepth(r, run)});
+	}
+
+	return output;
+}
+
+long long CoverageCache::depthSum(const Chromosome& chr, int start, int end) const
+{
+	long long sum = 0;
+	foreach(const DepthRun& run, runs(chr, start, end))
+	{
+		sum += (long long)(run.end - run.start + 1) * run.depth;
+	}
+	return sum;
+}
+
+int CoverageCache::regionIndex(const Chromosome& chr, int start, int end) const
+{
+	foreach(int index, index_->matchingIndices(chr, start, end))
+	{
+		const BedLine& line = regions_[index];
+		if (line.start()<=start && end<=line.end()) return index;
+	}
+	return -1;
+}
+
+int CoverageCache::runStart(int region, int run) const
+{
+	return readValue<qint32>(data_, region_offsets_[region] + (qint64)run * RUN_SIZE);
+}
+
+int CoverageCache::runDepth(int region, int run) const
+{
+	return readValue<qint32>(data_, region_offsets_[region] + (qint64)run * RUN_SIZE + 4);
+}
@@ -0,0 +1,97 @@
+#ifndef COVERAGECACHE_H
+#define COVERAGECACHE_H
+
+#include "cppNGS_global.h"
+#include "BedFile.h"
+#include "ChromosomalIndex.h"
+#include <QFile>
+#include <QSharedPointer>
+#include <QVector>
+
+///Stretch of bases with the same depth (1-based, closed interval).
+struct CPPNGSSHARED_EXPORT DepthRun
+{
+	int start;
+	int end;
+	int depth;
+};
+
+/**
+  @brief Persistent per-sample depth cache of a BAM/CRAM file.
+
+  The depth of the cached regions is stored as run-length encoded runs in a binary file next to the BAM/CRAM file (see defaultFileName).
+  The cache is only valid for the mapping/base quality cutoffs it was created with and for the BAM/CRAM file it was created from (file size, modification time and a checksum of the first and last 64KB of the file are checked).
+  Lookups use a memory-mapped file and are thread-safe.
+*/
+class CPPNGSSHARED_EXPORT CoverageCache
+{
+public:
+	///Opens a cache file. Throws an exception if the file is not a valid cache file.
+	CoverageCache(const QString& cache_file);
+	///Destructor.
+	~CoverageCache();
+
+	///Creates the cache file for the given regions of a BAM/CRAM file. If @p regions is empty, all chromosomes of the BAM/CRAM header are cached.
+	static void create(const QString& bam_file, const BedFile& regions, const QString& cache_file, int min_mapq, int min_baseq, const QString& ref_file = QString(), int threads = 1);
+	///Returns the default cache file name of a BAM/CRAM file.
+	static QString defaultFileName(const QString& bam_file);
+	///Returns the default cache of the BAM/CRAM file if it exists, is up-to-date and was created with the given cutoffs. Otherwise a null pointer is returned.
+	///The cache is opened only once per process. Later calls only check the file size and modification time of the BAM/CRAM file and the cache file.
+	static QSharedPointer<CoverageCache> openIfValid(const QString& bam_file, int min_mapq, int min_baseq);
+
+	///Returns the minimum mapping quality used to create the cache.
+	int minMapq() const
+	{
+		return min_mapq_;
+	}
+	///Returns the minimum base quality used to create the cache.
+	int minBaseq() const
+	{
+		return min_baseq_;
+	}
+	///Returns the cached regions (sorted and merged).
+	const BedFile& regions() const
+	{
+		return regions_;
+	}
+	///Returns if the BAM/CRAM file size, modification time and checksum match the values stored in the cache.
+	bool isUpToDate(const QString& bam_file) const;
+
+	///Returns if the range is fully contained in the cached regions.
+	bool contains(const Chromosome& chr, int start, int end) const;
+	///Returns if all regions of the BED file are fully contained in the cached regions.
+	bool contains(const BedFile& regions) const;
+
+	///Returns the depth runs of a range, clipped to the range. Throws an ArgumentException if the range is not fully contained in the cached regions.
+	QVector<DepthRun> runs(const Chromosome& chr, int start, int end) const;
+	///Returns the sum of the depth of all bases in the range. Throws an ArgumentException if the range is not fully contained in the cached regions.
+	long long depthSum(const Chromosome& chr, int start, int end) const;
+
+protected:
+	QFile file_;
+	const uchar* data_ = nullptr;
+	int min_mapq_;
+	int min_baseq_;
+	qint64 bam_size_;
+	qint64 bam_modified_;
+	QByteArray bam_checksum_;
+	BedFile regions_;
+	QVector<qint64> region_offsets_; //file offset of the first run of each region
+	QVector<int> region_run_counts_; //number of runs of each region
+	ChromosomalIndex<BedFile>* index_ = nullptr;
+
+	//Returns the MD5 checksum of the first and last 64KB of a BAM/CRAM file
+	static QByteArray checksum(const QString& bam_file);
+	//Returns the index of the region that contains the range, or -1 if the range is not fully contained in a region.
+	int regionIndex(const Chromosome& chr, int start, int end) const;
+	//Returns the start position of a run
+	int runStart(int region, int run) const;
+	//Returns the depth of a run
+	int runDepth(int region, int run) const;
+
+	//"declared away" methods
+	CoverageCache(const CoverageCache&) = delete;
+	CoverageCache& operator=(const CoverageCache&) = delete;
+};
+
+#endif // COVERAGECACHE_H
@@ -0,0 +1,321 @@
+#include "CoverageMatrix.h"
+#include "Exceptions.h"
+#include "Helper.h"
+#include "VersatileFile.h"
+#include <QFileInfo>
+#include <QtEndian>
+#include <cstring>
+
+//File layout (little-endian):
+//  header: magic (8 bytes), version, row count, sample count, reserved (qint32), data offset, sample table offset (qint64), padding to 64 bytes
+//  region table: for each row: chromosome name length (qint32), chromosome name, start, end (qint32)
+//  data: one column of row count depth values (double) per sample, starting at the data offset (aligned to 64 bytes)
+//  sample table: for each sample: name length (qint32), name, file name length (qint32), file name (UTF-8)
+static const QByteArray MATRIX_MAGIC = "NGSCOVMX";
+static const int MATRIX_VERSION = 2;
+static const int HEADER_SIZE = 64;
+static const int DATA_ALIGNMENT = 64;
+
+//Appends a little-endian integer to a buffer
+template<typename T>
+static void appendValue(QByteArray& buffer, T value)
+{
+	char bytes[sizeof(T)];
+	qToLittleEndian<T>(value, bytes);
+	buffer.append(bytes, sizeof(T));
+}
+
+//Reads a little-endian integer from a memory-mapped file
+template<typename T>
+static T readValue(const uchar* data, qint64 offset)
+{
+	return qFromLittleEndian<T>(data + offset);
+}
+
+//Reads a string with length prefix from a memory-mapped file and advances the offset
+static QByteArray readString(const uchar* data, qint64& offset, qint64 file_size, const QString& matrix_file)
+{
+	if (offset + 4 > file_size) THROW(FileParseException, "Coverage matrix file " + matrix_file + " is truncated!");
+	int length = readValue<qint32>(data, offset);
+	if (length<0 || offset + 4 + length > file_size) THROW(FileParseException, "Coverage matrix file " + matrix_file + " is truncated!");
+	QByteArray output(reinterpret_cast<const char*>(data + offset + 4), length);
+	offset += 4 + length;
+	return output;
+}
+
+//Appends a string with length prefix to a buffer
+static void appendString(QByteArray& buffer, const QByteArray& str)
+{
+	appendValue<qint32>(buffer, str.size());
+	buffer.append(str);
+}
+
+void SampleCoverageProfile::load(const QString& file)
+{
+	name.clear();
+	filename = file;
+	regions.clear();
+	depth.clear();
+
+	QSharedPointer<VersatileFile> stream = Helper::openVersatileFileForReading(file);
+	while(!stream->atEnd())
+	{
+		QByteArray line = stream->readLine();
+		while (line.endsWith('\n') || line.endsWith('\r')) line.chop(1);
+
+		//skip empty lines
+		if(line.length()==0) continue;
+
+		//header (sample name)
+		if (line.startsWith("#") || line.startsWith("track ") || line.startsWith("browser "))
+		{
+			if (line.startsWith("#chr\t"))
+			{
+				QByteArrayList fields = line.split('\t');
+				if (fields.count()>3) name = fields[3].trimmed();
+			}
+			continue;
+		}
+
+		//error when less than 4 fields
+		QByteArrayList fields = line.split('\t');
+		if (fields.count()<4)
+		{
+			THROW(FileParseException, "COV file line with less than four fields found: '" + line.trimmed() + "'");
+		}
+
+		//check that start/end/depth are numbers
+		bool ok = true;
+		int start = fields[1].toInt(&ok) + 1;
+		if (!ok) THROW(FileParseException, "COV file line with invalid starts position found: '" + line.trimmed() + "'");
+		int end = fields[2].toInt(&ok);
+		if (!ok) THROW(FileParseException, "COV file line with invalid end position found: '" + line.trimmed() + "'");
+		double value = fields[3].toDouble(&ok);
+		if (!ok) THROW(FileParseException, "COV file line with invalid coverage score found: '" + line.trimmed() + "'");
+
+		regions.append(BedLine(fields[0], start, end));
+		depth << value;
+	}
+
+	//fallback sample name
+	if (name.isEmpty())
+	{
+		QString tmp = QFileInfo(file).fileName();
+		if (tmp.endsWith(".gz", Qt::CaseInsensitive)) tmp.chop(3);
+		if (tmp.endsWith(".bed", Qt::CaseInsensitive)) tmp.chop(4);
+		if (tmp.endsWith(".cov", Qt::CaseInsensitive)) tmp.chop(4);
+		name = tmp.toUtf8();
+	}
+}
+
+CoverageMatrix::CoverageMatrix(const QString& matrix_file)
+	: file_(matrix_file)
+{
+#if Q_BYTE_ORDER != Q_LITTLE_ENDIAN
+	THROW(NotImplementedException, "Coverage matrix files are only supported on little-endian systems!");
+#endif
+
+	if (!file_.open(QFile::ReadOnly))
+	{
+		THROW(FileAccessException, "Could not open coverage matrix file " + matrix_file + " for reading: " + file_.errorString());
+	}
+	qint64 file_size = file_.size();
+	if (file_size<HEADER_SIZE)
+	{
+		THROW(FileParseException, "Coverage matrix file " + matrix_file + " is truncated!");
+	}
+	data_ = file_.map(0, file_size);
+	if (data_==nullptr)
+	{
+		THROW(FileAccessException, "Could not memory-map coverage matrix file " + matrix_file + ": " + file_.errorString());
+	}
+
+	//header
+	if (QByteArray(reinterpret_cast<const char*>(data_), MATRIX_MAGIC.size())!=MATRIX_MAGIC)
+	{
+		THROW(FileParseException, "File " + matrix_file + " is not a coverage matrix file!");
+	}
+	int version = readValue<qint32>(data_, 8);
+	if (version!=MATRIX_VERSION)
+	{
+		THROW(FileParseException, "Coverage matrix file " + matrix_file + " has unsupported version " + QString::number(version) + "!");
+	}
+	int row_count = readValue<qint32>(data_, 12);
+	int sample_count = readValue<qint32>(data_, 16);
+	data_offset_ = readValue<qint64>(data_, 24);
+	qint64 table_offset = readValue<qint64>(data_, 32);
+	if (row_count<0 || sample_count<0 || data_offset_<HEADER_SIZE || data_offset_%DATA_ALIGNMENT!=0 || table_offset!=data_offset_ + (qint64)sample_count * row_count * sizeof(double) || table_offset>file_size)
+	{
+		THROW(FileParseException, "Coverage matrix file " + matrix_file + " has an invalid header!");
+	}
+
+	//region table
+	qint64 offset = HEADER_SIZE;
+	for (int i=0; i<row_count; ++i)
+	{
+		Chromosome chr(readString(data_, offset, data_offset_, matrix_file));
+		if (offset + 8 > data_offset_) THROW(FileParseException, "Coverage matrix file " + matrix_file + " is truncated!");
+		int start = readValue<qint32>(data_, offset);
+		int end = readValue<qint32>(data_, offset + 4);
+		offset += 8;
+		regions_.append(BedLine(chr, start, end));
+	}
+
+	//sample table
+	offset = table_offset;
+	for (int i=0; i<sample_count; ++i)
+	{
+		names_ << readString(data_, offset, file_size, matrix_file);
+		files_ << QString::fromUtf8(readString(data_, offset, file_size, matrix_file));
+	}
+}
+
+CoverageMatrix::~CoverageMatrix()
+{
+	if (data_!=nullptr) file_.unmap(const_cast<uchar*>(data_));
+}
+
+void CoverageMatrix::append(const QString& matrix_file, const QList<SampleCoverageProfile>& profiles)
+{
+	if (profiles.isEmpty()) return;
+
+	CoverageMatrixWriter writer(matrix_file);
+	writer.append(profiles);
+	writer.commit();
+}
+
+CoverageMatrixWriter::CoverageMatrixWriter(const QString& matrix_file)
+	: matrix_file_(matrix_file)
+	, file_(matrix_file)
+	, regions_written_(false)
+	, data_offset_(0)
+{
+	//open old file before the new file is created
+	QScopedPointer<CoverageMatrix> old_matrix;
+	if (QFile::exists(matrix_file))
+	{
+		old_matrix.reset(new CoverageMatrix(matrix_file));
+	}
+
+	//write a new file that replaces the old file when complete, so that a crash or concurrent readers never see a partially written matrix
+	if (!file_.open(QFile::WriteOnly))
+	{
+		THROW(FileAccessException, "Could not open coverage matrix file " + matrix_file + " for writing: " + file_.errorString());
+	}
+
+	//header placeholder (written by commit)
+	file_.write(QByteArray(HEADER_SIZE, 0));
+
+	//region table and columns of the old file (copied once)
+	if (!old_matrix.isNull())
+	{
+		regions_ = old_matrix->regions_;
+		names_ = old_matrix->names_;
+		files_ = old_matrix->files_;
+		data_offset_ = old_matrix->data_offset_;
+
+		const qint64 old_table_offset = data_offset_ + (qint64)names_.count() * regions_.count() * sizeof(double);
+		file_.write(reinterpret_cast<const char*>(old_matrix->data_) + HEADER_SIZE, old_table_offset - HEADER_SIZE);
+		regions_written_ = true;
+	}
+}
+
+void CoverageMatrixWriter::append(const QList<SampleCoverageProfile>& profiles)
+{
+	if (profiles.isEmpty()) return;
+
+	//region table of a new file (regions of the first profile)
+	if (!regions_written_)
+	{
+		const BedFile& first = profiles[0].regions;
+		QByteArray region_table;
+		for (int i=0; i<first.count(); ++i)
+		{
+			const BedLine& line = first[i];
+			regions_.append(BedLine(line.chr(), line.start(), line.end()));
+			appendString(region_table, line.chr().str());
+			appendValue<qint32>(region_table, line.start());
+			appendValue<qint32>(region_table, line.end());
+		}
+		while ((HEADER_SIZE + region_table.size())%DATA_ALIGNMENT!=0) region_table.append('\0');
+		data_offset_ = HEADER_SIZE + region_table.size();
+		file_.write(region_table);
+		regions_written_ = true;
+	}
+
+	//check profiles
+	foreach(const SampleCoverageProfile& profile, profiles)
+	{
+		if (names_.contains(profile.name))
+		{
+			THROW(ArgumentException, "Sample '" + profile.name + "' of file " + profile.filename + " is already contained in coverage matrix " + matrix_file_ + "!");
+		}
+		if (profile.regions.count()!=regions_.count())
+		{
+			THROW(ArgumentException, "Coverage profile " + profile.filename + " contains a different number of regions (" + QString::number(profile.regions.count()) + ") than coverage matrix " + matrix_file_ + " (" + QString::number(regions_.count()) + ")!");
+		}
+		for (int i=0; i<regions_.count(); ++i)
+		{
+			const BedLine& line = profile.regions[i];
+			const BedLine& expected = regions_[i];
+			if (line.chr()!=expected.chr() || line.start()!=expected.start() || line.end()!=expected.end())
+			{
+				THROW(ArgumentException, "Region '" + line.toString(true) + "' of coverage profile " + profile.filename + " does not match region '" + expected.toString(true) + "' of coverage matrix " + matrix_file_ + "!");
+			}
+		}
+		names_ << profile.name;
+		files_ << profile.filename;
+	}
+
+	//new columns
+	foreach(const SampleCoverageProfile& profile, profiles)
+	{
+		QByteArray buffer;
+		buffer.reserve(profile.depth.count() * sizeof(double));
+		foreach(double value, profile.depth)
+		{
+			quint64 bits;
+			memcpy(&bits, &value, sizeof(double));
+			appendValue<quint64>(buffer, bits);
+		}
+		file_.write(buffer);
+	}
+}
+
+void CoverageMatrixWriter::commit()
+{
+	//nothing appended to a new file
+	if (!regions_written_)
+	{
+		file_.cancelWriting();
+		return;
+	}
+
+	//sample table
+	const qint64 table_offset = data_offset_ + (qint64)names_.count() * regions_.count() * sizeof(double);
+	QByteArray table;
+	for (int i=0; i<names_.count(); ++i)
+	{
+		appendString(table, names_[i]);
+		appendString(table, files_[i].toUtf8());
+	}
+	file_.write(table);
+	const bool size_ok = file_.pos()==table_offset + table.size();
+
+	//header
+	QByteArray header = MATRIX_MAGIC;
+	appendValue<qint32>(header, MATRIX_VERSION);
+	appendValue<qint32>(header, regions_.count());
+	appendValue<qint32>(header, names_.count());
+	appendValue<qint32>(header, 0);
+	appendValue<qint64>(header, data_offset_);
+	appendValue<qint64>(header, table_offset);
+	header.append(HEADER_SIZE - header.size(), '\0');
+	file_.seek(0);
+	file_.write(header);
+
+	if (!size_ok || !file_.commit())
+	{
+		THROW(FileAccessException, "Could not write coverage matrix file " + matrix_file_ + ": " + file_.errorString());
+	}
+}
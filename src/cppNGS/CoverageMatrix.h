@@ -0,0 +1,125 @@
+#ifndef COVERAGEMATRIX_H
+#define COVERAGEMATRIX_H
+
+#include "cppNGS_global.h"
+#include "BedFile.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QScopedPointer>
+#include <QVector>
+
+///Coverage profile of one sample, i.e. the average depth of each region.
+struct CPPNGSSHARED_EXPORT SampleCoverageProfile
+{
+	QByteArray name; //sample name
+	QString filename; //file the profile was loaded from
+	BedFile regions;
+	QVector<double> depth;
+
+	///Loads a coverage profile in BED format (GZ files supported). The sample name is taken from the fourth column of the '#chr' header line. If there is no header line, it is derived from the file name.
+	void load(const QString& file);
+};
+
+/**
+  @brief Binary column-major matrix of coverage profiles with one column per sample, e.g. for the selection of a CNV reference cohort.
+
+  The depth values are stored as 64-bit floats, i.e. they are written to text output with the same precision as they were read. Each column is a contiguous array in the memory-mapped file, i.e. columns can be processed without copying or parsing.
+  Samples can be appended to an existing matrix file (see CoverageMatrixWriter). The file is rewritten once and replaces the old file when complete, i.e. readers never see a partially written file. Appending to the same file from several processes at the same time is not supported.
+  Read access is thread-safe.
+*/
+class CPPNGSSHARED_EXPORT CoverageMatrix
+{
+public:
+	///Opens a matrix file. Throws an exception if the file is not a valid matrix file.
+	CoverageMatrix(const QString& matrix_file);
+	///Destructor.
+	~CoverageMatrix();
+
+	///Appends coverage profiles to a matrix file. If the file does not exist, it is created with the regions of the first profile.
+	///Throws an exception if the regions of a profile do not match the regions of the matrix or if a sample is already contained.
+	///Note: the file is rewritten by each call. Use CoverageMatrixWriter to append profiles in several batches.
+	static void append(const QString& matrix_file, const QList<SampleCoverageProfile>& profiles);
+
+	///Returns the number of rows (regions).
+	int rowCount() const
+	{
+		return regions_.count();
+	}
+	///Returns the number of columns (samples).
+	int sampleCount() const
+	{
+		return names_.count();
+	}
+	///Returns the regions of the rows.
+	const BedFile& regions() const
+	{
+		return regions_;
+	}
+	///Returns the name of a sample.
+	const QByteArray& sampleName(int sample) const
+	{
+		return names_[sample];
+	}
+	///Returns the file a sample was loaded from.
+	const QString& sampleFile(int sample) const
+	{
+		return files_[sample];
+	}
+	///Returns the index of a sample or -1 if the sample is not contained.
+	int sampleIndex(const QByteArray& name) const
+	{
+		return names_.indexOf(name);
+	}
+	///Returns the depth values of a sample (rowCount() values).
+	const double* column(int sample) const
+	{
+		return reinterpret_cast<const double*>(data_ + data_offset_) + (qint64)sample * regions_.count();
+	}
+
+protected:
+	QFile file_;
+	const uchar* data_ = nullptr;
+	qint64 data_offset_;
+	BedFile regions_;
+	QByteArrayList names_;
+	QStringList files_;
+
+	//"declared away" methods
+	CoverageMatrix(const CoverageMatrix&) = delete;
+	CoverageMatrix& operator=(const CoverageMatrix&) = delete;
+
+	friend class CoverageMatrixWriter;
+};
+
+/**
+  @brief Appends coverage profiles to a matrix file in batches.
+
+  The columns of an existing matrix file are copied to the new file only once, when the writer is created. The columns of each batch are written when the batch is appended.
+  The sample table and header are written by commit(), which replaces the old file. If commit() is not called, e.g. because of an exception, the old file is not modified.
+*/
+class CPPNGSSHARED_EXPORT CoverageMatrixWriter
+{
+public:
+	///Opens a matrix file for appending. If the file does not exist, it is created with the regions of the first appended profile.
+	CoverageMatrixWriter(const QString& matrix_file);
+
+	///Appends coverage profiles. Throws an exception if the regions of a profile do not match the regions of the matrix or if a sample is already contained.
+	void append(const QList<SampleCoverageProfile>& profiles);
+	///Writes the sample table and header and replaces the old file. If no profiles were appended to a new file, no file is created.
+	void commit();
+
+protected:
+	QString matrix_file_;
+	QSaveFile file_;
+	bool regions_written_;
+	BedFile regions_;
+	QByteArrayList names_;
+	QStringList files_;
+	qint64 data_offset_;
+
+	//"declared away" methods
+	CoverageMatrixWriter(const CoverageMatrixWriter&) = delete;
+	CoverageMatrixWriter& operator=(const CoverageMatrixWriter&) = delete;
+};
+
+#endif // COVERAGEMATRIX_H
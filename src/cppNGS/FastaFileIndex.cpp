@@ -5,6 +5,8 @@
 #include <QNetworkProxy>
 #include <QRegExp>
 #include <QStringList>
+#include <QMutexLocker>
+#include <cstring>
 #include "HttpRequestHandler.h"
 
 using namespace std;
@@ -32,12 +34,19 @@ FastaFileIndex::FastaFileIndex(QString fasta_file)
 	}
 	else
 	{
-		//open FASTA file handle
-		if (!file_.open(QIODevice::ReadOnly | QIODevice::Text))
+		//open FASTA file handle (newlines are skipped using the line length from the index, so the file is opened in binary mode)
+		if (!file_.open(QIODevice::ReadOnly))
 		{
 			THROW(FileAccessException, "Could not open FASTA file '" + fasta_name_ + "' for reading!");
 		}
 
+		//memory-map FASTA file (if not possible, e.g. on 32-bit systems, seek/read is used)
+		if (file_.size()>0)
+		{
+			data_ = file_.map(0, file_.size());
+			if (data_!=nullptr) data_size_ = file_.size();
+		}
+
 		//load index file
 		int linenum = 0;
 		QSharedPointer<QFile> file = Helper::openFileForReading(index_name_);
@@ -64,6 +73,7 @@ FastaFileIndex::~FastaFileIndex()
 {
 	if (isLocal())
 	{
+		if (data_!=nullptr) file_.unmap(const_cast<uchar*>(data_));
 		file_.close();
 	}
 }
@@ -71,43 +81,103 @@ FastaFileIndex::~FastaFileIndex()
 Sequence FastaFileIndex::seq(const Chromosome& chr, bool to_upper) const
 {
 	const FastaIndexEntry& entry = index(chr);
+	return seq(chr, 1, entry.length, to_upper);
+}
 
-	if (isLocal())
+Sequence FastaFileIndex::seq(const Chromosome& chr, int start, int length, bool to_upper) const
+{
+	//subtract 1 to make the coordinates 0-based
+	start -= 1;
+	const FastaIndexEntry& entry = checkRange(chr, start, length);
+	if (length==0) return Sequence();
+
+	//memory-mapped: copy directly from file data
+	if (data_!=nullptr)
 	{
-		//jump to postion
-		if (!file_.seek(entry.offset))
+		if (filePos(entry, start + length - 1)>=data_size_)
 		{
-			THROW(FileAccessException, "QFile::seek did not work on " + fasta_name_ + "'!");
+			THROW(FileAccessException, "FASTA file '" + fasta_name_ + "' is shorter than expected from the index!");
 		}
+		return extract(entry, reinterpret_cast<const char*>(data_), 0, start, length, to_upper);
 	}
 
 	//read data
-	int newlines_in_sequence = entry.length / entry.line_blen;
-	int seqlen = newlines_in_sequence  + entry.length;
-	Sequence output {};
+	qint64 read_start_pos = filePos(entry, start);
+	QByteArray raw = readRaw(read_start_pos, filePos(entry, start + length - 1) + 1 - read_start_pos);
+	return extract(entry, raw.constData(), read_start_pos, start, length, to_upper);
+}
 
-	if (isLocal())
+QList<Sequence> FastaFileIndex::seqs(const BedFile& regions, bool to_upper) const
+{
+	QList<Sequence> output;
+
+	//memory-mapped: no need to read blocks
+	if (data_!=nullptr)
 	{
-		output = file_.read(seqlen).replace('\n', "");
+		for (int i=0; i<regions.count(); ++i)
+		{
+			const BedLine& line = regions[i];
+			output << seq(line.chr(), line.start(), line.length(), to_upper);
+		}
+		return output;
 	}
-	else
+
+	//read blocks of sorted regions on the same chromosome in one pass (at most 10MB per block)
+	const qint64 max_block_size = 10000000;
+	int i = 0;
+	while (i<regions.count())
 	{
-		QString byte_range = "bytes=" + QString::number(entry.offset) + "-" + QString::number(entry.offset + seqlen -1);
-		HttpHeaders add_headers;
-		add_headers.insert("Accept", "text/plain");
-		add_headers.insert("Range", byte_range.toUtf8());
-        output = HttpRequestHandler(QNetworkProxy(QNetworkProxy::NoProxy)).get(fasta_name_, add_headers).body.replace("\n", 1, "", 0);
+		const Chromosome& chr = regions[i].chr();
+		QVector<QPair<int, int>> ranges; //0-based start and length of the regions in the block
+		qint64 block_start = -1;
+		qint64 block_end = -1;
+		const FastaIndexEntry* entry = nullptr;
+		while (i<regions.count())
+		{
+			const BedLine& line = regions[i];
+			if (line.chr()!=chr) break;
+			if (!ranges.isEmpty() && line.start()-1<ranges.last().first) break;
+
+			int start = line.start() - 1;
+			int length = line.length();
+			entry = &checkRange(chr, start, length);
+			if (length>0)
+			{
+				qint64 start_pos = filePos(*entry, start);
+				qint64 end_pos = filePos(*entry, start + length - 1) + 1;
+				if (block_start==-1)
+				{
+					block_start = start_pos;
+					block_end = end_pos;
+				}
+				else if (std::max(end_pos, block_end) - block_start > max_block_size)
+				{
+					break;
+				}
+				else
+				{
+					block_end = std::max(end_pos, block_end);
+				}
+			}
+
+			ranges << qMakePair(start, length);
+			++i;
+		}
+
+		//extract sequences
+		QByteArray raw;
+		if (block_start!=-1) raw = readRaw(block_start, block_end - block_start);
+		foreach(const auto& range, ranges)
+		{
+			output << extract(*entry, raw.constData(), block_start, range.first, range.second, to_upper);
+		}
 	}
 
-	//output
-	if (to_upper) output = output.toUpper();
 	return output;
 }
 
-Sequence FastaFileIndex::seq(const Chromosome& chr, int start, int length, bool to_upper) const
+const FastaFileIndex::FastaIndexEntry& FastaFileIndex::checkRange(const Chromosome& chr, int start, int& length) const
 {
-	//subtract 1 to make the coordinates 0-based
-	start -= 1;
 	if (start < 0)
 	{
 		THROW(ProgrammingException, "FastaFileIndex::seq: Invalid start position (" + QString::number(start) + ") for " + chr.strNormalized(true) + ":" + QString::number(start+1) + "-" + QString::number(start+length));
@@ -129,38 +199,64 @@ Sequence FastaFileIndex::seq(const Chromosome& chr, int start, int length, bool
 		length = min(length, entry.length - start);
 	}
 
-	//jump to postion
-	int newlines_before = start > 0 ? (start - 1) / entry.line_blen : 0;
-	qint64 read_start_pos = entry.offset + newlines_before + start;
+	return entry;
+}
+
+QByteArray FastaFileIndex::readRaw(qint64 pos, qint64 length) const
+{
+	QByteArray output;
 	if (isLocal())
 	{
-		if (!file_.seek(read_start_pos))
+		QMutexLocker locker(&file_mutex_);
+		if (!file_.seek(pos))
 		{
 			THROW(FileAccessException, "QFile::seek did not work on " + fasta_name_ + "'!");
 		}
-	}
-
-	//read data
-	int newlines_by_end = (start + length - 1) / entry.line_blen;
-	int newlines_inside = newlines_by_end - newlines_before;
-	int seqlen = length + newlines_inside;
-	Sequence output {};
-
-	if (isLocal())
-	{
-		output = file_.read(seqlen).replace('\n', "");
+		output = file_.read(length);
 	}
 	else
 	{
-		QString byte_range = "bytes=" + QString::number(read_start_pos) + "-" + QString::number(read_start_pos + seqlen - 1);
+		QString byte_range = "bytes=" + QString::number(pos) + "-" + QString::number(pos + length - 1);
 		HttpHeaders add_headers;
 		add_headers.insert("Accept", "text/plain");
 		add_headers.insert("Range", byte_range.toUtf8());
-        output = HttpRequestHandler(QNetworkProxy(QNetworkProxy::NoProxy)).get(fasta_name_, add_headers).body.replace("\n", 1, "", 0);
+		output = HttpRequestHandler(QNetworkProxy(QNetworkProxy::NoProxy)).get(fasta_name_, add_headers).body;
+	}
+
+	if (output.size()!=length)
+	{
+		THROW(FileAccessException, "Could not read " + QString::number(length) + " bytes at position " + QString::number(pos) + " from FASTA file '" + fasta_name_ + "'!");
+	}
+
+	return output;
+}
+
+Sequence FastaFileIndex::extract(const FastaIndexEntry& entry, const char* data, qint64 data_pos, int start, int length, bool to_upper)
+{
+	Sequence output;
+	output.resize(length);
+	char* out = output.data();
+
+	//copy line by line
+	int pos = start;
+	const int end = start + length;
+	while (pos<end)
+	{
+		int chunk = std::min(end - pos, entry.line_blen - pos % entry.line_blen);
+		memcpy(out, data + (filePos(entry, pos) - data_pos), chunk);
+		out += chunk;
+		pos += chunk;
+	}
+
+	if (to_upper)
+	{
+		char* seq = output.data();
+		for (int i=0; i<length; ++i)
+		{
+			if (seq[i]>='a' && seq[i]<='z') seq[i] -= 32;
+		}
 	}
 
-	//output
-	if (to_upper) output = output.toUpper();
 	return output;
 }
 
@@ -4,10 +4,13 @@
 #include "cppNGS_global.h"
 #include "Chromosome.h"
 #include "Sequence.h"
+#include "BedFile.h"
 #include <QMap>
 #include <QFile>
+#include <QMutex>
 
 ///Fasta file index for fast access to seqences in a FASTA file.
+///Local FASTA files are memory-mapped if possible. All sequence access methods are thread-safe, i.e. one index can be shared between threads.
 class CPPNGSSHARED_EXPORT FastaFileIndex
 {
 public:
@@ -20,6 +23,8 @@ public:
 	Sequence seq(const Chromosome& chr, bool to_upper = true) const;
 	///Returns the sequence corresponding to the given chromosome and range (start is 1-based). If the coordinates are invalid, an empty string is returned.
 	Sequence seq(const Chromosome& chr, int start, int length, bool to_upper = true) const;
+	///Returns the sequences of the given regions (in the same order). Sorted regions are fetched in one pass, i.e. this is much faster than calling seq() for each region if the FASTA file is not memory-mapped.
+	QList<Sequence> seqs(const BedFile& regions, bool to_upper = true) const;
 
 	///Returns the length of the given chromosome.
 	int lengthOf(const Chromosome& chr) const
@@ -46,9 +51,24 @@ protected:
 	};
 	QMap<QString, FastaIndexEntry> index_;
 	mutable QFile file_;
+	mutable QMutex file_mutex_; //guards seek/read of 'file_'
+	const uchar* data_ = nullptr; //memory-mapped file content (nullptr if not mapped)
+	qint64 data_size_ = 0; //size of memory-mapped file content
 	const FastaIndexEntry& index(const Chromosome& chr) const;
 	bool isLocal() const;
 	void saveEntryToIndex(const QList<QByteArray>& fields);
+
+	//Checks the range (0-based start) and restricts it to the chromosome length. Returns the index entry of the chromosome.
+	const FastaIndexEntry& checkRange(const Chromosome& chr, int start, int& length) const;
+	//Returns the file offset of a sequence position (0-based).
+	static qint64 filePos(const FastaIndexEntry& entry, int pos)
+	{
+		return entry.offset + (qint64)(pos / entry.line_blen) * entry.line_len + pos % entry.line_blen;
+	}
+	//Reads raw data from the FASTA file (local file or URL).
+	QByteArray readRaw(qint64 pos, qint64 length) const;
+	//Copies the sequence range (0-based start) from raw data starting at file offset 'data_pos', skipping newlines.
+	static Sequence extract(const FastaIndexEntry& entry, const char* data, qint64 data_pos, int start, int length, bool to_upper);
 };
 
 #endif
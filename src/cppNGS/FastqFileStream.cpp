@@ -1,4 +1,5 @@
 #include "FastqFileStream.h"
+#include "htslib/hts.h"
 
 void FastqEntry::validate(bool long_read) const
 {
@@ -116,33 +117,49 @@ int FastqEntry::trimN(int num_n)
     return 0;
 }
 
-FastqFileStream::FastqFileStream(QString filename, bool auto_validate, bool long_read)
+FastqFileStream::FastqFileStream(QString filename, bool auto_validate, bool long_read, int threads)
 	: filename_(filename)
-	, gzfile_(NULL)
-	, buffer_(0)
+	, bgzf_(nullptr)
+	, bgzf_line_(KS_INITIALIZE)
+	, bgzf_at_end_(false)
     , is_first_entry_(true)
     , last_output_(NULL)
     , entry_index_(-1)
     , auto_validate_(auto_validate)
 	, long_read_(long_read)
 {
-    gzfile_ = gzopen(filename.toUtf8().data(), "rb"); //read binary: always open in binary mode because windows and mac open in text mode
-    if (gzfile_ == NULL)
-    {
+	//open the file only once: htslib reads BGZF, plain gzip and uncompressed input, which is also required for pipes and stdin
+	bgzf_ = bgzf_open(filename.toUtf8().data(), "r");
+	if (bgzf_==nullptr)
+	{
 		THROW(FileAccessException, "Could not open file '" + filename + "' for reading!");
-    }
-
-	buffer_size_ =  ((long_read_)?8388608:1024);
+	}
 
-	gzbuffer(gzfile_, 128*buffer_size_);
+	//BGZF input: supports multi-threaded decompression
+	if (bgzf_compression(bgzf_)==bgzf)
+	{
+		//check for EOF marker - a missing marker indicates a truncated file (2 means that the check is not possible, e.g. for pipes)
+		int eof_status = bgzf_check_EOF(bgzf_);
+		if (eof_status==0 || eof_status<0)
+		{
+			bgzf_close(bgzf_);
+			bgzf_ = nullptr;
+			THROW(FileParseException, "File '" + filename + "' is truncated: BGZF EOF marker is missing!");
+		}
 
-	buffer_ = new char[buffer_size_];
+		if (threads>1 && bgzf_mt(bgzf_, threads, 256)!=0)
+		{
+			bgzf_close(bgzf_);
+			bgzf_ = nullptr;
+			THROW(Exception, "Could not create decompression threads for file '" + filename + "'!");
+		}
+	}
 }
 
 FastqFileStream::~FastqFileStream()
 {
-    gzclose(gzfile_);
-	delete[] buffer_;
+	if (bgzf_!=nullptr) bgzf_close(bgzf_);
+	ks_free(&bgzf_line_);
 }
 
 void FastqFileStream::readEntry(FastqEntry& entry)
@@ -150,24 +167,16 @@ void FastqFileStream::readEntry(FastqEntry& entry)
     //special cases handling
     if (is_first_entry_)
     {
-		last_output_ = gzgets(gzfile_, buffer_, buffer_size_);
+		readLine();
         is_first_entry_ = false;
     }
 
 	//handle errors like truncated GZ file
 	if (last_output_==nullptr)
 	{
-		int error_no = Z_OK;
-		QByteArray error_message = gzerror(gzfile_, &error_no);
-		if (error_no==Z_OK || error_no==Z_STREAM_END)
-		{
-			entry.clear();
-			return;
-		}
-		else
-		{
-			THROW(FileParseException, "Error while reading file '" + filename_ + "': " + error_message);
-		}
+		checkReadError();
+		entry.clear();
+		return;
 	}
 
 	//read data
@@ -185,39 +194,59 @@ void FastqFileStream::readEntry(FastqEntry& entry)
 
 void FastqFileStream::extractLine(QByteArray& line)
 {
-	line = QByteArray(buffer_);
+	//handle errors like truncated GZ file within an entry
+	if (last_output_==nullptr) checkReadError();
+
+	line = QByteArray(last_output_);
 	while (line.endsWith('\n') || line.endsWith('\r')) line.chop(1);
 
-	last_output_ = gzgets(gzfile_, buffer_, buffer_size_);
+	readLine();
+}
 
-	//handle errors like truncated GZ file
-	if (last_output_==nullptr)
+void FastqFileStream::readLine()
+{
+	last_output_ = nullptr;
+	if (bgzf_getline(bgzf_, '\n', &bgzf_line_)>=0)
 	{
-		int error_no = Z_OK;
-		QByteArray error_message = gzerror(gzfile_, &error_no);
-		if (error_no!=Z_OK && error_no!=Z_STREAM_END)
-		{
-			THROW(FileParseException, "Error while reading file '" + filename_ + "': " + error_message);
-		}
+		last_output_ = bgzf_line_.s;
+	}
+	else if (bgzf_->errcode==0)
+	{
+		bgzf_at_end_ = true;
+	}
+	//read errors are reported when the next line is extracted, so that all complete entries before the error are returned
+}
+
+void FastqFileStream::checkReadError()
+{
+	if (bgzf_->errcode!=0)
+	{
+		bgzf_at_end_ = true;
+		THROW(FileParseException, "Error while reading file '" + filename_ + "': BGZF error code " + QString::number(bgzf_->errcode));
 	}
 }
 
 
-FastqOutfileStream::FastqOutfileStream(QString filename, int compression_level, int compression_strategy)
+FastqOutfileStream::FastqOutfileStream(QString filename, int compression_level, int threads)
 	: filename_(filename)
+	, bgzf_(nullptr)
 	, is_closed_(false)
 {
-	gzfile_ = gzopen(filename.toUtf8().data(), "wb");
-    if (gzfile_ == NULL)
+	if (compression_level<0 || compression_level>9) THROW(ArgumentException, "Invalid gzip compression level '" + QString::number(compression_level) +"' given for FASTQ file '" + filename + "'!");
+
+	QByteArray mode = "w" + QByteArray::number(compression_level);
+	bgzf_ = bgzf_open(filename.toUtf8().data(), mode.data());
+	if (bgzf_ == nullptr)
     {
         THROW(FileAccessException, "Could not open file '" + filename + "' for writing!");
 	}
 
-	gzbuffer(gzfile_, 131072);
-
-	if (compression_level<0 || compression_level>9) THROW(ArgumentException, "Invalid gzip compression level '" + QString::number(compression_level) +"' given for FASTQ file '" + filename + "'!");
-	if (compression_strategy<0 || compression_strategy>4) THROW(ArgumentException, "Invalid gzip compression strategy '" + QString::number(compression_strategy) +"' given for FASTQ file '" + filename + "'!");
-	gzsetparams(gzfile_, compression_level, compression_strategy);
+	if (threads>1 && bgzf_mt(bgzf_, threads, 256)!=0)
+	{
+		bgzf_close(bgzf_);
+		bgzf_ = nullptr;
+		THROW(Exception, "Could not create compression threads for file '" + filename + "'!");
+	}
 }
 
 FastqOutfileStream::~FastqOutfileStream()
@@ -227,15 +256,17 @@ FastqOutfileStream::~FastqOutfileStream()
 
 void FastqOutfileStream::write(const FastqEntry& entry)
 {
-	static QByteArray newline = "\n";
-	if (gzputs(gzfile_, entry.header.constData())==-1
-		|| gzputs(gzfile_, newline)==-1
-		|| gzputs(gzfile_, entry.bases.constData())==-1
-		|| gzputs(gzfile_, newline)==-1
-		|| gzputs(gzfile_, entry.header2.constData())==-1
-		|| gzputs(gzfile_, newline)==-1
-		|| gzputs(gzfile_, entry.qualities.constData())==-1
-		|| gzputs(gzfile_, newline)==-1)
+	buffer_.clear();
+	buffer_.append(entry.header);
+	buffer_.append('\n');
+	buffer_.append(entry.bases);
+	buffer_.append('\n');
+	buffer_.append(entry.header2);
+	buffer_.append('\n');
+	buffer_.append(entry.qualities);
+	buffer_.append('\n');
+
+	if (bgzf_write(bgzf_, buffer_.constData(), buffer_.size())<0)
 	{
 		THROW(FileAccessException, "Could not write to file '" + filename_ + "'!");
 	}
@@ -245,6 +276,6 @@ void FastqOutfileStream::close()
 {
     if (is_closed_) return;
 
-	gzclose(gzfile_);
+	bgzf_close(bgzf_);
 	is_closed_ = true;
 }
@@ -5,6 +5,8 @@
 #include "Exceptions.h"
 #include "Sequence.h"
 #include <zlib.h>
+#include "htslib/bgzf.h"
+#include "htslib/kstring.h"
 #include <QString>
 #include <QVector>
 
@@ -38,21 +40,23 @@ struct CPPNGSSHARED_EXPORT FastqEntry
 /**
   @brief FASTQ file input stream (gzipped or plain).
 
+  The input is opened once using htslib, so it can also be a pipe or stdin.
+  BGZF-compressed input is decompressed with several threads if @p threads is greater than 1. Plain gzip streams cannot be decompressed in parallel and are read using one thread.
+
   @note The base/quality lines must not be wrapped.
-  @note Fastq lines longer that 1024 characters are not supported!
 */
 class CPPNGSSHARED_EXPORT FastqFileStream
 {
 public:
     ///Constructor.
-	FastqFileStream(QString filename, bool auto_validate=true, bool long_read=false);
+	FastqFileStream(QString filename, bool auto_validate=true, bool long_read=false, int threads=1);
     ///Destructor.
     ~FastqFileStream();
 
     ///Checks if the end of the file is reached.
     bool atEnd() const
     {
-        return gzeof(gzfile_);
+		return bgzf_at_end_;
     }
     ///Reads a line (or until the buffer is full).
 	void readEntry(FastqEntry& entry);
@@ -70,15 +74,17 @@ public:
 
 protected:
 	QString filename_;
-	gzFile gzfile_;
-	char* buffer_;
+	BGZF* bgzf_; //used for BGZF, plain gzip and uncompressed input
+	kstring_t bgzf_line_;
+	bool bgzf_at_end_;
     bool is_first_entry_;
     char* last_output_;
     int entry_index_;
     bool auto_validate_;
 	bool long_read_;
-	int buffer_size_;
 	void extractLine(QByteArray& line);
+	void readLine();
+	void checkReadError();
 
     //declared away methods
 	FastqFileStream(const FastqFileStream& ) = delete;
@@ -89,13 +95,15 @@ protected:
 
 
 /**
-  @brief FASTQ file output stream (gzipped).
+  @brief FASTQ file output stream (BGZF-compressed, i.e. readable as normal gzip file).
+
+  If @p threads is greater than 1, the blocks are compressed in parallel.
 */
 class CPPNGSSHARED_EXPORT FastqOutfileStream
 {
 public:
     ///Constructor.
-	FastqOutfileStream(QString filename, int compression_level = Z_BEST_SPEED, int compression_strategy = Z_DEFAULT_STRATEGY);
+	FastqOutfileStream(QString filename, int compression_level = Z_BEST_SPEED, int threads = 1);
     ///Destructor - closes the stream if not already done.
     ~FastqOutfileStream();
 
@@ -112,7 +120,8 @@ public:
 
 protected:
     QString filename_;
-	gzFile gzfile_;
+	BGZF* bgzf_;
+	QByteArray buffer_;
 	bool is_closed_;
 
     //declared away methods
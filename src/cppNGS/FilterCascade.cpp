@@ -4,6 +4,7 @@
 #include "Helper.h"
 #include "NGSHelper.h"
 #include "Log.h"
+#include "VariantGeneIndex.h"
 #include "GeneSet.h"
 #include "cmath"
 
@@ -87,6 +88,22 @@ FilterResult::FilterResult(int variant_count, bool value)
 	pass = QBitArray(variant_count, value);
 }
 
+const QVector<int>& FilterResult::selection() const
+{
+	if (!selection_valid_)
+	{
+		selection_.clear();
+		selection_.reserve(pass.count(true));
+		for (int i=0; i<pass.count(); ++i)
+		{
+			if (pass.testBit(i)) selection_.append(i);
+		}
+		selection_valid_ = true;
+	}
+
+	return selection_;
+}
+
 void FilterResult::removeFlagged(VariantList& variants)
 {
 	if (pass.count()!=variants.count()) THROW(ProgrammingException, "Variant and filter result count not equal in FilterResult::removeFlagged!");
@@ -113,6 +130,7 @@ void FilterResult::removeFlagged(VariantList& variants)
 
 	//update flags
 	pass = QBitArray(variants.count(), true);
+	selection_valid_ = false;
 }
 
 void FilterResult::removeFlagged(VcfFile& variants)
@@ -141,6 +159,7 @@ void FilterResult::removeFlagged(VcfFile& variants)
 
 	//update flags
 	pass = QBitArray(variants.count(), true);
+	selection_valid_ = false;
 }
 
 void FilterResult::removeFlagged(CnvList& cnvs)
@@ -165,6 +184,7 @@ void FilterResult::removeFlagged(CnvList& cnvs)
 
     //update flags
     pass = QBitArray(cnvs.count(), true);
+    selection_valid_ = false;
 }
 
 void FilterResult::removeFlagged(BedpeFile& svs)
@@ -187,6 +207,7 @@ void FilterResult::removeFlagged(BedpeFile& svs)
 
     //update flags
     pass = QBitArray(svs.count(), true);
+    selection_valid_ = false;
 }
 
 void FilterResult::tagNonPassing(VariantList& variants, const QByteArray& tag, const QByteArray& description)
@@ -580,115 +601,42 @@ void FilterCascade::moveUp(int index)
 {
 	filters_.move(index, index-1);
 	errors_.clear();
+	statistics_.clear();
 }
 
 void FilterCascade::moveDown(int index)
 {
 	filters_.move(index, index+1);
 	errors_.clear();
+	statistics_.clear();
 }
 
 FilterResult FilterCascade::apply(const VariantList& variants, bool throw_errors, bool debug_time) const
 {
-	QTime timer;
-	timer.start();
-
-	FilterResult result(variants.count());
-
-	//reset errors
-	errors_.fill(QStringList(), filters_.count());
-
-	if (debug_time)
-	{
-		Log::perf("FilterCascade: Initializing took ", timer);
-		timer.start();
-	}
-
-	for(int i=0; i<filters_.count(); ++i)
-	{
-		QSharedPointer<FilterBase> filter = filters_[i];
-		try
-		{
-			//check type
-			if (filter->type()!=VariantType::SNVS_INDELS) THROW(ArgumentException, "Filter '" + filter->name() + "' cannot be applied to small variants!");
-
-			//apply
-			filter->apply(variants, result);
-
-			if (debug_time)
-			{
-				Log::perf("FilterCascade: Filter " + filter->name() + " took ", timer);
-				timer.start();
-			}
-		}
-		catch(const Exception& e)
-		{
-			errors_[i].append(e.message());
-			if (throw_errors)
-			{
-				throw e;
-			}
-		}
-	}
-
-	return result;
+	return applyFilters(variants, VariantType::SNVS_INDELS, "small variants", throw_errors, debug_time);
 }
 
 FilterResult FilterCascade::apply(const CnvList& cnvs, bool throw_errors, bool debug_time) const
 {
-	QTime timer;
-	timer.start();
-
-	FilterResult result(cnvs.count());
-
-	//reset errors
-	errors_.fill(QStringList(), filters_.count());
-
-	if (debug_time)
-	{
-		Log::perf("FilterCascade: Initializing took ", timer);
-		timer.start();
-	}
-
-	for(int i=0; i<filters_.count(); ++i)
-	{
-		QSharedPointer<FilterBase> filter = filters_[i];
-		try
-		{
-			//check type
-			if (filter->type()!=VariantType::CNVS) THROW(ArgumentException, "Filter '" + filter->name() + "' cannot be applied to CNVs!");
-
-			//apply
-			filter->apply(cnvs, result);
-
-			if (debug_time)
-			{
-				Log::perf("FilterCascade: Filter " + filter->name() + " took ", timer);
-				timer.start();
-			}
-		}
-		catch(const Exception& e)
-		{
-			errors_[i].append(e.message());
-			if (throw_errors)
-			{
-				throw e;
-			}
-		}
-	}
-
-	return result;
+	return applyFilters(cnvs, VariantType::CNVS, "CNVs", throw_errors, debug_time);
 }
 
 FilterResult FilterCascade::apply(const BedpeFile& svs, bool throw_errors, bool debug_time) const
+{
+	return applyFilters(svs, VariantType::SVS, "SVs", throw_errors, debug_time);
+}
+
+template <typename T>
+FilterResult FilterCascade::applyFilters(const T& variants, VariantType type, const QString& type_name, bool throw_errors, bool debug_time) const
 {
 	QTime timer;
 	timer.start();
 
-	FilterResult result(svs.count());
+	FilterResult result(variants.count());
 
-	//reset errors
+	//reset errors and statistics
 	errors_.fill(QStringList(), filters_.count());
+	statistics_.fill(FilterStepStatistics(), filters_.count());
 
 	if (debug_time)
 	{
@@ -699,17 +647,23 @@ FilterResult FilterCascade::apply(const BedpeFile& svs, bool throw_errors, bool
 	for(int i=0; i<filters_.count(); ++i)
 	{
 		QSharedPointer<FilterBase> filter = filters_[i];
+		FilterStepStatistics& stats = statistics_[i];
 		try
 		{
 			//check type
-			if (filter->type()!=VariantType::SVS) THROW(ArgumentException, "Filter '" + filter->name() + "' cannot be applied to SVs!");
+			if (filter->type()!=type) THROW(ArgumentException, "Filter '" + filter->name() + "' cannot be applied to " + type_name + "!");
 
-			//apply
-			filter->apply(svs, result);
+			//apply (filters are applied to the selection vector, which is also used to count passing variants)
+			QTime filter_timer;
+			filter_timer.start();
+			stats.rows_in = result.selection().count();
+			filter->apply(variants, result);
+			stats.rows_out = result.selection().count();
+			stats.time_ms = filter_timer.elapsed();
 
 			if (debug_time)
 			{
-				Log::perf("FilterCascade: Filter " + filter->name() + " took ", timer);
+				Log::perf("FilterCascade: Filter " + filter->name() + " (" + QString::number(stats.rows_in) + " > " + QString::number(stats.rows_out) + " variants) took ", timer);
 				timer.start();
 			}
 		}
@@ -726,7 +680,6 @@ FilterResult FilterCascade::apply(const BedpeFile& svs, bool throw_errors, bool
 	return result;
 }
 
-
 QStringList FilterCascade::errors(int index) const
 {
 	if (errors_.isEmpty())
@@ -737,6 +690,16 @@ QStringList FilterCascade::errors(int index) const
 	return errors_[index];
 }
 
+FilterStepStatistics FilterCascade::statistics(int index) const
+{
+	if (index>=statistics_.count())
+	{
+		return FilterStepStatistics();
+	}
+
+	return statistics_[index];
+}
+
 void FilterCascade::load(QString filename)
 {
 	//clear contents
@@ -1023,21 +986,23 @@ void FilterAlleleFrequency::apply(const VariantList& variants, FilterResult& res
 	int i_1000g = annotationColumn(variants, "1000g", false);
 
 	//filter
+	const VariantAnnotationColumn& gnomad = variants.column(i_gnomad);
 	if (i_1000g == -1)
 	{
 		for(int i=0; i<variants.count(); ++i)
 		{
 			result.flags()[i] = result.flags()[i]
-				&& variants[i].annotations()[i_gnomad].toDouble()<=max_af;
+				&& gnomad.toDouble(i)<=max_af;
 		}
 	}
 	else
 	{
+		const VariantAnnotationColumn& tg = variants.column(i_1000g);
 		for(int i=0; i<variants.count(); ++i)
 		{
 			result.flags()[i] = result.flags()[i]
-				&& variants[i].annotations()[i_1000g].toDouble()<=max_af
-				&& variants[i].annotations()[i_gnomad].toDouble()<=max_af;
+				&& tg.toDouble(i)<=max_af
+				&& gnomad.toDouble(i)<=max_af;
 		}
 	}
 
@@ -1064,38 +1029,27 @@ void FilterGenes::apply(const VariantList& variants, FilterResult& result) const
 
 	GeneSet genes = GeneSet::createFromStringList(getStringList("genes"));
 
-	//get column indices
-	int i_gene = annotationColumn(variants, "gene");
+	//check column exists
+	annotationColumn(variants, "gene");
+	const VariantGeneIndex& index = variants.geneIndex();
 
 	//filter (text-based)
 	if (!genes.join('|').contains("*"))
 	{
-		for(int i=0; i<variants.count(); ++i)
-		{
-			if (!result.flags()[i]) continue;
-
-			result.flags()[i] = genes.intersectsWith(GeneSet::createFromText(variants[i].annotations()[i_gene], ','));
-		}
+		result.flags() &= index.rowsWithGenes(genes);
 	}
 	else //filter (regexp)
 	{
 		QRegExp reg(genes.join('|').replace("-", "\\-").replace("*", "[A-Z0-9-]*"));
-		for(int i=0; i<variants.count(); ++i)
+		QBitArray match(variants.count(), false);
+		foreach(const QByteArray& gene, index.genes())
 		{
-			if (!result.flags()[i]) continue;
-
-			GeneSet var_genes = GeneSet::createFromText(variants[i].annotations()[i_gene], ',');
-			bool match_found = false;
-			foreach(const QByteArray& var_gene, var_genes)
+			if (reg.exactMatch(gene))
 			{
-				if (reg.exactMatch(var_gene))
-				{
-					match_found = true;
-					break;
-				}
+				match |= index.rowsWithGene(gene);
 			}
-			result.flags()[i] = match_found;
 		}
+		result.flags() &= match;
 	}
 }
 
@@ -1111,10 +1065,8 @@ void FilterRegions::apply(const VariantList& variants, const BedFile& regions, F
 	//special case when only one region is contained
 	if (regions.count()==1)
 	{
-		for(int i=0; i<variants.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			result.flags()[i] = variants[i].overlapsWith(regions[0]);
 		}
 		return;
@@ -1122,10 +1074,8 @@ void FilterRegions::apply(const VariantList& variants, const BedFile& regions, F
 
 	//general case with many regions
 	ChromosomalIndex<BedFile> regions_idx(regions);
-	for (int i=0; i<variants.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		const Variant& v = variants[i];
 		int index = regions_idx.matchingIndex(v.chr(), v.start(), v.end());
 		result.flags()[i] = (index!=-1);
@@ -1143,10 +1093,8 @@ void FilterRegions::apply(const VcfFile& variants, const BedFile& regions, Filte
 	//special case when only one region is contained
 	if (regions.count()==1)
 	{
-		for(int i=0; i<variants.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			result.flags()[i] = variants[i].overlapsWith(regions[0]);
 		}
 		return;
@@ -1154,10 +1102,8 @@ void FilterRegions::apply(const VcfFile& variants, const BedFile& regions, Filte
 
 	//general case with many regions
 	ChromosomalIndex<BedFile> regions_idx(regions);
-	for (int i=0; i<variants.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		const  VcfLine& v = variants[i];
 		int index = regions_idx.matchingIndex(v.chr(), v.start(), v.end());
 		result.flags()[i] = (index!=-1);
@@ -1182,10 +1128,8 @@ void FilterFilterColumnEmpty::apply(const VariantList& variants, FilterResult& r
 {
 	if (!enabled_) return;
 
-	for(int i=0; i<variants.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		result.flags()[i] = variants[i].filters().isEmpty();
 	}
 }
@@ -1194,10 +1138,8 @@ void FilterFilterColumnEmpty::apply(const VcfFile& variants, FilterResult& resul
 {
 	if (!enabled_) return;
 
-	for(int i=0; i<variants.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		result.flags()[i] = variants[i].filtersPassed();
 	}
 }
@@ -1222,10 +1164,8 @@ void FilterVariantIsSNV::apply(const VariantList& variants, FilterResult& result
 
 	bool invert = getBool("invert");
 
-	for(int i=0; i<variants.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		if (invert)
 		{
 			result.flags()[i] = !variants[i].isSNV();
@@ -1240,10 +1180,8 @@ void FilterVariantIsSNV::apply(const VcfFile& variants, FilterResult& result) co
 {
 	if (!enabled_) return;
 
-	for(int i=0; i<variants.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		result.flags()[i] = variants[i].isSNV();
 	}
 }
@@ -1273,10 +1211,8 @@ void FilterSubpopulationAlleleFrequency::apply(const VariantList& variants, Filt
 
 	//filter
 	int i_gnomad = annotationColumn(variants, "gnomAD_sub");
-	for(int i=0; i<variants.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		QByteArrayList parts = variants[i].annotations()[i_gnomad].split(',');
 		foreach(const QByteArray& part, parts)
 		{
@@ -1317,10 +1253,8 @@ void FilterVariantImpact::apply(const VariantList& variants, FilterResult& resul
 	QByteArrayList impacts = getStringList("impact").join(":,:").prepend(":").append(":").toUtf8().split(',');
 
 	//filter
-	for(int i=0; i<variants.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		bool pass_impact = false;
 		foreach(const QByteArray& impact, impacts)
 		{
@@ -1362,15 +1296,16 @@ void FilterVariantCountNGSD::apply(const VariantList& variants, FilterResult& re
 	int i_ihdb_het = annotationColumn(variants, "NGSD_het");
 	int i_ihdb_mosaic = annotationColumn(variants, "NGSD_mosaic", false);
 	bool mosaic_as_het = getBool("mosaic_as_het");
+	const VariantAnnotationColumn& ihdb_hom = variants.column(i_ihdb_hom);
+	const VariantAnnotationColumn& ihdb_het = variants.column(i_ihdb_het);
+	const VariantAnnotationColumn* ihdb_mosaic = (mosaic_as_het && i_ihdb_mosaic!=-1) ? &variants.column(i_ihdb_mosaic) : nullptr;
 
 	if (getBool("ignore_genotype"))
 	{
-		for(int i=0; i<variants.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
-			int count = variants[i].annotations()[i_ihdb_het].toInt() + variants[i].annotations()[i_ihdb_hom].toInt();
-			if (mosaic_as_het && i_ihdb_mosaic!=-1) count += variants[i].annotations()[i_ihdb_mosaic].toInt();
+			int count = ihdb_het.toInt(i) + ihdb_hom.toInt(i);
+			if (ihdb_mosaic!=nullptr) count += ihdb_mosaic->toInt(i);
 
 			result.flags()[i] = count <= max_count;
 		}
@@ -1382,10 +1317,8 @@ void FilterVariantCountNGSD::apply(const VariantList& variants, FilterResult& re
 		geno_indices.removeAll(-1);
 		if (geno_indices.isEmpty()) THROW(ArgumentException, "Cannot apply filter '" + name() + "' to variant list without affected samples!");
 
-		for(int i=0; i<variants.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			bool var_is_hom = false;
 			foreach(int index, geno_indices)
 			{
@@ -1401,9 +1334,9 @@ void FilterVariantCountNGSD::apply(const VariantList& variants, FilterResult& re
 				}
 			}
 
-			int count = variants[i].annotations()[i_ihdb_hom].toInt();
-			if (!var_is_hom) count += variants[i].annotations()[i_ihdb_het].toInt();
-			if (!var_is_hom && mosaic_as_het && i_ihdb_mosaic!=-1) count += variants[i].annotations()[i_ihdb_mosaic].toInt();
+			int count = ihdb_hom.toInt(i);
+			if (!var_is_hom) count += ihdb_het.toInt(i);
+			if (!var_is_hom && ihdb_mosaic!=nullptr) count += ihdb_mosaic->toInt(i);
 
 			result.flags()[i] = count <= max_count;
 		}
@@ -1441,19 +1374,15 @@ void FilterFilterColumn::apply(const VariantList& variants, FilterResult& result
 	QString action = getString("action");
 	if (action=="REMOVE")
 	{
-		for(int i=0; i<variants.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			result.flags()[i] = !match(variants[i]);
 		}
 	}
 	else if (action=="FILTER")
 	{
-		for(int i=0; i<variants.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			result.flags()[i] = match(variants[i]);
 		}
 	}
@@ -1508,19 +1437,15 @@ void FilterClassificationNGSD::apply(const VariantList& variants, FilterResult&
 	QString action = getString("action");
 	if (action=="REMOVE")
 	{
-		for(int i=0; i<variants.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			result.flags()[i] = !match(variants[i]);
 		}
 	}
 	else if (action=="FILTER")
 	{
-		for(int i=0; i<variants.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			result.flags()[i] = match(variants[i]);
 		}
 	}
@@ -1565,39 +1490,17 @@ void FilterGeneInheritance::apply(const VariantList& variants, FilterResult& res
 {
 	if (!enabled_) return;
 
-	//get column indices
-	int i_geneinfo = annotationColumn(variants, "gene_info");
-	QStringList modes_passing = getStringList("modes");
+	//check column exists
+	annotationColumn(variants, "gene_info");
+	const VariantGeneIndex& index = variants.geneIndex();
 
 	//filter
-	for(int i=0; i<variants.count(); ++i)
+	QBitArray match(variants.count(), false);
+	foreach(const QString& mode, getStringList("modes"))
 	{
-		if (!result.flags()[i]) continue;
-
-		//parse gene_info entry - example: AL627309.1 (inh=n/a pLI=n/a), PRPF31 (inh=AD pLI=0.97), 34P13.14 (inh=n/a pLI=n/a)
-		QByteArrayList genes = variants[i].annotations()[i_geneinfo].split(',');
-		bool any_gene_passed = false;
-		foreach(const QByteArray& gene, genes)
-		{
-			int start = gene.indexOf('(');
-			QByteArrayList entries = gene.mid(start+1, gene.length()-start-2).split(' ');
-			foreach(const QByteArray& entry, entries)
-			{
-				if (entry.startsWith("inh="))
-				{
-					QStringList modes = QString(entry.mid(4)).split('+');
-					foreach(const QString& mode, modes)
-					{
-						if (modes_passing.contains(mode))
-						{
-							any_gene_passed = true;
-						}
-					}
-				}
-			}
-		}
-		result.flags()[i] = any_gene_passed;
+		match |= index.rowsWithInheritance(mode.toUtf8());
 	}
+	result.flags() &= match;
 }
 
 FilterGeneConstraint::FilterGeneConstraint()
@@ -1625,48 +1528,16 @@ void FilterGeneConstraint::apply(const VariantList& variants, FilterResult& resu
 {
 	if (!enabled_) return;
 
-	//get column indices
-	int i_geneinfo = annotationColumn(variants, "gene_info");
+	//check column exists
+	annotationColumn(variants, "gene_info");
+	const VariantGeneIndex& index = variants.geneIndex();
 	double min_pli = getDouble("min_pli");
 	double max_oe_lof = getDouble("max_oe_lof");
 
 	//filter
-	for(int i=0; i<variants.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
-		//parse gene_info entry - example: AL627309.1 (inh=n/a pLI=n/a), PRPF31 (inh=AD pLI=0.97), 34P13.14 (inh=n/a pLI=n/a oe_lof=)
-		QByteArrayList genes = variants[i].annotations()[i_geneinfo].split(',');
-		bool any_gene_passed = false;
-		foreach(const QByteArray& gene, genes)
-		{
-			int start = gene.indexOf('(');
-			QByteArrayList entries = gene.mid(start+1, gene.length()-start-2).split(' ');
-			foreach(const QByteArray& entry, entries)
-			{
-				if (entry.startsWith("pLI="))
-				{
-					bool ok;
-					double pli = entry.mid(4).toDouble(&ok);
-					if (!ok) pli = 0.0; // value 'n/a' > pass
-					if (pli>=min_pli)
-					{
-						any_gene_passed = true;
-					}
-				}
-				if (entry.startsWith("oe_lof="))
-				{
-					bool ok;
-					double oe = entry.mid(7).toDouble(&ok);
-					if (!ok) oe = 1.0; // value 'n/a' > pass
-					if (oe<=max_oe_lof)
-					{
-						any_gene_passed = true;
-					}
-				}
-			}
-		}
-		result.flags()[i] = any_gene_passed;
+		result.flags()[i] = index.maxPli(i)>=min_pli || index.minOeLof(i)<=max_oe_lof;
 	}
 }
 
@@ -1702,10 +1573,8 @@ void FilterGenotypeControl::apply(const VariantList& variants, FilterResult& res
 	if (geno_indices.isEmpty()) THROW(ArgumentException, "Cannot apply filter '" + name() + "' to variant list without control samples!");
 
 	//filter
-	for(int i=0; i<variants.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		if (same_genotype)
 		{
 			QByteArray geno_all = checkSameGenotype(geno_indices, variants[i]);
@@ -1793,10 +1662,8 @@ void FilterGenotypeAffected::apply(const VariantList& variants, FilterResult& re
 	//filter
 	if (!(genotypes.contains("comp-het") || genotypes.contains("comp-het (phased)") || genotypes.contains("comp-het (unphased)")))
 	{
-		for(int i=0; i<variants.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			QByteArray geno_all = checkSameGenotype(geno_indices, variants[i]);
 			if (geno_all.isEmpty() || !genotypes.contains(geno_all))
 			{
@@ -1864,10 +1731,8 @@ void FilterGenotypeAffected::apply(const VariantList& variants, FilterResult& re
 		}
 
 		//apply combined results from above
-		for(int i=0; i<variants.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			//other filter pass => pass
 			if (result_other.flags()[i]) continue;
 
@@ -1967,19 +1832,15 @@ void FilterColumnMatchRegexp::apply(const VariantList& variants, FilterResult& r
 	QString action = getString("action");
 	if (action=="REMOVE")
 	{
-		for(int i=0; i<variants.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			result.flags()[i] = !match(variants[i]);
 		}
 	}
 	else if (action=="FILTER")
 	{
-		for(int i=0; i<variants.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			result.flags()[i] = match(variants[i]);
 		}
 	}
@@ -2032,10 +1893,8 @@ void FilterAnnotationPathogenic::apply(const VariantList& variants, FilterResult
 
 	if (getString("action")=="FILTER")
 	{
-		for(int i=0; i<variants.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			result.flags()[i] = annotatedPathogenic(variants[i]);
 		}
 
@@ -2120,10 +1979,11 @@ void FilterPredictionPathogenic::apply(const VariantList& variants, FilterResult
 	if (!enabled_) return;
 
 	min = getInt("min");
-	i_phylop = annotationColumn(variants, "phyloP");
-	i_cadd = annotationColumn(variants, "CADD");
-	i_revel = annotationColumn(variants, "REVEL");
-	i_alphamissense =  annotationColumn(variants, "AlphaMissense", false); //optional to support old GSvar files without AlphaMissense
+	col_phylop = &variants.column(annotationColumn(variants, "phyloP"));
+	col_cadd = &variants.column(annotationColumn(variants, "CADD"));
+	col_revel = &variants.column(annotationColumn(variants, "REVEL"));
+	int i_alphamissense =  annotationColumn(variants, "AlphaMissense", false); //optional to support old GSvar files without AlphaMissense
+	col_alphamissense = i_alphamissense>=0 ? &variants.column(i_alphamissense) : nullptr;
 
 	skip_high_impact = getBool("skip_high_impact");
 	i_co_sp = annotationColumn(variants, "coding_and_splicing");
@@ -2135,12 +1995,11 @@ void FilterPredictionPathogenic::apply(const VariantList& variants, FilterResult
 
 	if (getString("action")=="FILTER")
 	{
-		for(int i=0; i<variants.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
 			if (skip_high_impact && variants[i].annotations()[i_co_sp].contains(":HIGH:")) continue;
 
-			result.flags()[i] = predictedPathogenic(variants[i]);
+			result.flags()[i] = predictedPathogenic(i);
 		}
 	}
 	else //KEEP
@@ -2150,19 +2009,19 @@ void FilterPredictionPathogenic::apply(const VariantList& variants, FilterResult
 			if (result.flags()[i]) continue;
 			if (skip_high_impact && variants[i].annotations()[i_co_sp].contains(":HIGH:")) continue;
 
-			result.flags()[i] = predictedPathogenic(variants[i]);
+			result.flags()[i] = predictedPathogenic(i);
 		}
 	}
 }
 
-bool FilterPredictionPathogenic::predictedPathogenic(const Variant& v) const
+bool FilterPredictionPathogenic::predictedPathogenic(int index) const
 {
 	int count = 0;
 
 	if (cutoff_phylop>-10)
 	{
 		bool ok;
-		double value = v.annotations()[i_phylop].toDouble(&ok);
+		double value = col_phylop->toDouble(index, &ok);
 		if (ok && value>=cutoff_phylop)
 		{
 			++count;
@@ -2173,7 +2032,7 @@ bool FilterPredictionPathogenic::predictedPathogenic(const Variant& v) const
 	if (cutoff_cadd>0)
 	{
 		bool ok;
-		double value = v.annotations()[i_cadd].toDouble(&ok);
+		double value = col_cadd->toDouble(index, &ok);
 		if (ok && value>=cutoff_cadd)
 		{
 			++count;
@@ -2184,17 +2043,17 @@ bool FilterPredictionPathogenic::predictedPathogenic(const Variant& v) const
 	if (cutoff_revel>0)
 	{
 		bool ok;
-		double value = v.annotations()[i_revel].toDouble(&ok);
+		double value = col_revel->toDouble(index, &ok);
 		if (ok && value>=cutoff_revel)
 		{
 			++count;
 		}
 	}
 
-	if (i_alphamissense>=0 && cutoff_alphamissense>0) //optional to support old GSvar files without AlphaMissense
+	if (col_alphamissense!=nullptr && cutoff_alphamissense>0) //optional to support old GSvar files without AlphaMissense
 	{
 		bool ok;
-		double value = v.annotations()[i_alphamissense].toDouble(&ok);
+		double value = col_alphamissense->toDouble(index, &ok);
 		if (ok && value>=cutoff_alphamissense)
 		{
 			++count;
@@ -2231,19 +2090,15 @@ void FilterAnnotationText::apply(const VariantList& variants, FilterResult& resu
 	QString action = getString("action");
 	if (action=="REMOVE")
 	{
-		for(int i=0; i<variants.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			result.flags()[i] = !match(variants[i]);
 		}
 	}
 	else if (action=="FILTER")
 	{
-		for(int i=0; i<variants.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			result.flags()[i] = match(variants[i]);
 		}
 	}
@@ -2325,10 +2180,8 @@ void FilterVariantType::apply(const VariantList& variants, FilterResult& result)
 
 	int index = annotationColumn(variants, "coding_and_splicing");
 
-	for(int i=0; i<variants.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		bool match_found = false;
 		foreach(const QByteArray& type, types)
 		{
@@ -2389,9 +2242,8 @@ void FilterVariantQC::apply(const VariantList& variants, FilterResult& result) c
 	int min_occ = getInt("min_occurences");
 
 
-	for(int i=0; i<variants.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
 		QByteArrayList parts = variants[i].annotations()[index].split(';');
 		foreach(const QByteArray& part, parts)
 		{
@@ -2536,10 +2388,8 @@ void FilterTrio::apply(const VariantList& variants, FilterResult& result) const
 		GeneSet het_father;
 		GeneSet het_mother;
 
-		for(int i=0; i<variants.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			const Variant& v = variants[i];
 			bool diplod_chromosome = v.chr().isAutosome() || (v.chr().isX() && gender_child=="female") || (v.chr().isX() && par_region.overlapsWith(v.chr(), v.start(), v.end()));
 			if (diplod_chromosome)
@@ -2564,10 +2414,8 @@ void FilterTrio::apply(const VariantList& variants, FilterResult& result) const
 	QMap<QByteArray, ImprintingInfo> imprinting = NGSHelper::imprintingGenes();
 
 	//apply
-	for(int i=0; i<variants.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		const Variant& v = variants[i];
 
 		//get genotypes
@@ -2721,32 +2569,18 @@ void FilterOMIM::apply(const VariantList& variants, FilterResult& result) const
 {
 	if (!enabled_) return;
 
-	int index = annotationColumn(variants, "OMIM");
+	//check column exists
+	annotationColumn(variants, "OMIM");
+	const QBitArray& omim = variants.geneIndex().rowsWithOmim();
 
 	QString action = getString("action");
 	if (action=="FILTER")
 	{
-		for(int i=0; i<variants.count(); ++i)
-		{
-			if (!result.flags()[i]) continue;
-
-			if (variants[i].annotations()[index].trimmed().isEmpty())
-			{
-				result.flags()[i] = false;
-			}
-		}
+		result.flags() &= omim;
 	}
 	else //REMOVE
 	{
-		for(int i=0; i<variants.count(); ++i)
-		{
-			if (!result.flags()[i]) continue;
-
-			if (!variants[i].annotations()[index].trimmed().isEmpty())
-			{
-				result.flags()[i] = false;
-			}
-		}
+		result.flags() &= ~omim;
 	}
 }
 
@@ -2769,14 +2603,13 @@ void FilterConservedness::apply(const VariantList& variants, FilterResult& resul
 	if (!enabled_) return;
 
 	int i_phylop = annotationColumn(variants, "phyloP");
+	const VariantAnnotationColumn& phylop = variants.column(i_phylop);
 	double min_score = getDouble("min_score");
 
-	for(int i=0; i<variants.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		bool ok;
-		double value = variants[i].annotations()[i_phylop].toDouble(&ok);
+		double value = phylop.toDouble(i, &ok);
 		if (!ok || value<min_score)
 		{
 			result.flags()[i] = false;
@@ -2808,10 +2641,8 @@ void FilterRegulatory::apply(const VariantList& variants, FilterResult& result)
 	QString action = getString("action");
 	if (action=="FILTER")
 	{
-		for(int i=0; i<variants.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			if (variants[i].annotations()[index].trimmed().isEmpty())
 			{
 				result.flags()[i] = false;
@@ -2820,10 +2651,8 @@ void FilterRegulatory::apply(const VariantList& variants, FilterResult& result)
 	}
 	else //REMOVE
 	{
-		for(int i=0; i<variants.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			if (!variants[i].annotations()[index].trimmed().isEmpty())
 			{
 				result.flags()[i] = false;
@@ -2855,10 +2684,8 @@ void FilterCnvSize::apply(const CnvList& cnvs, FilterResult& result) const
 	if (!enabled_) return;
 
 	double min_size_bases = getDouble("size") * 1000.0;
-	for(int i=0; i<cnvs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		if (cnvs[i].size() < min_size_bases)
 		{
 			result.flags()[i] = false;
@@ -2887,10 +2714,8 @@ void FilterCnvRegions::apply(const CnvList& cnvs, FilterResult& result) const
 	if (!enabled_) return;
 
 	int min_regions = getInt("regions");
-	for(int i=0; i<cnvs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		int number_of_regions = cnvs[i].regions();
 		if (number_of_regions<1) THROW(FileParseException, "Invalid/unset number of regions!");
 
@@ -2931,10 +2756,8 @@ void FilterCnvCopyNumber::apply(const CnvList& cnvs, FilterResult& result) const
 	}
 
 	int i_cn = cnvs.annotationIndexByName("CN_change", true);
-	for(int i=0; i<cnvs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		const QByteArray& cn = cnvs[i].annotations()[i_cn];
 
 		result.flags()[i] = cn_exp.contains(cn) || (cn_5plus && cn.toInt()>=5);
@@ -2965,10 +2788,8 @@ void FilterCnvAlleleFrequency::apply(const CnvList& cnvs, FilterResult& result)
 	double max_af = getDouble("max_af");
 
 	int i_af = cnvs.annotationIndexByName("potential_AF", true);
-	for(int i=0; i<cnvs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		const QByteArray& af = cnvs[i].annotations()[i_af];
 
 		if (af.toDouble()>max_af)
@@ -3002,10 +2823,8 @@ void FilterCnvMaxLoglikelihood::apply(const CnvList &cnvs, FilterResult &result)
 	double max_ll = getDouble("max_ll");
 	bool scale_by_regions = getBool("scale_by_regions");
 	int i_ll = cnvs.annotationIndexByName("loglikelihood", true);
-	for(int i=0; i<cnvs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		if (scale_by_regions)
 		{
 			int number_of_regions = cnvs[i].regions();
@@ -3053,10 +2872,8 @@ void FilterCnvLoglikelihood::apply(const CnvList& cnvs, FilterResult& result) co
 	int i_ll = cnvs.annotationIndexByName("loglikelihood", true);
 	if (cnvs.type()==CnvListType::CLINCNV_GERMLINE_SINGLE || cnvs.type()==CnvListType::CLINCNV_TUMOR_NORMAL_PAIR || cnvs.type()==CnvListType::CLINCNV_TUMOR_ONLY)
 	{
-		for(int i=0; i<cnvs.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			if (scale_by_regions)
 			{
 				int number_of_regions = cnvs[i].regions();
@@ -3078,10 +2895,8 @@ void FilterCnvLoglikelihood::apply(const CnvList& cnvs, FilterResult& result) co
 	}
 	else if (cnvs.type()==CnvListType::CLINCNV_GERMLINE_MULTI)
 	{
-		for(int i=0; i<cnvs.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			QByteArrayList lls = cnvs[i].annotations()[i_ll].split(',');
 			foreach(const QByteArray& ll, lls)
 			{
@@ -3139,10 +2954,8 @@ void FilterCnvQvalue::apply(const CnvList& cnvs, FilterResult& result) const
 
 	if (cnvs.type()==CnvListType::CLINCNV_GERMLINE_SINGLE || cnvs.type()==CnvListType::CLINCNV_TUMOR_ONLY)
 	{
-		for(int i=0; i<cnvs.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			if (cnvs[i].annotations()[i_q].toDouble()>max_q)
 			{
 				result.flags()[i] = false;
@@ -3151,10 +2964,8 @@ void FilterCnvQvalue::apply(const CnvList& cnvs, FilterResult& result) const
 	}
 	else if (cnvs.type()==CnvListType::CLINCNV_GERMLINE_MULTI)
 	{
-		for(int i=0; i<cnvs.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			QByteArrayList qs = cnvs[i].annotations()[i_q].split(',');
 			foreach(const QByteArray& q, qs)
 			{
@@ -3198,10 +3009,8 @@ void FilterCnvCompHet::apply(const CnvList& cnvs, FilterResult& result) const
 
 	//count hits per gene for CNVs
 	QMap<QByteArray, int> gene_count;
-	for(int i=0; i<cnvs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		foreach(const QByteArray& gene, cnvs[i].genes())
 		{
 			gene_count[gene] += 1;
@@ -3244,10 +3053,8 @@ void FilterCnvCompHet::apply(const CnvList& cnvs, FilterResult& result) const
 	}
 
 	//flag passing CNVs
-	for(int i=0; i<cnvs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		result.flags()[i] = cnvs[i].genes().intersectsWith(comphet_hit);
 	}
 }
@@ -3276,10 +3083,8 @@ void FilterCnvOMIM::apply(const CnvList& cnvs, FilterResult& result) const
 	QString action = getString("action");
 	if (action=="FILTER")
 	{
-		for(int i=0; i<cnvs.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			if (cnvs[i].annotations()[index].trimmed().isEmpty())
 			{
 				result.flags()[i] = false;
@@ -3288,10 +3093,8 @@ void FilterCnvOMIM::apply(const CnvList& cnvs, FilterResult& result) const
 	}
 	else //REMOVE
 	{
-		for(int i=0; i<cnvs.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			if (!cnvs[i].annotations()[index].trimmed().isEmpty())
 			{
 				result.flags()[i] = false;
@@ -3325,10 +3128,8 @@ void FilterCnvCnpOverlap::apply(const CnvList& cnvs, FilterResult& result) const
 	int index = cnvs.annotationIndexByName(getString("column").toUtf8(), true);
 	double max_ol = getDouble("max_ol");
 
-	for(int i=0; i<cnvs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		if (cnvs[i].annotations()[index].left(5).toDouble()>max_ol)
 		{
 			result.flags()[i] = false;
@@ -3363,10 +3164,8 @@ void FilterCnvGeneConstraint::apply(const CnvList& cnvs, FilterResult& result) c
 	double max_oe_lof = getDouble("max_oe_lof");
 
 	//filter
-	for(int i=0; i<cnvs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		//parse gene_info entry - example: 34P13.14 (region=complete oe_lof=), ...
 		QByteArrayList gene_entries= cnvs[i].annotations()[i_geneinfo].split(',');
 		bool any_gene_passed = false;
@@ -3416,9 +3215,8 @@ void FilterCnvTumorCopyNumberChange::apply(const CnvList& cnvs, FilterResult &re
 	int i_tumor_cn = cnvs.annotationIndexByName("tumor_CN_change", true);
 	int min_cn = getInt("min_tumor_cn");
 	int max_cn = getInt("max_tumor_cn");
-	for(int i=0; i<cnvs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
 		bool ok = false;
 		int tumor_cn = cnvs[i].annotations()[i_tumor_cn].trimmed().toDouble(&ok);
 		if(!ok) continue;
@@ -3450,9 +3248,8 @@ void FilterCnvClonality::apply(const CnvList &cnvs, FilterResult &result) const
 	double max_clonality = getDouble("max_clonality");
 
 	//filter
-	for(int i=0; i<cnvs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
 		bool ok = false;
 		double tumor_clonality = cnvs[i].annotations()[i_clonality].trimmed().toDouble(&ok);
 		if(!ok) continue;
@@ -3487,10 +3284,8 @@ void FilterCnvGeneOverlap::apply(const CnvList& cnvs, FilterResult& result) cons
 	QByteArrayList selected = selectedOptions();
 
 	//filter
-	for(int i=0; i<cnvs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		//parse gene_info entry - example: 34P13.14 (region=complete oe_lof=), ...
 		QByteArrayList gene_entries = cnvs[i].annotations()[i_geneinfo].split(',');
 		bool any_gene_passed = false;
@@ -3543,10 +3338,8 @@ void FilterCnvPathogenicCnvOverlap::apply(const CnvList& cnvs, FilterResult& res
 
 	int index = cnvs.annotationIndexByName("ngsd_pathogenic_cnvs", true);
 
-	for(int i=0; i<cnvs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		if (cnvs[i].annotations()[index].trimmed().isEmpty())
 		{
 			result.flags()[i] = false;
@@ -3582,10 +3375,8 @@ void FilterSvType::apply(const BedpeFile& svs, FilterResult& result) const
 	QStringList sv_types = getStringList("Structural variant type");
 
 	// iterate over all SVs
-	for(int i=0; i<svs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		result.flags()[i] = sv_types.contains(StructuralVariantTypeToString(svs[i].type()));
 	}
 }
@@ -3614,9 +3405,8 @@ void FilterSvRemoveChromosomeType::apply(const BedpeFile& svs, FilterResult& res
 
 
 	// iterate over all SVs
-	for(int i=0; i<svs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
 		if (remove_special_chr)
 		{
 			// only pass if both positions are located on standard chromosomes
@@ -3663,10 +3453,8 @@ void FilterSvGenotypeControl::apply(const BedpeFile& svs, FilterResult& result)
 	int format_col_index = svs.annotationIndexByName("FORMAT");
 
 	// iterate over all SVs
-	for(int i=0; i<svs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		// get genotype for each control sample
 
 		// get format keys and values
@@ -3745,10 +3533,8 @@ void FilterSvGenotypeAffected::apply(const BedpeFile& svs, FilterResult& result)
 
 
 	// iterate over all SVs
-	for(int i=0; i<svs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		// get genotype for each control sample
 
 		// get format keys and values
@@ -3821,10 +3607,8 @@ void FilterSvQuality::apply(const BedpeFile& svs, FilterResult& result) const
 	int quality_col_index = svs.annotationIndexByName("QUAL");
 
 	// iterate over all SVs
-	for(int i=0; i<svs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		result.flags()[i] = Helper::toDouble(svs[i].annotations()[quality_col_index]) >= min_quality;
 	}
 }
@@ -3859,10 +3643,8 @@ void FilterSvFilterColumn::apply(const BedpeFile& svs, FilterResult& result) con
 
 	if (action=="REMOVE")
 	{
-		for(int i=0; i<svs.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			QSet<QString> sv_entries = QString(svs[i].annotations()[filter_col_index]).split(';').toSet();
 			if (sv_entries.intersects(filter_entries))
 			{
@@ -3872,10 +3654,8 @@ void FilterSvFilterColumn::apply(const BedpeFile& svs, FilterResult& result) con
 	}
 	else if (action=="FILTER")
 	{
-		for(int i=0; i<svs.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			QSet<QString> sv_entries = QString(svs[i].annotations()[filter_col_index]).split(';').toSet();
 			if (!sv_entries.intersects(filter_entries))
 			{
@@ -3949,10 +3729,8 @@ void FilterSvPairedReadAF::apply(const BedpeFile& svs, FilterResult& result) con
 	}
 
 	// iterate over all SVs
-	for(int i=0; i<svs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		// get format keys and values
 		QByteArrayList format_keys = svs[i].annotations()[format_col_index].split(':');
 
@@ -4035,10 +3813,8 @@ void FilterSvSplitReadAF::apply(const BedpeFile& svs, FilterResult& result) cons
 	}
 
 	// iterate over all SVs
-	for(int i=0; i<svs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		// get format keys and values
 		QByteArrayList format_keys = svs[i].annotations()[format_col_index].split(':');
 
@@ -4125,10 +3901,8 @@ void FilterSvPeReadDepth::apply(const BedpeFile& svs, FilterResult& result) cons
 	}
 
 	// iterate over all SVs
-	for(int i=0; i<svs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		// get format keys and values
 		QByteArrayList format_keys = svs[i].annotations()[format_col_index].split(':');
 
@@ -4193,10 +3967,8 @@ void FilterSvSomaticscore::apply(const BedpeFile& svs, FilterResult& result) con
 	if (i_somaticscore == -1) THROW(FileParseException, "No SOMATICSCORE column found in BEDPE file!");
 
 	// iterate over all SVs
-	for(int i=0; i<svs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		// get somaticscore
 		double somaticscore = Helper::toInt(svs[i].annotations()[i_somaticscore], "Somaticscore", QString::number(i));
 		// compare AF with filter
@@ -4238,10 +4010,8 @@ void FilterSvGeneConstraint::apply(const BedpeFile& svs, FilterResult& result) c
 	double max_oe_lof = getDouble("max_oe_lof");
 
 	//filter
-	for(int i=0; i<svs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		//parse gene_info entry - example: 34P13.14 (region=complete oe_lof=), ...
 		QByteArrayList gene_entries= svs[i].annotations()[i_gene_info].split(',');
 		bool any_gene_passed = false;
@@ -4302,10 +4072,8 @@ void FilterSvGeneOverlap::apply(const BedpeFile& svs, FilterResult& result) cons
 	QByteArrayList selected = selectedOptions();
 
 	//filter
-	for(int i=0; i<svs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		//parse gene_info entry - example: 34P13.14 (region=complete oe_lof=), ...
 		QByteArrayList gene_entries = svs[i].annotations()[i_gene_info].split(',');
 		bool any_gene_passed = false;
@@ -4372,10 +4140,8 @@ void FilterSvSize::apply(const BedpeFile& svs, FilterResult& result) const
 	int min_size = getInt("min_size", false);
 	int max_size = getInt("max_size", false);
 
-	for(int i=0; i<svs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		// get SV length
 		int sv_length = svs.estimatedSvSize(i);
 		if (sv_length < min_size) result.flags()[i] = false;
@@ -4406,10 +4172,8 @@ void FilterSvOMIM::apply(const BedpeFile& svs, FilterResult& result) const
 	QString action = getString("action");
 	if (action=="FILTER")
 	{
-		for(int i=0; i<svs.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			if (svs[i].annotations()[index].trimmed().isEmpty())
 			{
 				result.flags()[i] = false;
@@ -4418,10 +4182,8 @@ void FilterSvOMIM::apply(const BedpeFile& svs, FilterResult& result) const
 	}
 	else
 	{
-		for(int i=0; i<svs.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			if (!svs[i].annotations()[index].trimmed().isEmpty())
 			{
 				result.flags()[i] = false;
@@ -4458,10 +4220,8 @@ void FilterSvCompHet::apply(const BedpeFile& svs, FilterResult& result) const
 
 	//count hits per gene for SVs
 	QMap<QByteArray, int> gene_count;
-	for(int i=0; i<svs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		GeneSet genes = GeneSet::createFromText(svs[i].annotations()[i_genes], ';');
 		foreach(const QByteArray& gene, genes)
 		{
@@ -4505,10 +4265,8 @@ void FilterSvCompHet::apply(const BedpeFile& svs, FilterResult& result) const
 	}
 
 	//flag passing SVs
-	for(int i=0; i<svs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		GeneSet genes = GeneSet::createFromText(svs[i].annotations()[i_genes], ';');
 		result.flags()[i] = genes.intersectsWith(comphet_hit);
 	}
@@ -4542,10 +4300,8 @@ void FilterSvCountNGSD::apply(const BedpeFile& svs, FilterResult& result) const
 	int idx_old = svs.annotationIndexByName("NGSD_COUNT", false);
 	if (idx_old!=-1 && svs.annotationIndexByName("NGSD_HOM",false)==-1)
 	{
-		for(int i=0; i<svs.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			QString text = svs[i].annotations()[idx_old];
 			if (text.contains('(')) text = text.split('(')[0];
 			int count = Helper::toInt(text, "NGSD count", QString::number(i));
@@ -4560,10 +4316,8 @@ void FilterSvCountNGSD::apply(const BedpeFile& svs, FilterResult& result) const
 
 	if (ignore_genotype)
 	{
-		for(int i=0; i<svs.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			int ngsd_count_hom = Helper::toInt(svs[i].annotations()[idx_ngsd_hom], "NGSD count hom", QString::number(i));
 			int ngsd_count_het = Helper::toInt(svs[i].annotations()[idx_ngsd_het], "NGSD count het", QString::number(i));
 			result.flags()[i] = (ngsd_count_hom + ngsd_count_het) <= max_count;
@@ -4584,10 +4338,8 @@ void FilterSvCountNGSD::apply(const BedpeFile& svs, FilterResult& result) const
 		}
 
 		// iterate over all SVs
-		for(int i=0; i<svs.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			// get format keys and values
 			QByteArrayList format_keys = svs[i].annotations()[idx_format].split(':');
 			int idx_genotype = format_keys.indexOf("GT");
@@ -4659,10 +4411,8 @@ void FilterSvAfNGSD::apply(const BedpeFile& svs, FilterResult& result) const
 	int idx_old = svs.annotationIndexByName("NGSD_COUNT", false);
 	if (idx_old!=-1 && svs.annotationIndexByName("NGSD_AF",false)==-1)
 	{
-		for(int i=0; i<svs.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			QString text = svs[i].annotations()[idx_old];
 			if (text.contains('(')) text = text.split('(')[0];
 			if (text.contains(')')) text = text.split(')')[0];
@@ -4675,9 +4425,8 @@ void FilterSvAfNGSD::apply(const BedpeFile& svs, FilterResult& result) const
 
 	int idx_ngsd_af = svs.annotationIndexByName("NGSD_AF");
 
-	for(int i=0; i<svs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
 		//allow empty NGSD af entry
 		if (svs[i].annotations()[idx_ngsd_af].trimmed().isEmpty())
 		{
@@ -4719,10 +4468,8 @@ void FilterSvBreakpointDensityNGSD::apply(const BedpeFile& svs, FilterResult& re
 
 	int idx_ngsd_density = (only_system_specific)? svs.annotationIndexByName("NGSD_SV_BREAKPOINT_DENSITY_SYS") : svs.annotationIndexByName("NGSD_SV_BREAKPOINT_DENSITY");
 
-	for(int i=0; i<svs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		QByteArray density = svs[i].annotations()[idx_ngsd_density];
 
 		if (density.trimmed().isEmpty()) continue; //skip empty entries
@@ -5020,10 +4767,8 @@ void FilterSomaticAlleleFrequency::apply(const VariantList& variants, FilterResu
 	if (min_af_tum>0.0)
 	{
 		int i_af = annotationColumn(variants, "tumor_af");
-		for(int i=0; i<variants.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			if (variants[i].annotations()[i_af].toDouble()<min_af_tum)
 			{
 				result.flags()[i] = false;
@@ -5035,10 +4780,8 @@ void FilterSomaticAlleleFrequency::apply(const VariantList& variants, FilterResu
 	if (max_af_nor<1.0)
 	{
 		int i_af = annotationColumn(variants, "normal_af");
-		for(int i=0; i<variants.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			if (variants[i].annotations()[i_af].toDouble()>max_af_nor)
 			{
 				result.flags()[i] = false;
@@ -5105,10 +4848,8 @@ void FilterTumorOnlyHomHet::apply(const VariantList& variants, FilterResult& res
 	if (hom_af_range != 0.0)
 	{
 		int i_af = annotationColumn(variants, "tumor_af");
-		for(int i=0; i<variants.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			if (variants[i].annotations()[i_af].toDouble()> (1.-hom_af_range) )
 			{
 				result.flags()[i] = false;
@@ -5217,10 +4958,8 @@ void FilterSpliceEffect::apply(const VariantList &variant_list, FilterResult &re
 	// action FILTER
 	if (getString("action") == "FILTER")
 	{
-		for(int i=0; i<variant_list.count(); ++i)
+		foreach(int i, result.selection())
 		{
-			if (!result.flags()[i]) continue;
-
 			//If the variant has no value for all possible filters remove it
 			QByteArray sai_anno = variant_list[i].annotations()[idx_sai].trimmed();
 			QByteArray mes_anno = variant_list[i].annotations()[idx_mes].trimmed();
@@ -5341,10 +5080,8 @@ void FilterVariantRNAAseAlleleFrequency::apply(const VariantList& variants, Filt
 
 	int idx_ase_af = annotationColumn(variants, "ASE_af");
 
-	for(int i=0; i<variants.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		//skip not covered variants
 		QString ase_af_string = variants[i].annotations()[idx_ase_af].trimmed();
 		if(ase_af_string.isEmpty() || ase_af_string.startsWith("n/a"))
@@ -5382,10 +5119,8 @@ void FilterVariantRNAAseDepth::apply(const VariantList& variants, FilterResult&
 
 	int idx_ase_depth = annotationColumn(variants, "ASE_depth");
 
-	for(int i=0; i<variants.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		int ase_depth = Helper::toInt(variants[i].annotations()[idx_ase_depth], "ASE_depth", QString::number(i));
 		result.flags()[i] = ase_depth >= min_depth;
 	}
@@ -5415,10 +5150,8 @@ void FilterVariantRNAAseAlt::apply(const VariantList& variants, FilterResult& re
 
 	int idx_ase_ac = annotationColumn(variants, "ASE_alt");
 
-	for(int i=0; i<variants.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		//skip not covered variants
 		QString ase_ac_string = variants[i].annotations()[idx_ase_ac].trimmed();
 		if(ase_ac_string.isEmpty() || ase_ac_string.startsWith("n/a"))
@@ -5457,10 +5190,8 @@ void FilterVariantRNAAsePval::apply(const VariantList& variants, FilterResult& r
 
 	int idx_ase_pval = annotationColumn(variants, "ASE_pval");
 
-	for(int i=0; i<variants.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		//skip not covered variants
 		QString ase_pval_string = variants[i].annotations()[idx_ase_pval].trimmed();
 		if(ase_pval_string.isEmpty() || ase_pval_string.startsWith("n/a"))
@@ -5497,10 +5228,8 @@ void FilterVariantRNAAberrantSplicing::apply(const VariantList& variants, Filter
 
 	int idx_asf = annotationColumn(variants, "aberrant_splicing");
 
-	for(int i=0; i<variants.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		QList<QByteArray> fraction_strings = variants[i].annotations()[idx_asf].split(',');
 		result.flags()[i] = false;
 		foreach (const QByteArray& fraction_string, fraction_strings)
@@ -5539,10 +5268,8 @@ void FilterVariantRNAGeneExpression::apply(const VariantList& variants, FilterRe
 
 	int idx_asf = annotationColumn(variants, "tpm");
 
-	for(int i=0; i<variants.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		QList<QByteArray> fraction_strings = variants[i].annotations()[idx_asf].split(',');
 		result.flags()[i] = false;
 		foreach (const QByteArray& fraction_string, fraction_strings)
@@ -5581,10 +5308,8 @@ void FilterVariantRNAExpressionFC::apply(const VariantList& variants, FilterResu
 
 	int idx_fc = annotationColumn(variants, "expr_log2fc");
 
-	for(int i=0; i<variants.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		QList<QByteArray> fc_strings = variants[i].annotations()[idx_fc].split(',');
 		result.flags()[i] = false;
 		foreach (const QByteArray& fc_string, fc_strings)
@@ -5623,10 +5348,8 @@ void FilterVariantRNAExpressionZScore::apply(const VariantList& variants, Filter
 
 	int idx_zscore = annotationColumn(variants, "expr_zscore");
 
-	for(int i=0; i<variants.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		QList<QByteArray> zscore_strings = variants[i].annotations()[idx_zscore].split(',');
 		result.flags()[i] = false;
 		foreach (const QByteArray& zscore_string, zscore_strings)
@@ -5665,10 +5388,8 @@ void FilterVariantLrSrOverlap::apply(const VariantList& variants, FilterResult&
 	bool invert = getBool("invert");
 	int idx_in_shortread = variants.annotationIndexByName("in_short-read");
 
-	for(int i=0; i<variants.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		if (invert)
 		{
 			result.flags()[i] = (variants[i].annotations().at(idx_in_shortread).trimmed() == "");
@@ -5709,10 +5430,8 @@ void FilterSvCnvOverlap::apply(const BedpeFile& svs, FilterResult& result) const
 	if (ol_col==-1) THROW(ProgrammingException, "Missing column CNV_OVERLAP");
 	int min_size = getInt("min_size", false);
 
-	for(int i=0; i<svs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		//skip if no overlap is annotated, i.e. not DEL/DUP
 		QByteArray ol_str = svs[i].annotations()[ol_col].trimmed();
 		if (ol_str.isEmpty()) continue;
@@ -5771,10 +5490,8 @@ void FilterSvLrAF::apply(const BedpeFile& svs, FilterResult& result) const
 	}
 
 	// iterate over all SVs
-	for(int i=0; i<svs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		//some SVs do not have a AF due to insufficient coverage, keep them in
 		if (svs[i].annotations()[col_index].isEmpty()) continue;
 
@@ -5808,10 +5525,8 @@ void FilterSvLrSupportReads::apply(const BedpeFile& svs, FilterResult& result) c
 	int col_index = svs.annotationIndexByName("SUPPORT");
 	int min_support = getInt("min_support", true);
 	// iterate over all SVs
-	for(int i=0; i<svs.count(); ++i)
+	foreach(int i, result.selection())
 	{
-		if (!result.flags()[i]) continue;
-
 		//get supporting read count
 		int sup_reads = Helper::toInt(svs[i].annotations()[col_index]);
 
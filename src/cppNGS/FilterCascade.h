@@ -71,17 +71,20 @@ class CPPNGSSHARED_EXPORT FilterResult
 		void invert()
 		{
 			pass = ~pass;
+			selection_valid_ = false;
 		}
 
 		///Resets the flags to all passing.
 		void reset(bool value = true)
 		{
 			pass.fill(value);
+			selection_valid_ = false;
 		}
 
 		///Read-write access to flags array.
 		QBitArray& flags()
 		{
+			selection_valid_ = false;
 			return pass;
 		}
 
@@ -91,6 +94,10 @@ class CPPNGSSHARED_EXPORT FilterResult
 			return pass;
 		}
 
+		///Returns the indices of the passing variants (selection vector), e.g. to apply a filter to passing variants only.
+		///The selection vector is re-created on first access after the flags were changed.
+		const QVector<int>& selection() const;
+
 		///Remove variants that did not pass the filter (with 'false' flag).
 		void removeFlagged(VariantList& variants);
 		void removeFlagged(VcfFile& variants);
@@ -103,6 +110,8 @@ class CPPNGSSHARED_EXPORT FilterResult
 
 	private:
 		QBitArray pass;
+		mutable QVector<int> selection_;
+		mutable bool selection_valid_ = false;
 };
 
 //Base class for all filters
@@ -208,6 +217,14 @@ class CPPNGSSHARED_EXPORT FilterBase
 		void checkIsRegistered() const;
 };
 
+//Statistics of one filter of a filter cascade run
+struct CPPNGSSHARED_EXPORT FilterStepStatistics
+{
+	int rows_in = 0; //number of passing variants before the filter was applied
+	int rows_out = 0; //number of passing variants after the filter was applied
+	int time_ms = 0; //runtime in milliseconds
+};
+
 //Filter cascade that contains polymorphic filters and can apply them
 class CPPNGSSHARED_EXPORT FilterCascade
 {
@@ -217,6 +234,7 @@ class CPPNGSSHARED_EXPORT FilterCascade
 		{
 			filters_.append(filter);
 			errors_.clear();
+			statistics_.clear();
 		}
 
 		//Remove a filter
@@ -224,6 +242,7 @@ class CPPNGSSHARED_EXPORT FilterCascade
 		{
 			filters_.removeAt(i);
 			errors_.clear();
+			statistics_.clear();
 		}
 
 		//Returns the number of filters
@@ -249,6 +268,7 @@ class CPPNGSSHARED_EXPORT FilterCascade
 		{
 			filters_.clear();
 			errors_.clear();
+			statistics_.clear();
 		}
 
 		//Move filter one position to the front.
@@ -268,6 +288,8 @@ class CPPNGSSHARED_EXPORT FilterCascade
 
 		//Returns errors occured during filter application.
 		QStringList errors(int index) const;
+		//Returns the statistics of a filter of the last cascade run (default-constructed if the filter was added after the last run).
+		FilterStepStatistics statistics(int index) const;
 
 		//Loads a filter cascade from file.
 		void load(QString filename);
@@ -289,6 +311,11 @@ class CPPNGSSHARED_EXPORT FilterCascade
 	private:
 		QList<QSharedPointer<FilterBase>> filters_;
 		mutable QVector<QStringList> errors_;
+		mutable QVector<FilterStepStatistics> statistics_;
+
+		//Applies all filters to the passing variants only
+		template <typename T>
+		FilterResult applyFilters(const T& variants, VariantType type, const QString& type_name, bool throw_errors, bool debug_time) const;
 };
 
 //Handles loading filters from filter INI files
@@ -546,13 +573,13 @@ class CPPNGSSHARED_EXPORT FilterPredictionPathogenic
 
 	protected:
 		//Counts the number of pathogenic predictions
-		bool predictedPathogenic(const Variant& v) const;
+		bool predictedPathogenic(int index) const;
 
 		mutable int min;
-		mutable int i_phylop;
-		mutable int i_cadd;
-		mutable int i_revel;
-		mutable int i_alphamissense;
+		mutable const VariantAnnotationColumn* col_phylop;
+		mutable const VariantAnnotationColumn* col_cadd;
+		mutable const VariantAnnotationColumn* col_revel;
+		mutable const VariantAnnotationColumn* col_alphamissense; //nullptr for old GSvar files without AlphaMissense
 		mutable bool skip_high_impact;
 		mutable int i_co_sp;
 
@@ -0,0 +1,64 @@
+#include "HtsThreadPool.h"
+#include "Exceptions.h"
+#include "htslib/thread_pool.h"
+#include <QMutex>
+#include <QMutexLocker>
+
+//State of the process-wide pool
+static QMutex pool_mutex;
+static int pool_threads = 0;
+static int pool_users = 0;
+static htsThreadPool pool = {nullptr, 0};
+
+void HtsThreadPool::setThreadCount(int threads)
+{
+	if (threads<2) threads = 0;
+
+	QMutexLocker locker(&pool_mutex);
+	if (threads==pool_threads) return;
+	if (pool_users>0)
+	{
+		THROW(ProgrammingException, "Cannot change the thread count of the htslib thread pool from " + QString::number(pool_threads) + " to " + QString::number(threads) + " while " + QString::number(pool_users) + " file(s) are attached!");
+	}
+
+	if (pool.pool!=nullptr)
+	{
+		hts_tpool_destroy(pool.pool);
+		pool.pool = nullptr;
+	}
+	pool_threads = threads;
+}
+
+int HtsThreadPool::threadCount()
+{
+	QMutexLocker locker(&pool_mutex);
+	return pool_threads;
+}
+
+bool HtsThreadPool::attach(htsFile* fp, const QString& filename)
+{
+	QMutexLocker locker(&pool_mutex);
+	if (pool_threads==0) return false;
+
+	if (pool.pool==nullptr)
+	{
+		pool.pool = hts_tpool_init(pool_threads);
+		if (pool.pool==nullptr)
+		{
+			THROW(Exception, "Could not create htslib thread pool with " + QString::number(pool_threads) + " threads!");
+		}
+	}
+	if (hts_set_thread_pool(fp, &pool)!=0)
+	{
+		THROW(FileAccessException, "Could not attach htslib thread pool to file " + filename);
+	}
+	++pool_users;
+
+	return true;
+}
+
+void HtsThreadPool::detach()
+{
+	QMutexLocker locker(&pool_mutex);
+	if (pool_users>0) --pool_users;
+}
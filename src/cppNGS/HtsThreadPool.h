@@ -0,0 +1,28 @@
+#ifndef HTSTHREADPOOL_H
+#define HTSTHREADPOOL_H
+
+#include "cppNGS_global.h"
+#include "htslib/hts.h"
+#include <QString>
+
+/**
+  @brief Process-wide htslib thread pool for BGZF/CRAM (de)compression.
+
+  The pool is disabled by default. When a thread count is set (e.g. by a tool with a 'threads' parameter), all BamReader/BamWriter instances created afterwards share the pool.
+  The pool is created when the first file is attached and destroyed when the thread count is changed while no file is attached.
+*/
+class CPPNGSSHARED_EXPORT HtsThreadPool
+{
+public:
+	///Sets the number of threads of the pool. A thread count below 2 disables the pool. Throws an exception if files are attached to the pool and the thread count changes.
+	static void setThreadCount(int threads);
+	///Returns the number of threads of the pool (0 if disabled).
+	static int threadCount();
+
+	///Attaches the pool to an opened file. Returns if the pool was attached, i.e. if the pool is enabled. Throws an exception if attaching fails.
+	static bool attach(htsFile* fp, const QString& filename);
+	///Detaches a file from the pool. Has to be called after the attached file was closed.
+	static void detach();
+};
+
+#endif // HTSTHREADPOOL_H
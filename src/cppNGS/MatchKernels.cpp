@@ -0,0 +1,245 @@
+#include "MatchKernels.h"
+#include "Sequence.h"
+#include "Exceptions.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MATCHKERNELS_X86
+#include <immintrin.h>
+#endif
+
+typedef MatchKernels::Counts (*CompareFunction)(const char*, const char*, int, int);
+typedef void (*ReverseComplementFunction)(const char*, char*, int);
+
+static MatchKernels::Counts compareScalar(const char* s1, const char* s2, int length, int max_mismatches)
+{
+	MatchKernels::Counts output;
+	for (int i=0; i<length; ++i)
+	{
+		char b1 = s1[i];
+		char b2 = s2[i];
+		if (b1=='N' || b2=='N')
+		{
+			++output.invalid;
+		}
+		else if (b1==b2)
+		{
+			++output.matches;
+		}
+		else
+		{
+			++output.mismatches;
+			if (max_mismatches>=0 && output.mismatches>max_mismatches) break;
+		}
+	}
+	return output;
+}
+
+static void reverseComplementScalar(const char* in, char* out, int length)
+{
+	for (int i=0; i<length; ++i)
+	{
+		out[length-1-i] = Sequence::complement(in[i]);
+	}
+}
+
+//adds the counts of the remaining bases to the output (scalar code)
+static void compareRemaining(MatchKernels::Counts& output, const char* s1, const char* s2, int length, int max_mismatches)
+{
+	MatchKernels::Counts rest = compareScalar(s1, s2, length, max_mismatches<0 ? -1 : max_mismatches-output.mismatches);
+	output.matches += rest.matches;
+	output.mismatches += rest.mismatches;
+	output.invalid += rest.invalid;
+}
+
+#ifdef MATCHKERNELS_X86
+
+//Complement lookup by the lower four bits of the base: A=0x41, C=0x43, G=0x47, N=0x4E, T=0x54. All other indices are 0.
+#define COMPLEMENT_TABLE 0, 'T', 0, 'G', 'A', 0, 0, 'C', 0, 0, 0, 0, 0, 0, 'N', 0
+#define REVERSE_INDICES 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0
+
+__attribute__((target("sse4.2,popcnt")))
+static MatchKernels::Counts compareSSE42(const char* s1, const char* s2, int length, int max_mismatches)
+{
+	MatchKernels::Counts output;
+	const __m128i n = _mm_set1_epi8('N');
+	int i = 0;
+	for (; i+16<=length; i+=16)
+	{
+		__m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s1+i));
+		__m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s2+i));
+		unsigned int invalid = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v1, n), _mm_cmpeq_epi8(v2, n)));
+		unsigned int equal = _mm_movemask_epi8(_mm_cmpeq_epi8(v1, v2)) & ~invalid;
+		int invalid_count = __builtin_popcount(invalid);
+		int match_count = __builtin_popcount(equal);
+		output.invalid += invalid_count;
+		output.matches += match_count;
+		output.mismatches += 16 - invalid_count - match_count;
+		if (max_mismatches>=0 && output.mismatches>max_mismatches) return output;
+	}
+	compareRemaining(output, s1+i, s2+i, length-i, max_mismatches);
+	return output;
+}
+
+__attribute__((target("sse4.2")))
+static void reverseComplementSSE42(const char* in, char* out, int length)
+{
+	const __m128i table = _mm_setr_epi8(COMPLEMENT_TABLE);
+	const __m128i reverse = _mm_setr_epi8(REVERSE_INDICES);
+	const __m128i low_bits = _mm_set1_epi8(0x0F);
+	const __m128i zero = _mm_setzero_si128();
+	int i = 0;
+	for (; i+16<=length; i+=16)
+	{
+		__m128i bases = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in+i));
+		__m128i complement = _mm_shuffle_epi8(table, _mm_and_si128(bases, low_bits));
+
+		//valid bases are mapped back to themselves - invalid bases are handled by the scalar code (exception)
+		__m128i back = _mm_shuffle_epi8(table, _mm_and_si128(complement, low_bits));
+		int valid = _mm_movemask_epi8(_mm_andnot_si128(_mm_cmpeq_epi8(complement, zero), _mm_cmpeq_epi8(back, bases)));
+		if (valid!=0xFFFF) break;
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out+length-i-16), _mm_shuffle_epi8(complement, reverse));
+	}
+	reverseComplementScalar(in+i, out, length-i);
+}
+
+__attribute__((target("avx2,popcnt")))
+static MatchKernels::Counts compareAVX2(const char* s1, const char* s2, int length, int max_mismatches)
+{
+	MatchKernels::Counts output;
+	const __m256i n = _mm256_set1_epi8('N');
+	int i = 0;
+	for (; i+32<=length; i+=32)
+	{
+		__m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s1+i));
+		__m256i v2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s2+i));
+		unsigned int invalid = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v1, n), _mm256_cmpeq_epi8(v2, n)));
+		unsigned int equal = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v1, v2)) & ~invalid;
+		int invalid_count = __builtin_popcount(invalid);
+		int match_count = __builtin_popcount(equal);
+		output.invalid += invalid_count;
+		output.matches += match_count;
+		output.mismatches += 32 - invalid_count - match_count;
+		if (max_mismatches>=0 && output.mismatches>max_mismatches) return output;
+	}
+	compareRemaining(output, s1+i, s2+i, length-i, max_mismatches);
+	return output;
+}
+
+__attribute__((target("avx2")))
+static void reverseComplementAVX2(const char* in, char* out, int length)
+{
+	const __m256i table = _mm256_setr_epi8(COMPLEMENT_TABLE, COMPLEMENT_TABLE);
+	const __m256i reverse = _mm256_setr_epi8(REVERSE_INDICES, REVERSE_INDICES);
+	const __m256i low_bits = _mm256_set1_epi8(0x0F);
+	const __m256i zero = _mm256_setzero_si256();
+	int i = 0;
+	for (; i+32<=length; i+=32)
+	{
+		__m256i bases = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in+i));
+		__m256i complement = _mm256_shuffle_epi8(table, _mm256_and_si256(bases, low_bits));
+
+		//valid bases are mapped back to themselves - invalid bases are handled by the scalar code (exception)
+		__m256i back = _mm256_shuffle_epi8(table, _mm256_and_si256(complement, low_bits));
+		unsigned int valid = _mm256_movemask_epi8(_mm256_andnot_si256(_mm256_cmpeq_epi8(complement, zero), _mm256_cmpeq_epi8(back, bases)));
+		if (valid!=0xFFFFFFFFu) break;
+
+		//reverse bytes in each 128-bit lane, then swap the lanes
+		__m256i reversed = _mm256_shuffle_epi8(complement, reverse);
+		reversed = _mm256_permute2x128_si256(reversed, reversed, 0x01);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out+length-i-32), reversed);
+	}
+	reverseComplementScalar(in+i, out, length-i);
+}
+
+#endif
+
+//Implementation selected for the CPU
+struct KernelImplementation
+{
+	QByteArray name;
+	CompareFunction compare;
+	ReverseComplementFunction reverse_complement;
+};
+
+//Returns the implementations supported by the CPU (fastest first)
+static QList<KernelImplementation> determineImplementations()
+{
+	QList<KernelImplementation> output;
+#ifdef MATCHKERNELS_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+	{
+		output << KernelImplementation{"AVX2", compareAVX2, reverseComplementAVX2};
+	}
+	if (__builtin_cpu_supports("sse4.2"))
+	{
+		output << KernelImplementation{"SSE4.2", compareSSE42, reverseComplementSSE42};
+	}
+#endif
+	output << KernelImplementation{"scalar", compareScalar, reverseComplementScalar};
+	return output;
+}
+
+static const QList<KernelImplementation>& supportedImplementationList()
+{
+	static const QList<KernelImplementation> impls = determineImplementations(); //thread-safe initialization
+	return impls;
+}
+
+static const KernelImplementation& selectedImplementation()
+{
+	return supportedImplementationList().first();
+}
+
+static const KernelImplementation& implementationByName(const QByteArray& name)
+{
+	const QList<KernelImplementation>& impls = supportedImplementationList();
+	for (int i=0; i<impls.count(); ++i)
+	{
+		if (impls[i].name==name) return impls[i];
+	}
+	THROW(ArgumentException, "Matching kernel implementation '" + name + "' is not supported by the CPU!");
+}
+
+MatchKernels::Counts MatchKernels::compare(const char* s1, const char* s2, int length, int max_mismatches)
+{
+	return selectedImplementation().compare(s1, s2, length, max_mismatches);
+}
+
+void MatchKernels::reverseComplement(const char* in, char* out, int length)
+{
+	selectedImplementation().reverse_complement(in, out, length);
+}
+
+QByteArray MatchKernels::reverseComplement(const QByteArray& seq)
+{
+	QByteArray output(seq.size(), Qt::Uninitialized);
+	reverseComplement(seq.constData(), output.data(), seq.size());
+	return output;
+}
+
+QByteArray MatchKernels::implementation()
+{
+	return selectedImplementation().name;
+}
+
+QByteArrayList MatchKernels::supportedImplementations()
+{
+	QByteArrayList output;
+	foreach(const KernelImplementation& impl, supportedImplementationList())
+	{
+		output << impl.name;
+	}
+	return output;
+}
+
+MatchKernels::Counts MatchKernels::compare(const QByteArray& implementation, const char* s1, const char* s2, int length, int max_mismatches)
+{
+	return implementationByName(implementation).compare(s1, s2, length, max_mismatches);
+}
+
+void MatchKernels::reverseComplement(const QByteArray& implementation, const char* in, char* out, int length)
+{
+	implementationByName(implementation).reverse_complement(in, out, length);
+}
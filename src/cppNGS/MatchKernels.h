@@ -0,0 +1,43 @@
+#ifndef MATCHKERNELS_H
+#define MATCHKERNELS_H
+
+#include "cppNGS_global.h"
+#include <QByteArrayList>
+
+///Sequence comparison kernels for adapter/insert matching.
+///The fastest implementation supported by the CPU is selected at runtime: AVX2, SSE4.2 or scalar.
+class CPPNGSSHARED_EXPORT MatchKernels
+{
+public:
+	///Result of a sequence comparison.
+	struct Counts
+	{
+		int matches = 0;
+		int mismatches = 0;
+		int invalid = 0; //positions with 'N' in one of the sequences
+	};
+
+	///Compares the first @p length bases of two sequences.
+	///If @p max_mismatches is not negative, the comparison may stop as soon as more mismatches are found. The counts are incomplete then, but the mismatch count is greater than @p max_mismatches.
+	static Counts compare(const char* s1, const char* s2, int length, int max_mismatches = -1);
+
+	///Writes the reverse complement of @p length bases to @p out. Throws a ProgrammingException if a base other than A, C, G, T or N is found.
+	static void reverseComplement(const char* in, char* out, int length);
+	///Returns the reverse complement of the given sequence (see above).
+	static QByteArray reverseComplement(const QByteArray& seq);
+
+	///Returns the name of the implementation selected for the CPU.
+	static QByteArray implementation();
+	///Returns the names of all implementations supported by the CPU (the selected implementation first, 'scalar' last).
+	static QByteArrayList supportedImplementations();
+
+	///Same as compare() above, but uses the given implementation instead of the selected one, e.g. to check that all implementations give the same result.
+	static Counts compare(const QByteArray& implementation, const char* s1, const char* s2, int length, int max_mismatches = -1);
+	///Same as reverseComplement() above, but uses the given implementation instead of the selected one.
+	static void reverseComplement(const QByteArray& implementation, const char* in, char* out, int length);
+
+private:
+	MatchKernels() = delete;
+};
+
+#endif // MATCHKERNELS_H
@@ -0,0 +1,283 @@
+#include "MultiRegionCoverage.h"
+#include "BamReader.h"
+#include "Exceptions.h"
+#include "Helper.h"
+#include <QAtomicInt>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QTextStream>
+#include <QTime>
+#include <algorithm>
+
+//Processes super-regions until none is left (super-regions are distributed dynamically, so that each worker needs only one BAM/CRAM reader)
+class MultiRegionCoverageWorker
+	: public QRunnable
+{
+public:
+	MultiRegionCoverageWorker(const MultiRegionCoverage& engine, QAtomicInt& next, MultiRegionCoverageResult& output, double* avg, QString& error, const QString& bam_file, const QString& ref_file, int low_cutoff, int high_cutoff, int min_mapq, int min_baseq)
+		: QRunnable()
+		, engine_(engine)
+		, next_(next)
+		, output_(output)
+		, avg_(avg)
+		, error_(error)
+		, bam_file_(bam_file)
+		, ref_file_(ref_file)
+		, low_cutoff_(low_cutoff)
+		, high_cutoff_(high_cutoff)
+		, min_mapq_(min_mapq)
+		, min_baseq_(min_baseq)
+	{
+	}
+
+	void run() override
+	{
+		try
+		{
+			BamReader reader(bam_file_, ref_file_);
+			int i = next_.fetchAndAddOrdered(1);
+			while (i<engine_.super_regions_.count())
+			{
+				processSuperRegion(reader, engine_.super_regions_[i]);
+				i = next_.fetchAndAddOrdered(1);
+			}
+		}
+		catch(Exception& e)
+		{
+			error_ = e.message();
+		}
+		catch(std::exception& e)
+		{
+			error_ = e.what();
+		}
+		catch(...)
+		{
+			error_ = "Unknown exception!";
+		}
+	}
+
+private:
+	const MultiRegionCoverage& engine_;
+	QAtomicInt& next_;
+	MultiRegionCoverageResult& output_;
+	double* avg_;
+	QString& error_;
+	QString bam_file_;
+	QString ref_file_;
+	int low_cutoff_;
+	int high_cutoff_;
+	int min_mapq_;
+	int min_baseq_;
+	QVector<int> depth_; //difference array, converted to depth in-place
+	QBitArray base_qualities_;
+
+	void processSuperRegion(BamReader& reader, const MultiRegionCoverage::SuperRegion& region)
+	{
+		//super-regions longer than the maximum span consist of one long target region - they are processed in windows, so that the memory is bounded
+		const int line_count = region.lines.count();
+		QVector<long long> sums(line_count, 0);
+		QVector<int> low_starts(line_count, -1);
+		QVector<int> high_starts(line_count, -1);
+		for (int w_start=region.start; w_start<=region.end; w_start+=engine_.max_span_)
+		{
+			const int w_end = std::min((long long)region.end, (long long)w_start + engine_.max_span_ - 1);
+			calculateDepth(reader, region.chr, w_start, w_end);
+
+			//statistics of target regions
+			for (int l=0; l<line_count; ++l)
+			{
+				const BedLine& line = engine_.regions_[region.lines[l]];
+				const int start = std::max(line.start(), w_start);
+				const int end = std::min(line.end(), w_end);
+				if (start>end) continue;
+
+				const int* depth = depth_.constData() + (start - w_start);
+				const int length = end - start + 1;
+				for (int p=0; p<length; ++p)
+				{
+					sums[l] += depth[p];
+				}
+				if (low_cutoff_>=0) addRegions(line, start, end, depth, low_starts[l], output_.low, [this](int d){ return d<low_cutoff_; });
+				if (high_cutoff_>=0) addRegions(line, start, end, depth, high_starts[l], output_.high, [this](int d){ return d>=high_cutoff_; });
+
+				if (end==line.end())
+				{
+					avg_[region.lines[l]] = (double)sums[l] / line.length();
+				}
+			}
+		}
+	}
+
+	//Calculates the depth of a window in depth_ (index 0 is the window start)
+	void calculateDepth(BamReader& reader, const Chromosome& chr, int start, int end)
+	{
+		const int span = end - start + 1;
+		depth_.fill(0, span + 1);
+		int* diff = depth_.data();
+
+		//accumulate start/end of covered stretches
+		reader.setRegion(chr, start, end);
+		BamAlignment al;
+		while (reader.getNextAlignment(al))
+		{
+			if (al.isDuplicate()) continue;
+			if (al.isSecondaryAlignment() || al.isSupplementaryAlignment()) continue;
+			if (al.isUnmapped() || al.mappingQuality()<min_mapq_) continue;
+
+			const int ol_start = std::max(start, al.start()) - start;
+			const int ol_end = std::min(end, al.end()) - start;
+			if (ol_start>ol_end) continue;
+
+			if (min_baseq_>0)
+			{
+				//add runs of bases with sufficient base quality
+				const int offset = start - al.start();
+				al.qualities(base_qualities_, min_baseq_, al.end() - al.start() + 1);
+				int run_start = -1;
+				for (int p=ol_start; p<=ol_end; ++p)
+				{
+					if (base_qualities_.testBit(p + offset))
+					{
+						if (run_start==-1) run_start = p;
+					}
+					else if (run_start!=-1)
+					{
+						++diff[run_start];
+						--diff[p];
+						run_start = -1;
+					}
+				}
+				if (run_start!=-1)
+				{
+					++diff[run_start];
+					--diff[ol_end+1];
+				}
+			}
+			else
+			{
+				++diff[ol_start];
+				--diff[ol_end+1];
+			}
+		}
+
+		//prefix sum
+		for (int p=1; p<span; ++p)
+		{
+			diff[p] += diff[p-1];
+		}
+	}
+
+	//Appends the stretches of the part [start, end] of a target region where 'filter' holds for the depth. Stretches that are still open are continued in the next part via @p reg_start.
+	template<typename Filter>
+	static void addRegions(const BedLine& line, int start, int end, const int* depth, int& reg_start, BedFile& output, Filter filter)
+	{
+		for (int pos=start; pos<=end; ++pos)
+		{
+			bool match = filter(depth[pos-start]);
+			if (reg_start!=-1 && !match)
+			{
+				output.append(BedLine(line.chr(), reg_start, pos - 1, line.annotations()));
+				reg_start = -1;
+			}
+			if (reg_start==-1 && match)
+			{
+				reg_start = pos;
+			}
+		}
+		if (reg_start!=-1 && end==line.end())
+		{
+			output.append(BedLine(line.chr(), reg_start, line.end(), line.annotations()));
+		}
+	}
+};
+
+MultiRegionCoverage::MultiRegionCoverage(const BedFile& regions, int max_gap, int max_span)
+	: regions_(regions)
+	, max_span_(max_span)
+{
+	if (max_span<1) THROW(ArgumentException, "Maximum span of super-regions has to be at least 1!");
+
+	//sort target regions by position (the input is not modified)
+	QVector<int> indices;
+	indices.reserve(regions.count());
+	for (int i=0; i<regions.count(); ++i)
+	{
+		if (regions[i].length()>0) indices << i;
+	}
+	std::sort(indices.begin(), indices.end(), [&regions](int a, int b)
+	{
+		const BedLine& la = regions[a];
+		const BedLine& lb = regions[b];
+		if (la.chr()!=lb.chr()) return la.chr() < lb.chr();
+		if (la.start()!=lb.start()) return la.start() < lb.start();
+		return a < b;
+	});
+
+	//merge nearby target regions into super-regions
+	foreach(int index, indices)
+	{
+		const BedLine& line = regions[index];
+		if (!super_regions_.isEmpty())
+		{
+			SuperRegion& last = super_regions_.last();
+			const int end = std::max(last.end, line.end());
+			if (last.chr==line.chr() && line.start()<=(long long)last.end + max_gap + 1 && (long long)end - last.start + 1 <= max_span)
+			{
+				last.end = end;
+				last.lines << index;
+				continue;
+			}
+		}
+		super_regions_ << SuperRegion{line.chr(), line.start(), line.end(), QVector<int>() << index};
+	}
+}
+
+MultiRegionCoverageResult MultiRegionCoverage::calculate(const QString& bam_file, int low_cutoff, int high_cutoff, int min_mapq, int min_baseq, int threads, const QString& ref_file, bool debug) const
+{
+	QTime timer;
+	timer.start();
+
+	MultiRegionCoverageResult output;
+	output.avg.fill(0.0, regions_.count());
+
+	//process super-regions (each worker collects its own low/high regions, average depth is written to disjoint indices)
+	const int worker_count = std::max(1, std::min(threads, super_regions_.count()));
+	QVector<MultiRegionCoverageResult> worker_output(worker_count);
+	QStringList errors;
+	for (int w=0; w<worker_count; ++w)
+	{
+		errors << QString();
+	}
+	QAtomicInt next(0);
+	QThreadPool thread_pool;
+	thread_pool.setMaxThreadCount(worker_count);
+	for (int w=0; w<worker_count; ++w)
+	{
+		thread_pool.start(new MultiRegionCoverageWorker(*this, next, worker_output[w], output.avg.data(), errors[w], bam_file, ref_file, low_cutoff, high_cutoff, min_mapq, min_baseq));
+	}
+	thread_pool.waitForDone();
+	foreach(const QString& error, errors)
+	{
+		if (!error.isEmpty()) THROW(Exception, error);
+	}
+
+	//combine output
+	foreach(const MultiRegionCoverageResult& result, worker_output)
+	{
+		for (int i=0; i<result.low.count(); ++i)
+		{
+			output.low.append(result.low[i]);
+		}
+		for (int i=0; i<result.high.count(); ++i)
+		{
+			output.high.append(result.high[i]);
+		}
+	}
+
+	if (debug)
+	{
+		QTextStream(stdout) << "Processing " << regions_.count() << " regions in " << super_regions_.count() << " super-regions with " << worker_count << " threads took " << Helper::elapsedTime(timer) << endl;
+	}
+
+	return output;
+}
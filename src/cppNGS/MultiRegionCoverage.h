@@ -0,0 +1,58 @@
+#ifndef MULTIREGIONCOVERAGE_H
+#define MULTIREGIONCOVERAGE_H
+
+#include "cppNGS_global.h"
+#include "BedFile.h"
+#include <QVector>
+
+///Coverage statistics of target regions determined by MultiRegionCoverage.
+struct CPPNGSSHARED_EXPORT MultiRegionCoverageResult
+{
+	BedFile low; //regions with depth below the low-coverage cutoff (not merged, annotations of the target region are passed on)
+	BedFile high; //regions with depth above or equal to the high-coverage cutoff (not merged, annotations of the target region are passed on)
+	QVector<double> avg; //average depth of each target region (same order as the target regions)
+};
+
+/**
+  @brief Single-pass coverage engine for target regions using random access to a BAM/CRAM file.
+
+  Target regions that are closer than a maximum gap are merged into super-regions. Each super-region is streamed from the BAM/CRAM file only once.
+  Depth is accumulated in a difference array, i.e. an alignment is added in constant time (or once per run of bases passing the base quality cutoff).
+  Low-coverage regions, high-coverage regions and the average depth of all target regions are derived from the same depth profile.
+  The target regions do not need to be sorted or merged.
+*/
+class CPPNGSSHARED_EXPORT MultiRegionCoverage
+{
+public:
+	///Constructor. Target regions with a gap of up to @p max_gap bases are merged into super-regions, unless the super-region would become longer than @p max_span bases.
+	///Target regions longer than @p max_span bases are streamed in windows of @p max_span bases, i.e. the memory used per thread is bounded by @p max_span.
+	MultiRegionCoverage(const BedFile& regions, int max_gap = 1000, int max_span = 1000000);
+
+	///Returns the number of super-regions.
+	int superRegionCount() const
+	{
+		return super_regions_.count();
+	}
+
+	///Calculates the coverage statistics of all target regions. A cutoff of -1 disables the respective output.
+	///Depth is defined as in Statistics::lowCoverage, i.e. duplicates, secondary/supplementary alignments and alignments with mapping quality below @p min_mapq are skipped and bases with base quality below @p min_baseq are not counted.
+	MultiRegionCoverageResult calculate(const QString& bam_file, int low_cutoff, int high_cutoff, int min_mapq = 1, int min_baseq = 0, int threads = 1, const QString& ref_file = QString(), bool debug = false) const;
+
+protected:
+	//Consecutive part of a chromosome that is streamed in one go
+	struct SuperRegion
+	{
+		Chromosome chr;
+		int start;
+		int end;
+		QVector<int> lines; //indices of the target regions
+	};
+
+	const BedFile& regions_;
+	int max_span_;
+	QVector<SuperRegion> super_regions_;
+
+	friend class MultiRegionCoverageWorker;
+};
+
+#endif // MULTIREGIONCOVERAGE_H
@@ -0,0 +1,229 @@
+#include "MultiSitePileup.h"
+#include "BamReader.h"
+#include "Exceptions.h"
+#include <QAtomicInt>
+#include <QRunnable>
+#include <QThreadPool>
+#include <algorithm>
+
+//Processes chromosomes until none is left (chromosomes are distributed dynamically, so that each worker needs only one BAM/CRAM reader)
+class MultiSitePileupWorker
+	: public QRunnable
+{
+public:
+	MultiSitePileupWorker(const MultiSitePileup& engine, const QVector<QVector<MultiSitePileup::Block>>& chr_blocks, QAtomicInt& next, Pileup* output, QString& error, const QString& bam_file, const QString& ref_file, int indel_window, int min_mapq, bool anom, int min_baseq)
+		: QRunnable()
+		, engine_(engine)
+		, chr_blocks_(chr_blocks)
+		, next_(next)
+		, output_(output)
+		, error_(error)
+		, bam_file_(bam_file)
+		, ref_file_(ref_file)
+		, indel_window_(indel_window)
+		, min_mapq_(min_mapq)
+		, anom_(anom)
+		, min_baseq_(min_baseq)
+	{
+	}
+
+	void run() override
+	{
+		try
+		{
+			BamReader reader(bam_file_, ref_file_);
+			int i = next_.fetchAndAddOrdered(1);
+			while (i<chr_blocks_.count())
+			{
+				foreach(const MultiSitePileup::Block& block, chr_blocks_[i])
+				{
+					engine_.processBlock(reader, block, output_, indel_window_, min_mapq_, anom_, min_baseq_);
+				}
+				i = next_.fetchAndAddOrdered(1);
+			}
+		}
+		catch(Exception& e)
+		{
+			error_ = e.message();
+		}
+		catch(std::exception& e)
+		{
+			error_ = e.what();
+		}
+		catch(...)
+		{
+			error_ = "Unknown exception!";
+		}
+	}
+
+private:
+	const MultiSitePileup& engine_;
+	const QVector<QVector<MultiSitePileup::Block>>& chr_blocks_;
+	QAtomicInt& next_;
+	Pileup* output_;
+	QString& error_;
+	QString bam_file_;
+	QString ref_file_;
+	int indel_window_;
+	int min_mapq_;
+	bool anom_;
+	int min_baseq_;
+};
+
+MultiSitePileup::MultiSitePileup(int max_gap)
+	: max_gap_(max_gap)
+{
+}
+
+int MultiSitePileup::addSite(const Chromosome& chr, int pos)
+{
+	sites_ << Site{chr, pos};
+	return sites_.count() - 1;
+}
+
+QVector<Pileup> MultiSitePileup::calculate(BamReader& reader, int indel_window, int min_mapq, bool anom, int min_baseq) const
+{
+	QVector<Pileup> output(sites_.count());
+	Pileup* data = output.data();
+	foreach(const QVector<Block>& blocks, createBlocks())
+	{
+		foreach(const Block& block, blocks)
+		{
+			processBlock(reader, block, data, indel_window, min_mapq, anom, min_baseq);
+		}
+	}
+	return output;
+}
+
+QVector<Pileup> MultiSitePileup::calculate(const QString& bam_file, const QString& ref_file, int threads, int indel_window, int min_mapq, bool anom, int min_baseq) const
+{
+	QVector<Pileup> output(sites_.count());
+	const QVector<QVector<Block>> chr_blocks = createBlocks();
+
+	//process chromosomes (sites of different chromosomes are written to disjoint indices)
+	const int worker_count = std::max(1, std::min(threads, chr_blocks.count()));
+	QStringList errors;
+	for (int w=0; w<worker_count; ++w)
+	{
+		errors << QString();
+	}
+	QAtomicInt next(0);
+	QThreadPool thread_pool;
+	thread_pool.setMaxThreadCount(worker_count);
+	for (int w=0; w<worker_count; ++w)
+	{
+		thread_pool.start(new MultiSitePileupWorker(*this, chr_blocks, next, output.data(), errors[w], bam_file, ref_file, indel_window, min_mapq, anom, min_baseq));
+	}
+	thread_pool.waitForDone();
+	foreach(const QString& error, errors)
+	{
+		if (!error.isEmpty()) THROW(Exception, error);
+	}
+
+	return output;
+}
+
+QVector<QVector<MultiSitePileup::Block>> MultiSitePileup::createBlocks() const
+{
+	//sort sites by position (the input order is not modified)
+	QVector<int> indices;
+	indices.reserve(sites_.count());
+	for (int i=0; i<sites_.count(); ++i)
+	{
+		indices << i;
+	}
+	std::sort(indices.begin(), indices.end(), [this](int a, int b)
+	{
+		const Site& sa = sites_[a];
+		const Site& sb = sites_[b];
+		if (sa.chr!=sb.chr) return sa.chr < sb.chr;
+		if (sa.pos!=sb.pos) return sa.pos < sb.pos;
+		return a < b;
+	});
+
+	//merge nearby sites into blocks
+	QVector<QVector<Block>> output;
+	foreach(int index, indices)
+	{
+		const Site& site = sites_[index];
+		if (!output.isEmpty() && output.last().last().chr==site.chr)
+		{
+			Block& last = output.last().last();
+			if (site.pos<=(long long)last.end + max_gap_ + 1)
+			{
+				last.end = site.pos;
+				last.sites << index;
+				continue;
+			}
+			output.last() << Block{site.chr, site.pos, site.pos, QVector<int>() << index};
+			continue;
+		}
+		output << (QVector<Block>() << Block{site.chr, site.pos, site.pos, QVector<int>() << index});
+	}
+
+	return output;
+}
+
+void MultiSitePileup::processBlock(BamReader& reader, const Block& block, Pileup* output, int indel_window, int min_mapq, bool anom, int min_baseq) const
+{
+	const int count = block.sites.count();
+	QVector<int> positions(count);
+	for (int i=0; i<count; ++i)
+	{
+		positions[i] = sites_[block.sites[i]].pos;
+	}
+	QVector<int> reads_mapped(count, 0);
+	QVector<int> reads_mapq0(count, 0);
+	QVector<QPair<char, int>> bases(count);
+
+	//iterate through all alignments and create counts (alignments are sorted by start position, so sites before the start of an alignment are done)
+	reader.setRegion(block.chr, block.start, block.end);
+	int first = 0;
+	BamAlignment al;
+	while (reader.getNextAlignment(al))
+	{
+		if (!al.isProperPair() && anom==false) continue;
+		if (al.isSecondaryAlignment() || al.isSupplementaryAlignment()) continue;
+		if (al.isDuplicate()) continue;
+		if (al.isUnmapped()) continue;
+
+		//determine covered sites
+		const int start = al.start();
+		const int end = al.end();
+		while (first<count && positions[first]<start) ++first;
+		int last = first;
+		while (last<count && positions[last]<=end) ++last;
+		if (first==last) continue;
+
+		const bool mapq0 = al.mappingQuality()==0;
+		for (int i=first; i<last; ++i)
+		{
+			reads_mapped[i] += 1;
+			if (mapq0) reads_mapq0[i] += 1;
+		}
+
+		if (al.mappingQuality()<min_mapq) continue;
+
+		//snps
+		al.extractBasesByCIGAR(positions.constData() + first, last - first, bases.data() + first);
+		for (int i=first; i<last; ++i)
+		{
+			Pileup& pileup = output[block.sites[i]];
+			if (bases[i].second>=min_baseq)
+			{
+				pileup.inc(bases[i].first);
+			}
+
+			//indels
+			if (indel_window>=0)
+			{
+				pileup.addIndels(al.extractIndelsByCIGAR(positions[i], indel_window));
+			}
+		}
+	}
+
+	for (int i=0; i<count; ++i)
+	{
+		output[block.sites[i]].setMapq0Frac((double)reads_mapq0[i] / reads_mapped[i]);
+	}
+}
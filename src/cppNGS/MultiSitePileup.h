@@ -0,0 +1,66 @@
+#ifndef MULTISITEPILEUP_H
+#define MULTISITEPILEUP_H
+
+#include "cppNGS_global.h"
+#include "Chromosome.h"
+#include "Pileup.h"
+#include <QVector>
+
+class BamReader;
+
+/**
+  @brief Batched pileup engine for many sites, e.g. the SNPs of a panel used for sample identity, contamination or gender checks.
+
+  Sites that are closer than a maximum gap are merged into blocks. Each block is read from the BAM/CRAM file with one region query (instead of one query per site).
+  The CIGAR of each alignment is processed only once for all sites it covers.
+  The pileups are identical to the result of BamReader::getPileup for each site.
+  Sites do not need to be sorted. The output is in the order the sites were added.
+*/
+class CPPNGSSHARED_EXPORT MultiSitePileup
+{
+public:
+	///Constructor. Sites with a gap of up to @p max_gap bases are read from the BAM/CRAM file in one go.
+	MultiSitePileup(int max_gap = 1000);
+
+	///Adds a site (1-based position) and returns its index.
+	int addSite(const Chromosome& chr, int pos);
+	///Returns the number of sites.
+	int siteCount() const
+	{
+		return sites_.count();
+	}
+
+	///Calculates the pileups of all sites using an open reader. The parameters have the same meaning as in BamReader::getPileup.
+	QVector<Pileup> calculate(BamReader& reader, int indel_window = -1, int min_mapq = 1, bool anom = false, int min_baseq = 13) const;
+	///Calculates the pileups of all sites using several threads. Chromosomes are distributed to the threads, each thread uses its own reader.
+	QVector<Pileup> calculate(const QString& bam_file, const QString& ref_file, int threads, int indel_window = -1, int min_mapq = 1, bool anom = false, int min_baseq = 13) const;
+
+protected:
+	//Site with 1-based position
+	struct Site
+	{
+		Chromosome chr;
+		int pos;
+	};
+
+	//Consecutive part of a chromosome that is read in one go
+	struct Block
+	{
+		Chromosome chr;
+		int start;
+		int end;
+		QVector<int> sites; //indices of the sites (sorted by position)
+	};
+
+	int max_gap_;
+	QVector<Site> sites_;
+
+	//Creates blocks of nearby sites and returns them grouped by chromosome.
+	QVector<QVector<Block>> createBlocks() const;
+	//Calculates the pileups of the sites in a block.
+	void processBlock(BamReader& reader, const Block& block, Pileup* output, int indel_window, int min_mapq, bool anom, int min_baseq) const;
+
+	friend class MultiSitePileupWorker;
+};
+
+#endif // MULTISITEPILEUP_H
@@ -4,6 +4,7 @@
 #include "Log.h"
 
 #include <QFileInfo>
+#include <QtEndian>
 
 namespace {
 
@@ -1070,8 +1071,291 @@ QHash<QByteArray, QByteArray> parseGffAttributes(const QByteArray& attributes)
 	return output;
 }
 
+namespace {
+
+	//Binary transcript database layout (little-endian):
+	//  header: magic (8 bytes), version, flags (bit 0: include_all, bit 1: skip_not_hgnc) (qint32), source (string)
+	//  string table: count (qint32), strings
+	//  transcripts: count (qint32), for each transcript: gene, gene ID, HGNC ID, name, CCDS name, biotype, chromosome (string indices), version, source, strand, flags, coding start, coding end, exon count, exon start/end pairs (qint32)
+	//  relations: ENST>ENSG count (qint32), string index pairs, ENSG>symbol count (qint32), string index pairs
+	//Strings are stored with a length prefix (qint32).
+	const QByteArray GFF_DB_MAGIC = "NGSTRXDB";
+	const int GFF_DB_VERSION = 1;
+
+	//Transcript flags
+	const int GFF_DB_PREFERRED = 1;
+	const int GFF_DB_GENCODE_BASIC = 2;
+	const int GFF_DB_ENSEMBL_CANONICAL = 4;
+	const int GFF_DB_MANE_SELECT = 8;
+	const int GFF_DB_MANE_PLUS_CLINICAL = 16;
+
+	void appendInt(QByteArray& buffer, qint32 value)
+	{
+		char bytes[4];
+		qToLittleEndian<qint32>(value, bytes);
+		buffer.append(bytes, 4);
+	}
+
+	void appendString(QByteArray& buffer, const QByteArray& str)
+	{
+		appendInt(buffer, str.size());
+		buffer.append(str);
+	}
+
+	//Table of unique strings (repeated strings like gene names are stored only once)
+	struct GffDatabaseStrings
+	{
+		QHash<QByteArray, int> indices;
+		QByteArrayList strings;
+
+		int add(const QByteArray& str)
+		{
+			auto it = indices.constFind(str);
+			if (it!=indices.cend()) return it.value();
+
+			int index = strings.count();
+			indices.insert(str, index);
+			strings << str;
+			return index;
+		}
+	};
+
+	//Sequential reader for a memory-mapped transcript database
+	struct GffDatabaseReader
+	{
+		const uchar* data;
+		qint64 size;
+		qint64 offset;
+		QString filename;
+
+		qint32 readInt()
+		{
+			if (offset + 4 > size) THROW(FileParseException, "Transcript database " + filename + " is truncated!");
+			qint32 value = qFromLittleEndian<qint32>(data + offset);
+			offset += 4;
+			return value;
+		}
+
+		QByteArray readString()
+		{
+			int length = readInt();
+			if (length<0 || offset + length > size) THROW(FileParseException, "Transcript database " + filename + " is truncated!");
+			QByteArray output(reinterpret_cast<const char*>(data + offset), length);
+			offset += length;
+			return output;
+		}
+
+		const QByteArray& readStringIndex(const QByteArrayList& strings)
+		{
+			int index = readInt();
+			if (index<0 || index>=strings.count()) THROW(FileParseException, "Transcript database " + filename + " contains invalid string index " + QString::number(index) + "!");
+			return strings[index];
+		}
+	};
+} // end anonymous namespace
+
+bool NGSHelper::isGffDatabase(QString filename)
+{
+	QFile file(filename);
+	if (!file.open(QFile::ReadOnly)) return false;
+	return file.read(GFF_DB_MAGIC.size())==GFF_DB_MAGIC;
+}
+
+void NGSHelper::storeGffDatabase(QString filename, const GffData& data, const GffSettings& settings)
+{
+	GffDatabaseStrings strings;
+
+	//transcripts (sorted by position)
+	TranscriptList transcripts = data.transcripts;
+	transcripts.sortByPosition();
+	QByteArray body;
+	appendInt(body, transcripts.count());
+	foreach(const Transcript& t, transcripts)
+	{
+		appendInt(body, strings.add(t.gene()));
+		appendInt(body, strings.add(t.geneId()));
+		appendInt(body, strings.add(t.hgncId()));
+		appendInt(body, strings.add(t.name()));
+		appendInt(body, strings.add(t.nameCcds()));
+		appendInt(body, strings.add(Transcript::biotypeToString(t.biotype())));
+		appendInt(body, strings.add(t.chr().str()));
+		appendInt(body, t.version());
+		appendInt(body, t.source());
+		appendInt(body, t.strand());
+		int flags = 0;
+		if (t.isPreferredTranscript()) flags |= GFF_DB_PREFERRED;
+		if (t.isGencodeBasicTranscript()) flags |= GFF_DB_GENCODE_BASIC;
+		if (t.isEnsemblCanonicalTranscript()) flags |= GFF_DB_ENSEMBL_CANONICAL;
+		if (t.isManeSelectTranscript()) flags |= GFF_DB_MANE_SELECT;
+		if (t.isManePlusClinicalTranscript()) flags |= GFF_DB_MANE_PLUS_CLINICAL;
+		appendInt(body, flags);
+		appendInt(body, t.codingStart());
+		appendInt(body, t.codingEnd());
+		const BedFile& regions = t.regions();
+		appendInt(body, regions.count());
+		for (int i=0; i<regions.count(); ++i)
+		{
+			appendInt(body, regions[i].start());
+			appendInt(body, regions[i].end());
+		}
+	}
+
+	//relations
+	appendInt(body, data.enst2ensg.count());
+	for (auto it=data.enst2ensg.cbegin(); it!=data.enst2ensg.cend(); ++it)
+	{
+		appendInt(body, strings.add(it.key()));
+		appendInt(body, strings.add(it.value()));
+	}
+	appendInt(body, data.ensg2symbol.count());
+	for (auto it=data.ensg2symbol.cbegin(); it!=data.ensg2symbol.cend(); ++it)
+	{
+		appendInt(body, strings.add(it.key()));
+		appendInt(body, strings.add(it.value()));
+	}
+
+	//header and string table
+	QByteArray header = GFF_DB_MAGIC;
+	appendInt(header, GFF_DB_VERSION);
+	appendInt(header, (settings.include_all ? 1 : 0) | (settings.skip_not_hgnc ? 2 : 0));
+	appendString(header, settings.source.toUtf8());
+	appendInt(header, strings.strings.count());
+	foreach(const QByteArray& str, strings.strings)
+	{
+		appendString(header, str);
+	}
+
+	//write
+	QSharedPointer<QFile> file = Helper::openFileForWriting(filename);
+	file->write(header);
+	file->write(body);
+	if (file->error()!=QFile::NoError)
+	{
+		THROW(FileAccessException, "Could not write transcript database " + filename + ": " + file->errorString());
+	}
+}
+
+void NGSHelper::loadGffDatabase(QString filename, GffData& output, const GffSettings& settings)
+{
+	QFile file(filename);
+	if (!file.open(QFile::ReadOnly))
+	{
+		THROW(FileAccessException, "Could not open transcript database " + filename + " for reading: " + file.errorString());
+	}
+	GffDatabaseReader reader;
+	reader.size = file.size();
+	reader.data = file.map(0, reader.size);
+	reader.offset = GFF_DB_MAGIC.size();
+	reader.filename = filename;
+	if (reader.data==nullptr)
+	{
+		THROW(FileAccessException, "Could not memory-map transcript database " + filename + ": " + file.errorString());
+	}
+
+	//header
+	int version = reader.readInt();
+	if (version!=GFF_DB_VERSION)
+	{
+		THROW(FileParseException, "Transcript database " + filename + " has unsupported version " + QString::number(version) + ". Please re-create it!");
+	}
+	int flags = reader.readInt();
+	QString source = QString::fromUtf8(reader.readString());
+	bool include_all = flags & 1;
+	bool skip_not_hgnc = flags & 2;
+	if (source!=settings.source || include_all!=settings.include_all || skip_not_hgnc!=settings.skip_not_hgnc)
+	{
+		THROW(ArgumentException, "Transcript database " + filename + " was created with different settings (source=" + source + ", all=" + (include_all ? "yes" : "no") + ", skip_not_hgnc=" + (skip_not_hgnc ? "yes" : "no") + ")!");
+	}
+
+	//string table
+	int string_count = reader.readInt();
+	QByteArrayList strings;
+	strings.reserve(string_count);
+	for (int i=0; i<string_count; ++i)
+	{
+		strings << reader.readString();
+	}
+
+	//transcripts
+	QHash<const QByteArray*, Chromosome> chr_cache;
+	QHash<const QByteArray*, Transcript::BIOTYPE> biotype_cache;
+	int transcript_count = reader.readInt();
+	output.transcripts.reserve(transcript_count);
+	for (int i=0; i<transcript_count; ++i)
+	{
+		Transcript t;
+		t.setGene(reader.readStringIndex(strings));
+		t.setGeneId(reader.readStringIndex(strings));
+		t.setHgncId(reader.readStringIndex(strings));
+		t.setName(reader.readStringIndex(strings));
+		t.setNameCcds(reader.readStringIndex(strings));
+		const QByteArray& biotype = reader.readStringIndex(strings);
+		if (!biotype_cache.contains(&biotype)) biotype_cache.insert(&biotype, Transcript::stringToBiotype(biotype));
+		t.setBiotype(biotype_cache[&biotype]);
+		const QByteArray& chr = reader.readStringIndex(strings);
+		if (!chr_cache.contains(&chr)) chr_cache.insert(&chr, Chromosome(chr));
+		t.setVersion(reader.readInt());
+		t.setSource((Transcript::SOURCE)reader.readInt());
+		int strand = reader.readInt();
+		if (strand!=Transcript::PLUS && strand!=Transcript::MINUS) THROW(FileParseException, "Transcript database " + filename + " contains invalid strand of transcript " + t.name() + "!");
+		t.setStrand((Transcript::STRAND)strand);
+		int t_flags = reader.readInt();
+		t.setPreferredTranscript(t_flags & GFF_DB_PREFERRED);
+		t.setGencodeBasicTranscript(t_flags & GFF_DB_GENCODE_BASIC);
+		t.setEnsemblCanonicalTranscript(t_flags & GFF_DB_ENSEMBL_CANONICAL);
+		t.setManeSelectTranscript(t_flags & GFF_DB_MANE_SELECT);
+		t.setManePlusClinicalTranscript(t_flags & GFF_DB_MANE_PLUS_CLINICAL);
+		int coding_start = reader.readInt();
+		int coding_end = reader.readInt();
+		int exon_count = reader.readInt();
+		BedFile regions;
+		const Chromosome& t_chr = chr_cache[&chr];
+		for (int e=0; e<exon_count; ++e)
+		{
+			int start = reader.readInt();
+			int end = reader.readInt();
+			regions.append(BedLine(t_chr, start, end));
+		}
+		t.setRegions(regions, coding_start, coding_end);
+
+		output.transcripts << t;
+	}
+
+	//relations
+	int relation_count = reader.readInt();
+	output.enst2ensg.reserve(relation_count);
+	for (int i=0; i<relation_count; ++i)
+	{
+		const QByteArray& enst = reader.readStringIndex(strings);
+		output.enst2ensg.insert(enst, reader.readStringIndex(strings));
+	}
+	relation_count = reader.readInt();
+	output.ensg2symbol.reserve(relation_count);
+	for (int i=0; i<relation_count; ++i)
+	{
+		const QByteArray& ensg = reader.readStringIndex(strings);
+		output.ensg2symbol.insert(ensg, reader.readStringIndex(strings));
+	}
+
+	file.unmap(const_cast<uchar*>(reader.data));
+}
+
 GffData NGSHelper::loadGffFile(QString filename, GffSettings settings)
 {
+	//binary transcript database
+	if (isGffDatabase(filename))
+	{
+		GffData data;
+		loadGffDatabase(filename, data, settings);
+		if (settings.print_to_stdout)
+		{
+			QTextStream out(stdout);
+			out << "Loaded " << data.transcripts.geneCount() << " genes from transcript database" << endl;
+			out << "Loaded " << data.transcripts.count() << " transcripts from transcript database" << endl;
+		}
+		return data;
+	}
+
 	int c_skipped_special_chr = 0;
 	QSet<QByteArray> special_chrs;
 	int c_skipped_no_name_and_hgnc = 0;
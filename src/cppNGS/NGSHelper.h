@@ -117,7 +117,12 @@ public:
 	static QString populationCodeToHumanReadable(QString code);
 
 	///Returns transcripts with features from a Ensembl GFF file, transcript_gene_relation (ENST>ENSG) and gene_name_relation (ENSG>gene symbol).
+	///Binary transcript databases created with storeGffDatabase() are detected automatically. Their settings must match the given settings.
 	static GffData loadGffFile(QString filename, GffSettings settings);
+	///Stores GFF data as binary transcript database, which is loaded much faster than the GFF file. Transcripts are stored sorted by position.
+	static void storeGffDatabase(QString filename, const GffData& data, const GffSettings& settings);
+	///Returns if the file is a binary transcript database.
+	static bool isGffDatabase(QString filename);
 
 	///Returns a map with matching Ensembl, RefSeq and CCDS transcript identifiers (without version numbers).
 	static const QMap<QByteArray, QByteArrayList>& transcriptMatches(GenomeBuild build);
@@ -136,6 +141,7 @@ private:
 
 	static void loadGffEnsembl(QString filename, GffData& data, const GffSettings& settings, int& c_skipped_special_chr, QSet<QByteArray>& special_chrs, int& c_skipped_no_name_and_hgnc, int& c_skipped_low_evidence, int& c_skipped_not_hgnc);
 	static void loadGffRefseq(QString filename, GffData& data, const GffSettings& settings, int& c_skipped_special_chr, QSet<QByteArray>& special_chrs, int& c_skipped_no_name_and_hgnc, int& c_skipped_low_evidence, int& c_skipped_not_hgnc);
+	static void loadGffDatabase(QString filename, GffData& data, const GffSettings& settings);
 
 };
 
@@ -31,6 +31,17 @@ void Pileup::inc(char base)
 	else THROW(ArgumentException, "Unknown base '" + QString(QChar(base)) + "' in pileup!");
 }
 
+void Pileup::add(const Pileup& rhs)
+{
+	a_ += rhs.a_;
+	c_ += rhs.c_;
+	g_ += rhs.g_;
+	t_ += rhs.t_;
+	n_ += rhs.n_;
+	del_ += rhs.del_;
+	indels_ << rhs.indels_;
+}
+
 void Pileup::clear()
 {
 	a_ = 0;
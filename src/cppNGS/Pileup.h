@@ -75,6 +75,9 @@ public:
 		++del_;
 	}
 
+	///Adds the counts and indels of another pileup.
+	void add(const Pileup& rhs);
+
 	///Clears all counts and indels.
     void clear();
     ///Returns the overall depth of the based 'A','C','G' and 'T'. 'N' and '-' are only included on demand.
@@ -2,6 +2,237 @@
 #include "Exceptions.h"
 #include "BasicStatistics.h"
 #include "NGSHelper.h"
+#include "MultiSitePileup.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QMutex>
+#include <QtEndian>
+#include <QtAlgorithms>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+//Fingerprint file layout (little-endian):
+//  header: magic (8 bytes), version, SNP count, called SNP count, minimum coverage, maximum SNPs, flags (qint32), panel identifier (quint64), source file size, source file modification time (qint64), source file path length (qint32), reserved (qint32)
+//  source file path (UTF-8)
+//  data: bit vector of SNPs with reference allele, bit vector of SNPs with alternative allele (quint64 words)
+static const QByteArray FINGERPRINT_MAGIC = "NGSFPRNT";
+static const int FINGERPRINT_VERSION = 2;
+static const int FINGERPRINT_HEADER_SIZE = 64;
+//Number of SNPs for which pileups are calculated in one go
+static const int PILEUP_BATCH_SIZE = 1000;
+
+GenotypeFingerprint::GenotypeFingerprint()
+	: GenotypeFingerprint(0, 0)
+{
+}
+
+GenotypeFingerprint::GenotypeFingerprint(quint64 panel_id, int snp_count)
+	: panel_id_(panel_id)
+	, snp_count_(snp_count)
+	, called_count_(0)
+	, min_cov_(0)
+	, max_snps_(0)
+	, include_single_end_reads_(false)
+	, source_file_()
+	, source_size_(-1)
+	, source_modified_(-1)
+	, ref_((snp_count + 63) / 64, 0)
+	, alt_((snp_count + 63) / 64, 0)
+{
+}
+
+VcfFile GenotypeFingerprint::panel(GenomeBuild build, bool include_gonosomes, const BedFile& roi)
+{
+	VcfFile snps = roi.count()>0 ? NGSHelper::getKnownVariants(build, true, roi, 0.2, 0.8) : NGSHelper::getKnownVariants(build, true, 0.2, 0.8);
+	if (include_gonosomes) return snps;
+
+	VcfFile output;
+	output.copyMetaData(snps);
+	for (int i=0; i<snps.count(); ++i)
+	{
+		if (snps[i].chr().isAutosome()) output.append(snps[i]);
+	}
+	return output;
+}
+
+quint64 GenotypeFingerprint::panelId(const VcfFile& panel)
+{
+	//FNV-1a hash of the SNPs
+	quint64 hash = 14695981039346656037ull;
+	for (int i=0; i<panel.count(); ++i)
+	{
+		const VcfLine& snp = panel[i];
+		QByteArray text = snp.chr().strNormalized(true) + ":" + QByteArray::number(snp.start()) + " " + snp.ref() + ">" + snp.alt(0) + "\n";
+		foreach(char c, text)
+		{
+			hash ^= (uchar)c;
+			hash *= 1099511628211ull;
+		}
+	}
+	return hash;
+}
+
+GenotypeFingerprint GenotypeFingerprint::fromBam(const VcfFile& panel, quint64 panel_id, const QString& filename, int min_cov, int max_snps, const QString& ref_file, bool include_single_end_reads)
+{
+	GenotypeFingerprint output(panel_id, panel.count());
+	output.min_cov_ = min_cov;
+	output.max_snps_ = max_snps;
+	output.include_single_end_reads_ = include_single_end_reads;
+	output.setSource(filename);
+
+	//pileups are calculated in batches, so that not all SNPs are processed when the maximum number of SNPs is reached early
+	BamReader reader(filename, ref_file);
+	for(int batch_start=0; batch_start<panel.count(); batch_start+=PILEUP_BATCH_SIZE)
+	{
+		const int batch_end = std::min(batch_start + PILEUP_BATCH_SIZE, panel.count());
+		MultiSitePileup engine;
+		for(int i=batch_start; i<batch_end; ++i)
+		{
+			engine.addSite(panel[i].chr(), panel[i].start());
+		}
+		QVector<Pileup> pileups = engine.calculate(reader, -1, 1, include_single_end_reads);
+
+		for(int i=batch_start; i<batch_end; ++i)
+		{
+			const VcfLine& snp = panel[i];
+			const Pileup& pileup = pileups[i-batch_start];
+			if (pileup.depth(false)<min_cov) continue;
+
+			//skip non-informative snps
+			QChar ref = snp.ref()[0];
+			QChar obs = snp.alt(0)[0];
+			double frequency = pileup.frequency(ref, obs);
+			if (!BasicStatistics::isValidFloat(frequency)) continue;
+
+			output.setGenotype(i, genotypeFromFrequency(frequency));
+
+			if (max_snps>0 && output.calledCount()>=max_snps) return output;
+		}
+	}
+
+	return output;
+}
+
+GenotypeFingerprint::Genotype GenotypeFingerprint::genotypeFromFrequency(double frequency)
+{
+	if (frequency<0.1) return HOM_REF;
+	if (frequency>0.9) return HOM_ALT;
+	return HET;
+}
+
+void GenotypeFingerprint::load(const QString& filename)
+{
+	QFile file(filename);
+	if (!file.open(QFile::ReadOnly))
+	{
+		THROW(FileAccessException, "Could not open fingerprint file " + filename + " for reading: " + file.errorString());
+	}
+	QByteArray data = file.readAll();
+	const uchar* bytes = reinterpret_cast<const uchar*>(data.constData());
+
+	//header
+	if (data.size()<FINGERPRINT_HEADER_SIZE || !data.startsWith(FINGERPRINT_MAGIC))
+	{
+		THROW(FileParseException, "File " + filename + " is not a genotype fingerprint file!");
+	}
+	int version = qFromLittleEndian<qint32>(bytes + 8);
+	if (version!=FINGERPRINT_VERSION)
+	{
+		THROW(FileParseException, "Fingerprint file " + filename + " has unsupported version " + QString::number(version) + "!");
+	}
+	int snp_count = qFromLittleEndian<qint32>(bytes + 12);
+	int called_count = qFromLittleEndian<qint32>(bytes + 16);
+	int path_length = qFromLittleEndian<qint32>(bytes + 56);
+	int words = (snp_count + 63) / 64;
+	if (snp_count<0 || path_length<0 || data.size()!=FINGERPRINT_HEADER_SIZE + (qint64)path_length + 16ll * words)
+	{
+		THROW(FileParseException, "Fingerprint file " + filename + " is truncated!");
+	}
+	*this = GenotypeFingerprint(qFromLittleEndian<quint64>(bytes + 32), snp_count);
+	min_cov_ = qFromLittleEndian<qint32>(bytes + 20);
+	max_snps_ = qFromLittleEndian<qint32>(bytes + 24);
+	include_single_end_reads_ = qFromLittleEndian<qint32>(bytes + 28) & 1;
+	source_size_ = qFromLittleEndian<qint64>(bytes + 40);
+	source_modified_ = qFromLittleEndian<qint64>(bytes + 48);
+	source_file_ = QString::fromUtf8(data.constData() + FINGERPRINT_HEADER_SIZE, path_length);
+
+	//data
+	const uchar* ref_data = bytes + FINGERPRINT_HEADER_SIZE + path_length;
+	const uchar* alt_data = ref_data + 8 * words;
+	for (int w=0; w<words; ++w)
+	{
+		ref_[w] = qFromLittleEndian<quint64>(ref_data + 8 * w);
+		alt_[w] = qFromLittleEndian<quint64>(alt_data + 8 * w);
+		called_count_ += qPopulationCount(ref_[w] | alt_[w]);
+	}
+	if (called_count_!=called_count)
+	{
+		THROW(FileParseException, "Fingerprint file " + filename + " is corrupt: called SNP count does not match!");
+	}
+}
+
+void GenotypeFingerprint::store(const QString& filename) const
+{
+	const QByteArray path = source_file_.toUtf8();
+	QByteArray data(FINGERPRINT_HEADER_SIZE + path.size() + 16 * ref_.count(), 0);
+	uchar* bytes = reinterpret_cast<uchar*>(data.data());
+	memcpy(bytes, FINGERPRINT_MAGIC.constData(), FINGERPRINT_MAGIC.size());
+	qToLittleEndian<qint32>(FINGERPRINT_VERSION, bytes + 8);
+	qToLittleEndian<qint32>(snp_count_, bytes + 12);
+	qToLittleEndian<qint32>(called_count_, bytes + 16);
+	qToLittleEndian<qint32>(min_cov_, bytes + 20);
+	qToLittleEndian<qint32>(max_snps_, bytes + 24);
+	qToLittleEndian<qint32>(include_single_end_reads_ ? 1 : 0, bytes + 28);
+	qToLittleEndian<quint64>(panel_id_, bytes + 32);
+	qToLittleEndian<qint64>(source_size_, bytes + 40);
+	qToLittleEndian<qint64>(source_modified_, bytes + 48);
+	qToLittleEndian<qint32>(path.size(), bytes + 56);
+	memcpy(bytes + FINGERPRINT_HEADER_SIZE, path.constData(), path.size());
+	uchar* ref_data = bytes + FINGERPRINT_HEADER_SIZE + path.size();
+	uchar* alt_data = ref_data + 8 * ref_.count();
+	for (int w=0; w<ref_.count(); ++w)
+	{
+		qToLittleEndian<quint64>(ref_[w], ref_data + 8 * w);
+		qToLittleEndian<quint64>(alt_[w], alt_data + 8 * w);
+	}
+
+	//write to a temporary file that replaces the old file when complete, so that concurrent readers never see a partially written file
+	QSaveFile file(filename);
+	if (!file.open(QFile::WriteOnly) || file.write(data)!=data.size() || !file.commit())
+	{
+		THROW(FileAccessException, "Could not write fingerprint file " + filename + ": " + file.errorString());
+	}
+}
+
+void GenotypeFingerprint::setSource(const QString& filename)
+{
+	QFileInfo info(filename);
+	source_file_ = info.absoluteFilePath();
+	source_size_ = info.size();
+	source_modified_ = info.lastModified().toMSecsSinceEpoch();
+}
+
+bool GenotypeFingerprint::isFromSource(const QString& filename) const
+{
+	QFileInfo info(filename);
+	return info.exists() && source_file_==info.absoluteFilePath() && source_size_==info.size() && source_modified_==info.lastModified().toMSecsSinceEpoch();
+}
+
+void GenotypeFingerprint::setGenotype(int index, Genotype genotype)
+{
+	if (index<0 || index>=snp_count_) THROW(ArgumentException, "SNP index " + QString::number(index) + " out of range (0-" + QString::number(snp_count_-1) + ")!");
+
+	const quint64 mask = 1ull << (index & 63);
+	quint64& ref = ref_[index>>6];
+	quint64& alt = alt_[index>>6];
+	if (ref & mask || alt & mask) --called_count_;
+	ref = (genotype & HOM_REF) ? (ref | mask) : (ref & ~mask);
+	alt = (genotype & HOM_ALT) ? (alt | mask) : (alt & ~mask);
+	if (genotype!=NO_CALL) ++called_count_;
+}
 
 SampleSimilarity::VariantGenotypes SampleSimilarity::genotypesVcf(const VcfFile& variants, const QString& filename, bool include_gonosomes, bool skip_multi)
 {
@@ -78,27 +309,43 @@ SampleSimilarity::VariantGenotypes SampleSimilarity::genotypesGSvar(VariantList
 
 SampleSimilarity::VariantGenotypes SampleSimilarity::genotypesBam(const VcfFile& snps, BamReader& reader, int min_cov, int max_snps, bool include_gonosomes,  bool include_single_end_reads)
 {
-	VariantGenotypes output;
+	//determine SNPs to use
+	QVector<int> indices;
 	for(int i=0; i<snps.count(); ++i)
 	{
-		const Chromosome& chr = snps[i].chr();
-		int pos = snps[i].start();
+		if (!snps[i].chr().isAutosome() && !include_gonosomes) continue;
+		indices << i;
+	}
 
-		if (!chr.isAutosome() && !include_gonosomes) continue;
+	//pileups are calculated in batches, so that not all SNPs are processed when the maximum number of SNPs is reached early
+	VariantGenotypes output;
+	for(int batch_start=0; batch_start<indices.count(); batch_start+=PILEUP_BATCH_SIZE)
+	{
+		const int batch_end = std::min(batch_start + PILEUP_BATCH_SIZE, indices.count());
+		MultiSitePileup engine;
+		for(int b=batch_start; b<batch_end; ++b)
+		{
+			engine.addSite(snps[indices[b]].chr(), snps[indices[b]].start());
+		}
+		QVector<Pileup> pileups = engine.calculate(reader, -1, 1, include_single_end_reads);
 
-		Pileup pileup = reader.getPileup(chr, pos, -1, 1, include_single_end_reads);
-		if (pileup.depth(false)<min_cov) continue;
+		for(int b=batch_start; b<batch_end; ++b)
+		{
+			const VcfLine& snp = snps[indices[b]];
+			const Pileup& pileup = pileups[b-batch_start];
+			if (pileup.depth(false)<min_cov) continue;
 
-		QChar ref = snps[i].ref()[0];
-		QChar obs = snps[i].alt(0)[0];
-		double frequency = pileup.frequency(ref, obs);
+			QChar ref = snp.ref()[0];
+			QChar obs = snp.alt(0)[0];
+			double frequency = pileup.frequency(ref, obs);
 
-		//skip non-informative snps
-		if (!BasicStatistics::isValidFloat(frequency)) continue;
+			//skip non-informative snps
+			if (!BasicStatistics::isValidFloat(frequency)) continue;
 
-		output[strToPointer(chr.strNormalized(false) + ":" + QString::number(pos) + " " + ref + ">" + obs)] = frequency;
+			output[strToPointer(snp.chr().strNormalized(false) + ":" + QString::number(snp.start()) + " " + ref + ">" + obs)] = frequency;
 
-		if (output.count()>=max_snps) break;
+			if (output.count()>=max_snps) return output;
+		}
 	}
 
 	return output;
@@ -196,12 +443,21 @@ SampleSimilarity::VariantGenotypes SampleSimilarity::genotypesFromBam(GenomeBuil
 	return output;
 }
 
+SampleSimilarity::VariantGenotypes SampleSimilarity::genotypesFromBam(const VcfFile& snps, const QString& filename, int min_cov, int max_snps, bool include_gonosomes, const QString& ref_file, bool include_single_end_reads)
+{
+	//open BAM
+	BamReader reader(filename, ref_file);
+
+	//get VariantGenotypes
+	VariantGenotypes output = genotypesBam(snps, reader, min_cov, max_snps, include_gonosomes, include_single_end_reads);
+
+	return output;
+}
+
 void SampleSimilarity::calculateSimilarity(const VariantGenotypes& in1, const VariantGenotypes& in2)
 {
-	static QVector<double> geno1;
-	geno1.clear();
-	static QVector<double> geno2;
-	geno2.clear();
+	QVector<double> geno1;
+	QVector<double> geno2;
 	clear();
 
 	//calculate overlap / correlation
@@ -252,6 +508,87 @@ void SampleSimilarity::calculateSimilarity(const VariantGenotypes& in1, const Va
 	}
 }
 
+void SampleSimilarity::calculateSimilarity(const GenotypeFingerprint& fp1, const GenotypeFingerprint& fp2)
+{
+	clear();
+	if (fp1.panelId()!=fp2.panelId() || fp1.snpCount()!=fp2.snpCount())
+	{
+		THROW(ArgumentException, "Genotype fingerprints of different SNP panels cannot be compared!");
+	}
+
+	//count genotype combinations (genotypes as integer dosage: het=1, hom-alt=2)
+	long long c_ol = 0;
+	long long c_ibs2 = 0;
+	long long c_ibs0 = 0;
+	long long c_equal = 0;
+	long long het1 = 0;
+	long long hom_alt1 = 0;
+	long long het2 = 0;
+	long long hom_alt2 = 0;
+	long long het_het = 0;
+	long long het_hom_alt = 0;
+	long long hom_alt_hom_alt = 0;
+	const quint64* ref1 = fp1.refBits().constData();
+	const quint64* alt1 = fp1.altBits().constData();
+	const quint64* ref2 = fp2.refBits().constData();
+	const quint64* alt2 = fp2.altBits().constData();
+	const int words = fp1.refBits().count();
+	for (int w=0; w<words; ++w)
+	{
+		const quint64 both = (ref1[w] | alt1[w]) & (ref2[w] | alt2[w]);
+		const quint64 hr1 = ref1[w] & ~alt1[w] & both;
+		const quint64 ha1 = alt1[w] & ~ref1[w] & both;
+		const quint64 h1 = ref1[w] & alt1[w] & both;
+		const quint64 hr2 = ref2[w] & ~alt2[w] & both;
+		const quint64 ha2 = alt2[w] & ~ref2[w] & both;
+		const quint64 h2 = ref2[w] & alt2[w] & both;
+
+		c_ol += qPopulationCount(both);
+		c_ibs2 += qPopulationCount((hr1 & hr2) | (ha1 & ha2));
+		c_ibs0 += qPopulationCount((hr1 & ha2) | (ha1 & hr2));
+		c_equal += qPopulationCount(both & ~(ref1[w] ^ ref2[w]) & ~(alt1[w] ^ alt2[w]));
+		het1 += qPopulationCount(h1);
+		hom_alt1 += qPopulationCount(ha1);
+		het2 += qPopulationCount(h2);
+		hom_alt2 += qPopulationCount(ha2);
+		het_het += qPopulationCount(h1 & h2);
+		het_hom_alt += qPopulationCount((h1 & ha2) | (ha1 & h2));
+		hom_alt_hom_alt += qPopulationCount(ha1 & ha2);
+	}
+
+	//abort if no overlap
+	if (c_ol==0)
+	{
+		messages_.append("Zero overlap between variant lists!");
+		return;
+	}
+
+	//count overall number of variants
+	no_variants1_ = fp1.calledCount();
+	no_variants2_ = fp2.calledCount();
+	int min_count = std::min(no_variants1_, no_variants2_);
+	ol_perc_ = 100.0 * c_ol / min_count;
+	ol_count_ = c_ol;
+	ibs2_perc_ = 100.0 * c_ibs2 / min_count;
+	ibs0_perc_ = 100.0 * c_ibs0 / min_count;
+
+	//correlation from sums of the dosages
+	const double n = c_ol;
+	const double sum1 = het1 + 2.0 * hom_alt1;
+	const double sum2 = het2 + 2.0 * hom_alt2;
+	const double sum_sq1 = het1 + 4.0 * hom_alt1;
+	const double sum_sq2 = het2 + 4.0 * hom_alt2;
+	const double sum_prod = het_het + 2.0 * het_hom_alt + 4.0 * hom_alt_hom_alt;
+	sample_correlation_ = (n * sum_prod - sum1 * sum2) / std::sqrt((n * sum_sq1 - sum1 * sum1) * (n * sum_sq2 - sum2 * sum2));
+
+	//calulate percentage with same genotype if correlation is not calculatable
+	if (!BasicStatistics::isValidFloat(sample_correlation_))
+	{
+		sample_correlation_ = c_equal / n;
+		messages_.append("Could not calulate genotype correlation, calculated the fraction of matching genotypes instead.");
+	}
+}
+
 void SampleSimilarity::clear()
 {
 	no_variants1_ = 0;
@@ -281,6 +618,8 @@ float SampleSimilarity::genoToDouble(const QString& geno)
 const QChar* SampleSimilarity::strToPointer(const QString& str)
 {
 	static QSet<QString> uniq;
+	static QMutex mutex;
+	QMutexLocker locker(&mutex);
 
 	auto it = uniq.find(str);
 	if (it==uniq.cend())
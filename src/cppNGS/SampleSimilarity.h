@@ -6,6 +6,115 @@
 #include "Statistics.h"
 #include <QStringList>
 #include <QHash>
+#include <QVector>
+
+//Genotype fingerprint of a sample for a fixed SNP panel with 2 bits per SNP.
+//The genotypes are stored in two bit vectors (reference allele observed, alternative allele observed), which allows comparing two fingerprints with bit operations and popcount only.
+class CPPNGSSHARED_EXPORT GenotypeFingerprint
+{
+public:
+	//Genotype (bit 0: reference allele observed, bit 1: alternative allele observed)
+	enum Genotype
+	{
+		NO_CALL = 0,
+		HOM_REF = 1,
+		HOM_ALT = 2,
+		HET = 3
+	};
+
+	//Default constructor (empty panel).
+	GenotypeFingerprint();
+	//Constructor for a SNP panel (all SNPs not called).
+	GenotypeFingerprint(quint64 panel_id, int snp_count);
+
+	//Returns the SNP panel for fingerprints, i.e. known SNPs with AF 20-80%.
+	static VcfFile panel(GenomeBuild build, bool include_gonosomes, const BedFile& roi = BedFile());
+	//Returns the identifier of a SNP panel (hash of the SNP positions and alleles). Only fingerprints of the same panel can be compared.
+	static quint64 panelId(const VcfFile& panel);
+	//Determines the genotypes from BAM/CRAM. SNPs with a depth below 'min_cov' are not called. Genotyping stops after 'max_snps' called SNPs (0 means unlimited).
+	static GenotypeFingerprint fromBam(const VcfFile& panel, quint64 panel_id, const QString& filename, int min_cov, int max_snps, const QString& ref_file = QString(), bool include_single_end_reads=false);
+	//Converts an allele frequency to a genotype (same thresholds as for IBS0/IBS2).
+	static Genotype genotypeFromFrequency(double frequency);
+
+	//Loads a fingerprint file.
+	void load(const QString& filename);
+	//Stores a fingerprint file.
+	void store(const QString& filename) const;
+
+	//Sets the file the genotypes were determined from (absolute path, size and modification time are stored).
+	void setSource(const QString& filename);
+	//Returns the absolute path of the file the genotypes were determined from (empty if unknown).
+	const QString& sourceFile() const
+	{
+		return source_file_;
+	}
+	//Returns if the genotypes were determined from the given file and the file was not modified since then (path, size and modification time are compared).
+	bool isFromSource(const QString& filename) const;
+
+	//Returns the SNP panel identifier.
+	quint64 panelId() const
+	{
+		return panel_id_;
+	}
+	//Returns the number of SNPs of the panel.
+	int snpCount() const
+	{
+		return snp_count_;
+	}
+	//Returns the number of called SNPs.
+	int calledCount() const
+	{
+		return called_count_;
+	}
+	//Returns the minimum coverage used for genotyping.
+	int minCov() const
+	{
+		return min_cov_;
+	}
+	//Returns the maximum number of called SNPs used for genotyping.
+	int maxSnps() const
+	{
+		return max_snps_;
+	}
+	//Returns if reads which are not (properly) paired were used for genotyping.
+	bool includeSingleEndReads() const
+	{
+		return include_single_end_reads_;
+	}
+
+	//Returns the genotype of a SNP.
+	Genotype genotype(int index) const
+	{
+		const quint64 mask = 1ull << (index & 63);
+		return (Genotype)(((ref_[index>>6] & mask) ? 1 : 0) | ((alt_[index>>6] & mask) ? 2 : 0));
+	}
+	//Sets the genotype of a SNP.
+	void setGenotype(int index, Genotype genotype);
+
+	//Returns the bit vector of SNPs with observed reference allele (64 SNPs per word).
+	const QVector<quint64>& refBits() const
+	{
+		return ref_;
+	}
+	//Returns the bit vector of SNPs with observed alternative allele (64 SNPs per word).
+	const QVector<quint64>& altBits() const
+	{
+		return alt_;
+	}
+
+private:
+	quint64 panel_id_;
+	int snp_count_;
+	int called_count_;
+	int min_cov_;
+	int max_snps_;
+	bool include_single_end_reads_;
+	QString source_file_;
+	qint64 source_size_;
+	qint64 source_modified_; //milliseconds since epoch
+	QVector<quint64> ref_;
+	QVector<quint64> alt_;
+};
 
 // Sample similarity calculator
 class CPPNGSSHARED_EXPORT SampleSimilarity
@@ -26,9 +135,13 @@ public:
 	//Extract genotypes from BAM
 	static VariantGenotypes genotypesFromBam(GenomeBuild build, const QString& filename, int min_cov, int max_snps, bool include_gonosomes, const BedFile& roi, const QString& ref_file = QString(), bool include_single_end_reads=false);
 	static VariantGenotypes genotypesFromBam(GenomeBuild build, const QString& filename, int min_cov, int max_snps, bool include_gonosomes, const QString& ref_file = QString(), bool include_single_end_reads=false);
+	//Extract genotypes from BAM using a pre-loaded SNP list, e.g. from NGSHelper::getKnownVariants (thread-safe).
+	static VariantGenotypes genotypesFromBam(const VcfFile& snps, const QString& filename, int min_cov, int max_snps, bool include_gonosomes, const QString& ref_file = QString(), bool include_single_end_reads=false);
 
 	//Calculation of similarity
 	void calculateSimilarity(const VariantGenotypes& in1, const VariantGenotypes& in2);
+	//Calculation of similarity from genotype fingerprints of the same SNP panel. The correlation is calculated from the genotypes (0, 0.5, 1) instead of the allele frequencies.
+	void calculateSimilarity(const GenotypeFingerprint& fp1, const GenotypeFingerprint& fp2);
 
 	// Number of variants in first sample
 	int noVariants1()
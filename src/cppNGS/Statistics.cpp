@@ -20,78 +20,11 @@
 #include "Histogram.h"
 #include "FilterCascade.h"
 #include "ToolBase.h"
-
-class RegionDepth
-{
-public:
-	RegionDepth(Chromosome chr, int start, int end):
-	  chr_(chr)
-	, start_(start)
-	, end_(end)
-	{
-		depth_ = QVector<int>(end_-start_+1);
-		depth_.fill(0);
-	}
-
-	//for QContainers
-	RegionDepth()
-	{
-		chr_ = Chromosome();
-		start_ = -1;
-		end_ = -1;
-		depth_ = QVector<int>();
-	}
-
-	void incrementRegion(int start, int end)
-	{
-		int idx_start = std::max(start, start_) - start_;
-		int idx_end = std::min(end, end_) - start_;
-		for (int i=idx_start; i<=idx_end; ++i)
-		{
-			depth_[i] += 1;
-		}
-	}
-
-	//read access
-	int operator[](int pos) const
-	{
-		if (pos < start_ || end_ < pos)
-		{
-			THROW(ArgumentException, "Access outside of valid region. Position " + QString::number(pos) + " not in region: " + QString::number(start_) + "-"  + QString::number(end_) + ".");
-		}
-
-		return depth_[pos-start_];
-	}
-
-	//Interface for ChromosomalIndex
-	const Chromosome& chr() const
-	{
-		return chr_;
-	}
-
-	int start() const
-	{
-		return start_;
-	}
-
-	int end() const
-	{
-		return end_;
-	}
-
-	int count() const
-	{
-		return end_-start_+1;
-	}
-
-private:
-	Chromosome chr_;
-	int start_;
-	int end_;
-	QVector<int> depth_;
-};
-
-
+#include "WorkerMappingQC.h"
+#include "BedFileSweepCursor.h"
+#include "CoverageCache.h"
+#include "MultiRegionCoverage.h"
+#include "MultiSitePileup.h"
 
 QCCollection Statistics::variantList(const VcfFile& variants, bool filter)
 {
@@ -322,14 +255,13 @@ QCCollection Statistics::phasing(const VcfFile& variants, bool filter, BedFile&
 	return output;
 }
 
-QCCollection Statistics::mapping(const BedFile& bed_file, const QString& bam_file, const QString& ref_file, int min_mapq, bool is_cfdna)
+QCCollection Statistics::mapping(const BedFile& bed_file, const QString& bam_file, const QString& ref_file, int min_mapq, bool is_cfdna, int threads)
 {
-	//check target region is merged/sorted and create index
+	//check target region is merged/sorted
 	if (!bed_file.isMergedAndSorted())
 	{
 		THROW(ArgumentException, "Merged and sorted BED file required for coverage details statistics!");
 	}
-	ChromosomalIndex<BedFile> roi_index(bed_file);
 
 	//create coverage statistics data structure
 	long long roi_bases = 0;
@@ -348,13 +280,11 @@ QCCollection Statistics::mapping(const BedFile& bed_file, const QString& bam_fil
 	dropout.add(bed_file);
 	dropout.chunk(100);
 	QHash<int, double> gc_roi;
-	QHash<int, double> gc_reads;
 	QHash<int, int> gc_index_to_bin_map;
+	QList<Sequence> dropout_seqs = ref_idx.seqs(dropout);
 	for (int i=0; i<dropout.count(); ++i)
 	{
-		BedLine& line = dropout[i];
-		Sequence seq = ref_idx.seq(line.chr(), line.start(), line.length());
-		double gc_content = seq.gcContent();
+		double gc_content = dropout_seqs[i].gcContent();
 		if (!BasicStatistics::isValidFloat(gc_content))
 		{
 			gc_index_to_bin_map[i] = -1;
@@ -366,141 +296,56 @@ QCCollection Statistics::mapping(const BedFile& bed_file, const QString& bam_fil
 			gc_roi[bin] += 1.0;
 		}
 	}
-	ChromosomalIndex<BedFile> dropout_index(dropout);
+
+	//iterate through all alignments (shards contain whole chromosomes, so that each target region is processed by one shard only)
+	WorkerMappingQC::Data data;
+	data.mode = WorkerMappingQC::TARGET;
+	data.bam_file = bam_file;
+	data.ref_file = ref_file;
+	data.min_mapq = min_mapq;
+	data.roi = &bed_file;
+	data.roi_cursor = BedFileSweepCursor(bed_file);
+	data.dropout_cursor = BedFileSweepCursor(dropout);
+	data.gc_index_to_bin_map = &gc_index_to_bin_map;
+	data.roi_cov = roi_cov.data();
+	QList<WorkerMappingQC::Shard> shards;
+	if (threads>1)
+	{
+		shards = WorkerMappingQC::createShards(bam_file, ref_file, 20000000, false);
+	}
+	else
+	{
+		shards << WorkerMappingQC::Shard();
+	}
+	WorkerMappingQC::Shard counts = WorkerMappingQC::runShards(shards, data, threads);
 
 	//init counts
-	int al_total = 0;
-	int al_mapped = 0;
-	int al_ontarget = 0;
-	int al_neartarget = 0;
-	int al_ontarget_raw = 0;
-	int al_dup = 0;
-	int al_proper_paired = 0;
-	double bases_trimmed = 0;
-	double bases_mapped = 0;
-	double bases_clipped = 0;
-	double insert_size_sum = 0;
+	long long al_total = counts.al_total;
+	long long al_mapped = counts.al_mapped;
+	long long al_ontarget = counts.al_ontarget;
+	long long al_neartarget = counts.al_neartarget;
+	long long al_proper_paired = counts.al_proper_paired;
+	long long al_dup = counts.al_dup;
+	double bases_trimmed = counts.basesTrimmed();
+	double bases_mapped = counts.bases_mapped;
+	double bases_clipped = counts.bases_clipped;
+	double insert_size_sum = counts.insert_size_sum;
 	Histogram insert_dist(0, 999, 5);
-	long long bases_usable = 0;
-	QVector<long long> bases_usable_dp(5); //usable bases by duplication level
-	long long bases_usable_raw = 0; //usable bases in BAM before deduplication
-	bases_usable_dp.fill(0);
+	for (int i=0; i<counts.insert_size_counts.count(); ++i)
+	{
+		for (long long c=0; c<counts.insert_size_counts[i]; ++c) insert_dist.inc(i, true);
+	}
+	long long bases_usable = counts.bases_usable;
+	const QVector<long long>& bases_usable_dp = counts.bases_usable_dp; //usable bases by duplication level
+	long long bases_usable_raw = counts.bases_usable_raw; //usable bases in BAM before deduplication
 	Histogram dp_dist(0.5, 4.5, 1);
-	int max_length = 0;
-	bool paired_end = false;
-
-	//iterate through all alignments
-	BamReader reader(bam_file, ref_file);
-	BamAlignment al;
-	while (reader.getNextAlignment(al))
+	for (int i=1; i<counts.dp_counts.count(); ++i)
 	{
-		//skip secondary alignments
-		if (al.isSecondaryAlignment() || al.isSupplementaryAlignment()) continue;
-
-		++al_total;
-		max_length = std::max(max_length, al.length());
-
-		//track if spliced alignment
-		bool spliced_alignment = false;
-
-		if (!al.isUnmapped())
-		{
-			++al_mapped;
-
-			//calculate soft/hard-clipped bases
-			const int start_pos = al.start();
-			const int end_pos = al.end();
-			bases_mapped += al.length();
-			const QList<CigarOp> cigar_data = al.cigarData();
-			foreach(const CigarOp& op, cigar_data)
-			{
-				if (op.Type==BAM_CSOFT_CLIP || op.Type==BAM_CHARD_CLIP)
-				{
-					bases_clipped += op.Length;
-				}
-				else if (op.Type==BAM_CREF_SKIP)
-				{
-					spliced_alignment = true;
-				}
-			}
-
-			//calculate usable bases, base-resolution coverage and GC statistics
-			const Chromosome& chr = reader.chromosome(al.chromosomeID());
-			QVector<int> indices = roi_index.matchingIndices(chr, start_pos-250, end_pos+250);
-			if (indices.count()!=0)
-			{
-				++al_neartarget;
-
-				//check if on target
-				indices = roi_index.matchingIndices(chr, start_pos, end_pos);
-				if (indices.count()!=0)
-				{
-					++al_ontarget;
-					int dp = al.tagi("DP");
-					if (dp != 0)
-					{
-						dp_dist.inc(std::min(dp, 4), true);
-						al_ontarget_raw += dp;
-					}
-
-					//calculate usable bases and base-resolution coverage on target region
-					if (!al.isDuplicate() && al.mappingQuality()>=min_mapq)
-					{
-						foreach(int index, indices)
-						{
-							const int ol_start = std::max(bed_file[index].start(), start_pos);
-							const int ol_end = std::min(bed_file[index].end(), end_pos);
-							bases_usable += ol_end - ol_start + 1;
-							bases_usable_dp[std::min(dp, 4)] += ol_end - ol_start + 1;
-							bases_usable_raw += (ol_end - ol_start + 1)  * (dp + 1);
-							roi_cov[index].incrementRegion(ol_start, ol_end);
-						}
-					}
-
-					//calculate GC statistics
-					indices = dropout_index.matchingIndices(chr, start_pos, end_pos);
-					foreach(int index, indices)
-					{
-						int bin = gc_index_to_bin_map[index];
-						if (bin>=0)
-						{
-							gc_reads[bin] += 1.0/indices.count();
-						}
-					}
-				}
-			}
-		}
-
-		//insert size
-		if (al.isPaired())
-		{
-			paired_end = true;
-
-			if (al.isProperPair())
-			{
-				++al_proper_paired;
-
-				//if alignment is spliced, exclude it from insert size calculation
-				if (!spliced_alignment)
-				{
-					int insert_size = std::min(abs(al.insertSize()), 999); //cap insert size at 1000
-					insert_size_sum += insert_size;
-					insert_dist.inc(insert_size, true);
-				}
-			}
-		}
-
-		//trimmed bases (this is not entirely correct if the first alignments are all trimmed, but saves the second pass through the data)
-		if (al.length()<max_length)
-		{
-			bases_trimmed += (max_length - al.length());
-		}
-
-		if (al.isDuplicate())
-		{
-			++al_dup;
-		}
+		for (long long c=0; c<counts.dp_counts[i]; ++c) dp_dist.inc(i, true);
 	}
+	int max_length = counts.max_length;
+	bool paired_end = counts.paired_end;
+	QHash<int, double> gc_reads = counts.gcReads();
 
 	//calculate AT/GC dropout
 	QList<double> values = gc_roi.values();
@@ -720,6 +565,7 @@ QCCollection Statistics::mapping(const BedFile& bed_file, const QString& bam_fil
 	QFile::remove(plotname);
 
 	//add YX read ratio
+	BamReader reader(bam_file, ref_file);
 	double yx_ratio = yxRatio(reader);
 	if (!std::isnan(yx_ratio))
 	{
@@ -729,99 +575,46 @@ QCCollection Statistics::mapping(const BedFile& bed_file, const QString& bam_fil
 	return output;
 }
 
-QCCollection Statistics::mapping(const QString &bam_file, int min_mapq, const QString& ref_file)
+QCCollection Statistics::mapping(const QString &bam_file, int min_mapq, const QString& ref_file, int threads)
 {
 	//open BAM file
 	BamReader reader(bam_file, ref_file);
 
-	//init counts
-	long long al_total = 0;
-	long long al_mapped = 0;
-	long long al_ontarget = 0;
-	long long al_dup = 0;
-	long long al_proper_paired = 0;
-	double bases_trimmed = 0;
-	double bases_mapped = 0;
-	double bases_clipped = 0;
-	double insert_size_sum = 0;
-	Histogram insert_dist(0, 999, 5);
-	long long bases_usable = 0;
-	int max_length = 0;
-	bool paired_end = false;
-
 	//iterate through all alignments
-	BamAlignment al;
-	while (reader.getNextAlignment(al))
+	WorkerMappingQC::Data data;
+	data.mode = WorkerMappingQC::GENOME;
+	data.bam_file = bam_file;
+	data.ref_file = ref_file;
+	data.min_mapq = min_mapq;
+	QList<WorkerMappingQC::Shard> shards;
+	if (threads>1)
 	{
-		//skip secondary alignments
-		if (al.isSecondaryAlignment() || al.isSupplementaryAlignment()) continue;
-
-		++al_total;
-		max_length = std::max(max_length, al.length());
-
-		//track if spliced alignment
-		bool spliced_alignment = false;
-
-		if (!al.isUnmapped())
-		{
-			++al_mapped;
-
-			//calculate soft/hard-clipped bases
-			bases_mapped += al.length();
-			const QList<CigarOp> cigar_data = al.cigarData();
-			foreach(const CigarOp& op, cigar_data)
-			{
-				if (op.Type==BAM_CSOFT_CLIP || op.Type==BAM_CHARD_CLIP)
-				{
-					bases_clipped += op.Length;
-				}
-				else if (op.Type==BAM_CREF_SKIP)
-				{
-					spliced_alignment = true;
-				}
-			}
-
-			//usable
-			if (reader.chromosome(al.chromosomeID()).isNonSpecial())
-			{
-				++al_ontarget;
-
-				if (!al.isDuplicate() && al.mappingQuality()>=min_mapq)
-				{
-					bases_usable += al.length();
-				}
-			}
-		}
-
-		//insert size
-		if (al.isPaired())
-		{
-			paired_end = true;
-
-			if (al.isProperPair())
-			{
-				++al_proper_paired;
-				//if alignment is spliced, exclude it from insert size calculation
-				if (!spliced_alignment)
-				{
-					const int insert_size = std::min(abs(al.insertSize()),  999); //cap insert size at 1000
-					insert_size_sum += insert_size;
-					insert_dist.inc(insert_size, true);
-				}
-			}
-		}
-
-		//trimmed bases (this is not entirely correct if the first alignments are all trimmed, but saves the second pass through the data)
-		if (al.length()<max_length)
-		{
-			bases_trimmed += (max_length - al.length());
-		}
+		shards = WorkerMappingQC::createShards(bam_file, ref_file, 20000000, true);
+	}
+	else
+	{
+		shards << WorkerMappingQC::Shard();
+	}
+	WorkerMappingQC::Shard counts = WorkerMappingQC::runShards(shards, data, threads);
 
-		if (al.isDuplicate())
-		{
-			++al_dup;
-		}
+	//init counts
+	long long al_total = counts.al_total;
+	long long al_mapped = counts.al_mapped;
+	long long al_ontarget = counts.al_ontarget;
+	long long al_dup = counts.al_dup;
+	long long al_proper_paired = counts.al_proper_paired;
+	double bases_trimmed = counts.basesTrimmed();
+	double bases_mapped = counts.bases_mapped;
+	double bases_clipped = counts.bases_clipped;
+	double insert_size_sum = counts.insert_size_sum;
+	Histogram insert_dist(0, 999, 5);
+	for (int i=0; i<counts.insert_size_counts.count(); ++i)
+	{
+		for (long long c=0; c<counts.insert_size_counts[i]; ++c) insert_dist.inc(i, true);
 	}
+	long long bases_usable = counts.bases_usable;
+	int max_length = counts.max_length;
+	bool paired_end = counts.paired_end;
 
 	//output
 	QCCollection output;
@@ -882,7 +675,7 @@ QCCollection Statistics::mapping(const QString &bam_file, int min_mapq, const QS
 	return output;
 }
 
-QCCollection Statistics::mapping_wgs(const QString &bam_file, const QString& bedpath, int min_mapq, const QString& ref_file)
+QCCollection Statistics::mapping_wgs(const QString &bam_file, const QString& bedpath, int min_mapq, const QString& ref_file, int threads)
 {
 	//open BAM file
 	BamReader reader(bam_file, ref_file);
@@ -918,13 +711,11 @@ QCCollection Statistics::mapping_wgs(const QString &bam_file, const QString& bed
 	dropout.add(roi);
 	dropout.chunk(100);
 	QHash<int, double> gc_roi;
-	QHash<int, double> gc_reads;
 	QHash<int, int> gc_index_to_bin_map;
+	QList<Sequence> dropout_seqs = ref_idx.seqs(dropout);
 	for (int i=0; i<dropout.count(); ++i)
 	{
-		BedLine& line = dropout[i];
-		Sequence seq = ref_idx.seq(line.chr(), line.start(), line.length());
-		double gc_content = seq.gcContent();
+		double gc_content = dropout_seqs[i].gcContent();
 		if (!BasicStatistics::isValidFloat(gc_content))
 		{
 			gc_index_to_bin_map[i] = -1;
@@ -936,128 +727,62 @@ QCCollection Statistics::mapping_wgs(const QString &bam_file, const QString& bed
 			gc_roi[bin] += 1.0;
 		}
 	}
-	ChromosomalIndex<BedFile> dropout_index(dropout);
-
-	//init counts
-	long long al_total = 0;
-	long long al_mapped = 0;
-	long long al_ontarget = 0;
-	long long al_dup = 0;
-	long long al_proper_paired = 0;
-	double bases_trimmed = 0;
-	double bases_mapped = 0;
-	double bases_clipped = 0;
-	double insert_size_sum = 0;
-	Histogram insert_dist(0, 999, 5);
-	long long bases_usable = 0;
-	long long bases_usable_roi = 0;
-
-	int max_length = 0;
-	bool paired_end = false;
 
 	//iterate through all alignments
-	BamAlignment al;
-	while (reader.getNextAlignment(al))
+	WorkerMappingQC::Data data;
+	data.mode = WorkerMappingQC::GENOME;
+	data.bam_file = bam_file;
+	data.ref_file = ref_file;
+	data.min_mapq = min_mapq;
+	QList<WorkerMappingQC::Shard> shards;
+	if (threads>1)
 	{
-		//skip secondary alignments
-		if (al.isSecondaryAlignment() || al.isSupplementaryAlignment()) continue;
-
-		++al_total;
-		max_length = std::max(max_length, al.length());
-
-		//track if spliced alignment
-		bool spliced_alignment = false;
-
-		if (!al.isUnmapped())
-		{
-			++al_mapped;
-
-			//calculate soft/hard-clipped bases
-			bases_mapped += al.length();
-			const QList<CigarOp> cigar_data = al.cigarData();
-			foreach(const CigarOp& op, cigar_data)
-			{
-				if (op.Type==BAM_CSOFT_CLIP || op.Type==BAM_CHARD_CLIP)
-				{
-					bases_clipped += op.Length;
-				}
-				else if (op.Type==BAM_CREF_SKIP)
-				{
-					spliced_alignment = true;
-				}
-			}
-
-			//usable
-			Chromosome chr = reader.chromosome(al.chromosomeID());
-			if (chr.isNonSpecial())
-			{
-				++al_ontarget;
-				if (!al.isDuplicate() && al.mappingQuality()>=min_mapq)
-				{
-					bases_usable += al.length();
-				}
-			}
-		}
-
-		//insert size
-		if (al.isPaired())
-		{
-			paired_end = true;
-
-			if (al.isProperPair())
-			{
-				++al_proper_paired;
-				//if alignment is spliced, exclude it from insert size calculation
-				if (!spliced_alignment)
-				{
-					const int insert_size = std::min(abs(al.insertSize()),  999); //cap insert size at 1000
-					insert_size_sum += insert_size;
-					insert_dist.inc(insert_size, true);
-				}
-			}
-		}
-
-		//trimmed bases (this is not entirely correct if the first alignments are all trimmed, but saves the second pass through the data)
-		if (al.length()<max_length)
-		{
-			bases_trimmed += (max_length - al.length());
-		}
-
-		if (al.isDuplicate())
-		{
-			++al_dup;
-		}
+		shards = WorkerMappingQC::createShards(bam_file, ref_file, 20000000, true);
 	}
-
-	for (int i=0; i<roi.count(); ++i)
+	else
 	{
-		reader.setRegion(roi[i].chr(), roi[i].start(), roi[i].end());
-
-		BamAlignment al;
-		while (reader.getNextAlignment(al))
-		{
-			//skip secondary alignments
-			if (al.isSecondaryAlignment() || al.isSupplementaryAlignment() || al.isUnmapped()) continue;
+		shards << WorkerMappingQC::Shard();
+	}
+	WorkerMappingQC::Shard counts = WorkerMappingQC::runShards(shards, data, threads);
 
-			//calculate GC statistics
-			QVector<int> indices = dropout_index.matchingIndices(reader.chromosome(al.chromosomeID()), al.start(), al.end());
-			foreach(int index, indices)
-			{
-				int bin = gc_index_to_bin_map[index];
-				if (bin>=0)
-				{
-					gc_reads[bin] += 1.0/indices.count();
-				}
-			}
+	//process target region alignments (by random access, in shards of target regions)
+	WorkerMappingQC::Data roi_data = data;
+	roi_data.mode = WorkerMappingQC::TARGET_REGIONS;
+	roi_data.roi = &roi;
+	roi_data.dropout_cursor = BedFileSweepCursor(dropout);
+	roi_data.gc_index_to_bin_map = &gc_index_to_bin_map;
+	roi_data.roi_cov = roi_cov.data();
+	QList<WorkerMappingQC::Shard> roi_shards;
+	const int roi_shard_size = threads>1 ? 200 : std::max(1, roi.count());
+	for (int start=0; start<roi.count(); start+=roi_shard_size)
+	{
+		WorkerMappingQC::Shard shard;
+		shard.roi_start = start;
+		shard.roi_end = std::min(start+roi_shard_size, roi.count()) - 1;
+		roi_shards << shard;
+	}
+	WorkerMappingQC::Shard roi_counts = WorkerMappingQC::runShards(roi_shards, roi_data, threads);
 
-			if (!al.isDuplicate() && al.mappingQuality()>=min_mapq)
-			{
-				//calculate usable bases and base-resolution coverage on target region
-				bases_usable_roi += al.length();
-				roi_cov[i].incrementRegion(al.start(), al.end());
-			}
-		}
+	//init counts
+	long long al_total = counts.al_total;
+	long long al_mapped = counts.al_mapped;
+	long long al_ontarget = counts.al_ontarget;
+	long long al_dup = counts.al_dup;
+	long long al_proper_paired = counts.al_proper_paired;
+	double bases_trimmed = counts.basesTrimmed();
+	double bases_mapped = counts.bases_mapped;
+	double bases_clipped = counts.bases_clipped;
+	double insert_size_sum = counts.insert_size_sum;
+	Histogram insert_dist(0, 999, 5);
+	for (int i=0; i<counts.insert_size_counts.count(); ++i)
+	{
+		for (long long c=0; c<counts.insert_size_counts[i]; ++c) insert_dist.inc(i, true);
 	}
+	long long bases_usable = counts.bases_usable;
+	long long bases_usable_roi = roi_counts.bases_usable;
+	int max_length = counts.max_length;
+	bool paired_end = counts.paired_end;
+	QHash<int, double> gc_reads = roi_counts.gcReads();
 
 	//calculate coverage depth statistics
 	double avg_depth = (double) bases_usable_roi / roi.baseCount();
@@ -1431,12 +1156,14 @@ QCValue Statistics::mutationBurdenNormalized(QString somatic_vcf, QString exons,
 
 QCCollection Statistics::somaticCustomDepth(const BedFile& bed_file, QString bam_file, QString ref_file, int min_mapq)
 {
-	//check target region is merged/sorted and create index
+	//check target region is merged/sorted and create overlap cursors
 	if (!bed_file.isMergedAndSorted())
 	{
 		THROW(ArgumentException, "Merged and sorted BED file required for depth details statistics!");
 	}
-	ChromosomalIndex<BedFile> roi_index(bed_file);
+	BedFileSweepCursor roi_near_cursor(bed_file);
+	BedFileSweepCursor roi_cursor(bed_file);
+	QVector<int> indices;
 
 	//create coverage statistics data structure
 	long long roi_bases = 0;
@@ -1482,12 +1209,10 @@ QCCollection Statistics::somaticCustomDepth(const BedFile& bed_file, QString bam
 
 			//calculate usable bases, base-resolution coverage and GC statistics
 			const Chromosome& chr = reader.chromosome(al.chromosomeID());
-			QVector<int> indices = roi_index.matchingIndices(chr, start_pos-250, end_pos+250);
-			if (indices.count()!=0)
+			if (roi_near_cursor.overlaps(chr, start_pos-250, end_pos+250))
 			{
 				//check if on target
-				indices = roi_index.matchingIndices(chr, start_pos, end_pos);
-				if (indices.count()!=0)
+				if (roi_cursor.matchingIndices(chr, start_pos, end_pos, indices)!=0)
 				{
 					int dp = al.tagi("DP");
 					if (dp != 0)
@@ -1689,6 +1414,8 @@ QCCollection Statistics::somatic(GenomeBuild build, QString& tumor_bam, QString&
 	QVector<double> freqs;
 	BamReader reader_tumor(tumor_bam, ref_fasta);
 	BamReader reader_normal(normal_bam, ref_fasta);
+	QVector<int> indices;
+	MultiSitePileup engine_tu;
 	for (int i=0; i<variants.count(); ++i)
 	{
 		const  VcfLine& v = variants[i];
@@ -1697,11 +1424,31 @@ QCCollection Statistics::somatic(GenomeBuild build, QString& tumor_bam, QString&
 		if (!v.chr().isAutosome()) continue;
 		if(!variants[i].filtersPassed()) continue;	//skip non-somatic variants
 
-		Pileup pileup_tu = reader_tumor.getPileup(v.chr(), v.start());
-		if (pileup_tu.depth(true) < min_depth) continue;
-		Pileup pileup_no = reader_normal.getPileup(v.chr(), v.start());
+		indices << i;
+		engine_tu.addSite(v.chr(), v.start());
+	}
+	QVector<Pileup> pileups_tu = engine_tu.calculate(reader_tumor);
+
+	//normal pileups are only needed for variants with sufficient tumor depth
+	QVector<int> indices_no;
+	MultiSitePileup engine_no;
+	for (int j=0; j<indices.count(); ++j)
+	{
+		if (pileups_tu[j].depth(true) < min_depth) continue;
+
+		const  VcfLine& v = variants[indices[j]];
+		indices_no << j;
+		engine_no.addSite(v.chr(), v.start());
+	}
+	QVector<Pileup> pileups_no = engine_no.calculate(reader_normal);
+
+	for (int k=0; k<indices_no.count(); ++k)
+	{
+		const Pileup& pileup_tu = pileups_tu[indices_no[k]];
+		const Pileup& pileup_no = pileups_no[k];
 		if (pileup_no.depth(true) < min_depth) continue;
 
+		const  VcfLine& v = variants[indices[indices_no[k]]];
 		double no_freq = pileup_no.frequency(v.ref()[0], v.alt(0)[0]);
 		if (!BasicStatistics::isValidFloat(no_freq) || no_freq >= 0.01) continue;
 
@@ -2206,9 +1953,15 @@ QCCollection Statistics::contamination(GenomeBuild build, QString bam, const QSt
 	int passed = 0;
 	double passed_depth_sum = 0.0;
 	VcfFile snps = NGSHelper::getKnownVariants(build, true, 0.2, 0.8);
+	MultiSitePileup engine;
 	for(int i=0; i<snps.count(); ++i)
 	{
-		Pileup pileup = reader.getPileup(snps[i].chr(), snps[i].start(), -1, 1, longread);
+		engine.addSite(snps[i].chr(), snps[i].start());
+	}
+	QVector<Pileup> pileups = engine.calculate(reader, -1, 1, longread);
+	for(int i=0; i<snps.count(); ++i)
+	{
+		const Pileup& pileup = pileups[i];
 		int depth = pileup.depth(false);
 		if (depth<min_cov) continue;
 
@@ -2394,76 +2147,111 @@ BedFile Statistics::lowOrHighCoverage(const BedFile& bed_file, const QString& ba
 	//check BED is sorted for WGS mode
 	if (!random_access && !bed_file.isSorted()) THROW(ArgumentException, "Input BED file has to be sorted for sweep algorithm!");
 
-	//create analysis chunks (200 lines)
-	QTime timer;
-	timer.start();
-	QList<WorkerLowOrHighCoverage::Chunk> bed_chunks;
-	if (!random_access)
+	//use coverage cache if it contains all regions
+	QSharedPointer<CoverageCache> cache = CoverageCache::openIfValid(bam_file, min_mapq, min_baseq);
+	if (!cache.isNull() && cache->contains(bed_file))
 	{
-		//determine chr chunks
-		QList<QPair<long, WorkerLowOrHighCoverage::Chunk>> chunks_with_size;
-		foreach(const Chromosome& chr, bed_file.chromosomes())
+		if (debug) QTextStream(stdout) << "Using coverage cache " << CoverageCache::defaultFileName(bam_file) << endl;
+
+		BedFile output;
+		for (int i=0; i<bed_file.count(); ++i)
 		{
-			//determine start index
-			int start = -1;
-			for (int i=0; i<bed_file.count(); ++i)
+			const BedLine& bed_line = bed_file[i];
+			int reg_start = -1;
+			foreach(const DepthRun& run, cache->runs(bed_line.chr(), bed_line.start(), bed_line.end()))
 			{
-				if (bed_file[i].chr()==chr)
+				bool filter = is_high ? (run.depth>=cutoff) : (run.depth<cutoff);
+				if (reg_start!=-1 && !filter)
 				{
-					start = i;
-					break;
+					output.append(BedLine(bed_line.chr(), reg_start, run.start-1, bed_line.annotations()));
+					reg_start = -1;
 				}
-			}
-
-			//determine end index
-			int end = -1;
-			for (int i=bed_file.count()-1; i>=0; --i)
-			{
-				if (bed_file[i].chr()==chr)
+				if (reg_start==-1 && filter)
 				{
-					end = i;
-					break;
+					reg_start = run.start;
 				}
 			}
+			if (reg_start!=-1)
+			{
+				output.append(BedLine(bed_line.chr(), reg_start, bed_line.end(), bed_line.annotations()));
+			}
+		}
+
+		output.merge(true, true, true);
+		return output;
+	}
+
+	//random access: single pass over nearby regions
+	if (random_access)
+	{
+		if (debug) QTextStream(stdout) << "Using 'random access' algorithm!" << endl;
 
-			//deterine base count of chunks
-			long bases = 0;
-			for (int i=start; i<=end; ++i)
+		MultiRegionCoverage engine(bed_file);
+		MultiRegionCoverageResult result = engine.calculate(bam_file, is_high ? -1 : cutoff, is_high ? cutoff : -1, min_mapq, min_baseq, threads, ref_file, debug);
+		BedFile& output = is_high ? result.high : result.low;
+		output.merge(true, true, true);
+		return output;
+	}
+
+	//create analysis chunks (one per chromosome)
+	QTime timer;
+	timer.start();
+	QList<WorkerLowOrHighCoverageChr::Chunk> bed_chunks;
+
+	//determine chr chunks
+	QList<QPair<long, WorkerLowOrHighCoverageChr::Chunk>> chunks_with_size;
+	foreach(const Chromosome& chr, bed_file.chromosomes())
+	{
+		//determine start index
+		int start = -1;
+		for (int i=0; i<bed_file.count(); ++i)
+		{
+			if (bed_file[i].chr()==chr)
 			{
-				bases += bed_file[i].length();
+				start = i;
+				break;
 			}
-			chunks_with_size << qMakePair(bases,  WorkerLowOrHighCoverage::Chunk{bed_file, start, end, "", BedFile()});
 		}
 
-		//sort chunks by size
-		std::sort(chunks_with_size.begin(), chunks_with_size.end(),
-			[](const QPair<long, WorkerLowOrHighCoverage::Chunk>& a, const QPair<long, WorkerLowOrHighCoverage::Chunk>& b)
+		//determine end index
+		int end = -1;
+		for (int i=bed_file.count()-1; i>=0; --i)
+		{
+			if (bed_file[i].chr()==chr)
 			{
-				return a.first > b.first;
+				end = i;
+				break;
 			}
-		);
+		}
 
-		//add chunks ordered by size
-		foreach(const auto& entry, chunks_with_size)
+		//deterine base count of chunks
+		long bases = 0;
+		for (int i=start; i<=end; ++i)
 		{
-			bed_chunks << entry.second;
+			bases += bed_file[i].length();
 		}
+		chunks_with_size << qMakePair(bases,  WorkerLowOrHighCoverageChr::Chunk{bed_file, start, end, "", BedFile()});
 	}
-	else
-	{
-		for (int start=0; start<bed_file.count(); start += 200)
+
+	//sort chunks by size
+	std::sort(chunks_with_size.begin(), chunks_with_size.end(),
+		[](const QPair<long, WorkerLowOrHighCoverageChr::Chunk>& a, const QPair<long, WorkerLowOrHighCoverageChr::Chunk>& b)
 		{
-			int end = start+199;
-			if (end>=bed_file.count()) end = bed_file.count() -1;
-			bed_chunks << WorkerLowOrHighCoverage::Chunk{bed_file, start, end, QString(), BedFile{}};
+			return a.first > b.first;
 		}
+	);
+
+	//add chunks ordered by size
+	foreach(const auto& entry, chunks_with_size)
+	{
+		bed_chunks << entry.second;
 	}
 
 	//debug output
 	if (debug)
 	{
 		QTextStream out(stdout);
-		out << "Using '" << (random_access ? "random access" : "sweep") << "' algorithm!" << endl;
+		out << "Using 'sweep' algorithm!" << endl;
 		out << "Creating " << bed_chunks.count() << " chunks took " << Helper::elapsedTime(timer) << endl;
 		out << "Starting processing chunks with " << threads << " threads" << endl;
 	}
@@ -2475,28 +2263,16 @@ BedFile Statistics::lowOrHighCoverage(const BedFile& bed_file, const QString& ba
 	//start analysis chunks
 	for (int i=0; i<bed_chunks.count(); ++i)
 	{
-		if (!random_access)
-		{
-			if (debug) QTextStream(stdout) << "Creating BED index" << endl;
-			ChromosomalIndex<BedFile> bed_index(bed_file);
+		if (debug) QTextStream(stdout) << "Creating BED index" << endl;
+		ChromosomalIndex<BedFile> bed_index(bed_file);
 
-			if (debug) QTextStream(stdout) << "Starting worker " << i << endl;
-			WorkerLowOrHighCoverageChr* worker = new WorkerLowOrHighCoverageChr(bed_chunks[i], bed_index, bam_file, cutoff, min_mapq, min_baseq, ref_file, is_high, debug);
-			thread_pool.start(worker);
+		if (debug) QTextStream(stdout) << "Starting worker " << i << endl;
+		WorkerLowOrHighCoverageChr* worker = new WorkerLowOrHighCoverageChr(bed_chunks[i], bed_index, bam_file, cutoff, min_mapq, min_baseq, ref_file, is_high, debug);
+		thread_pool.start(worker);
 
-			//wait until finished
-			if (debug) QTextStream(stdout) << "Waiting for workers to finish..." << endl;
-			thread_pool.waitForDone();
-		}
-		else
-		{
-			WorkerLowOrHighCoverage* worker = new WorkerLowOrHighCoverage(bed_chunks[i], bam_file, cutoff, min_mapq, min_baseq, ref_file, is_high, debug);
-			thread_pool.start(worker);
-
-			//wait until finished
-			if (debug) QTextStream(stdout) << "Waiting for workers to finish..." << endl;
-			thread_pool.waitForDone();
-		}
+		//wait until finished
+		if (debug) QTextStream(stdout) << "Waiting for workers to finish..." << endl;
+		thread_pool.waitForDone();
 	}
 
 	//debug output
@@ -2504,7 +2280,7 @@ BedFile Statistics::lowOrHighCoverage(const BedFile& bed_file, const QString& ba
 
 	//check for errors and merge results
 	BedFile output;
-	foreach(const WorkerLowOrHighCoverage::Chunk& bed_chunk, bed_chunks)
+	foreach(const WorkerLowOrHighCoverageChr::Chunk& bed_chunk, bed_chunks)
 	{
 		if (!bed_chunk.error.isEmpty()) THROW(Exception, bed_chunk.error);
 
@@ -2554,77 +2330,94 @@ void Statistics::avgCoverage(BedFile& bed_file, const QString& bam_file, int min
 	//check BED is sorted for chromosomal sweep algorithm
 	if (!random_access && !bed_file.isSorted()) THROW(ArgumentException, "Input BED file has to be sorted for sweep algorithm!");
 
-	//create analysis chunks
-	QTime timer;
-	timer.start();
-	QList<WorkerAverageCoverage::Chunk> chunks;
-	if (!random_access)
+	//use coverage cache if it contains all regions
+	QSharedPointer<CoverageCache> cache = CoverageCache::openIfValid(bam_file, min_mapq, 0);
+	if (!cache.isNull() && cache->contains(bed_file))
 	{
-		//determine chr chunks
-		QList<QPair<long, WorkerAverageCoverage::Chunk>> chunks_with_size;
-		foreach(const Chromosome& chr, bed_file.chromosomes())
+		if (debug) QTextStream(stdout) << "Using coverage cache " << CoverageCache::defaultFileName(bam_file) << endl;
+
+		for (int i=0; i<bed_file.count(); ++i)
 		{
-			//determine start index
-			int start = -1;
-			for (int i=0; i<bed_file.count(); ++i)
-			{
-				if (bed_file[i].chr()==chr)
-				{
-					start = i;
-					break;
-				}
-			}
+			BedLine& bed_line = bed_file[i];
+			long long cov = cache->depthSum(bed_line.chr(), bed_line.start(), bed_line.end());
+			bed_line.annotations().append(QByteArray::number((double)cov / bed_line.length(), 'f', decimals));
+		}
+		return;
+	}
 
-			//determine end index
-			int end = -1;
-			for (int i=bed_file.count()-1; i>=0; --i)
-			{
-				if (bed_file[i].chr()==chr)
-				{
-					end = i;
-					break;
-				}
-			}
+	//random access: single pass over nearby regions
+	if (random_access)
+	{
+		if (debug) QTextStream(stdout) << "Using 'random access' algorithm!" << endl;
+
+		MultiRegionCoverage engine(bed_file);
+		MultiRegionCoverageResult result = engine.calculate(bam_file, -1, -1, min_mapq, 0, threads, ref_file, debug);
+		for (int i=0; i<bed_file.count(); ++i)
+		{
+			bed_file[i].annotations().append(QByteArray::number(result.avg[i], 'f', decimals));
+		}
+		return;
+	}
+
+	//create analysis chunks (one per chromosome)
+	QTime timer;
+	timer.start();
+	QList<WorkerAverageCoverageChr::Chunk> chunks;
 
-			//deterine base count of chunks
-			long bases = 0;
-			for (int i=start; i<=end; ++i)
+	//determine chr chunks
+	QList<QPair<long, WorkerAverageCoverageChr::Chunk>> chunks_with_size;
+	foreach(const Chromosome& chr, bed_file.chromosomes())
+	{
+		//determine start index
+		int start = -1;
+		for (int i=0; i<bed_file.count(); ++i)
+		{
+			if (bed_file[i].chr()==chr)
 			{
-				bases += bed_file[i].length();
+				start = i;
+				break;
 			}
-			chunks_with_size << qMakePair(bases,  WorkerAverageCoverage::Chunk{bed_file, start, end, ""});
 		}
 
-		//sort chunks by size
-		std::sort(chunks_with_size.begin(), chunks_with_size.end(),
-			[](const QPair<long, WorkerAverageCoverage::Chunk>& a, const QPair<long, WorkerAverageCoverage::Chunk>& b)
+		//determine end index
+		int end = -1;
+		for (int i=bed_file.count()-1; i>=0; --i)
+		{
+			if (bed_file[i].chr()==chr)
 			{
-				return a.first > b.first;
+				end = i;
+				break;
 			}
-		);
+		}
 
-		//add chunks ordered by size
-		foreach(const auto& entry, chunks_with_size)
+		//deterine base count of chunks
+		long bases = 0;
+		for (int i=start; i<=end; ++i)
 		{
-			chunks << entry.second;
+			bases += bed_file[i].length();
 		}
+		chunks_with_size << qMakePair(bases,  WorkerAverageCoverageChr::Chunk{bed_file, start, end, ""});
 	}
-	else
-	{
-		const int chunk_size = 200;
-		for (int start=0; start<bed_file.count(); start += chunk_size)
+
+	//sort chunks by size
+	std::sort(chunks_with_size.begin(), chunks_with_size.end(),
+		[](const QPair<long, WorkerAverageCoverageChr::Chunk>& a, const QPair<long, WorkerAverageCoverageChr::Chunk>& b)
 		{
-			int end = start+chunk_size-1;
-			if (end>=bed_file.count()) end = bed_file.count() -1;
-			chunks << WorkerAverageCoverage::Chunk{bed_file, start, end, ""};
+			return a.first > b.first;
 		}
+	);
+
+	//add chunks ordered by size
+	foreach(const auto& entry, chunks_with_size)
+	{
+		chunks << entry.second;
 	}
 
 	//debug output
 	if (debug)
 	{
 		QTextStream out(stdout);
-		out << "Using '" << (random_access ? "random access" : "sweep") << "' algorithm!" << endl;
+		out << "Using 'sweep' algorithm!" << endl;
 		out << "Creating " << chunks.count() << " chunks took " << Helper::elapsedTime(timer) << endl;
 	}
 
@@ -2635,23 +2428,15 @@ void Statistics::avgCoverage(BedFile& bed_file, const QString& bam_file, int min
 	//start analysis chunks
 	for (int i=0; i<chunks.count(); ++i)
 	{
-		if (!random_access)
-		{
-			WorkerAverageCoverageChr* worker = new WorkerAverageCoverageChr(chunks[i], bam_file, min_mapq, decimals, ref_file, debug);
-			thread_pool.start(worker);
-		}
-		else
-		{
-			WorkerAverageCoverage* worker = new WorkerAverageCoverage(chunks[i], bam_file, min_mapq, decimals, ref_file, debug);
-			thread_pool.start(worker);
-		}
+		WorkerAverageCoverageChr* worker = new WorkerAverageCoverageChr(chunks[i], bam_file, min_mapq, decimals, ref_file, debug);
+		thread_pool.start(worker);
 	}
 
 	//wait until finished
 	thread_pool.waitForDone();
 
 	//check if error occured
-	foreach(const WorkerAverageCoverage::Chunk& chunk, chunks)
+	foreach(const WorkerAverageCoverageChr::Chunk& chunk, chunks)
 	{
 		if (!chunk.error.isEmpty()) THROW(Exception, chunk.error);
 	}
@@ -2726,12 +2511,16 @@ GenderEstimate Statistics::genderHetX(GenomeBuild build, QString bam_file, doubl
 	//count het SNPs
 	int c_all = 0;
 	int c_het = 0;
-	QVector<Pileup> counts;
-	counts.reserve(snps.count());
+	MultiSitePileup engine;
+	for (int i=0; i<snps.count(); ++i)
+	{
+		engine.addSite(snps[i].chr(), snps[i].start());
+	}
+	QVector<Pileup> pileups = engine.calculate(reader, -1, 20, include_single_end_reads, 20);
 	for (int i=0; i<snps.count(); ++i)
 	{
 		const VcfLine& snp = snps[i];
-		Pileup pileup = reader.getPileup(snp.chr(), snp.start(), -1, 20, include_single_end_reads, 20);
+		const Pileup& pileup = pileups[i];
 
 		int depth = pileup.depth(false);
 		if (depth<20) continue;
@@ -9,8 +9,8 @@
 #include "NGSHelper.h"
 #include "GenomeBuild.h"
 #include <QMap>
-#include "WorkerLowOrHighCoverage.h"
-#include "WorkerAverageCoverage.h"
+#include "WorkerLowOrHighCoverageChr.h"
+#include "WorkerAverageCoverageChr.h"
 
 ///Helper class for gender estimates
 struct CPPNGSSHARED_EXPORT GenderEstimate
@@ -39,12 +39,12 @@ public:
 	static QCCollection variantList(const VcfFile& variants, bool filter);
 	////Calculates QC metrics for phasing on a VCF file (long read data) and returns the phasing blocks as BED file
 	static QCCollection phasing(const VcfFile& variants, bool filter, BedFile& phasing_blocks);
-	///Calculates mapping QC metrics for a target region from a BAM file. The input BED file must be merged!
-	static QCCollection mapping(const BedFile& bed_file, const QString& bam_file, const QString& ref_file, int min_mapq=1, bool is_cfdna = false);
-	///Calculates mapping QC metrics from a BAM file.
-	static QCCollection mapping(const QString& bam_file, int min_mapq=1, const QString& ref_file = QString());
+	///Calculates mapping QC metrics for a target region from a BAM file. The input BED file must be merged! If more than one thread is used, the BAM file has to be indexed.
+	static QCCollection mapping(const BedFile& bed_file, const QString& bam_file, const QString& ref_file, int min_mapq=1, bool is_cfdna = false, int threads = 1);
+	///Calculates mapping QC metrics from a BAM file. If more than one thread is used, the BAM file has to be indexed.
+	static QCCollection mapping(const QString& bam_file, int min_mapq=1, const QString& ref_file = QString(), int threads = 1);
 	///Calculates mapping QC metrics for WGS from a BAM file.
-	static QCCollection mapping_wgs(const QString& bam_file, const QString& bedpath="", int min_mapq=1, const QString& ref_file = QString());
+	static QCCollection mapping_wgs(const QString& bam_file, const QString& bedpath="", int min_mapq=1, const QString& ref_file = QString(), int threads = 1);
 	///Calculates mapping QC metrics for a housekeeping genes exon region from a BAM file. The input BED file must be merged!
 	static QCCollection mapping_housekeeping(const BedFile& bed_file, const QString& bam_file, const QString& ref_file, int min_mapq=1);
 	///Calculates target region statistics (term-value pairs). @p merge determines if overlapping regions are merged before calculating the statistics.
@@ -66,6 +66,7 @@ public:
 	static AncestryEstimates ancestry(GenomeBuild build, QString filename, int min_snp=1000, double abs_score_cutoff = 0.32, double max_mad_dist = 4.2);
 
 	///Calculates the part of the target region that has a lower coverage than the given cutoff. The input BED file must be merged and sorted!
+	///Note: lowCoverage, avgCoverage and highCoverage use the coverage cache of the BAM/CRAM file instead of the BAM/CRAM file, if the cache is up-to-date, was created with the same cutoffs and contains all regions (see CoverageCache).
 	static BedFile lowCoverage(const BedFile& bed_file, const QString& bam_file, int cutoff, int min_mapq=1, int min_baseq=0, int threads=1, const QString& ref_file = QString(), bool random_access=true, bool debug=false);
 	///Calculates and annotates the average coverage of the regions in the bed file. Debug flag enables debug output to stdout.
 	static void avgCoverage(BedFile& bed_file, const QString& bam_file, int min_mapq=1, int threads=1, int decimals=2, const QString& ref_file = QString(), bool random_access=true, bool debug=false);
@@ -111,17 +111,17 @@ void StatisticsReads::update(const BamAlignment& al)
 	}
 	
 	//create pileups
-	QVector<int> base_ints = al.baseIntegers();
+	const BaseView bases = al.basesView();
 	for (int i=0; i<cycles; ++i)
 	{
-		int base = base_ints[i];
+		int base = bases.code(i);
 		
 		if (base==1) pileups_[i].incA();
 		else if (base==2) pileups_[i].incC();
 		else if (base==4) pileups_[i].incG();
 		else if (base==8) pileups_[i].incT();
 		else if (base==15) pileups_[i].incN();
-		else THROW(ProgrammingException, "Unknown base '" + QString::number(base_ints[i]) + "' in StatisticsReads::update!");
+		else THROW(ProgrammingException, "Unknown base '" + QString::number(base) + "' in StatisticsReads::update!");
 	}
 
 	//handle qualities
@@ -146,6 +146,56 @@ void StatisticsReads::update(const BamAlignment& al)
 	if (mean_qscore>=20.0) ++c_read_q20_;
 }
 
+void StatisticsReads::merge(const StatisticsReads& rhs)
+{
+	c_forward_ += rhs.c_forward_;
+	c_reverse_ += rhs.c_reverse_;
+	for (auto it=rhs.read_lengths_.cbegin(); it!=rhs.read_lengths_.cend(); ++it)
+	{
+		read_lengths_[it.key()] += it.value();
+	}
+	bases_sequenced_ += rhs.bases_sequenced_;
+	c_read_q20_ += rhs.c_read_q20_;
+	c_base_q30_ += rhs.c_base_q30_;
+
+	//per-cycle data
+	if (rhs.pileups_.size()>pileups_.size())
+	{
+		pileups_.resize(rhs.pileups_.size());
+		qualities1_.resize(rhs.pileups_.size());
+		qualities2_.resize(rhs.pileups_.size());
+	}
+	for (int i=0; i<rhs.pileups_.size(); ++i)
+	{
+		pileups_[i].add(rhs.pileups_[i]);
+		qualities1_[i] += rhs.qualities1_[i];
+		qualities2_[i] += rhs.qualities2_[i];
+	}
+	for (int i=0; i<base_qualities_.size(); ++i)
+	{
+		base_qualities_[i] += rhs.base_qualities_[i];
+	}
+
+	//Q score distributions (only reported in long-read mode)
+	if (long_read_)
+	{
+		Histogram tmp_r1 = rhs.qscore_dist_r1;
+		QVector<double> x = tmp_r1.xCoords();
+		for (int bin=0; bin<tmp_r1.binCount(); ++bin)
+		{
+			long long count = (long long)tmp_r1.binValue(bin);
+			for (long long c=0; c<count; ++c) qscore_dist_r1.inc(x[bin], true);
+		}
+		Histogram tmp_r2 = rhs.qscore_dist_r2;
+		x = tmp_r2.xCoords();
+		for (int bin=0; bin<tmp_r2.binCount(); ++bin)
+		{
+			long long count = (long long)tmp_r2.binValue(bin);
+			for (long long c=0; c<count; ++c) qscore_dist_r2.inc(x[bin], true);
+		}
+	}
+}
+
 QCCollection StatisticsReads::getResult()
 {
 	//create output values
@@ -29,6 +29,8 @@ public:
 	void update(const FastqEntry& entry, ReadDirection direction);
 	///Updates the statistics based on the given alignment
 	void update(const BamAlignment& al);
+	///Adds the statistics of another instance, e.g. of another thread.
+	void merge(const StatisticsReads& rhs);
 
 	///Returns the statistics result.
 	QCCollection getResult();
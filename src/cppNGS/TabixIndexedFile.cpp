@@ -1,21 +1,44 @@
 #include "TabixIndexedFile.h"
 #include "Exceptions.h"
 #include "Chromosome.h"
-
-/*
-#include "htslib/sam.h"
-#include "htslib/vcf.h"
-#include "htslib/kseq.h"
 #include "htslib/bgzf.h"
-#include "htslib/hts.h"
-#include "htslib/regidx.h"
-*/
+
+//Size of the cache for decompressed BGZF blocks of each data file handle (up to 64KB per block)
+static const int BLOCK_CACHE_SIZE = 4 * 1024 * 1024;
+
+TabixIndexedFile::Index::Index()
+	: tbx(nullptr)
+{
+}
+
+TabixIndexedFile::Index::~Index()
+{
+	if (tbx!=nullptr) tbx_destroy(tbx);
+}
+
 TabixIndexedFile::TabixIndexedFile()
 	: file_(nullptr)
-	, tbx_(nullptr)
 {
 }
 
+TabixIndexedFile::TabixIndexedFile(const TabixIndexedFile& rhs)
+	: index_(rhs.index_)
+	, file_(nullptr)
+{
+	if (!index_.isNull()) openDataFile(index_->filename);
+}
+
+TabixIndexedFile& TabixIndexedFile::operator=(const TabixIndexedFile& rhs)
+{
+	if (this==&rhs) return *this;
+
+	clear();
+	index_ = rhs.index_;
+	if (!index_.isNull()) openDataFile(index_->filename);
+
+	return *this;
+}
+
 TabixIndexedFile::~TabixIndexedFile()
 {
 	clear();
@@ -25,48 +48,56 @@ void TabixIndexedFile::load(QByteArray filename)
 {
 	clear();
 
-	//store file name
-	filename_ = filename;
-
 	//open data file
-	file_ = hts_open(filename.data(), "r");
-	if (file_ == nullptr) THROW(FileParseException, "Could not open data file " + filename_);
+	openDataFile(filename);
 
 	//load index
-	tbx_ = tbx_index_load(filename.data());
-	if (tbx_ == nullptr) THROW(FileParseException, "Could not load tabix index of " + filename_);
+	QSharedPointer<Index> index(new Index());
+	index->filename = filename;
+	index->tbx = tbx_index_load(filename.data());
+	if (index->tbx == nullptr) THROW(FileParseException, "Could not load tabix index of " + filename);
 
 	//create dictionary of chromosome identifiers
 	int nseq;
-	const char** seq = tbx_seqnames(tbx_, &nseq);
+	const char** seq = tbx_seqnames(index->tbx, &nseq);
+	index->chr_names = QVector<QByteArray>(nseq);
 	for (int i=0; i<nseq; i++)
 	{
-		int tabix_id = tbx_name2id(tbx_, seq[i]);
+		int tabix_id = tbx_name2id(index->tbx, seq[i]);
 		int ngsbits_id = Chromosome(seq[i]).num();
-		chr2chr_[ngsbits_id] = tabix_id;
+		index->chr2chr[ngsbits_id] = tabix_id;
+		index->chr_names[tabix_id] = seq[i];
 	}
 	free(seq);
+	index_ = index;
 }
 
 void TabixIndexedFile::clear()
 {
-	filename_.clear();
-
-	if (tbx_!=nullptr) tbx_destroy(tbx_);
-	tbx_ = nullptr;
+	index_.clear();
 
 	if (file_!=nullptr) hts_close(file_);
 	file_ = nullptr;
+}
+
+void TabixIndexedFile::openDataFile(const QByteArray& filename)
+{
+	file_ = hts_open(filename.data(), "r");
+	if (file_ == nullptr) THROW(FileParseException, "Could not open data file " + filename);
 
-	chr2chr_.clear();
+	//cache decompressed blocks - neighboring queries often hit the same block
+	BGZF* bgzf = hts_get_bgzfp(file_);
+	if (bgzf!=nullptr) bgzf_set_cache_size(bgzf, BLOCK_CACHE_SIZE);
 }
 
 QByteArrayList TabixIndexedFile::getMatchingLines(const Chromosome& chr, int start, int end, bool ignore_missing_chr) const
 {
 	QByteArrayList output;
 
+	if (index_.isNull()) THROW(ProgrammingException, "Tabix-indexed file queried before it was loaded!");
+
 	//get chromsome identifier
-	int chr_id = chr2chr_.value(chr.num(), -1);
+	int chr_id = index_->chr2chr.value(chr.num(), -1);
 	if (chr_id==-1)
 	{
 		if (ignore_missing_chr)
@@ -75,16 +106,16 @@ QByteArrayList TabixIndexedFile::getMatchingLines(const Chromosome& chr, int sta
 		}
 		else
 		{
-			THROW(ProgrammingException, "Chromosome '"+chr.str() + "' not found in tabix index of " + filename_);
+			THROW(ProgrammingException, "Chromosome '"+chr.str() + "' not found in tabix index of " + index_->filename);
 		}
 
 	}
 	kstring_t str = {0, 0, nullptr};
-	hts_itr_t* itr = tbx_itr_queryi(tbx_, chr_id, start-1, end);
+	hts_itr_t* itr = tbx_itr_queryi(index_->tbx, chr_id, start-1, end);
 	if (itr)
 	{
 		int r;
-		while(r=tbx_itr_next(file_, tbx_, itr, &str), r>=0)
+		while(r=tbx_itr_next(file_, index_->tbx, itr, &str), r>=0)
 		{
 			output << QByteArray(str.s);
 		}
@@ -92,15 +123,125 @@ QByteArrayList TabixIndexedFile::getMatchingLines(const Chromosome& chr, int sta
 		if (r < -1)
 		{
 			free(str.s);
-			THROW(FileParseException, "Error while accessing file through the index file for " + filename_ + ".");
+			THROW(FileParseException, "Error while accessing file through the index file for " + index_->filename + ".");
 		}
 	}
 	else
 	{
 		free(str.s);
-		THROW(FileParseException, "Error while parsing the index file for " + filename_ + ".");
+		THROW(FileParseException, "Error while parsing the index file for " + index_->filename + ".");
 	}
 	free(str.s);
 
 	return output;
 }
+
+TabixIndexedFileCursor::TabixIndexedFileCursor(const TabixIndexedFile& file)
+	: index_(file.index_)
+	, fp_(nullptr)
+	, str_{0, 0, nullptr}
+	, line_valid_(false)
+	, line_pos_(-1)
+	, line_offset_(0)
+	, last_tid_(-1)
+	, last_pos_(-1)
+	, seeks_(0)
+{
+	if (index_.isNull()) THROW(ProgrammingException, "Tabix cursor created for a file that is not loaded!");
+
+	fp_ = hts_open(index_->filename.data(), "r");
+	if (fp_ == nullptr) THROW(FileParseException, "Could not open data file " + index_->filename);
+}
+
+TabixIndexedFileCursor::~TabixIndexedFileCursor()
+{
+	free(str_.s);
+	if (fp_!=nullptr) hts_close(fp_);
+}
+
+QByteArrayList TabixIndexedFileCursor::getLinesAt(const Chromosome& chr, int pos, bool ignore_missing_chr)
+{
+	//get chromsome identifier
+	int tid = index_->chr2chr.value(chr.num(), -1);
+	if (tid==-1)
+	{
+		if (ignore_missing_chr) return QByteArrayList();
+		THROW(ProgrammingException, "Chromosome '"+chr.str() + "' not found in tabix index of " + index_->filename);
+	}
+
+	//same position as last query (e.g. multi-allelic variants split into several lines)
+	if (tid==last_tid_ && pos==last_pos_) return last_lines_;
+
+	//determine first file offset that can contain the position
+	hts_itr_t* itr = tbx_itr_queryi(index_->tbx, tid, pos-1, pos);
+	if (itr==nullptr) THROW(FileParseException, "Error while parsing the index file for " + index_->filename + ".");
+	int64_t target = itr->n_off>0 ? itr->off[0].u : -1;
+	tbx_itr_destroy(itr);
+
+	//seek if streaming forward is not possible or would require decompressing blocks we don't need
+	bool in_order = line_valid_ && tid==last_tid_ && pos>last_pos_;
+	if (target!=-1 && (!in_order || (target>>16) > (line_offset_>>16)))
+	{
+		seek(target);
+	}
+
+	if (tid!=last_tid_)
+	{
+		last_chr_ = index_->chr_names[tid];
+	}
+	last_tid_ = tid;
+	last_pos_ = pos;
+	last_lines_.clear();
+
+	//no data for this position in the index
+	if (target==-1) return last_lines_;
+
+	//stream forward: skip lines before the position and collect lines at the position
+	while (line_valid_ && line_chr_==last_chr_ && line_pos_<=pos)
+	{
+		if (line_pos_==pos) last_lines_ << line_;
+		readLine();
+	}
+
+	return last_lines_;
+}
+
+void TabixIndexedFileCursor::seek(int64_t offset)
+{
+	if (bgzf_seek(hts_get_bgzfp(fp_), offset, SEEK_SET)<0) THROW(FileParseException, "Could not seek in file " + index_->filename + ".");
+	++seeks_;
+
+	readLine();
+}
+
+void TabixIndexedFileCursor::readLine()
+{
+	BGZF* bgzf = hts_get_bgzfp(fp_);
+	while(true)
+	{
+		line_offset_ = bgzf_tell(bgzf);
+		int r = bgzf_getline(bgzf, '\n', &str_);
+		if (r<-1) THROW(FileParseException, "Error while reading file " + index_->filename + ".");
+		if (r==-1) //end of file
+		{
+			line_valid_ = false;
+			return;
+		}
+
+		//skip header and empty lines
+		if (str_.l==0 || str_.s[0]=='#') continue;
+
+		//parse chromosome and position
+		line_ = QByteArray(str_.s, str_.l);
+		int tab1 = line_.indexOf('\t');
+		int tab2 = tab1==-1 ? -1 : line_.indexOf('\t', tab1+1);
+		if (tab2==-1) THROW(FileParseException, "VCF line with too few columns in file " + index_->filename + ": " + line_);
+		line_chr_ = line_.left(tab1);
+		bool ok = false;
+		line_pos_ = line_.mid(tab1+1, tab2-tab1-1).toInt(&ok);
+		if (!ok) THROW(FileParseException, "Could not convert VCF variant position to integer in file " + index_->filename + ": " + line_);
+
+		line_valid_ = true;
+		return;
+	}
+}
@@ -8,11 +8,25 @@
 
 #include <QByteArrayList>
 #include <QHash>
+#include <QSharedPointer>
+#include <QVector>
 
+/**
+  @brief Tabix-indexed file (e.g. VCF.GZ with TBI index).
+
+  The index is immutable and shared between copies of a file object. Each copy has its own data file handle with a small cache of decompressed blocks.
+  Thus, several threads can query the same file by using one copy per thread, without loading the index more than once.
+*/
 class CPPNGSSHARED_EXPORT TabixIndexedFile
 {
 public:
+	///Default constructor.
 	TabixIndexedFile();
+	///Copy constructor: shares the index, but opens a separate data file handle.
+	TabixIndexedFile(const TabixIndexedFile& rhs);
+	///Assignment operator: shares the index, but opens a separate data file handle.
+	TabixIndexedFile& operator=(const TabixIndexedFile& rhs);
+	///Destructor.
 	~TabixIndexedFile();
 
 	///Open the file and loads the index.
@@ -25,10 +39,75 @@ public:
 	QByteArrayList getMatchingLines(const Chromosome& chr, int start, int end, bool ignore_missing_chr = false) const;
 
 protected:
-	QByteArray filename_;
+	//Index data shared between all copies of a file
+	struct Index
+	{
+		Index();
+		~Index();
+
+		QByteArray filename;
+		tbx_t* tbx;
+		QHash<int, int> chr2chr; //dictionary to translate ngs-bits chromosome IDs to tabix chromosome IDs
+		QVector<QByteArray> chr_names; //chromosome names in the file (index is the tabix chromosome ID)
+	};
+
+	QSharedPointer<const Index> index_;
 	htsFile* file_;
-	tbx_t* tbx_;
-	QHash<int, int> chr2chr_; //dictionary to translate ngs-bits chromosome IDs to tabix chromosome IDs
+
+	//opens the data file
+	void openDataFile(const QByteArray& filename);
+
+	friend class TabixIndexedFileCursor;
+};
+
+///Forward-only cursor for merge-joins of coordinate-sorted data against a tabix-indexed VCF file.
+///The file is streamed sequentially, i.e. each BGZF block is decompressed only once as long as the queried positions are increasing.
+///The index is only used to jump over blocks that cannot contain the queried position.
+///Queries that are not sorted are supported, but trigger a seek.
+class CPPNGSSHARED_EXPORT TabixIndexedFileCursor
+{
+public:
+	///Constructor. The index of @p file is used, the data file is opened separately.
+	TabixIndexedFileCursor(const TabixIndexedFile& file);
+	~TabixIndexedFileCursor();
+
+	///Returns the lines which start at the given position (1-based).
+	QByteArrayList getLinesAt(const Chromosome& chr, int pos, bool ignore_missing_chr = false);
+
+	///Returns the number of seeks performed (for statistics/debugging).
+	int seekCount() const
+	{
+		return seeks_;
+	}
+
+protected:
+	QSharedPointer<const TabixIndexedFile::Index> index_;
+	htsFile* fp_;
+	kstring_t str_;
+
+	//current line (not consumed yet)
+	bool line_valid_;
+	QByteArray line_;
+	QByteArray line_chr_;
+	int line_pos_;
+	int64_t line_offset_;
+
+	//last query and its result
+	int last_tid_;
+	int last_pos_;
+	QByteArray last_chr_;
+	QByteArrayList last_lines_;
+
+	int seeks_;
+
+	//reads the next data line into the current line
+	void readLine();
+	//moves the cursor to the given virtual file offset
+	void seek(int64_t offset);
+
+	//declared away
+	TabixIndexedFileCursor(const TabixIndexedFileCursor&) = delete;
+	TabixIndexedFileCursor& operator=(const TabixIndexedFileCursor&) = delete;
 };
 
 #endif // TABIXINDEXEDFILE_H
@@ -0,0 +1,79 @@
+#include "VariantGeneIndex.h"
+#include "VariantList.h"
+#include <cmath>
+#include <limits>
+
+VariantGeneIndex::VariantGeneIndex(const VariantList& variants)
+	: row_count_(variants.count())
+	, empty_(variants.count(), false)
+	, gene_rows_()
+	, inheritance_rows_()
+	, max_pli_(variants.count(), -std::numeric_limits<double>::infinity())
+	, min_oe_lof_(variants.count(), std::numeric_limits<double>::infinity())
+	, omim_rows_(variants.count(), false)
+{
+	//genes
+	int i_gene = variants.annotationIndexByName("gene", true, false);
+	if (i_gene!=-1)
+	{
+		const VariantAnnotationColumn& column = variants.column(i_gene);
+		for (int i=0; i<row_count_; ++i)
+		{
+			foreach(const QByteArray& gene, GeneSet::createFromText(column.value(i), ','))
+			{
+				QBitArray& rows = gene_rows_[gene];
+				if (rows.isEmpty()) rows = empty_;
+				rows.setBit(i);
+			}
+		}
+	}
+
+	//inheritance and constraint
+	int i_gene_info = variants.annotationIndexByName("gene_info", true, false);
+	if (i_gene_info!=-1)
+	{
+		const VariantAnnotationColumn& column = variants.column(i_gene_info);
+		for (int i=0; i<row_count_; ++i)
+		{
+			foreach(const VariantGeneInfo& info, column.geneInfo(i))
+			{
+				foreach(const QByteArray& mode, info.inheritance)
+				{
+					QBitArray& rows = inheritance_rows_[mode];
+					if (rows.isEmpty()) rows = empty_;
+					rows.setBit(i);
+				}
+				if (info.has_pli)
+				{
+					max_pli_[i] = std::max(max_pli_[i], std::isnan(info.pli) ? 0.0 : info.pli);
+				}
+				if (info.has_oe_lof)
+				{
+					min_oe_lof_[i] = std::min(min_oe_lof_[i], std::isnan(info.oe_lof) ? 1.0 : info.oe_lof);
+				}
+			}
+		}
+	}
+
+	//OMIM
+	int i_omim = variants.annotationIndexByName("OMIM", true, false);
+	if (i_omim!=-1)
+	{
+		const VariantAnnotationColumn& column = variants.column(i_omim);
+		for (int i=0; i<row_count_; ++i)
+		{
+			if (!column.value(i).trimmed().isEmpty()) omim_rows_.setBit(i);
+		}
+	}
+}
+
+QBitArray VariantGeneIndex::rowsWithGenes(const GeneSet& genes) const
+{
+	QBitArray output = empty_;
+	foreach(const QByteArray& gene, genes)
+	{
+		auto it = gene_rows_.constFind(gene);
+		if (it!=gene_rows_.cend()) output |= it.value();
+	}
+	return output;
+}
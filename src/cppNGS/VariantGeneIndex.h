@@ -0,0 +1,80 @@
+#ifndef VARIANTGENEINDEX_H
+#define VARIANTGENEINDEX_H
+
+#include "cppNGS_global.h"
+#include "GeneSet.h"
+#include <QBitArray>
+#include <QHash>
+#include <QVector>
+
+class VariantList;
+
+/**
+  @brief Pre-parsed gene annotations of a variant list for gene-based filtering.
+
+  The index is created from the 'gene', 'gene_info' and 'OMIM' columns (missing columns are treated as empty).
+  Variant rows are represented as bitmaps, i.e. gene-based filters are bitmap operations on the filter result.
+  Use VariantList::geneIndex() to get a cached instance of the index.
+*/
+class CPPNGSSHARED_EXPORT VariantGeneIndex
+{
+public:
+	///Constructor.
+	VariantGeneIndex(const VariantList& variants);
+
+	///Returns the number of variant rows.
+	int count() const
+	{
+		return row_count_;
+	}
+
+	///Returns all genes of the 'gene' column (normalized as in GeneSet).
+	QList<QByteArray> genes() const
+	{
+		return gene_rows_.keys();
+	}
+	///Returns the rows of variants that affect the given gene (normalized as in GeneSet).
+	QBitArray rowsWithGene(const QByteArray& gene) const
+	{
+		return gene_rows_.value(gene, empty_);
+	}
+	///Returns the rows of variants that affect at least one of the given genes.
+	QBitArray rowsWithGenes(const GeneSet& genes) const;
+
+	///Returns the rows of variants where at least one gene has the given inheritance mode in the 'gene_info' column.
+	QBitArray rowsWithInheritance(const QByteArray& mode) const
+	{
+		return inheritance_rows_.value(mode, empty_);
+	}
+	///Returns the maximum pLI score of the genes of a row. Non-numeric values are treated as 0.0. If there is no pLI entry, -infinity is returned.
+	double maxPli(int row) const
+	{
+		return max_pli_[row];
+	}
+	///Returns the minimum gnomAD o/e score for LoF variants of the genes of a row. Non-numeric values are treated as 1.0. If there is no o/e entry, infinity is returned.
+	double minOeLof(int row) const
+	{
+		return min_oe_lof_[row];
+	}
+
+	///Returns the rows of variants with non-empty 'OMIM' column.
+	const QBitArray& rowsWithOmim() const
+	{
+		return omim_rows_;
+	}
+
+protected:
+	int row_count_;
+	QBitArray empty_;
+	QHash<QByteArray, QBitArray> gene_rows_;
+	QHash<QByteArray, QBitArray> inheritance_rows_;
+	QVector<double> max_pli_;
+	QVector<double> min_oe_lof_;
+	QBitArray omim_rows_;
+
+	//"declared away" methods
+	VariantGeneIndex(const VariantGeneIndex&) = delete;
+	VariantGeneIndex& operator=(const VariantGeneIndex&) = delete;
+};
+
+#endif // VARIANTGENEINDEX_H
@@ -1,8 +1,53 @@
 #include "VariantHgvsAnnotator.h"
 
-VariantHgvsAnnotator::VariantHgvsAnnotator(const FastaFileIndex& genome_idx, Parameters params)
+TranscriptSequenceCache::TranscriptSequenceCache(int max_bases)
+	: mutex_()
+	, cache_(max_bases)
+	, hits_(0)
+	, misses_(0)
+{
+}
+
+QByteArray TranscriptSequenceCache::key(const Transcript& transcript, bool add_utr_3)
+{
+	return transcript.chr().str() + ':' + transcript.nameWithVersion() + (add_utr_3 ? ":utr3" : "");
+}
+
+bool TranscriptSequenceCache::get(const QByteArray& key, Sequence& seq)
+{
+	QMutexLocker locker(&mutex_);
+
+	const Sequence* cached = cache_.object(key);
+	if (cached==nullptr)
+	{
+		++misses_;
+		return false;
+	}
+
+	++hits_;
+	seq = *cached;
+	return true;
+}
+
+void TranscriptSequenceCache::insert(const QByteArray& key, const Sequence& seq)
+{
+	QMutexLocker locker(&mutex_);
+
+	cache_.insert(key, new Sequence(seq), std::max(seq.length(), 1));
+}
+
+double TranscriptSequenceCache::hitPercentage() const
+{
+	long long total = hits_ + misses_;
+	if (total==0) return 0.0;
+
+	return 100.0 * hits_ / total;
+}
+
+VariantHgvsAnnotator::VariantHgvsAnnotator(const FastaFileIndex& genome_idx, Parameters params, TranscriptSequenceCache* sequence_cache)
 	: params_(params)
 	, genome_idx_(genome_idx)
+	, sequence_cache_(sequence_cache)
 {
 }
 
@@ -1444,6 +1489,14 @@ Sequence VariantHgvsAnnotator::getCodingSequence(const Transcript& trans, bool a
 {
     Sequence seq;
 
+	//use cached sequence if available
+	QByteArray cache_key;
+	if (sequence_cache_!=nullptr)
+	{
+		cache_key = TranscriptSequenceCache::key(trans, add_utr_3);
+		if (sequence_cache_->get(cache_key, seq)) return seq;
+	}
+
     if(add_utr_3 && trans.strand() == Transcript::MINUS)
     {
         for(int i=0; i<trans.utr3prime().count(); i++)
@@ -1486,6 +1539,8 @@ Sequence VariantHgvsAnnotator::getCodingSequence(const Transcript& trans, bool a
         seq.reverseComplement();
     }
 
+	if (sequence_cache_!=nullptr) sequence_cache_->insert(cache_key, seq);
+
     return seq;
 }
 
@@ -11,6 +11,8 @@
 #include "NGSHelper.h"
 #include "Exceptions.h"
 #include "VariantImpact.h"
+#include <QCache>
+#include <QMutex>
 
 ///Representation of the effect of a variant
 ///NOTE: the order is important as it defines the severity of the variant.
@@ -99,6 +101,44 @@ struct CPPNGSSHARED_EXPORT VariantConsequence
 	QByteArray toString() const;
 };
 
+///Thread-safe LRU cache of spliced transcript sequences. It can be shared by several VariantHgvsAnnotator instances, e.g. one per thread.
+class CPPNGSSHARED_EXPORT TranscriptSequenceCache
+{
+public:
+	///Constructor. The cache size is given in bases. If the cache is full, the least recently used sequences are removed.
+	TranscriptSequenceCache(int max_bases = 50000000);
+
+	///Returns the cache key of a transcript sequence.
+	static QByteArray key(const Transcript& transcript, bool add_utr_3);
+	///Returns the sequence for the key in 'seq'. Returns false if the sequence is not cached.
+	bool get(const QByteArray& key, Sequence& seq);
+	///Stores a sequence.
+	void insert(const QByteArray& key, const Sequence& seq);
+
+	///Returns the number of cache hits.
+	long long hits() const
+	{
+		return hits_;
+	}
+	///Returns the number of cache misses.
+	long long misses() const
+	{
+		return misses_;
+	}
+	///Returns the percentage of cache hits.
+	double hitPercentage() const;
+
+private:
+	QMutex mutex_;
+	QCache<QByteArray, Sequence> cache_;
+	long long hits_;
+	long long misses_;
+
+	//"declared away" methods
+	TranscriptSequenceCache(const TranscriptSequenceCache&) = delete;
+	TranscriptSequenceCache& operator=(const TranscriptSequenceCache&) = delete;
+};
+
 ///Class for generating HGVS nomenclature and variant effect from VCF/GSVar
 class CPPNGSSHARED_EXPORT VariantHgvsAnnotator
 {
@@ -116,7 +156,8 @@ public:
 	};
 
     ///Constructor to change parameters for detecting up/downstream and splice region variants: different for 5 and 3 prime site intron
-	VariantHgvsAnnotator(const FastaFileIndex& genome_idx, Parameters params = Parameters());
+	///If a sequence cache is given, transcript sequences are taken from the cache instead of assembling them for each variant.
+	VariantHgvsAnnotator(const FastaFileIndex& genome_idx, Parameters params = Parameters(), TranscriptSequenceCache* sequence_cache = nullptr);
 
 	///Calculates variant consequence from VCF-style variant (not multi-allelic)
 	VariantConsequence annotate(const Transcript& transcript, const VcfLine& variant, bool debug=false);
@@ -129,6 +170,7 @@ public:
 private:
 	Parameters params_;
 	const FastaFileIndex& genome_idx_;
+	TranscriptSequenceCache* sequence_cache_;
 
 	QByteArray annotateRegionsCoding(const Transcript& transcript, VariantConsequence& hgvs, int gen_pos, bool is_dup, bool debug=false);
 	QByteArray annotateRegionsNonCoding(const Transcript& transcript, VariantConsequence& hgvs, int gen_pos, bool is_dup = false);
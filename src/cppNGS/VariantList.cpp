@@ -6,12 +6,15 @@
 #include "ChromosomalIndex.h"
 #include "NGSHelper.h"
 #include "VcfFile.h"
+#include "VariantGeneIndex.h"
 
 #include <QFile>
 #include <QTextStream>
 #include <QRegExp>
 #include <QBitArray>
 #include <QUrl>
+#include <QMutexLocker>
+#include <limits>
 
 #include <zlib.h>
 
@@ -524,12 +527,131 @@ bool VariantList::LessComparator::operator()(const Variant& a, const Variant& b)
 }
 
 
+VariantAnnotationColumn::VariantAnnotationColumn(const VariantList& variants, int index)
+	: data_()
+	, offsets_()
+	, mutex_()
+	, doubles_parsed_(0)
+	, ints_parsed_(0)
+	, gene_info_parsed_(0)
+{
+	//determine buffer size to avoid re-allocations
+	const int count = variants.count();
+	long long size = 0;
+	for (int i=0; i<count; ++i)
+	{
+		const QList<QByteArray>& annos = variants[i].annotations();
+		if (index<annos.count()) size += annos[index].length();
+	}
+	if (size>std::numeric_limits<int>::max())
+	{
+		THROW(ProgrammingException, "Variant annotation column " + QString::number(index) + " is too large for column-major storage!");
+	}
+
+	//copy data
+	data_.reserve(size);
+	offsets_.reserve(count + 1);
+	offsets_ << 0;
+	for (int i=0; i<count; ++i)
+	{
+		const QList<QByteArray>& annos = variants[i].annotations();
+		if (index<annos.count()) data_.append(annos[index]);
+		offsets_ << data_.length();
+	}
+}
+
+void VariantAnnotationColumn::parseDoubles() const
+{
+	QMutexLocker locker(&mutex_);
+	if (doubles_parsed_.loadAcquire()!=0) return;
+
+	const int n = count();
+	doubles_.resize(n);
+	doubles_ok_.resize(n);
+	for (int i=0; i<n; ++i)
+	{
+		bool ok = false;
+		doubles_[i] = QByteArray::fromRawData(data_.constData() + offsets_[i], length(i)).toDouble(&ok);
+		doubles_ok_.setBit(i, ok);
+	}
+
+	doubles_parsed_.storeRelease(1);
+}
+
+void VariantAnnotationColumn::parseInts() const
+{
+	QMutexLocker locker(&mutex_);
+	if (ints_parsed_.loadAcquire()!=0) return;
+
+	const int n = count();
+	ints_.resize(n);
+	ints_ok_.resize(n);
+	for (int i=0; i<n; ++i)
+	{
+		bool ok = false;
+		ints_[i] = QByteArray::fromRawData(data_.constData() + offsets_[i], length(i)).toInt(&ok);
+		ints_ok_.setBit(i, ok);
+	}
+
+	ints_parsed_.storeRelease(1);
+}
+
+void VariantAnnotationColumn::parseGeneInfo() const
+{
+	QMutexLocker locker(&mutex_);
+	if (gene_info_parsed_.loadAcquire()!=0) return;
+
+	//example: AL627309.1 (inh=n/a pLI=n/a), PRPF31 (inh=AD pLI=0.97 oe_lof=0.21), 34P13.14 (inh=n/a pLI=n/a oe_lof=)
+	const int n = count();
+	gene_info_.resize(n);
+	for (int i=0; i<n; ++i)
+	{
+		QByteArrayList genes = value(i).split(',');
+		QVector<VariantGeneInfo>& infos = gene_info_[i];
+		infos.reserve(genes.count());
+		foreach(const QByteArray& gene, genes)
+		{
+			VariantGeneInfo info;
+			int start = gene.indexOf('(');
+			info.gene = gene.left(start).trimmed();
+			QByteArrayList entries = gene.mid(start+1, gene.length()-start-2).split(' ');
+			foreach(const QByteArray& entry, entries)
+			{
+				if (entry.startsWith("inh="))
+				{
+					info.inheritance << entry.mid(4).split('+');
+				}
+				else if (entry.startsWith("pLI="))
+				{
+					bool ok;
+					double pli = entry.mid(4).toDouble(&ok);
+					info.has_pli = true;
+					if (ok) info.pli = pli;
+				}
+				else if (entry.startsWith("oe_lof="))
+				{
+					bool ok;
+					double oe_lof = entry.mid(7).toDouble(&ok);
+					info.has_oe_lof = true;
+					if (ok) info.oe_lof = oe_lof;
+				}
+			}
+			infos.append(info);
+		}
+	}
+
+	gene_info_parsed_.storeRelease(1);
+}
+
 VariantList::VariantList()
 	: comments_()
 	, annotation_descriptions_()
 	, annotation_headers_()
 	, filters_()
 	, variants_()
+	, columns_()
+	, gene_index_()
+	, cache_mutex_(new QMutex(QMutex::Recursive)) //recursive because the gene index uses cached columns
 {
 }
 
@@ -742,6 +864,7 @@ void VariantList::removeAnnotation(int index)
 		THROW(ProgrammingException, "Variant annotation column index " + QString::number(index) + " out of range [0," + QString::number(annotation_headers_.count()-1) + "] in removeAnnotation(index) method!");
 	}
 
+	invalidateColumns();
 	annotation_headers_.removeAt(index);
 	for (int i=0; i<variants_.count(); ++i)
 	{
@@ -766,6 +889,50 @@ void VariantList::removeAnnotationByName(QString name, bool exact_match, bool er
 	}
 }
 
+void VariantList::setAnnotation(int variant_index, int annotation_index, const QByteArray& value)
+{
+	if (annotation_index<0 || annotation_index>=annotation_headers_.count())
+	{
+		THROW(ProgrammingException, "Variant annotation column index " + QString::number(annotation_index) + " out of range [0," + QString::number(annotation_headers_.count()-1) + "] in setAnnotation method!");
+	}
+
+	variants_[variant_index].annotations()[annotation_index] = value;
+
+	//update cached data of the column only
+	QMutexLocker locker(cache_mutex_.data());
+	columns_.remove(annotation_index);
+	const QString& name = annotation_headers_[annotation_index].name();
+	if (name=="gene" || name=="gene_info" || name=="OMIM") gene_index_.clear();
+}
+
+const VariantAnnotationColumn& VariantList::column(int index) const
+{
+	if (index<0 || index>=annotation_headers_.count())
+	{
+		THROW(ProgrammingException, "Variant annotation column index " + QString::number(index) + " out of range [0," + QString::number(annotation_headers_.count()-1) + "] in column(index) method!");
+	}
+
+	QMutexLocker locker(cache_mutex_.data());
+	QSharedPointer<VariantAnnotationColumn>& column = columns_[index];
+	if (column.isNull())
+	{
+		column.reset(new VariantAnnotationColumn(*this, index));
+	}
+
+	return *column;
+}
+
+const VariantGeneIndex& VariantList::geneIndex() const
+{
+	QMutexLocker locker(cache_mutex_.data());
+	if (gene_index_.isNull())
+	{
+		gene_index_.reset(new VariantGeneIndex(*this));
+	}
+
+	return *gene_index_;
+}
+
 void VariantList::load(QString filename, const BedFile& roi, bool invert)
 {
 	loadInternal(filename, &roi, invert);
@@ -1021,6 +1188,7 @@ void VariantList::clear()
 
 void VariantList::clearAnnotations()
 {
+	invalidateColumns();
 	annotation_headers_.clear();
 	annotation_descriptions_.clear();
 	for(int i=0; i<variants_.count(); ++i)
@@ -1031,6 +1199,7 @@ void VariantList::clearAnnotations()
 
 void VariantList::clearVariants()
 {
+	invalidateColumns();
 	variants_.clear();
 }
 
@@ -1040,6 +1209,7 @@ void VariantList::leftAlign(QString ref_file)
 	FastaFileIndex reference(ref_file);
 
 	//init
+	invalidateColumns();
 	for (QVector<Variant>::iterator variant=variants_.begin(); variant!=variants_.end(); ++variant)
 	{
 		variant->leftAlign(reference);
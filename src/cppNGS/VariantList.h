@@ -9,6 +9,12 @@
 #include "GenomeBuild.h"
 #include "VcfLine.h"
 #include "VariantImpact.h"
+#include <QSharedPointer>
+#include <QBitArray>
+#include <QMutex>
+#include <QAtomicInt>
+#include <cstring>
+#include <limits>
 
 ///Variant caller information
 struct VariantCaller
@@ -264,6 +270,97 @@ QString CPPNGSSHARED_EXPORT analysisTypeToString(AnalysisType type, bool human_r
 ///Returns a the  repesentation of the analysis type (does not support the human-readable version).
 AnalysisType CPPNGSSHARED_EXPORT stringToAnalysisType(QString type);
 
+class VariantList;
+class VariantGeneIndex;
+
+///Parsed gene entry of the 'gene_info' annotation column, e.g. 'PRPF31 (inh=AD pLI=0.97 oe_lof=0.21)'.
+struct CPPNGSSHARED_EXPORT VariantGeneInfo
+{
+	QByteArray gene;
+	QByteArrayList inheritance; //inheritance modes, e.g. 'AD' and 'AR' for 'inh=AD+AR'
+	bool has_pli = false; //if the 'pLI' entry is present
+	double pli = std::numeric_limits<double>::quiet_NaN(); //NaN if the value is not numeric
+	bool has_oe_lof = false; //if the 'oe_lof' entry is present
+	double oe_lof = std::numeric_limits<double>::quiet_NaN(); //NaN if the value is not numeric
+};
+
+///Column-major copy of one annotation column of a variant list, used as a cache for column-wise filtering.
+///The values are stored in one contiguous buffer, which is much more cache-friendly than accessing the annotations of each variant.
+///The copy is held in addition to the per-variant annotations, i.e. it does not reduce memory usage.
+///Typed numeric values are parsed on first access. Read access is thread-safe.
+class CPPNGSSHARED_EXPORT VariantAnnotationColumn
+{
+public:
+	///Constructor - copies the annotation column with the given index. Variants with less annotations are treated as having an empty value.
+	VariantAnnotationColumn(const VariantList& variants, int index);
+
+	///Returns the number of values.
+	int count() const
+	{
+		return offsets_.count() - 1;
+	}
+	///Returns the length of the value of the given row.
+	int length(int row) const
+	{
+		return offsets_[row+1] - offsets_[row];
+	}
+	///Returns a copy of the value of the given row.
+	QByteArray value(int row) const
+	{
+		return data_.mid(offsets_[row], length(row));
+	}
+	///Returns if the value of the given row is equal to the given string.
+	bool equals(int row, const QByteArray& str) const
+	{
+		return length(row)==str.length() && memcmp(data_.constData() + offsets_[row], str.constData(), str.length())==0;
+	}
+
+	///Returns the value of the given row converted to double (same conversion as QByteArray::toDouble).
+	double toDouble(int row, bool* ok = nullptr) const
+	{
+		if (doubles_parsed_.loadAcquire()==0) parseDoubles();
+		if (ok!=nullptr) *ok = doubles_ok_.testBit(row);
+		return doubles_[row];
+	}
+	///Returns the value of the given row converted to integer (same conversion as QByteArray::toInt).
+	int toInt(int row, bool* ok = nullptr) const
+	{
+		if (ints_parsed_.loadAcquire()==0) parseInts();
+		if (ok!=nullptr) *ok = ints_ok_.testBit(row);
+		return ints_[row];
+	}
+
+	///Returns the value of the given row parsed as 'gene_info' annotation (one entry per gene).
+	const QVector<VariantGeneInfo>& geneInfo(int row) const
+	{
+		if (gene_info_parsed_.loadAcquire()==0) parseGeneInfo();
+		return gene_info_[row];
+	}
+
+protected:
+	QByteArray data_;
+	QVector<int> offsets_;
+
+	//lazily materialized numeric columns
+	mutable QMutex mutex_;
+	mutable QAtomicInt doubles_parsed_;
+	mutable QVector<double> doubles_;
+	mutable QBitArray doubles_ok_;
+	mutable QAtomicInt ints_parsed_;
+	mutable QVector<int> ints_;
+	mutable QBitArray ints_ok_;
+	mutable QAtomicInt gene_info_parsed_;
+	mutable QVector<QVector<VariantGeneInfo>> gene_info_;
+
+	void parseDoubles() const;
+	void parseInts() const;
+	void parseGeneInfo() const;
+
+	//"declared away" methods
+	VariantAnnotationColumn(const VariantAnnotationColumn&) = delete;
+	VariantAnnotationColumn& operator=(const VariantAnnotationColumn&) = delete;
+};
+
 ///A list of genetic variants
 class CPPNGSSHARED_EXPORT VariantList
 {
@@ -282,11 +379,13 @@ public:
     ///Adds a variant. Throws ArgumentException if the variant is not valid or does not contain the required number of annotations.
     void append(const Variant& variant)
     {
+		invalidateColumns();
         variants_.append(variant);
     }
     ///Removes the variant with the index @p index.
     void remove(int index)
     {
+		invalidateColumns();
         variants_.remove(index);
     }
     ///Variant accessor to a single variant.
@@ -295,6 +394,7 @@ public:
         return variants_[index];
     }
     ///Read-write accessor to a single variant.
+	///Note: Annotation changes made through the returned reference are not detected by column() and geneIndex() - use setAnnotation() to change annotations.
     Variant& operator[](int index)
     {
         return variants_[index];
@@ -307,6 +407,7 @@ public:
 	///Resize variant list.
 	void resize(int size)
 	{
+		invalidateColumns();
 		variants_.resize(size);
 	}
 	///Reserves space for a defined number of variants.
@@ -334,6 +435,7 @@ public:
     ///Non-const access to annotation headers.
 	QList<VariantAnnotationHeader>& annotations()
 	{
+		invalidateColumns();
 		return annotation_headers_;
 	}
 
@@ -369,6 +471,17 @@ public:
 	///Removes an annotation column by name.
 	void removeAnnotationByName(QString name, bool exact_match=true, bool error_on_mismatch=true);
 
+	///Sets the annotation with index @p annotation_index of the variant with index @p variant_index. The cached copy of the column and the gene index are updated if necessary.
+	void setAnnotation(int variant_index, int annotation_index, const QByteArray& value);
+
+	///Returns a column-major copy of the annotation column with the given index, e.g. for fast column-wise filtering.
+	///The copy is created on first access and cached until variants or annotation columns are added, removed or reordered, or until setAnnotation() changes the column. Creating the copy is thread-safe.
+	///Note: Annotation changes made through non-const variant references (see operator[]) are not detected!
+	const VariantAnnotationColumn& column(int index) const;
+	///Returns an index of the gene-related annotations ('gene', 'gene_info' and 'OMIM' columns), e.g. for fast gene-based filtering.
+	///The index is created on first access and cached like the columns (see column). Creating the index is thread-safe.
+	const VariantGeneIndex& geneIndex() const;
+
 	///Const access to filter descriptions.
 	const QMap<QString, QString>& filters() const
 	{
@@ -400,6 +513,7 @@ public:
 	template <typename T>
 	void sortCustom(const T& comarator)
 	{
+		invalidateColumns();
 		std::sort(variants_.begin(), variants_.end(), comarator);
 	}
 
@@ -451,6 +565,16 @@ protected:
 	QList<VariantAnnotationHeader> annotation_headers_;
 	QMap<QString, QString> filters_;
     QVector<Variant> variants_;
+	mutable QHash<int, QSharedPointer<VariantAnnotationColumn>> columns_;
+	mutable QSharedPointer<VariantGeneIndex> gene_index_;
+	QSharedPointer<QMutex> cache_mutex_; //guards creation of 'columns_' and 'gene_index_' (shared between copies, which also share the cached data)
+
+	//Clears the column-major annotation copies and the gene index
+	void invalidateColumns()
+	{
+		if (!columns_.isEmpty()) columns_.clear();
+		if (!gene_index_.isNull()) gene_index_.clear();
+	}
 
 	void loadInternal(QString filename, const BedFile* roi = nullptr, bool invert=false, bool header_only=false);
 
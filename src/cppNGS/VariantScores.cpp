@@ -130,9 +130,9 @@ int VariantScores::annotate(VariantList& variants, const VariantScores::Result&
 			rank_str = QByteArray::number(result.ranks[i]);
 			++c_scored;
 		}
-		variants[i].annotations()[i_score] = score_str;
-		variants[i].annotations()[i_rank] = rank_str;
-		if (add_explanations) variants[i].annotations()[i_score_exp] = result.score_explanations[i].join(" ").toUtf8();
+		variants.setAnnotation(i, i_score, score_str);
+		variants.setAnnotation(i, i_rank, rank_str);
+		if (add_explanations) variants.setAnnotation(i, i_score_exp, result.score_explanations[i].join(" ").toUtf8());
 	}
 
 	return c_scored;
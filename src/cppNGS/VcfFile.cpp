@@ -2,11 +2,13 @@
 #include "Helper.h"
 #include <QFileInfo>
 #include <zlib.h>
+#include <algorithm>
 
 VcfFile::VcfFile()
 	: vcf_lines_()
 	, vcf_header_()
 	, sample_names_()
+	, lazy_decoding_(false)
 {
 }
 
@@ -83,10 +85,48 @@ void VcfFile::parseHeaderFields(const QByteArray& line, bool allow_multi_sample)
 
 void VcfFile::parseVcfEntry(int line_number, const QByteArray& line, QSet<QByteArray>& info_ids, QSet<QByteArray>& format_ids, QSet<QByteArray>& filter_ids, bool allow_multi_sample, ChromosomalIndex<BedFile>* roi_idx, bool invert)
 {
-	QList<QByteArray> line_parts = line.split('\t');
-	if (line_parts.count()< MIN_COLS)
+	QList<QByteArray> line_parts;
+	int column_count = 0;
+	//lazy decoding: only the columns up to FORMAT are split, INFO and sample columns are decoded from the raw line when accessed
+	QByteArray raw_line;
+	int info_start = -1;
+	int info_end = -1;
+	int samples_start = -1;
+	if (lazy_decoding_)
+	{
+		raw_line = QByteArray(line.constData(), line.size()); //deep copy - the line might point to the reading buffer
+		int start = 0;
+		while (start!=-1 && line_parts.count()<=FORMAT)
+		{
+			int end = raw_line.indexOf('\t', start);
+			if (end==-1) end = raw_line.size();
+			if (line_parts.count()==INFO)
+			{
+				info_start = start;
+				info_end = end;
+				line_parts << QByteArray::fromRawData(raw_line.constData() + start, end - start);
+			}
+			else
+			{
+				line_parts << raw_line.mid(start, end - start);
+			}
+			start = end<raw_line.size() ? end + 1 : -1;
+		}
+		column_count = line_parts.count();
+		if (start!=-1)
+		{
+			samples_start = start;
+			column_count += 1 + (int)std::count(raw_line.constBegin() + start, raw_line.constEnd(), '\t');
+		}
+	}
+	else
+	{
+		line_parts = line.split('\t');
+		column_count = line_parts.count();
+	}
+	if (column_count< MIN_COLS)
 	{
-		THROW(FileParseException, "VCF data line needs at least 8 tab-separated columns! Found " + QString::number(line_parts.count()) + " column(s) in line number " + QString::number(line_number) + ": " + line);
+		THROW(FileParseException, "VCF data line needs at least 8 tab-separated columns! Found " + QString::number(column_count) + " column(s) in line number " + QString::number(line_number) + ": " + line);
 	}
 
 	VcfLine vcf_line;
@@ -152,7 +192,26 @@ void VcfFile::parseVcfEntry(int line_number, const QByteArray& line, QSet<QByteA
 	}
 
 	//INFO
-	if(line_parts[INFO]!=".")
+	if(line_parts[INFO]!="." && lazy_decoding_)
+	{
+		//only add keys missing in the header, values are decoded when accessed
+		const QByteArray& info_column = line_parts[INFO];
+		int start = 0;
+		while (start<=info_column.size())
+		{
+			int end = info_column.indexOf(';', start);
+			if (end==-1) end = info_column.size();
+			int sep_index = info_column.indexOf('=', start);
+			if (sep_index==-1 || sep_index>end) sep_index = end;
+			const QByteArray key = QByteArray::fromRawData(info_column.constData() + start, sep_index - start);
+			if(!info_ids.contains(key))
+			{
+				addMissingInfoLine(strCache(QByteArray(key.constData(), key.size())), info_ids);
+			}
+			start = end + 1;
+		}
+	}
+	else if(line_parts[INFO]!=".")
 	{
 		QByteArrayList info_keys;
 		QByteArrayList info_values;
@@ -165,14 +224,7 @@ void VcfFile::parseVcfEntry(int line_number, const QByteArray& line, QSet<QByteA
 			//check if the info is known in header
 			if(!info_ids.contains(key))
 			{
-				InfoFormatLine new_info_line;
-				new_info_line.id = key;
-				new_info_line.number = strCache("1");
-				new_info_line.type = strCache("String");
-				new_info_line.description = strCache("no description available");
-				vcf_header_.addInfoLine(new_info_line);
-
-				info_ids.insert(key);
+				addMissingInfoLine(key, info_ids);
 			}
 
 			if(sep_index==-1) //Flag
@@ -190,7 +242,7 @@ void VcfFile::parseVcfEntry(int line_number, const QByteArray& line, QSet<QByteA
 	}
 
 	//FORMAT && SAMPLE
-	if(line_parts.count() >= 9)
+	if(column_count >= 9)
 	{
 		//parse format entries
 		bool is_first = true;
@@ -231,16 +283,32 @@ void VcfFile::parseVcfEntry(int line_number, const QByteArray& line, QSet<QByteA
 		vcf_line.setFormatKeys(strArrayCache(format_list));
 
 		//SAMPLE
-		if(line_parts.count() >= 10)
+		if(column_count >= 10)
 		{
-			int last_column_to_parse = allow_multi_sample ? line_parts.count() : 10;
+			int last_column_to_parse = allow_multi_sample ? column_count : 10;
 
-			if(allow_multi_sample && sampleIDs().count() != line_parts.count() - 9)
+			if(allow_multi_sample && sampleIDs().count() != column_count - 9)
 			{
-				THROW(FileParseException, "Number of samples in line (" + QString::number(line_parts.count() - 9) + ") not equal to number of samples in header (" + QString::number(sampleIDs().count()) + ")  in line " + QString::number(line_number) + ": " + line);
+				THROW(FileParseException, "Number of samples in line (" + QString::number(column_count - 9) + ") not equal to number of samples in header (" + QString::number(sampleIDs().count()) + ")  in line " + QString::number(line_number) + ": " + line);
 			}
 
-			for(int i = 9; i < last_column_to_parse; ++i)
+			//lazy decoding: sample columns are not decoded, but the number of entries is validated
+			if (lazy_decoding_)
+			{
+				int start = samples_start;
+				for(int i = 9; i < last_column_to_parse; ++i)
+				{
+					int end = raw_line.indexOf('\t', start);
+					if (end==-1) end = raw_line.size();
+					if(std::count(raw_line.constBegin() + start, raw_line.constBegin() + end, ':') + 1 != format_list.count())
+					{
+						THROW(FileParseException, "Sample column has different number of entries than defined in Format column for line " + QString::number(line_number) + ": " + line);
+					}
+					start = end + 1;
+				}
+			}
+
+			for(int i = 9; i < last_column_to_parse && !lazy_decoding_; ++i)
 			{
 				QByteArrayList sample_entries = line_parts[i].split(':');
 
@@ -265,12 +333,37 @@ void VcfFile::parseVcfEntry(int line_number, const QByteArray& line, QSet<QByteA
 		}
 	}
 
+	//keep raw line for lazy decoding
+	if (lazy_decoding_ && line_parts[INFO]==".") info_start = -1;
+	if (lazy_decoding_ && (info_start!=-1 || samples_start!=-1))
+	{
+		int samples_end = raw_line.size();
+		if (samples_start!=-1 && !allow_multi_sample)
+		{
+			int end = raw_line.indexOf('\t', samples_start);
+			if (end!=-1) samples_end = end;
+		}
+		vcf_line.setRawData(raw_line, info_start, info_end, samples_start, samples_end);
+	}
+
 	//set sample names
 	vcf_line.setSamplNames(sample_names_);
 
 	vcf_lines_.append(vcf_line);
 }
 
+void VcfFile::addMissingInfoLine(const QByteArray& key, QSet<QByteArray>& info_ids)
+{
+	InfoFormatLine new_info_line;
+	new_info_line.id = key;
+	new_info_line.number = strCache("1");
+	new_info_line.type = strCache("String");
+	new_info_line.description = strCache("no description available");
+	vcf_header_.addInfoLine(new_info_line);
+
+	info_ids.insert(key);
+}
+
 void VcfFile::processVcfLine(int& line_number, const QByteArray& line, QSet<QByteArray>& info_ids, QSet<QByteArray>& format_ids, QSet<QByteArray>& filter_ids, bool allow_multi_sample, ChromosomalIndex<BedFile>* roi_idx, bool invert)
 {
 	++line_number;
@@ -658,9 +751,18 @@ void VcfFile::storeLineInformation(QTextStream& stream, const VcfLine& line) con
 	{
 		stream << '\t' << line.formatKeys().join(':');
 
-		foreach(const QByteArrayList& sample_entry, line.samples())
+		//sample columns that were not decoded (lazy decoding) are written as they were read
+		const QByteArray raw_samples = line.rawSamples();
+		if (!raw_samples.isEmpty())
 		{
-			stream << '\t' << (sample_entry.empty() ? "." : sample_entry.join(':'));
+			stream << '\t' << raw_samples;
+		}
+		else
+		{
+			foreach(const QByteArrayList& sample_entry, line.samples())
+			{
+				stream << '\t' << (sample_entry.empty() ? "." : sample_entry.join(':'));
+			}
 		}
 	}
 
@@ -61,6 +61,17 @@ public:
 	void leftNormalize(QString reference_genome);
 	///Right-normalize every VCF line in the vcf file according to a reference genome
 	void rightNormalize(QString reference_genome);
+	///Enables lazy decoding for loading: INFO and sample columns are kept as raw text and decoded when accessed for the first time. Untouched sample columns are written as they were read. The number of entries of sample columns is still validated against FORMAT during loading. Recommended for large multi-sample files if only some columns are needed.
+	///Note: errors in sample columns are reported when the columns are decoded. Decoding modifies the line, i.e. lines must be accessed by one thread only until they are decoded.
+	void setLazyDecoding(bool lazy_decoding)
+	{
+		lazy_decoding_ = lazy_decoding;
+	}
+	///Returns if lazy decoding is enabled for loading.
+	bool lazyDecoding() const
+	{
+		return lazy_decoding_;
+	}
 	///Load a VCF file
 	void load(const QString& filename, bool allow_multi_sample = true);
 	///Load part of a VCF file defied by a region (inside the region of invert=false and outside the region otherwise)
@@ -139,12 +150,14 @@ private:
 	void parseHeaderFields(const QByteArray& line, bool allow_multi_sample);
 	void parseVcfEntry(int line_number, const QByteArray& line, QSet<QByteArray>& info_ids, QSet<QByteArray>& format_ids, QSet<QByteArray>& filter_ids, bool allow_multi_sample, ChromosomalIndex<BedFile>* roi_idx, bool invert=false);
 	void parseVcfHeader(int line_number, const QByteArray& line);
+	void addMissingInfoLine(const QByteArray& key, QSet<QByteArray>& info_ids);
 	void processVcfLine(int& line_number, const QByteArray& line, QSet<QByteArray>& info_ids, QSet<QByteArray>& format_ids, QSet<QByteArray>& filter_ids, bool allow_multi_sample, ChromosomalIndex<BedFile>* roi_idx, bool invert=false);
 	void storeLineInformation(QTextStream& stream, const VcfLine& line) const;
 
 	QList<VcfLine> vcf_lines_; //variant lines
 	VcfHeader vcf_header_; //all informations from header
 	QByteArrayList sample_names_;
+	bool lazy_decoding_;
 
 	//INFO/FORMAT/FILTER definition line for VCFCHECK only
 	struct DefinitionLine
@@ -223,6 +236,8 @@ private:
 	};
 	//for using the parse functions in testing
 	friend class VcfLine_Test;
+	//for lazy decoding of INFO and sample columns
+	friend class VcfLine;
 
 	//storing all QByteArrays in a list of unique QByteArrays
 	static const QByteArray& strCache(const QByteArray& str);
@@ -1,4 +1,5 @@
 #include "VcfLine.h"
+#include "VcfFile.h"
 #include "Helper.h"
 #include "Log.h"
 #include "VariantList.h"
@@ -13,6 +14,11 @@ VcfLine::VcfLine()
 	, filters_()
 	, info_()
 	, sample_values_()
+	, raw_()
+	, raw_info_start_(-1)
+	, raw_info_end_(-1)
+	, raw_samples_start_(-1)
+	, raw_samples_end_(-1)
 {
 }
 
@@ -29,6 +35,11 @@ VcfLine::VcfLine(const Chromosome& chr, int pos, const Sequence& ref, const QLis
 	, sample_names_(sample_ids)
 	, format_keys_(format_ids)
 	, sample_values_(list_of_format_values)
+	, raw_()
+	, raw_info_start_(-1)
+	, raw_info_end_(-1)
+	, raw_samples_start_(-1)
+	, raw_samples_end_(-1)
 {
 	if(list_of_format_values.size() != sample_ids.size())
 	{
@@ -38,6 +49,9 @@ VcfLine::VcfLine(const Chromosome& chr, int pos, const Sequence& ref, const QLis
 
 void VcfLine::setInfo(const QByteArrayList& info_keys, const QByteArrayList& info_values)
 {
+	raw_info_start_ = -1;
+	if (raw_samples_start_==-1) raw_.clear();
+
 	info_keys_ = info_keys;
 	info_ = info_values;
 
@@ -46,11 +60,81 @@ void VcfLine::setInfo(const QByteArrayList& info_keys, const QByteArrayList& inf
 
 void VcfLine::addFormatValues(const QByteArrayList& format_values)
 {
+	if (raw_samples_start_!=-1) decodeSamples();
 	sample_values_.push_back(format_values);
 
 	if (format_values.count()!=format_keys_.count()) THROW(ProgrammingException, "Format keys and values have differing counts: " + QString::number(format_keys_.count()) + " / " + QString::number(format_values.count()));
 }
 
+void VcfLine::setRawData(const QByteArray& line, int info_start, int info_end, int samples_start, int samples_end)
+{
+	raw_ = line;
+	raw_info_start_ = info_start;
+	raw_info_end_ = info_end;
+	raw_samples_start_ = samples_start;
+	raw_samples_end_ = samples_end;
+
+	info_keys_.clear();
+	info_.clear();
+	sample_values_.clear();
+}
+
+void VcfLine::decodeInfo() const
+{
+	QByteArrayList info_keys;
+	QByteArrayList info_values;
+	foreach(const QByteArray& info, raw_.mid(raw_info_start_, raw_info_end_ - raw_info_start_).split(';'))
+	{
+		int sep_index = info.indexOf('=');
+		if(sep_index==-1) //Flag
+		{
+			info_keys.push_back(VcfFile::strCache(info));
+			info_values.push_back(VcfFile::strCache("TRUE"));
+		}
+		else //other types
+		{
+			info_keys.push_back(VcfFile::strCache(info.left(sep_index)));
+			info_values.push_back(VcfFile::strCache(info.mid(sep_index+1)));
+		}
+	}
+	info_keys_ = VcfFile::strArrayCache(info_keys);
+	info_ = VcfFile::strArrayCache(info_values);
+
+	raw_info_start_ = -1;
+	if (raw_samples_start_==-1) raw_.clear();
+}
+
+void VcfLine::decodeSamples() const
+{
+	QList<QByteArrayList> sample_values;
+	int start = raw_samples_start_;
+	while (true)
+	{
+		int end = raw_.indexOf('\t', start);
+		if (end==-1 || end>raw_samples_end_) end = raw_samples_end_;
+
+		QByteArrayList sample_entries = raw_.mid(start, end - start).split(':');
+
+		//SAMPLE columns can have missing trailing entries, but can not have more than specified in FORMAT
+		if(sample_entries.count()!=format_keys_.count())
+		{
+			THROW(FileParseException, "Sample column has different number of entries than defined in Format column for variant " + toString());
+		}
+		for(int i=0; i<sample_entries.count(); ++i)
+		{
+			sample_entries[i] = VcfFile::strCache(sample_entries[i]);
+		}
+		sample_values.push_back(VcfFile::strArrayCache(sample_entries));
+
+		if (end==raw_samples_end_) break;
+		start = end + 1;
+	}
+	sample_values_ = sample_values;
+
+	raw_samples_start_ = -1;
+	if (raw_info_start_==-1) raw_.clear();
+}
+
 
 const QByteArrayList VcfHeader::InfoTypes = {"Integer", "Float", "Flag", "Character", "String"};
 const QByteArrayList VcfHeader::FormatTypes =  {"Integer", "Float", "Character", "String"};
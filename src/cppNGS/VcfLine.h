@@ -226,12 +226,14 @@ public:
 	//Returns a list of all info IDs
 	const QList<QByteArray>& infoKeys() const
 	{
+		if (raw_info_start_!=-1) decodeInfo();
 		return info_keys_;
 	}
 
 	//Returns the value for an info ID as key
 	const QByteArray& info(const QByteArray& key, bool error_if_key_absent = false) const
 	{
+		if (raw_info_start_!=-1) decodeInfo();
 		int info_pos = info_keys_.indexOf(key);
 		if(info_pos==-1)
 		{
@@ -247,11 +249,13 @@ public:
 	///Returns a list, which stores for every sample a list of the values for every format ID
 	const QList<QByteArrayList>& samples() const
 	{
+		if (raw_samples_start_!=-1) decodeSamples();
 		return sample_values_;
 	}
 	///Returns a list of all values for every format ID for the sample sample_name
 	const QByteArrayList& sample(const QByteArray& sample_name) const
 	{
+		if (raw_samples_start_!=-1) decodeSamples();
 		int pos = sample_names_.indexOf(sample_name);
 		if(pos >= sample_values_.count()) THROW(ArgumentException, "Sample name " + sample_name + " not found in VCF sample name list!");
 
@@ -260,12 +264,14 @@ public:
 	///Returns a list of all values for every format ID for the sample at position pos
 	const QByteArrayList& sample(int pos) const
 	{
+		if (raw_samples_start_!=-1) decodeSamples();
 		if(pos >= sample_values_.count()) THROW(ArgumentException, QString::number(pos) + " is out of range for SAMPLES. The VCF file provides " + QString::number(samples().size()) + " SAMPLES");
 		return sample_values_.at(pos);
 	}
 	///Returns the value for a format and sample ID
 	const QByteArray& formatValueFromSample(const QByteArray& format_key, const QByteArray& sample_name) const
 	{
+		if (raw_samples_start_!=-1) decodeSamples();
 		int sample_pos = sample_names_.indexOf(sample_name);
 		int format_pos = format_keys_.indexOf(format_key);
 		//qDebug() << sample_pos << format_pos << sample_names_ << format_keys_;
@@ -281,6 +287,7 @@ public:
 	///Returns the value for a format ID and sample position (default is first sample)
 	const QByteArray& formatValueFromSample(const QByteArray& format_key, int sample_pos = 0) const
 	{
+		if (raw_samples_start_!=-1) decodeSamples();
 		if(sample_pos >= samples().size()) THROW(ArgumentException, QString::number(sample_pos) + " is out of range for SAMPLES. The VCF file provides " + QString::number(samples().size()) + " SAMPLES");
 
 		int format_pos = format_keys_.indexOf(format_key);
@@ -363,6 +370,7 @@ public:
 	//Sets format keys
 	void setFormatKeys(const QByteArrayList& keys)
 	{
+		if (raw_samples_start_!=-1) decodeSamples();
 		format_keys_ = keys;
 	}
 	//Set the list, which stores for every sample a list of all format values
@@ -371,6 +379,14 @@ public:
 		sample_names_ = sample_names;
 	}
 	void addFormatValues(const QByteArrayList& format_values);
+	//Sets the raw line for lazy decoding: the INFO column and the sample columns are given as ranges [start, end) in the line and are decoded when accessed for the first time. Use -1 as start if the column is not present.
+	void setRawData(const QByteArray& line, int info_start, int info_end, int samples_start, int samples_end);
+	//Returns the raw sample columns if they were not decoded yet (lazy decoding) or an empty array otherwise. The data is not copied, i.e. it is only valid as long as the line is not modified.
+	QByteArray rawSamples() const
+	{
+		if (raw_samples_start_==-1) return QByteArray();
+		return QByteArray::fromRawData(raw_.constData() + raw_samples_start_, raw_samples_end_ - raw_samples_start_);
+	}
 
 	//Overlap check for chromosome and position range.
 	bool overlapsWith(const Chromosome& input_chr, int input_start, int input_end) const
@@ -463,11 +479,23 @@ private:
 
 	QByteArrayList filters_; //list of filter entries. ATTENTION: PASS is contained
 
-	QByteArrayList info_keys_;
-	QByteArrayList info_;
+	mutable QByteArrayList info_keys_;
+	mutable QByteArrayList info_;
 
 	QByteArrayList sample_names_;
 
 	QByteArrayList format_keys_;
-	QList<QByteArrayList> sample_values_;
+	mutable QList<QByteArrayList> sample_values_;
+
+	//raw line for lazy decoding (shared between copies of the line, released when INFO and samples are decoded)
+	mutable QByteArray raw_;
+	mutable int raw_info_start_;
+	int raw_info_end_;
+	mutable int raw_samples_start_;
+	int raw_samples_end_;
+
+	//Decodes the INFO column from the raw line.
+	void decodeInfo() const;
+	//Decodes the sample columns from the raw line.
+	void decodeSamples() const;
 };
@@ -1,12 +1,12 @@
-#ifndef WORKERAVERAGECOVERAGE_H
-#define WORKERAVERAGECOVERAGE_H
+#ifndef WORKERAVERAGECOVERAGECHR_H
+#define WORKERAVERAGECOVERAGECHR_H
 
 #include <QRunnable>
 #include "BedFile.h"
 #include "Exceptions.h"
 
-//Coverage calculation worker using random-access
-class WorkerAverageCoverage
+//Coverage calculation worker using a chromosome-wise sweep
+class WorkerAverageCoverageChr
 	: public QRunnable
 {
 public:
@@ -31,7 +31,7 @@ public:
 		}
 	};
 
-	WorkerAverageCoverage(Chunk& chunk, QString bam_file, int min_mapq, int decimals, QString ref_file, bool debug);
+	WorkerAverageCoverageChr(Chunk& chunk, QString bam_file, int min_mapq, int decimals, QString ref_file, bool debug);
 	virtual void run() override;
 
 private:
@@ -42,22 +42,4 @@ private:
 	QString ref_file_;
 	bool debug_;
 };
-
-//Coverage calculation worker using a chromosome-wise sweep
-class WorkerAverageCoverageChr
-	: public QRunnable
-{
-public:
-
-	WorkerAverageCoverageChr(WorkerAverageCoverage::Chunk& chunk, QString bam_file, int min_mapq, int decimals, QString ref_file, bool debug);
-	virtual void run() override;
-
-private:
-	WorkerAverageCoverage::Chunk& chunk_;
-	QString bam_file_;
-	int min_mapq_;
-	int decimals_;
-	QString ref_file_;
-	bool debug_;
-};
-#endif // WORKERAVERAGECOVERAGE_H
+#endif // WORKERAVERAGECOVERAGECHR_H
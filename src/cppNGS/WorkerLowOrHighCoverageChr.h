@@ -1,12 +1,12 @@
-#ifndef WORKERLOWORHIGHCOVERAGE_H
-#define WORKERLOWORHIGHCOVERAGE_H
+#ifndef WORKERLOWORHIGHCOVERAGECHR_H
+#define WORKERLOWORHIGHCOVERAGECHR_H
 
 #include <QRunnable>
 #include "BedFile.h"
 #include "BamReader.h"
 #include "ChromosomalIndex.h"
 
-class WorkerLowOrHighCoverage : public QRunnable
+class WorkerLowOrHighCoverageChr : public QRunnable
 {
 public:
 	struct Chunk
@@ -30,30 +30,11 @@ public:
 		}
 	};
 
-	WorkerLowOrHighCoverage(Chunk& bed_chunk, QString bam_file, int cutoff, int min_mapq, int min_baseq, QString ref_file, bool is_high, bool debug);
+	WorkerLowOrHighCoverageChr(Chunk& bed_chunk, const ChromosomalIndex<BedFile>& bed_index, QString bam_file, int cutoff, int min_mapq, int min_baseq, QString ref_file, bool is_high, bool debug);
 	virtual void run() override;
 
 private:
 	Chunk& chunk_;
-	QString bam_file_;
-	int cutoff_;
-	int min_mapq_;
-	int min_baseq_;
-	QString ref_file_;
-	bool is_high_;
-	bool debug_;
-};
-
-
-class WorkerLowOrHighCoverageChr : public QRunnable
-{
-public:
-
-	WorkerLowOrHighCoverageChr(WorkerLowOrHighCoverage::Chunk& bed_chunk, const ChromosomalIndex<BedFile>& bed_index, QString bam_file, int cutoff, int min_mapq, int min_baseq, QString ref_file, bool is_high, bool debug);
-	virtual void run() override;
-
-private:
-	WorkerLowOrHighCoverage::Chunk& chunk_;
 	const ChromosomalIndex<BedFile>& bed_index_;
 	QString bam_file_;
 	int cutoff_;
@@ -65,4 +46,4 @@ private:
 };
 
 
-#endif // WORKERLOWORHIGHCOVERAGE_H
+#endif // WORKERLOWORHIGHCOVERAGECHR_H
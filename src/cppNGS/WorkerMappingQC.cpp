@@ -0,0 +1,369 @@
+#include "WorkerMappingQC.h"
+#include <QThreadPool>
+
+void WorkerMappingQC::Shard::merge(const Shard& rhs)
+{
+	al_total += rhs.al_total;
+	al_mapped += rhs.al_mapped;
+	al_ontarget += rhs.al_ontarget;
+	al_neartarget += rhs.al_neartarget;
+	al_ontarget_raw += rhs.al_ontarget_raw;
+	al_dup += rhs.al_dup;
+	al_proper_paired += rhs.al_proper_paired;
+	bases_mapped += rhs.bases_mapped;
+	bases_clipped += rhs.bases_clipped;
+	insert_size_sum += rhs.insert_size_sum;
+	bases_usable += rhs.bases_usable;
+	bases_usable_raw += rhs.bases_usable_raw;
+	for (int i=0; i<bases_usable_dp.count(); ++i)
+	{
+		bases_usable_dp[i] += rhs.bases_usable_dp[i];
+	}
+	for (int i=0; i<insert_size_counts.count(); ++i)
+	{
+		insert_size_counts[i] += rhs.insert_size_counts[i];
+	}
+	for (int i=0; i<dp_counts.count(); ++i)
+	{
+		dp_counts[i] += rhs.dp_counts[i];
+	}
+	for (int bin=0; bin<gc_read_counts.count(); ++bin)
+	{
+		const QVector<long long>& rhs_counts = rhs.gc_read_counts[bin];
+		QVector<long long>& counts = gc_read_counts[bin];
+		if (counts.count()<rhs_counts.count()) counts.resize(rhs_counts.count());
+		for (int n=0; n<rhs_counts.count(); ++n)
+		{
+			counts[n] += rhs_counts[n];
+		}
+	}
+	paired_end |= rhs.paired_end;
+
+	//the reads of 'rhs' come after our reads, i.e. the maximum read length up to them is at least our maximum read length
+	for (auto it=rhs.max_length_counts.cbegin(); it!=rhs.max_length_counts.cend(); ++it)
+	{
+		max_length_counts[std::max(max_length, it.key())] += it.value();
+	}
+	max_length = std::max(max_length, rhs.max_length);
+	length_sum += rhs.length_sum;
+}
+
+long long WorkerMappingQC::Shard::basesTrimmed() const
+{
+	long long output = 0;
+	for (auto it=max_length_counts.cbegin(); it!=max_length_counts.cend(); ++it)
+	{
+		output += (long long)it.key() * it.value();
+	}
+	return output - length_sum;
+}
+
+QHash<int, double> WorkerMappingQC::Shard::gcReads() const
+{
+	QHash<int, double> output;
+	for (int bin=0; bin<gc_read_counts.count(); ++bin)
+	{
+		const QVector<long long>& counts = gc_read_counts[bin];
+		for (int n=1; n<counts.count(); ++n)
+		{
+			if (counts[n]==0) continue;
+			output[bin] += (double)counts[n] / n;
+		}
+	}
+	return output;
+}
+
+WorkerMappingQC::WorkerMappingQC(Shard& shard, const Data& data)
+	: QRunnable()
+	, shard_(shard)
+	, data_(data)
+	, roi_near_cursor_(data.roi_cursor)
+	, roi_cursor_(data.roi_cursor)
+	, dropout_cursor_(data.dropout_cursor)
+{
+}
+
+void WorkerMappingQC::run()
+{
+	try
+	{
+		BamReader reader(data_.bam_file, data_.ref_file);
+
+		if (data_.mode==TARGET_REGIONS)
+		{
+			for (int i=shard_.roi_start; i<=shard_.roi_end; ++i)
+			{
+				processTargetRegion(reader, i);
+			}
+			return;
+		}
+
+		long long max_length_count = 0;
+		BamAlignment al;
+		if (shard_.regions.isEmpty() && !shard_.unmapped) //whole file
+		{
+			while (reader.getNextAlignment(al))
+			{
+				if (al.isSecondaryAlignment() || al.isSupplementaryAlignment()) continue;
+				processAlignment(al, reader, max_length_count);
+			}
+		}
+		else
+		{
+			for (int r=0; r<shard_.regions.count(); ++r)
+			{
+				const BedLine& region = shard_.regions[r];
+				reader.setRegion(region.chr(), region.start(), region.end());
+				while (reader.getNextAlignment(al))
+				{
+					if (al.isSecondaryAlignment() || al.isSupplementaryAlignment()) continue;
+
+					//alignments that start before the region belong to the previous region
+					if (al.start()<region.start()) continue;
+
+					processAlignment(al, reader, max_length_count);
+				}
+			}
+
+			if (shard_.unmapped)
+			{
+				reader.setRegionUnmapped();
+				while (reader.getNextAlignment(al))
+				{
+					if (al.isSecondaryAlignment() || al.isSupplementaryAlignment()) continue;
+					processAlignment(al, reader, max_length_count);
+				}
+			}
+		}
+
+		if (max_length_count>0) shard_.max_length_counts[shard_.max_length] += max_length_count;
+	}
+	catch(Exception& e)
+	{
+		shard_.error = e.message();
+	}
+	catch(std::exception& e)
+	{
+		shard_.error = e.what();
+	}
+	catch(...)
+	{
+		shard_.error = "Unknown exception!";
+	}
+}
+
+void WorkerMappingQC::processAlignment(const BamAlignment& al, const BamReader& reader, long long& max_length_count)
+{
+	++shard_.al_total;
+
+	//maximum read length up to this read (for trimmed bases)
+	if (al.length()>shard_.max_length)
+	{
+		if (max_length_count>0) shard_.max_length_counts[shard_.max_length] += max_length_count;
+		shard_.max_length = al.length();
+		max_length_count = 0;
+	}
+	++max_length_count;
+	shard_.length_sum += al.length();
+
+	//track if spliced alignment
+	bool spliced_alignment = false;
+
+	if (!al.isUnmapped())
+	{
+		++shard_.al_mapped;
+
+		//calculate soft/hard-clipped bases
+		const int start_pos = al.start();
+		const int end_pos = al.end();
+		shard_.bases_mapped += al.length();
+		for (const CigarOp& op : al.cigarView())
+		{
+			if (op.Type==BAM_CSOFT_CLIP || op.Type==BAM_CHARD_CLIP)
+			{
+				shard_.bases_clipped += op.Length;
+			}
+			else if (op.Type==BAM_CREF_SKIP)
+			{
+				spliced_alignment = true;
+			}
+		}
+
+		const Chromosome& chr = reader.chromosome(al.chromosomeID());
+		if (data_.mode==GENOME)
+		{
+			//usable
+			if (chr.isNonSpecial())
+			{
+				++shard_.al_ontarget;
+
+				if (!al.isDuplicate() && al.mappingQuality()>=data_.min_mapq)
+				{
+					shard_.bases_usable += al.length();
+				}
+			}
+		}
+		else
+		{
+			//calculate usable bases, base-resolution coverage and GC statistics
+			if (roi_near_cursor_.overlaps(chr, start_pos-250, end_pos+250))
+			{
+				++shard_.al_neartarget;
+
+				//check if on target
+				if (roi_cursor_.matchingIndices(chr, start_pos, end_pos, roi_indices_)!=0)
+				{
+					++shard_.al_ontarget;
+					int dp = al.tagi("DP");
+					if (dp != 0)
+					{
+						++shard_.dp_counts[std::min(dp, 4)];
+						shard_.al_ontarget_raw += dp;
+					}
+
+					//calculate usable bases and base-resolution coverage on target region
+					if (!al.isDuplicate() && al.mappingQuality()>=data_.min_mapq)
+					{
+						foreach(int index, roi_indices_)
+						{
+							const BedLine& line = (*data_.roi)[index];
+							const int ol_start = std::max(line.start(), start_pos);
+							const int ol_end = std::min(line.end(), end_pos);
+							shard_.bases_usable += ol_end - ol_start + 1;
+							shard_.bases_usable_dp[std::min(dp, 4)] += ol_end - ol_start + 1;
+							shard_.bases_usable_raw += (long long)(ol_end - ol_start + 1)  * (dp + 1);
+							data_.roi_cov[index].incrementRegion(ol_start, ol_end);
+						}
+					}
+
+					//calculate GC statistics
+					dropout_cursor_.matchingIndices(chr, start_pos, end_pos, dropout_indices_);
+					addGcCounts(dropout_indices_);
+				}
+			}
+		}
+	}
+
+	//insert size
+	if (al.isPaired())
+	{
+		shard_.paired_end = true;
+
+		if (al.isProperPair())
+		{
+			++shard_.al_proper_paired;
+
+			//if alignment is spliced, exclude it from insert size calculation
+			if (!spliced_alignment)
+			{
+				int insert_size = std::min(abs(al.insertSize()), 999); //cap insert size at 1000
+				shard_.insert_size_sum += insert_size;
+				++shard_.insert_size_counts[insert_size];
+			}
+		}
+	}
+
+	if (al.isDuplicate())
+	{
+		++shard_.al_dup;
+	}
+}
+
+void WorkerMappingQC::processTargetRegion(BamReader& reader, int index)
+{
+	const BedLine& line = (*data_.roi)[index];
+	reader.setRegion(line.chr(), line.start(), line.end());
+
+	BamAlignment al;
+	while (reader.getNextAlignment(al))
+	{
+		//skip secondary alignments
+		if (al.isSecondaryAlignment() || al.isSupplementaryAlignment() || al.isUnmapped()) continue;
+
+		//calculate GC statistics
+		dropout_cursor_.matchingIndices(reader.chromosome(al.chromosomeID()), al.start(), al.end(), dropout_indices_);
+		addGcCounts(dropout_indices_);
+
+		if (!al.isDuplicate() && al.mappingQuality()>=data_.min_mapq)
+		{
+			//calculate usable bases and base-resolution coverage on target region
+			shard_.bases_usable += al.length();
+			data_.roi_cov[index].incrementRegion(al.start(), al.end());
+		}
+	}
+}
+
+void WorkerMappingQC::addGcCounts(const QVector<int>& indices)
+{
+	const int n = indices.count();
+	foreach(int index, indices)
+	{
+		int bin = data_.gc_index_to_bin_map->value(index, -1);
+		if (bin>=0)
+		{
+			QVector<long long>& counts = shard_.gc_read_counts[bin];
+			if (counts.count()<=n) counts.resize(n+1);
+			++counts[n];
+		}
+	}
+}
+
+QList<WorkerMappingQC::Shard> WorkerMappingQC::createShards(const QString& bam_file, const QString& ref_file, int shard_size, bool split_chromosomes)
+{
+	BamReader reader(bam_file, ref_file);
+
+	QList<Shard> output;
+	Shard current;
+	long long current_size = 0;
+	foreach(const Chromosome& chr, reader.chromosomes())
+	{
+		const int chr_size = reader.chromosomeSize(chr);
+		int start = 1;
+		while (start<=chr_size)
+		{
+			int end = split_chromosomes ? std::min(chr_size, start + shard_size - 1) : chr_size;
+			current.regions.append(BedLine(chr, start, end));
+			current_size += end - start + 1;
+			if (current_size>=shard_size)
+			{
+				output << current;
+				current = Shard();
+				current_size = 0;
+			}
+			start = end + 1;
+		}
+	}
+
+	//reads without coordinate are at the end of the file
+	current.unmapped = true;
+	output << current;
+
+	return output;
+}
+
+WorkerMappingQC::Shard WorkerMappingQC::runShards(QList<Shard>& shards, const Data& data, int threads)
+{
+	//run shards
+	QThreadPool thread_pool;
+	thread_pool.setMaxThreadCount(threads);
+	for (int i=0; i<shards.count(); ++i)
+	{
+		thread_pool.start(new WorkerMappingQC(shards[i], data));
+	}
+	thread_pool.waitForDone();
+
+	//check if error occured
+	foreach(const Shard& shard, shards)
+	{
+		if (!shard.error.isEmpty()) THROW(Exception, shard.error);
+	}
+
+	//merge counts in file order
+	Shard output;
+	foreach(const Shard& shard, shards)
+	{
+		output.merge(shard);
+	}
+
+	return output;
+}
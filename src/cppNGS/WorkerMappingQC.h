@@ -0,0 +1,182 @@
+#ifndef WORKERMAPPINGQC_H
+#define WORKERMAPPINGQC_H
+
+#include <QRunnable>
+#include <QVector>
+#include <QHash>
+#include <QMap>
+#include "BedFile.h"
+#include "BamReader.h"
+#include "BedFileSweepCursor.h"
+#include "Exceptions.h"
+
+//Base-resolution depth of a target region
+class RegionDepth
+{
+public:
+	RegionDepth(Chromosome chr, int start, int end):
+	  chr_(chr)
+	, start_(start)
+	, end_(end)
+	{
+		depth_ = QVector<int>(end_-start_+1);
+		depth_.fill(0);
+	}
+
+	//for QContainers
+	RegionDepth()
+	{
+		chr_ = Chromosome();
+		start_ = -1;
+		end_ = -1;
+		depth_ = QVector<int>();
+	}
+
+	void incrementRegion(int start, int end)
+	{
+		int idx_start = std::max(start, start_) - start_;
+		int idx_end = std::min(end, end_) - start_;
+		for (int i=idx_start; i<=idx_end; ++i)
+		{
+			depth_[i] += 1;
+		}
+	}
+
+	//read access
+	int operator[](int pos) const
+	{
+		if (pos < start_ || end_ < pos)
+		{
+			THROW(ArgumentException, "Access outside of valid region. Position " + QString::number(pos) + " not in region: " + QString::number(start_) + "-"  + QString::number(end_) + ".");
+		}
+
+		return depth_[pos-start_];
+	}
+
+	//Interface for ChromosomalIndex
+	const Chromosome& chr() const
+	{
+		return chr_;
+	}
+
+	int start() const
+	{
+		return start_;
+	}
+
+	int end() const
+	{
+		return end_;
+	}
+
+	int count() const
+	{
+		return end_-start_+1;
+	}
+
+private:
+	Chromosome chr_;
+	int start_;
+	int end_;
+	QVector<int> depth_;
+};
+
+//Mapping QC worker that processes one shard of a BAM/CRAM file.
+//The counts of all shards are merged in file order, which yields exactly the same result as a serial run.
+class WorkerMappingQC
+	: public QRunnable
+{
+public:
+	enum Mode
+	{
+		GENOME, //whole genome without target region
+		TARGET, //target region (panel, exome, etc.)
+		TARGET_REGIONS //target regions are processed by random access (WGS)
+	};
+
+	//Read-only data shared by all shards
+	struct Data
+	{
+		Mode mode;
+		QString bam_file;
+		QString ref_file;
+		int min_mapq;
+
+		//target region data (not used in GENOME mode)
+		const BedFile* roi = nullptr;
+		BedFileSweepCursor roi_cursor; //copied by each shard
+		BedFileSweepCursor dropout_cursor; //copied by each shard
+		const QHash<int, int>* gc_index_to_bin_map = nullptr;
+		RegionDepth* roi_cov = nullptr; //written by shards, but each region is written by one shard only
+	};
+
+	//Shard definition and the counts accumulated for it
+	struct Shard
+	{
+		//input: regions of the shard - alignments are assigned to the region that contains their start position. If empty, the whole file is processed.
+		BedFile regions;
+		//input: if alignments without coordinate are processed
+		bool unmapped = false;
+		//input: range of target region indices (TARGET_REGIONS mode only)
+		int roi_start = -1;
+		int roi_end = -1;
+
+		//output
+		long long al_total = 0;
+		long long al_mapped = 0;
+		long long al_ontarget = 0;
+		long long al_neartarget = 0;
+		long long al_ontarget_raw = 0;
+		long long al_dup = 0;
+		long long al_proper_paired = 0;
+		long long bases_mapped = 0;
+		long long bases_clipped = 0;
+		long long insert_size_sum = 0;
+		long long bases_usable = 0;
+		long long bases_usable_raw = 0;
+		QVector<long long> bases_usable_dp = QVector<long long>(5, 0); //usable bases by duplication level
+		QVector<long long> insert_size_counts = QVector<long long>(1000, 0); //read count per insert size (capped at 999)
+		QVector<long long> dp_counts = QVector<long long>(5, 0); //read count per duplication level (capped at 4)
+		QVector<QVector<long long>> gc_read_counts = QVector<QVector<long long>>(101); //read count per GC bin and number of overlapping GC windows
+		bool paired_end = false;
+		int max_length = 0;
+		long long length_sum = 0;
+		QMap<int, long long> max_length_counts; //number of reads by maximum read length up to that read (needed for trimmed bases)
+		QString error; //In case of error
+
+		//Appends the counts of the given shard, which has to be the next shard in file order.
+		void merge(const Shard& rhs);
+		//Returns the number of trimmed bases, i.e. the sum of the difference between each read and the maximum read length seen up to that read.
+		long long basesTrimmed() const;
+		//Returns the GC bin values (reads are split equally between the GC windows they overlap).
+		QHash<int, double> gcReads() const;
+	};
+
+	WorkerMappingQC(Shard& shard, const Data& data);
+	virtual void run() override;
+
+	//Creates shards of the genome in file order (BAM/CRAM header order, followed by unmapped reads). Chromosomes are split into pieces of roughly @p shard_size bases if @p split_chromosomes is set.
+	static QList<Shard> createShards(const QString& bam_file, const QString& ref_file, int shard_size, bool split_chromosomes);
+	//Runs the shards in parallel and returns the merged counts. Throws an exception if a shard failed.
+	static Shard runShards(QList<Shard>& shards, const Data& data, int threads);
+
+private:
+	Shard& shard_;
+	const Data& data_;
+
+	//overlap cursors (alignments are processed in coordinate order)
+	BedFileSweepCursor roi_near_cursor_;
+	BedFileSweepCursor roi_cursor_;
+	BedFileSweepCursor dropout_cursor_;
+	QVector<int> roi_indices_;
+	QVector<int> dropout_indices_;
+
+	//processes one alignment
+	void processAlignment(const BamAlignment& al, const BamReader& reader, long long& max_length_count);
+	//processes one target region (TARGET_REGIONS mode)
+	void processTargetRegion(BamReader& reader, int index);
+	//adds a read to the GC bins of the overlapping GC windows
+	void addGcCounts(const QVector<int>& indices);
+};
+
+#endif // WORKERMAPPINGQC_H
@@ -37,6 +37,7 @@ LIBS += -lz
 QMAKE_LFLAGS += "-Wl,-rpath,\'\$$ORIGIN\'"
 
 SOURCES += BedFile.cpp \
+    BedFileSweepCursor.cpp \
     Chromosome.cpp \
     ClientHelper.cpp \
     RefGenomeService.cpp \
@@ -78,11 +79,21 @@ SOURCES += BedFile.cpp \
     ChainFileReader.cpp \
     BigWigReader.cpp \
     VariantHgvsAnnotator.cpp \
-    WorkerAverageCoverage.cpp \
-    WorkerLowOrHighCoverage.cpp \
+    WorkerAverageCoverageChr.cpp \
+    WorkerMappingQC.cpp \
+    CoverageCache.cpp \
+    CoverageMatrix.cpp \
+    MultiRegionCoverage.cpp \
+    VariantGeneIndex.cpp \
+    MultiSitePileup.cpp \
+    HtsThreadPool.cpp \
+    BamMateCache.cpp \
+    MatchKernels.cpp \
+    WorkerLowOrHighCoverageChr.cpp \
     PipelineSettings.cpp
 
 HEADERS += BedFile.h \
+    BedFileSweepCursor.h \
     Chromosome.h \
     ClientHelper.h \
     FileInfo.h \
@@ -91,6 +102,7 @@ HEADERS += BedFile.h \
     VariantImpact.h \
     VariantList.h \
     ChromosomalIndex.h \
+    ChromosomalIntervalTree.h \
     Statistics.h \
     Pileup.h \
     NGSHelper.h \
@@ -131,8 +143,17 @@ HEADERS += BedFile.h \
     ChainFileReader.h \
     BigWigReader.h \
     VariantHgvsAnnotator.h \
-    WorkerAverageCoverage.h \
-    WorkerLowOrHighCoverage.h \
+    WorkerAverageCoverageChr.h \
+    WorkerMappingQC.h \
+    CoverageCache.h \
+    CoverageMatrix.h \
+    MultiRegionCoverage.h \
+    VariantGeneIndex.h \
+    MultiSitePileup.h \
+    HtsThreadPool.h \
+    BamMateCache.h \
+    MatchKernels.h \
+    WorkerLowOrHighCoverageChr.h \
     PipelineSettings.h
 
 RESOURCES += \
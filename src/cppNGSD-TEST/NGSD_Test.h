@@ -3389,6 +3389,52 @@ private slots:
 		I_EQUAL(c_fail, 0);
 	}
 
+	void addVariants()
+	{
+		if (!NGSD::isAvailable(true)) SKIP("Test needs access to the NGSD test database!");
+
+		NGSD db(true);
+		db.init();
+
+		VariantList variants;
+		variants.load(TESTDATA("../tools-TEST/data_in/NGSDAddVariantsGermline_in2.GSvar"));
+
+		//first import: all variants are added
+		int c_add, c_update;
+		QList<int> ids = db.addVariants(variants, 1.0, c_add, c_update);
+		I_EQUAL(ids.count(), variants.count());
+		QSet<int> unique_ids = ids.toSet();
+		unique_ids.remove(-1);
+		I_EQUAL(c_add, unique_ids.count());
+		I_EQUAL(c_update, 0);
+		for (int i=0; i<variants.count(); ++i)
+		{
+			if (ids[i]==-1) continue;
+			I_EQUAL(ids[i], db.variantId(variants[i]).toInt());
+		}
+		I_EQUAL(db.getValue("SELECT count(*) FROM variant_literature").toInt(), 3);
+
+		//second import: nothing changes
+		QList<int> ids2 = db.addVariants(variants, 1.0, c_add, c_update);
+		IS_TRUE(ids2==ids);
+		I_EQUAL(c_add, 0);
+		I_EQUAL(c_update, 0);
+		I_EQUAL(db.getValue("SELECT count(*) FROM variant_literature").toInt(), 3);
+
+		//third import: meta data of one variant changed
+		int i_gnomad = variants.annotationIndexByName("gnomAD");
+		variants[0].annotations()[i_gnomad] = "0.1234";
+		ids2 = db.addVariants(variants, 1.0, c_add, c_update);
+		IS_TRUE(ids2==ids);
+		I_EQUAL(c_add, 0);
+		I_EQUAL(c_update, 1);
+		F_EQUAL(db.getValue("SELECT gnomad FROM variant WHERE id=" + QString::number(ids[0])).toDouble(), 0.1234);
+
+		//max AF
+		ids2 = db.addVariants(variants, 0.01, c_add, c_update);
+		I_EQUAL(ids2[0], -1);
+	}
+
 	void test_overriding_the_processed_sample_data_folder()
 	{
 		if (!NGSD::isAvailable(true)) SKIP("Test needs access to the NGSD test database!");
@@ -1371,19 +1371,25 @@ QString NGSD::addVariant(const Variant& variant, const VariantList& variant_list
 	return query.lastInsertId().toString();
 }
 
-QList<int> NGSD::addVariants(const VariantList& variant_list, double max_af, int& c_add, int& c_update)
+//Returns a key that uniquely identifies a variant in the 'variant' table
+static QByteArray variantKey(const QByteArray& chr, int start, int end, const QByteArray& ref, const QByteArray& obs)
 {
-	QList<int> output;
-
-	//prepare queried
-	SqlQuery q_id = getQuery();
-	q_id.prepare("SELECT id, gnomad, coding, cadd, spliceai FROM variant WHERE chr=:0 AND start=:1 AND end=:2 AND ref=:3 AND obs=:4");
-
-	SqlQuery q_update = getQuery(); //use binding (user input)
-	q_update.prepare("UPDATE variant SET gnomad=:0, coding=:1, cadd=:2, spliceai=:3 WHERE id=:4");
+	return chr + ':' + QByteArray::number(start) + '-' + QByteArray::number(end) + ' ' + ref + '>' + obs;
+}
 
-	SqlQuery q_insert = getQuery(); //use binding (user input)
-	q_insert.prepare("INSERT INTO variant (chr, start, end, ref, obs, gnomad, coding, cadd, spliceai) VALUES (:0,:1,:2,:3,:4,:5,:6,:7,:8) ON DUPLICATE KEY UPDATE id=id");
+QList<int> NGSD::addVariants(const VariantList& variant_list, double max_af, int& c_add, int& c_update)
+{
+	//variant data to import
+	struct VariantData
+	{
+		int index; //index in the variant list
+		QByteArray chr;
+		QByteArray key;
+		QByteArray gnomad;
+		QByteArray cadd;
+		double spliceai;
+		QByteArrayList pubmed_ids;
+	};
 
 	//get annotated column indices
 	int i_gnomad = variant_list.annotationIndexByName("gnomAD");
@@ -1392,90 +1398,207 @@ QList<int> NGSD::addVariants(const VariantList& variant_list, double max_af, int
 	int i_spliceai = variant_list.annotationIndexByName("SpliceAI");
 	int i_pubmed = variant_list.annotationIndexByName("PubMed", true, false);
 
-	c_add = 0;
-	c_update = 0;
+	//determine variants to import
+	QList<int> output;
+	QVector<VariantData> data;
+	data.reserve(variant_list.count());
 	for (int i=0; i<variant_list.count(); ++i)
 	{
 		const Variant& variant = variant_list[i];
+		output << -1;
 
 		//skip variants over 500 bases length - the unique index of the variant table does not work for those
-		if (variant.ref().count()>MAX_VARIANT_SIZE || variant.obs().count()>MAX_VARIANT_SIZE)
-		{
-			output << -1;
-			continue;
-		}
+		if (variant.ref().count()>MAX_VARIANT_SIZE || variant.obs().count()>MAX_VARIANT_SIZE) continue;
 
 		//skip variants with too high AF
 		QByteArray gnomad = variant.annotations()[i_gnomad].trimmed();
 		if (gnomad=="n/a") gnomad.clear();
-		if (!gnomad.isEmpty() && gnomad.toDouble()>max_af)
-		{
-			output << -1;
-			continue;
-		}
+		if (!gnomad.isEmpty() && gnomad.toDouble()>max_af) continue;
 
+		VariantData entry;
+		entry.index = i;
+		entry.chr = variant.chr().strNormalized(true);
+		entry.key = variantKey(entry.chr, variant.start(), variant.end(), variant.ref(), variant.obs());
+		entry.gnomad = gnomad;
+		entry.cadd = variant.annotations()[i_cadd].trimmed();
+		entry.spliceai = NGSHelper::maxSpliceAiScore(variant.annotations()[i_spliceai]);
+		if (i_pubmed > 0) entry.pubmed_ids = variant.annotations()[i_pubmed].split(',');
+		data << entry;
+	}
 
-		QByteArray cadd = variant.annotations()[i_cadd].trimmed();
-		double spliceai = NGSHelper::maxSpliceAiScore(variant.annotations()[i_spliceai]);
-		QByteArrayList pubmed_ids;
-		if (i_pubmed > 0) pubmed_ids = variant.annotations()[i_pubmed].split(',');
-
-		//get variant ID
-		q_id.bindValue(0, variant.chr().strNormalized(true));
-		q_id.bindValue(1, variant.start());
-		q_id.bindValue(2, variant.end());
-		q_id.bindValue(3, variant.ref());
-		q_id.bindValue(4, variant.obs());
-		q_id.exec();
-		if (q_id.next()) //update (common case)
-		{
-			int id = q_id.value(0).toInt();
-
-			//check if variant meta data needs to be updated
-			if (q_id.value(1).toByteArray().toDouble()!=gnomad.toDouble() //numeric comparison (NULL > "" > 0.0)
-				|| q_id.value(2).toByteArray()!=variant.annotations()[i_co_sp]
-				|| q_id.value(3).toByteArray().toDouble()!=cadd.toDouble() //numeric comparison (NULL > "" > 0.0)
-				|| q_id.value(4).toByteArray().toDouble()!=std::max(0.0, spliceai) //numeric comparison (NULL > "" > 0.0); no SpliceAI leads to a score of -1, so we use max to set it to 0.
-				)
-			{
-				q_update.bindValue(0, gnomad.isEmpty() ? QVariant() : gnomad);
-				q_update.bindValue(1, variant.annotations()[i_co_sp]);
-				q_update.bindValue(2, cadd.isEmpty() ? QVariant() : cadd);
-				q_update.bindValue(3, spliceai<0 ? QVariant() : spliceai);
-				q_update.bindValue(4, id);
-				q_update.exec();
-				++c_update;
+	//import variants in blocks: one query per block for ID lookup, insert, update and PubMed IDs (instead of several queries per variant)
+	const int block_size = 1000;
+	c_add = 0;
+	c_update = 0;
+	for (int block_start=0; block_start<data.count(); block_start+=block_size)
+	{
+		const int block_end = std::min(block_start + block_size, data.count());
+
+		//get IDs and meta data of variants already in NGSD
+		QHash<QByteArray, int> key2id;
+		QVector<int> updates;
+		QVector<int> inserts;
+		QSet<QByteArray> keys_handled; //variants can be contained several times in the input
+		{
+			QStringList placeholders;
+			for (int d=block_start; d<block_end; ++d) placeholders << "(?,?,?,?,?)";
+			SqlQuery q_id = getQuery(); //use binding (user input)
+			q_id.prepare("SELECT id, chr, start, end, ref, obs, gnomad, coding, cadd, spliceai FROM variant WHERE (chr, start, end, ref, obs) IN (" + placeholders.join(",") + ")");
+			int b = 0;
+			for (int d=block_start; d<block_end; ++d)
+			{
+				const Variant& variant = variant_list[data[d].index];
+				q_id.bindValue(b++, data[d].chr);
+				q_id.bindValue(b++, variant.start());
+				q_id.bindValue(b++, variant.end());
+				q_id.bindValue(b++, variant.ref());
+				q_id.bindValue(b++, variant.obs());
 			}
+			q_id.exec();
 
-			output << id;
+			QHash<QByteArray, int> key2row;
+			QVector<QVariantList> rows;
+			while (q_id.next())
+			{
+				QByteArray key = variantKey(q_id.value(1).toByteArray(), q_id.value(2).toInt(), q_id.value(3).toInt(), q_id.value(4).toByteArray(), q_id.value(5).toByteArray());
+				key2row[key] = rows.count();
+				rows << (QVariantList() << q_id.value(0) << q_id.value(6) << q_id.value(7) << q_id.value(8) << q_id.value(9));
+			}
+
+			for (int d=block_start; d<block_end; ++d)
+			{
+				const VariantData& entry = data[d];
+				if (keys_handled.contains(entry.key)) continue;
+				keys_handled << entry.key;
+
+				if (key2row.contains(entry.key)) //update (common case)
+				{
+					const QVariantList& row = rows[key2row[entry.key]];
+					key2id[entry.key] = row[0].toInt();
+
+					//check if variant meta data needs to be updated
+					if (row[1].toByteArray().toDouble()!=entry.gnomad.toDouble() //numeric comparison (NULL > "" > 0.0)
+						|| row[2].toByteArray()!=variant_list[entry.index].annotations()[i_co_sp]
+						|| row[3].toByteArray().toDouble()!=entry.cadd.toDouble() //numeric comparison (NULL > "" > 0.0)
+						|| row[4].toByteArray().toDouble()!=std::max(0.0, entry.spliceai) //numeric comparison (NULL > "" > 0.0); no SpliceAI leads to a score of -1, so we use max to set it to 0.
+						)
+					{
+						updates << d;
+					}
+				}
+				else //insert (rare case)
+				{
+					inserts << d;
+				}
+			}
 		}
-		else //insert (rare case)
-		{
-			q_insert.bindValue(0, variant.chr().strNormalized(true));
-			q_insert.bindValue(1, variant.start());
-			q_insert.bindValue(2, variant.end());
-			q_insert.bindValue(3, variant.ref());
-			q_insert.bindValue(4, variant.obs());
-			q_insert.bindValue(5, gnomad.isEmpty() ? QVariant() : gnomad);
-			q_insert.bindValue(6, variant.annotations()[i_co_sp]);
-			q_insert.bindValue(7, cadd.isEmpty() ? QVariant() : cadd);
-			q_insert.bindValue(8, spliceai<0 ? QVariant() : spliceai);
+
+		//update meta data of existing variants (multi-row insert of existing IDs updates the rows)
+		if (!updates.isEmpty())
+		{
+			QStringList placeholders;
+			for (int u=0; u<updates.count(); ++u) placeholders << "(?,?,?,?,?,?,?,?,?,?)";
+			SqlQuery q_update = getQuery(); //use binding (user input)
+			q_update.prepare("INSERT INTO variant (id, chr, start, end, ref, obs, gnomad, coding, cadd, spliceai) VALUES " + placeholders.join(",") + " ON DUPLICATE KEY UPDATE gnomad=VALUES(gnomad), coding=VALUES(coding), cadd=VALUES(cadd), spliceai=VALUES(spliceai)");
+			int b = 0;
+			foreach(int d, updates)
+			{
+				const VariantData& entry = data[d];
+				const Variant& variant = variant_list[entry.index];
+				q_update.bindValue(b++, key2id[entry.key]);
+				q_update.bindValue(b++, entry.chr);
+				q_update.bindValue(b++, variant.start());
+				q_update.bindValue(b++, variant.end());
+				q_update.bindValue(b++, variant.ref());
+				q_update.bindValue(b++, variant.obs());
+				q_update.bindValue(b++, entry.gnomad.isEmpty() ? QVariant() : entry.gnomad);
+				q_update.bindValue(b++, variant.annotations()[i_co_sp]);
+				q_update.bindValue(b++, entry.cadd.isEmpty() ? QVariant() : entry.cadd);
+				q_update.bindValue(b++, entry.spliceai<0 ? QVariant() : entry.spliceai);
+			}
+			q_update.exec();
+			c_update += updates.count();
+		}
+
+		//insert missing variants
+		if (!inserts.isEmpty())
+		{
+			QStringList placeholders;
+			for (int n=0; n<inserts.count(); ++n) placeholders << "(?,?,?,?,?,?,?,?,?)";
+			SqlQuery q_insert = getQuery(); //use binding (user input)
+			q_insert.prepare("INSERT INTO variant (chr, start, end, ref, obs, gnomad, coding, cadd, spliceai) VALUES " + placeholders.join(",") + " ON DUPLICATE KEY UPDATE id=id");
+			QStringList id_placeholders;
+			int b = 0;
+			foreach(int d, inserts)
+			{
+				const VariantData& entry = data[d];
+				const Variant& variant = variant_list[entry.index];
+				q_insert.bindValue(b++, entry.chr);
+				q_insert.bindValue(b++, variant.start());
+				q_insert.bindValue(b++, variant.end());
+				q_insert.bindValue(b++, variant.ref());
+				q_insert.bindValue(b++, variant.obs());
+				q_insert.bindValue(b++, entry.gnomad.isEmpty() ? QVariant() : entry.gnomad);
+				q_insert.bindValue(b++, variant.annotations()[i_co_sp]);
+				q_insert.bindValue(b++, entry.cadd.isEmpty() ? QVariant() : entry.cadd);
+				q_insert.bindValue(b++, entry.spliceai<0 ? QVariant() : entry.spliceai);
+				id_placeholders << "(?,?,?,?,?)";
+			}
 			q_insert.exec();
-			++c_add;
-			QVariant last_insert_id = q_insert.lastInsertId();
-			if (last_insert_id.isValid())
+			c_add += inserts.count();
+
+			//get IDs of inserted variants ("lastInsertId()" is not reliable for multi-row inserts and variants inserted by another query in the meantime)
+			SqlQuery q_id = getQuery(); //use binding (user input)
+			q_id.prepare("SELECT id, chr, start, end, ref, obs FROM variant WHERE (chr, start, end, ref, obs) IN (" + id_placeholders.join(",") + ")");
+			b = 0;
+			foreach(int d, inserts)
 			{
-				output << last_insert_id.toInt();
+				const Variant& variant = variant_list[data[d].index];
+				q_id.bindValue(b++, data[d].chr);
+				q_id.bindValue(b++, variant.start());
+				q_id.bindValue(b++, variant.end());
+				q_id.bindValue(b++, variant.ref());
+				q_id.bindValue(b++, variant.obs());
 			}
-			else //the variant was inserted by another query between checking and inserting here. Thus the insert statement was ignored. In this case "lastInsertId()" does not return the actual ID > we need to get the variant id manually
+			q_id.exec();
+			while (q_id.next())
 			{
-				output << variantId(variant).toInt();
+				key2id[variantKey(q_id.value(1).toByteArray(), q_id.value(2).toInt(), q_id.value(3).toInt(), q_id.value(4).toByteArray(), q_id.value(5).toByteArray())] = q_id.value(0).toInt();
 			}
 		}
-		foreach (const QByteArray pubmed_id, pubmed_ids)
+
+		//set output IDs and collect PubMed IDs
+		QStringList pubmed_placeholders;
+		QVariantList pubmed_values;
+		for (int d=block_start; d<block_end; ++d)
 		{
-			if (pubmed_id.isEmpty()) continue;
-			addPubmedId(output.last(), pubmed_id);
+			const VariantData& entry = data[d];
+			int id = key2id.value(entry.key, -1);
+			if (id==-1) //fallback in case the database normalizes values differently (e.g. case)
+			{
+				id = variantId(variant_list[entry.index]).toInt();
+				key2id[entry.key] = id;
+			}
+			output[entry.index] = id;
+
+			foreach (const QByteArray& pubmed_id, entry.pubmed_ids)
+			{
+				if (pubmed_id.isEmpty()) continue;
+				pubmed_placeholders << "(?,?)";
+				pubmed_values << id << pubmed_id;
+			}
+		}
+
+		//add PubMed IDs
+		if (!pubmed_placeholders.isEmpty())
+		{
+			SqlQuery q_pubmed = getQuery(); //use binding (user input)
+			q_pubmed.prepare("INSERT INTO `variant_literature` (`variant_id`, `pubmed`) VALUES " + pubmed_placeholders.join(",") + " ON DUPLICATE KEY UPDATE id=id");
+			for (int b=0; b<pubmed_values.count(); ++b)
+			{
+				q_pubmed.bindValue(b, pubmed_values[b]);
+			}
+			q_pubmed.exec();
 		}
 	}
 
@@ -82,5 +82,9 @@ private slots:
 		IS_TRUE(QFile::exists("out/BamClipOverlap_out6.bam"));
 		COMPARE_FILES("out/BamClipOverlap_Test_line81.log", TESTDATA("data_out/BamClipOverlap_out11.log"));
 	}
-};
 
+	void invalid_max_cache()
+	{
+		EXECUTE_FAIL("BamClipOverlap", "-in " + TESTDATA("data_in/BamClipOverlap_in1.bam") + " -out out/BamClipOverlap_out12.bam -max_cache 0");
+	}
+};
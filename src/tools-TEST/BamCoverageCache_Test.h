@@ -0,0 +1,56 @@
+#include "TestFramework.h"
+
+TEST_CLASS(BamCoverageCache_Test)
+{
+Q_OBJECT
+private slots:
+
+	void panel()
+	{
+		//copy BAM file to output folder (the cache is stored next to the BAM file)
+		QFile::remove("out/panel.bam");
+		QFile::remove("out/panel.bam.bai");
+		QFile::copy(TESTDATA("../cppNGS-TEST/data_in/panel.bam"), "out/panel.bam");
+		QFile::copy(TESTDATA("../cppNGS-TEST/data_in/panel.bam.bai"), "out/panel.bam.bai");
+
+		EXECUTE("BamCoverageCache", "-bam out/panel.bam -roi " + TESTDATA("../cppNGS-TEST/data_in/panel.bed"));
+		IS_TRUE(QFile::exists("out/panel.bam.cov"));
+
+		//cache is used: same results as with BAM file (the index is removed, i.e. the BAM file itself cannot be used)
+		QFile::remove("out/panel.bam.bai");
+		EXECUTE("BedLowCoverage", "-in " + TESTDATA("../cppNGS-TEST/data_in/panel.bed") + " -bam out/panel.bam -out out/BamCoverageCache_test01_out.bed -cutoff 20");
+		COMPARE_FILES("out/BamCoverageCache_test01_out.bed", TESTDATA("data_out/BedLowCoverage_test01_out.bed"));
+
+		EXECUTE("BedCoverage", "-in " + TESTDATA("../cppNGS-TEST/data_in/panel.bed") + " -bam out/panel.bam -out out/BamCoverageCache_test02_out.tsv");
+		COMPARE_FILES_DELTA("out/BamCoverageCache_test02_out.tsv", TESTDATA("data_out/BedCoverage_test01_out.tsv"), 1.0, true, '\t'); //delta because of macOS rounding problem
+
+		//cache is not used: different cutoffs (fails without index)
+		EXECUTE_FAIL("BedLowCoverage", "-in " + TESTDATA("../cppNGS-TEST/data_in/panel.bed") + " -bam out/panel.bam -out out/BamCoverageCache_test03_out.bed -cutoff 20 -min_mapq 20 -min_baseq 30");
+
+		//cache is not used: BAM file modified after the cache was created (fails without index)
+		QFile bam("out/panel.bam");
+		IS_TRUE(bam.open(QFile::ReadWrite));
+		IS_TRUE(bam.setFileTime(bam.fileTime(QFileDevice::FileModificationTime).addSecs(60), QFileDevice::FileModificationTime));
+		bam.close();
+		EXECUTE_FAIL("BedLowCoverage", "-in " + TESTDATA("../cppNGS-TEST/data_in/panel.bed") + " -bam out/panel.bam -out out/BamCoverageCache_test01_out.bed -cutoff 20");
+
+		//cache is not used: different cutoffs
+		QFile::copy(TESTDATA("../cppNGS-TEST/data_in/panel.bam.bai"), "out/panel.bam.bai");
+		EXECUTE("BedLowCoverage", "-in " + TESTDATA("../cppNGS-TEST/data_in/panel.bed") + " -bam out/panel.bam -out out/BamCoverageCache_test03_out.bed -cutoff 20 -min_mapq 20 -min_baseq 30");
+		COMPARE_FILES("out/BamCoverageCache_test03_out.bed", TESTDATA("data_out/BedLowCoverage_test03_out.bed"));
+	}
+
+	void panel_mq20_bq30()
+	{
+		QFile::remove("out/panel.bam");
+		QFile::remove("out/panel.bam.bai");
+		QFile::copy(TESTDATA("../cppNGS-TEST/data_in/panel.bam"), "out/panel.bam");
+		QFile::copy(TESTDATA("../cppNGS-TEST/data_in/panel.bam.bai"), "out/panel.bam.bai");
+
+		EXECUTE("BamCoverageCache", "-bam out/panel.bam -roi " + TESTDATA("../cppNGS-TEST/data_in/panel.bed") + " -min_mapq 20 -min_baseq 30 -threads 2");
+		QFile::remove("out/panel.bam.bai");
+
+		EXECUTE("BedLowCoverage", "-in " + TESTDATA("../cppNGS-TEST/data_in/panel.bed") + " -bam out/panel.bam -out out/BamCoverageCache_test04_out.bed -cutoff 20 -min_mapq 20 -min_baseq 30");
+		COMPARE_FILES("out/BamCoverageCache_test04_out.bed", TESTDATA("data_out/BedLowCoverage_test03_out.bed"));
+	}
+};
@@ -17,4 +17,10 @@ private slots:
 		COMPARE_GZ_FILES("out/BamFilter_out2.bam", TESTDATA("data_out/BamFilter_out2.bam"));
 	}
 
+	void test_03_threads()
+	{
+		EXECUTE("BamFilter", "-in " + TESTDATA("data_in/BamFilter_in1.bam") + " -out out/BamFilter_out3.bam -threads 4");
+		COMPARE_GZ_FILES("out/BamFilter_out3.bam", TESTDATA("data_out/BamFilter_out1.bam"));
+	}
+
 };
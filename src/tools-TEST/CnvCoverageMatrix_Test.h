@@ -0,0 +1,35 @@
+#include "TestFramework.h"
+
+TEST_CLASS(CnvCoverageMatrix_Test)
+{
+Q_OBJECT
+private:
+
+	static QByteArray fileContent(QString filename)
+	{
+		QFile file(filename);
+		if (!file.open(QFile::ReadOnly)) THROW(FileAccessException, "Could not open file " + filename);
+		return file.readAll();
+	}
+
+private slots:
+
+	void append()
+	{
+		//create in one go
+		QFile::remove("out/CnvCoverageMatrix_test01.bin");
+		EXECUTE("CnvCoverageMatrix", "-in " + TESTDATA("data_in/CnvReferenceCohort_in_ref1.cov") + " " + TESTDATA("data_in/CnvReferenceCohort_in_ref2.cov") + " " + TESTDATA("data_in/CnvReferenceCohort_in_ref3.cov.gz") + " -out out/CnvCoverageMatrix_test01.bin -threads 2");
+
+		//create by appending
+		QFile::remove("out/CnvCoverageMatrix_test02.bin");
+		EXECUTE("CnvCoverageMatrix", "-in " + TESTDATA("data_in/CnvReferenceCohort_in_ref1.cov") + " -out out/CnvCoverageMatrix_test02.bin");
+		EXECUTE("CnvCoverageMatrix", "-in " + TESTDATA("data_in/CnvReferenceCohort_in_ref2.cov") + " " + TESTDATA("data_in/CnvReferenceCohort_in_ref3.cov.gz") + " -out out/CnvCoverageMatrix_test02.bin -threads 2");
+
+		IS_TRUE(fileContent("out/CnvCoverageMatrix_test01.bin")==fileContent("out/CnvCoverageMatrix_test02.bin"));
+
+		//sample already contained (file is not modified)
+		EXECUTE_FAIL("CnvCoverageMatrix", "-in " + TESTDATA("data_in/CnvReferenceCohort_in_ref4.cov.gz") + " " + TESTDATA("data_in/CnvReferenceCohort_in_ref1.cov") + " -out out/CnvCoverageMatrix_test02.bin");
+		IS_TRUE(fileContent("out/CnvCoverageMatrix_test01.bin")==fileContent("out/CnvCoverageMatrix_test02.bin"));
+	}
+
+};
@@ -11,5 +11,16 @@ private slots:
 		COMPARE_FILES("out/CnvReferenceCohort_test01_out.tsv", TESTDATA("data_out/CnvReferenceCohort_test01_out.tsv"));
 		COMPARE_FILES("out/CnvReferenceCohort_Test_line10.log", TESTDATA("data_out/CnvReferenceCohort_out.log"));
 	}
+
+	void test_02()
+	{
+		QFile::remove("out/CnvReferenceCohort_test02.bin");
+		EXECUTE("CnvCoverageMatrix", "-in " + TESTDATA("data_in/CnvReferenceCohort_in_ref1.cov") + " " + TESTDATA("data_in/CnvReferenceCohort_in_ref2.cov") + " " + TESTDATA("data_in/CnvReferenceCohort_in_ref3.cov.gz") + " " + TESTDATA("data_in/CnvReferenceCohort_in_ref4.cov.gz") + " " + TESTDATA("data_in/CnvReferenceCohort_in_ref5.cov.gz") + " -out out/CnvReferenceCohort_test02.bin");
+
+		//same output as with reference files
+		EXECUTE("CnvReferenceCohort", "-in " + TESTDATA("data_in/CnvReferenceCohort_in.cov") + " -in_matrix out/CnvReferenceCohort_test02.bin -exclude " + TESTDATA("data_in/CnvReferenceCohort_exclude1.bed") + " " + TESTDATA("data_in/CnvReferenceCohort_exclude2.bed") + " " + TESTDATA("data_in/CnvReferenceCohort_exclude3.bed") + " -out out/CnvReferenceCohort_test02_out.tsv -cov_max 3 -threads 2");
+		COMPARE_FILES("out/CnvReferenceCohort_test02_out.tsv", TESTDATA("data_out/CnvReferenceCohort_test01_out.tsv"));
+		COMPARE_FILES("out/CnvReferenceCohort_Test_line21.log", TESTDATA("data_out/CnvReferenceCohort_out.log"));
+	}
 	
 };
@@ -22,4 +22,13 @@ private slots:
 		COMPARE_GZ_FILES("out/FastqConcat_out2.fastq.gz", TESTDATA("data_out/FastqConcat_out2.fastq.gz"));
 	}
 
+	void threads_test()
+	{
+		EXECUTE("FastqConcat", "-in " + TESTDATA("data_in/FastqConcat_in1.fastq.gz") + " "
+				+ TESTDATA("data_in/FastqConcat_in2.fastq.gz") + " "
+				+ TESTDATA("data_in/FastqConcat_in3.fastq.gz")
+				+ " -out out/FastqConcat_out3.fastq.gz -threads 4");
+		COMPARE_GZ_FILES("out/FastqConcat_out3.fastq.gz", TESTDATA("data_out/FastqConcat_out.fastq.gz"));
+	}
+
 };
@@ -0,0 +1,23 @@
+#include "TestFramework.h"
+#include "Settings.h"
+
+TEST_CLASS(GffToTranscriptDb_Test)
+{
+Q_OBJECT
+private slots:
+
+	void default_params()
+	{
+		QString ref_file = Settings::string("reference_genome", true);
+		if (ref_file=="") SKIP("Test needs the reference genome!");
+
+		EXECUTE("GffToTranscriptDb", "-in " + TESTDATA("data_in/VcfAnnotateConsequence_transcripts.gff3") + " -out out/GffToTranscriptDb_out1.transcripts");
+
+		//consequence annotation with transcript database is the same as with GFF file
+		EXECUTE("VcfAnnotateConsequence", "-in " + TESTDATA("data_in/VcfAnnotateConsequence_in1.vcf") + " -gff out/GffToTranscriptDb_out1.transcripts -out out/GffToTranscriptDb_out2.vcf -splice_region_in5 8 -splice_region_in3 8");
+		COMPARE_FILES("out/GffToTranscriptDb_out2.vcf", TESTDATA("data_out/VcfAnnotateConsequence_out1.vcf"));
+
+		//different settings
+		EXECUTE_FAIL("VcfAnnotateConsequence", "-in " + TESTDATA("data_in/VcfAnnotateConsequence_in1.vcf") + " -gff out/GffToTranscriptDb_out1.transcripts -out out/GffToTranscriptDb_out3.vcf -all");
+	}
+};
@@ -46,4 +46,69 @@ private slots:
 		COMPARE_FILES("out/SampleSimilarity_out7.tsv", TESTDATA("data_out/SampleSimilarity_out7.tsv"));
 	}
 
+	void test_gsvar_multisample_threads()
+	{
+		EXECUTE("SampleSimilarity", "-in " + TESTDATA("data_in/SampleSimilarity_in1.GSvar") + " " + TESTDATA("data_in/SampleSimilarity_in2.GSvar") + " " + TESTDATA("data_in/SampleSimilarity_in3.GSvar") + " -build hg19 -out out/SampleSimilarity_out8.tsv -include_gonosomes -mode gsvar -threads 2");
+		COMPARE_FILES("out/SampleSimilarity_out8.tsv", TESTDATA("data_out/SampleSimilarity_out1.tsv"));
+	}
+
+	void test_gsvar_in2()
+	{
+		QString tmp = Helper::tempFileName("_samples.txt");
+		Helper::storeTextFile(tmp, QStringList() << TESTDATA("data_in/SampleSimilarity_in1.GSvar"));
+		EXECUTE("SampleSimilarity", "-in " + tmp + " -in2 " + TESTDATA("data_in/SampleSimilarity_in2.GSvar") + " " + TESTDATA("data_in/SampleSimilarity_in3.GSvar") + " -build hg19 -out out/SampleSimilarity_out9.tsv -include_gonosomes -mode gsvar");
+		COMPARE_FILES("out/SampleSimilarity_out9.tsv", TESTDATA("data_out/SampleSimilarity_out9.tsv"));
+	}
+
+	void test_fingerprint()
+	{
+		//genotyping from BAM (fingerprints are stored)
+		QDir("out/SampleSimilarity_fingerprints").removeRecursively();
+		EXECUTE("SampleSimilarity", "-in " + TESTDATA("data_in/SampleSimilarity_in4.bam") + " " + TESTDATA("data_in/SampleSimilarity_in5.bam") + " -build hg19 -out out/SampleSimilarity_out10.tsv -mode fingerprint -max_snps 200 -fingerprint_dir out/SampleSimilarity_fingerprints -threads 2");
+		QStringList fp_files = QDir("out/SampleSimilarity_fingerprints").entryList(QStringList() << "*.fingerprint", QDir::Files, QDir::Name);
+		I_EQUAL(fp_files.count(), 2);
+		IS_TRUE(fp_files[0].startsWith("SampleSimilarity_in4.bam_"));
+		IS_TRUE(fp_files[1].startsWith("SampleSimilarity_in5.bam_"));
+
+		//same SNPs and genotypes as in BAM mode, i.e. overlap and IBS metrics are the same (the correlation is calculated from genotypes instead of allele frequencies)
+		QStringList expected = Helper::loadTextFile(TESTDATA("data_out/SampleSimilarity_out2.tsv"));
+		QStringList lines = Helper::loadTextFile("out/SampleSimilarity_out10.tsv");
+		I_EQUAL(lines.count(), expected.count());
+		S_EQUAL(lines[0], expected[0]);
+		QStringList parts = lines[1].split('\t');
+		QStringList parts_expected = expected[1].split('\t');
+		S_EQUAL(parts[0], parts_expected[0]);
+		S_EQUAL(parts[1], parts_expected[1]);
+		S_EQUAL(parts[2], parts_expected[2]);
+		S_EQUAL(parts[4], parts_expected[4]);
+		S_EQUAL(parts[5], parts_expected[5]);
+
+		//stored fingerprints are re-used
+		EXECUTE("SampleSimilarity", "-in " + TESTDATA("data_in/SampleSimilarity_in4.bam") + " " + TESTDATA("data_in/SampleSimilarity_in5.bam") + " -build hg19 -out out/SampleSimilarity_out11.tsv -mode fingerprint -max_snps 200 -fingerprint_dir out/SampleSimilarity_fingerprints");
+		COMPARE_FILES("out/SampleSimilarity_out11.tsv", "out/SampleSimilarity_out10.tsv");
+
+		//stored fingerprints of a different file with the same name are not re-used
+		QDir().mkpath("out/SampleSimilarity_copy");
+		QFile::remove("out/SampleSimilarity_copy/SampleSimilarity_in5.bam");
+		QFile::remove("out/SampleSimilarity_copy/SampleSimilarity_in5.bam.bai");
+		IS_TRUE(QFile::copy(TESTDATA("data_in/SampleSimilarity_in4.bam"), "out/SampleSimilarity_copy/SampleSimilarity_in5.bam"));
+		IS_TRUE(QFile::copy(TESTDATA("data_in/SampleSimilarity_in4.bam.bai"), "out/SampleSimilarity_copy/SampleSimilarity_in5.bam.bai"));
+		EXECUTE("SampleSimilarity", "-in " + TESTDATA("data_in/SampleSimilarity_in4.bam") + " out/SampleSimilarity_copy/SampleSimilarity_in5.bam -build hg19 -out out/SampleSimilarity_out14.tsv -mode fingerprint -max_snps 200 -fingerprint_dir out/SampleSimilarity_fingerprints");
+		lines = Helper::loadTextFile("out/SampleSimilarity_out14.tsv");
+		parts = lines[1].split('\t');
+		S_EQUAL(parts[3], "1.0000"); //identical samples
+		S_EQUAL(parts[4], "0.00");
+		I_EQUAL(QDir("out/SampleSimilarity_fingerprints").entryList(QStringList() << "*.fingerprint", QDir::Files).count(), 3);
+
+		//fingerprint files as input
+		EXECUTE("SampleSimilarity", "-in out/SampleSimilarity_fingerprints/" + fp_files[0] + " out/SampleSimilarity_fingerprints/" + fp_files[1] + " -build hg19 -out out/SampleSimilarity_out12.tsv -mode fingerprint");
+		QStringList lines1 = Helper::loadTextFile("out/SampleSimilarity_out10.tsv");
+		QStringList lines2 = Helper::loadTextFile("out/SampleSimilarity_out12.tsv");
+		I_EQUAL(lines1.count(), lines2.count());
+		S_EQUAL(lines1[1].section('\t', 2), lines2[1].section('\t', 2));
+
+		//fingerprints of a different SNP panel
+		EXECUTE_FAIL("SampleSimilarity", "-in out/SampleSimilarity_fingerprints/" + fp_files[0] + " out/SampleSimilarity_fingerprints/" + fp_files[1] + " -build hg38 -out out/SampleSimilarity_out13.tsv -mode fingerprint");
+	}
+
 };
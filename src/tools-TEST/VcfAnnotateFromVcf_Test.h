@@ -38,6 +38,21 @@ private slots:
 		}
 	}
 
+	void test_sorted()
+	{
+		EXECUTE("VcfAnnotateFromVcf", "-in " + TESTDATA("data_in/VcfAnnotateFromVcf_in1.vcf") + " -out out/VcfAnnotateFromVcf_out1_sorted.vcf -config_file " + TESTDATA("data_in/VcfAnnotateFromVcf_config.tsv") + " -sorted");
+		COMPARE_FILES("out/VcfAnnotateFromVcf_out1_sorted.vcf", TESTDATA("data_out/VcfAnnotateFromVcf_out1.vcf"));
+		VCF_IS_VALID_HG19("out/VcfAnnotateFromVcf_out1_sorted.vcf");
+
+		EXECUTE("VcfAnnotateFromVcf", "-in " + TESTDATA("data_in/VcfAnnotateFromVcf_in1.vcf") + " -out out/VcfAnnotateFromVcf_out2_sorted.vcf -source " + TESTDATA("data_in/VcfAnnotateFromVcf_an2_NGSD.vcf.gz") + " -info_keys COUNTS,GSC01=GROUP,HAF,CLAS,CLAS_COM,COM -id_column ID -prefix NGSD -block_size 30 -threads 4 -sorted");
+		COMPARE_FILES("out/VcfAnnotateFromVcf_out2_sorted.vcf", TESTDATA("data_out/VcfAnnotateFromVcf_out2.vcf"));
+		VCF_IS_VALID_HG19("out/VcfAnnotateFromVcf_out2_sorted.vcf");
+
+		EXECUTE("VcfAnnotateFromVcf", "-in " + TESTDATA("data_in/VcfAnnotateFromVcf_in1.vcf") + " -source " + TESTDATA("data_in/VcfAnnotateFromVcf_an3_ExOnly.vcf.gz") + " -out out/VcfAnnotateFromVcf_out6_sorted.vcf -existence_only -sorted");
+		COMPARE_FILES("out/VcfAnnotateFromVcf_out6_sorted.vcf", TESTDATA("data_out/VcfAnnotateFromVcf_out6.vcf"));
+		VCF_IS_VALID_HG19("out/VcfAnnotateFromVcf_out6_sorted.vcf");
+	}
+
 	void test_with_unordered_info_ids()
 	{
 		EXECUTE("VcfAnnotateFromVcf", "-in " + TESTDATA("data_in/VcfAnnotateFromVcf_in1.vcf") + " -out out/VcfAnnotateFromVcf_out3.vcf -source " + TESTDATA("data_in/VcfAnnotateFromVcf_an2_NGSD.vcf.gz") + " -info_keys GSC01=GROUP,CLAS,COM,CLAS_COM,COUNTS,HAF -id_column ID -prefix NGSD" );
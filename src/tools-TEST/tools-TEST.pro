@@ -28,6 +28,7 @@ INCLUDEPATH += $$PWD/../VcfToBedpe
 HEADERS += NGSDAddVariantsSomatic_Test.h \
     BamRemoveVariants_Test.h \
     CnvReferenceCohort_Test.h \
+    CnvCoverageMatrix_Test.h \
     BedpeAnnotateBreakpointDensity_Test.h \
     NGSDExportGff_Test.h \
     FastqCheckUMI.h \
@@ -88,6 +89,7 @@ HEADERS += NGSDAddVariantsSomatic_Test.h \
     NGSDImportHGNC_Test.h \
     NGSDImportEnsembl_Test.h \
     BamDownsample_Test.h \
+    BamCoverageCache_Test.h \
     BedReadCount_Test.h \
     NGSDImportHPO_Test.h \
     BamClipOverlap_Test.h \
@@ -135,6 +137,7 @@ HEADERS += NGSDAddVariantsSomatic_Test.h \
     VariantAnnotateASE_Test.h \
     SplicingToBed_Test.h \
     GraphStringDb_Test.h \
+    GffToTranscriptDb_Test.h \
     GenePrioritization_Test.h \
     CfDnaQC_Test.h \
     VcfAnnotateFromBigWig_Test.h \
@@ -598,3 +598,15 @@ BamRemoveVariants.depends = cppNGS
 SUBDIRS += CnvReferenceCohort
 tools-TEST.depends += CnvReferenceCohort
 CnvReferenceCohort.depends = cppNGS
+
+SUBDIRS += BamCoverageCache
+tools-TEST.depends += BamCoverageCache
+BamCoverageCache.depends = cppNGS
+
+SUBDIRS += CnvCoverageMatrix
+tools-TEST.depends += CnvCoverageMatrix
+CnvCoverageMatrix.depends = cppNGS
+
+SUBDIRS += GffToTranscriptDb
+tools-TEST.depends += GffToTranscriptDb
+GffToTranscriptDb.depends = cppNGS
@@ -0,0 +1,47 @@
+#!/bin/bash
+#Micro-benchmark of VcfAnnotateFromVcf on repository test data (no external data needed).
+#Every input variant is contained in the source file, i.e. every variant takes the INFO parsing path.
+#Reports variants per second (best of several runs) and heap allocations per variant (if valgrind is installed).
+#Usage: VcfAnnotateFromVcf.sh [bin folder] [runs]
+set -e
+
+BIN=${1:-../../bin}
+RUNS=${2:-5}
+SOURCE=../../src/tools-TEST/data_in/VcfAnnotateFromVcf_an2_NGSD.vcf.gz
+ARGS="-source $SOURCE -info_keys COUNTS,GSC01=GROUP,HAF,CLAS,CLAS_COM,COM -id_column ID -prefix NGSD"
+TMP=$(mktemp -d)
+trap "rm -rf $TMP" EXIT
+
+#create input files: all variants of the source file and the first 1000 variants
+zcat $SOURCE > $TMP/in_all.vcf
+zcat $SOURCE | awk '/^#/ || ++n<=1000' > $TMP/in_1000.vcf
+VARIANTS=$(grep -vc "^#" $TMP/in_all.vcf)
+VARIANTS_SMALL=$(grep -vc "^#" $TMP/in_1000.vcf)
+
+#runtime
+BEST=""
+for i in $(seq 1 $RUNS)
+do
+	START=$(date +%s.%N)
+	$BIN/VcfAnnotateFromVcf -in $TMP/in_all.vcf -out $TMP/out.vcf $ARGS > /dev/null
+	END=$(date +%s.%N)
+	TIME=$(echo "$END - $START" | bc -l)
+	if [ -z "$BEST" ] || [ $(echo "$TIME < $BEST" | bc -l) -eq 1 ]; then BEST=$TIME; fi
+done
+echo "variants: $VARIANTS"
+printf "runtime (best of %d): %.3f s\n" $RUNS $BEST
+printf "variants per second: %.0f\n" $(echo "$VARIANTS / $BEST" | bc -l)
+
+#heap allocations (difference between both inputs, i.e. without start-up and header allocations)
+if ! command -v valgrind > /dev/null
+then
+	echo "allocations per variant: skipped (valgrind not installed)"
+	exit 0
+fi
+function allocs()
+{
+	valgrind --tool=memcheck $BIN/VcfAnnotateFromVcf -in $1 -out $TMP/out.vcf $ARGS 2>&1 >/dev/null | grep "total heap usage" | awk '{gsub(",", "", $5); print $5}'
+}
+ALLOCS_ALL=$(allocs $TMP/in_all.vcf)
+ALLOCS_SMALL=$(allocs $TMP/in_1000.vcf)
+printf "allocations per variant: %.1f\n" $(echo "($ALLOCS_ALL - $ALLOCS_SMALL) / ($VARIANTS - $VARIANTS_SMALL)" | bc -l)